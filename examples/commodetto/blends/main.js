@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2016-2017  Moddable Tech, Inc.
+ *
+ *   This file is part of the Moddable SDK.
+ * 
+ *   This work is licensed under the
+ *       Creative Commons Attribution 4.0 International License.
+ *   To view a copy of this license, visit
+ *       <http://creativecommons.org/licenses/by/4.0>.
+ *   or send a letter to Creative Commons, PO Box 1866,
+ *   Mountain View, CA 94042, USA.
+ *
+ */
+
+// Measures the Poco blenders: blended rectangles, gray (anti-aliased) bitmaps, and masked bitmaps.
+// Pixels are discarded. A checksum of the first frame of each kind allows output to be compared between builds.
+
+import PixelsOut from "commodetto/PixelsOut";
+import Bitmap from "commodetto/Bitmap";
+import Poco from "commodetto/Poco";
+
+const width = 320;
+const height = 240;
+const lines = 16;
+const count = 40;
+const frames = 50;
+
+let checksum = 0;
+class ChecksumOut extends PixelsOut {
+	send(pixels, offset, count) {
+		if (!checksum)
+			return;
+		let bytes = new Uint8Array(pixels, offset, count);
+		for (let i = 0; i < count; i++)
+			checksum = (Math.imul(checksum, 31) + bytes[i]) | 0;
+	}
+}
+
+let out = new ChecksumOut({width, height, pixelFormat: screen.pixelFormat});
+let render = new Poco(out, {pixels: width * lines, displayListLength: 8192});
+
+let seed = 1;
+function random(range) {
+	seed = (Math.imul(seed, 1103515245) + 12345) & 0x7FFFFFFF;
+	return (seed >> 8) % range;
+}
+
+function fill(buffer) {
+	let bytes = new Uint8Array(buffer);
+	for (let i = 0; i < bytes.length; i++)
+		bytes[i] = random(256);
+	return buffer;
+}
+
+const gray = new Bitmap(256, 128, Bitmap.Gray16, fill(new ArrayBuffer(256 * 128 / 2)), 0);
+const bits = new Bitmap(256, 128, screen.pixelFormat, fill(new ArrayBuffer((256 * 128 * Bitmap.depth(screen.pixelFormat)) >> 3)), 0);
+
+const kinds = {
+	blendRectangle(x, y, w, h) {
+		render.blendRectangle(render.makeColor(random(256), random(256), random(256)), 1 + random(254), x, y, w, h);
+	},
+	drawGray(x, y, w, h) {
+		render.drawGray(gray, render.makeColor(random(256), random(256), random(256)), x, y, random(64), 0, w >> 1, h >> 1);
+	},
+	drawMasked(x, y, w, h) {
+		render.drawMasked(bits, x, y, random(64), 0, w >> 1, h >> 1, gray, random(64), 0, 1 + random(254));
+	},
+};
+
+for (let name in kinds) {
+	let draw = kinds[name];
+	let start = Date.now();
+	checksum = 1;
+	for (let frame = 0; frame < frames; frame++) {
+		seed = 1;
+		render.begin();
+			render.fillRectangle(render.makeColor(0, 0, 0), 0, 0, width, height);
+			for (let i = 0; i < count; i++)
+				draw(random(width) - 20, random(height) - 20, 32 + random(width), 32 + random(height >> 1));
+		render.end();
+		if (0 == frame)
+			trace(`${name}: checksum ${(checksum >>> 0).toString(16)}, `);
+		checksum = 0;
+	}
+	trace(`${(Date.now() - start) / frames} ms per frame\n`);
+}
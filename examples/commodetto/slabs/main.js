@@ -0,0 +1,70 @@
+/*
+ * Copyright (c) 2016-2017  Moddable Tech, Inc.
+ *
+ *   This file is part of the Moddable SDK.
+ * 
+ *   This work is licensed under the
+ *       Creative Commons Attribution 4.0 International License.
+ *   To view a copy of this license, visit
+ *       <http://creativecommons.org/licenses/by/4.0>.
+ *   or send a letter to Creative Commons, PO Box 1866,
+ *   Mountain View, CA 94042, USA.
+ *
+ */
+
+// Measures Poco rendering of a tall scene with many commands into small strips.
+// Pixels are discarded, so the time is spent walking the display list and blitting.
+
+import PixelsOut from "commodetto/PixelsOut";
+import Poco from "commodetto/Poco";
+
+const width = 1280;
+const height = 800;
+const lines = 8;
+const count = 2000;
+const frames = 20;
+
+class NullOut extends PixelsOut {
+	send(pixels, offset, count) {
+	}
+}
+
+let out = new NullOut({width, height, pixelFormat: screen.pixelFormat});
+let render = new Poco(out, {pixels: width * lines, displayListLength: 48 * 1024});
+
+let seed = 1;
+function random(range) {
+	seed = (Math.imul(seed, 1103515245) + 12345) & 0x7FFFFFFF;
+	return (seed >> 8) % range;
+}
+
+let commands = [];
+for (let i = 0; i < count; i++) {
+	let kind = random(8);
+	let color = render.makeColor(random(256), random(256), random(256));
+	let x = random(width), y = random(height);
+	if (kind < 5)
+		commands.push({kind, color, x, y, w: 4 + random(40), h: 4 + random(24)});
+	else if (kind < 7)
+		commands.push({kind, color, x, y, w: 4 + random(80), h: 4 + random(80), blend: 32 + random(192)});
+	else
+		commands.push({kind, color, x, y});
+}
+
+let black = render.makeColor(0, 0, 0);
+let start = Date.now();
+for (let frame = 0; frame < frames; frame++) {
+	render.begin();
+		render.fillRectangle(black, 0, 0, width, height);
+		for (let i = 0; i < count; i++) {
+			let c = commands[i];
+			if (c.kind < 5)
+				render.fillRectangle(c.color, c.x, c.y, c.w, c.h);
+			else if (c.kind < 7)
+				render.blendRectangle(c.color, c.blend, c.x, c.y, c.w, c.h);
+			else
+				render.drawPixel(c.color, c.x, c.y);
+		}
+	render.end();
+}
+trace(`${count} commands, ${width}x${height} in ${lines} line strips: ${(Date.now() - start) / frames} ms per frame\n`);
@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2016-2017  Moddable Tech, Inc.
+ *
+ *   This file is part of the Moddable SDK.
+ * 
+ *   This work is licensed under the
+ *       Creative Commons Attribution 4.0 International License.
+ *   To view a copy of this license, visit
+ *       <http://creativecommons.org/licenses/by/4.0>.
+ *   or send a letter to Creative Commons, PO Box 1866,
+ *   Mountain View, CA 94042, USA.
+ *
+ */
+
+// Measures the cost of suspending and resuming async functions and generators.
+// XS does not support for await yet, so each item is awaited in a for of loop.
+
+const count = 100000;
+
+async function awaitValues(items) {
+	let sum = 0;
+	for (const item of items)
+		sum += await item;
+	return sum;
+}
+
+async function awaitPromises(items) {
+	let sum = 0;
+	for (const item of items)
+		sum += await Promise.resolve(item);
+	return sum;
+}
+
+async function awaitInTry(items) {
+	let sum = 0, finallies = 0;
+	try {
+		for (const item of items) {
+			try {
+				sum += await item;
+			}
+			finally {
+				finallies++;
+			}
+		}
+	}
+	catch (e) {
+	}
+	return sum + finallies;
+}
+
+function* generate(n) {
+	for (let i = 0; i < n; i++)
+		yield i;
+}
+
+async function measure(name, f) {
+	const when = Date.now();
+	await f();
+	trace(name + ": " + (Date.now() - when) + " ms\n");
+}
+
+async function main() {
+	const items = [];
+	for (let i = 0; i < count; i++)
+		items.push(i);
+	trace(count + " items\n");
+	await measure("await values", () => awaitValues(items));
+	await measure("await promises", () => awaitPromises(items));
+	await measure("await in try", () => awaitInTry(items));
+	await measure("yield", () => {
+		let sum = 0;
+		for (const value of generate(count))
+			sum += value;
+	});
+}
+
+main();
@@ -62,9 +62,10 @@ enum {
 	kModInstrumentationGarbageCollectionCount,
 	kModInstrumentationModulesLoaded,
 	kModInstrumentationStackRemain,
+	kModInstrumentationStackHighWater,
 
 	kModInstrumentationCallbacksBegin = kModInstrumentationSystemFreeMemory,
-	kModInstrumentationCallbacksEnd = kModInstrumentationStackRemain,
+	kModInstrumentationCallbacksEnd = kModInstrumentationStackHighWater,
 
 	kModInstrumentationLast = kModInstrumentationCallbacksEnd
 };
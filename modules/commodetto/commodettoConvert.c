@@ -41,17 +41,37 @@
 	XS binding
 */
 
+/*
+	process returns the number of bytes written to dst. when its optional stream argument is true, input may end
+	anywhere: a partial pixel, and any whole pixels that would share its destination byte, are held and converted at the
+	start of the next call. a call without stream converts all remaining input, leaving the last destination byte
+	partially filled when needed, as each call did before.
+*/
+
+#define kCarryBytes (32)
+
 typedef struct {
 	CommodettoBitmapFormat	srcPixelFormat;
 	CommodettoBitmapFormat	dstPixelFormat;
 	uint8_t					srcPixelDepth;
 	uint8_t					dstPixelDepth;
 
+	uint8_t					unitPixels;			// source pixels for a whole number of bytes of both source and destination
+	uint8_t					unitBytes;
+	uint8_t					carryBytes;
+
 	void					*clut;
 
 	CommodettoConverter		converter;
+
+	uint8_t					carry[kCarryBytes];
 } xsConvertRecord,  *xsConvert;
 
+static uint8_t convertFormats(xsConvert c, CommodettoBitmapFormat srcPixelFormat, CommodettoBitmapFormat dstPixelFormat);
+static const char *convertClut(xsConvert c, void *clut, uint32_t clutBytes);
+static int convertProcess(xsConvert c, uint8_t *src, int srcLength, uint8_t *dst, int dstLength, uint8_t stream);
+static void buildInverseTable(uint16_t *colors, uint8_t *inverseTable);
+
 void xs_Convert_destructor(void *data)
 {
 	if (data) {
@@ -65,19 +85,13 @@ void xs_Convert(xsMachine *the)
 {
 	xsConvert c = xsmcSetHostChunk(xsThis, NULL, sizeof(xsConvertRecord));
 
-	c->srcPixelFormat = (CommodettoBitmapFormat)xsmcToInteger(xsArg(0));
-	c->dstPixelFormat = (CommodettoBitmapFormat)xsmcToInteger(xsArg(1));
-
-	c->srcPixelDepth = CommodettoBitmapGetDepth(c->srcPixelFormat);
-	c->dstPixelDepth = CommodettoBitmapGetDepth(c->dstPixelFormat);
-
-	c->converter = CommodettoPixelsConverterGet(c->srcPixelFormat, c->dstPixelFormat);
-	if (NULL == c->converter)
+	if (!convertFormats(c, (CommodettoBitmapFormat)xsmcToInteger(xsArg(0)), (CommodettoBitmapFormat)xsmcToInteger(xsArg(1))))
 		xsErrorPrintf("conversion not supported");
 
 	if (kCommodettoBitmapCLUT16 == c->dstPixelFormat) {
 		void *clut;
 		uint32_t clutBytes;
+		const char *error;
 
 		if (!xsmcTest(xsArg(2)))
 			xsErrorPrintf("clut required");
@@ -93,18 +107,18 @@ void xs_Convert(xsMachine *the)
 			clutBytes = xsmcToInteger(xsVar(0));
 		}
 
-		c->clut = malloc(clutBytes);
-		if (NULL == c->clut)
-			xsErrorPrintf("not enough memory to clone clut");
-		memcpy(c->clut, clut, clutBytes);
+		c = xsmcGetHostChunk(xsThis);		// after the byteLength get, which may move the chunk
+		error = convertClut(c, clut, clutBytes);
+		if (error)
+			xsErrorPrintf(error);
 	}
 }
 
 void xs_convert_process(xsMachine *the)
 {
-	xsConvert c = xsmcGetHostChunk(xsThis);
 	uint8_t *src, *dst;
-	int srcLength, dstLength, pixelCount;
+	int srcLength, dstLength, written;
+	uint8_t stream = (xsmcArgc > 2) && xsmcTest(xsArg(2));
 
 	if (xsmcIsInstanceOf(xsArg(0), xsArrayBufferPrototype)) {
 		src = xsmcToArrayBuffer(xsArg(0));
@@ -119,12 +133,109 @@ void xs_convert_process(xsMachine *the)
 	dst = xsmcToArrayBuffer(xsArg(1));
 	dstLength = xsGetArrayBufferLength(xsArg(1));
 
+	written = convertProcess(xsmcGetHostChunk(xsThis), src, srcLength, dst, dstLength, stream);		// after the byteLength get, which may move the chunk
+	if (written < 0)
+		xsErrorPrintf("dst buffer too small");
+
+	xsmcSetInteger(xsResult, written);
+}
+
+/*
+	formats, and the source pixels of a unit. returns 0 when there is no converter
+*/
+
+uint8_t convertFormats(xsConvert c, CommodettoBitmapFormat srcPixelFormat, CommodettoBitmapFormat dstPixelFormat)
+{
+	c->srcPixelFormat = srcPixelFormat;
+	c->dstPixelFormat = dstPixelFormat;
+
+	c->srcPixelDepth = CommodettoBitmapGetDepth(c->srcPixelFormat);
+	c->dstPixelDepth = CommodettoBitmapGetDepth(c->dstPixelFormat);
+	c->unitPixels = (c->dstPixelDepth < 8) ? (8 / c->dstPixelDepth) : 1;
+	if ((c->srcPixelDepth < 8) && ((8 / c->srcPixelDepth) > c->unitPixels))
+		c->unitPixels = 8 / c->srcPixelDepth;
+	c->unitBytes = (c->unitPixels * c->srcPixelDepth) >> 3;
+
+	c->converter = CommodettoPixelsConverterGet(c->srcPixelFormat, c->dstPixelFormat);
+	return NULL != c->converter;
+}
+
+/*
+	copy of a CLUT16 clut, with its inverse table built when only the 16 colors are given. returns an error message or NULL
+*/
+
+const char *convertClut(xsConvert c, void *clut, uint32_t clutBytes)
+{
+	if (clutBytes < (sizeof(uint16_t) * 16))
+		return "invalid clut";
+
+	if (clutBytes >= ((sizeof(uint16_t) * 16) + 4096)) {
+		c->clut = malloc(clutBytes);
+		if (NULL == c->clut)
+			return "not enough memory to clone clut";
+		memcpy(c->clut, clut, clutBytes);
+	}
+	else {
+		// only the 16 colors: build the 4:4:4 inverse table that follows them in a full clut
+		c->clut = malloc((sizeof(uint16_t) * 16) + 4096);
+		if (NULL == c->clut)
+			return "not enough memory to clone clut";
+		memcpy(c->clut, clut, sizeof(uint16_t) * 16);
+		buildInverseTable(c->clut, (uint8_t *)c->clut + (sizeof(uint16_t) * 16));
+	}
+
+	return NULL;
+}
+
+/*
+	converts src to dst, holding back the end of a stream. returns the number of bytes written, or -1 when dst is too small
+*/
+
+int convertProcess(xsConvert c, uint8_t *src, int srcLength, uint8_t *dst, int dstLength, uint8_t stream)
+{
+	int pixelCount, written = 0;
+
+	if (c->carryBytes) {
+		// complete the unit held by the previous call
+		int use = c->unitBytes - c->carryBytes;
+
+		if (use > srcLength)
+			use = srcLength;
+		memcpy(c->carry + c->carryBytes, src, use);
+		c->carryBytes += use;
+		src += use;
+		srcLength -= use;
+
+		if ((c->carryBytes < c->unitBytes) && stream)
+			return 0;
+
+		pixelCount = (c->carryBytes << 3) / c->srcPixelDepth;
+		written = ((pixelCount * c->dstPixelDepth) + 7) >> 3;
+		if (dstLength < written)
+			return -1;
+
+		(c->converter)((uint32_t)pixelCount, c->carry, dst, c->clut);
+		c->carryBytes = 0;
+
+		dst += written;
+		dstLength -= written;
+	}
+
 	pixelCount = (srcLength << 3) / c->srcPixelDepth;
+	if (stream) {
+		// hold a partial pixel, and any whole pixels that share its destination byte
+		pixelCount -= pixelCount % c->unitPixels;
+		c->carryBytes = srcLength - ((pixelCount * c->srcPixelDepth) >> 3);
+		memcpy(c->carry, src + srcLength - c->carryBytes, c->carryBytes);
+	}
 
 	if (((dstLength << 3) / c->dstPixelDepth) < pixelCount)
-		xsErrorPrintf("dst buffer too small");
+		return -1;
 
 	(c->converter)((uint32_t)pixelCount, src, dst, c->clut);
+	written += ((pixelCount * c->dstPixelDepth) + 7) >> 3;
+
+	return written;
 }
 
 /*
@@ -143,8 +254,10 @@ static void ccGray256toMonochrome(uint32_t pixelCount, void *src, void *dst, voi
 static void ccGray256toGray16(uint32_t pixelCount, void *src, void *dst, void *clut);
 static void ccGray256toRGB332(uint32_t pixelCount, void *src, void *dst, void *clut);
 static void ccGray256toRGB565LE(uint32_t pixelCount, void *src, void *dst, void *clut);
+static void ccGray256toCLUT16(uint32_t pixelCount, void *src, void *dst, void *clut);
 
 static void ccRGB565LEtoGray256(uint32_t pixelCount, void *srcPixels, void *dstPixels, void *clut);
+static void ccRGB565LEtoCLUT16(uint32_t pixelCount, void *srcPixels, void *dstPixels, void *clut);
 
 static void cc24RGBtoGray16(uint32_t pixelCount, void *src, void *dst, void *clut);
 static void cc24RGBtoGray256(uint32_t pixelCount, void *src, void *dst, void *clut);
@@ -179,7 +292,7 @@ static const CommodettoConverter gFromGray256[] ICACHE_XS6RO_ATTR = {
 	NULL,					// toRGB565BE
 	NULL,					// to24RGB
 	NULL,					// to32RGBA
-	NULL					// toCLUT16
+	ccGray256toCLUT16		// toCLUT16
 };
 
 static const CommodettoConverter gFromRGB565LE[] ICACHE_XS6RO_ATTR = {
@@ -191,7 +304,7 @@ static const CommodettoConverter gFromRGB565LE[] ICACHE_XS6RO_ATTR = {
 	NULL,					// toRGB565BE
 	NULL,					// to24RGB
 	NULL,					// to32RGBA
-	NULL					// toCLUT16
+	ccRGB565LEtoCLUT16		// toCLUT16
 };
 
 static const CommodettoConverter gFrom24RGB[] ICACHE_XS6RO_ATTR = {
@@ -235,13 +348,16 @@ uint8_t CommodettoPixelsConvert(uint32_t pixelCount,
 								void *srcPixels, CommodettoBitmapFormat srcFormat,
 								void *dstPixels, CommodettoBitmapFormat dstFormat)
 {
-	if ((srcFormat < kCommodettoBitmapMonochrome) || (dstFormat < kCommodettoBitmapMonochrome))
+	CommodettoConverter converter;
+
+	if (dstFormat > kCommodettoBitmap32RGBA)
 		return 0;
 
-	if ((srcFormat > kCommodettoBitmap32RGBA) || (dstFormat > kCommodettoBitmap32RGBA))
+	converter = CommodettoPixelsConverterGet(srcFormat, dstFormat);
+	if (NULL == converter)
 		return 0;
 
-	(gFromConverters[srcFormat - kCommodettoBitmapMonochrome])[dstFormat - kCommodettoBitmapMonochrome](pixelCount, srcPixels, dstPixels, NULL);
+	(converter)(pixelCount, srcPixels, dstPixels, NULL);
 
 	return 1;
 }
@@ -254,6 +370,9 @@ CommodettoConverter CommodettoPixelsConverterGet(CommodettoBitmapFormat srcForma
 	if ((srcFormat > kCommodettoBitmap32RGBA) || (dstFormat > kCommodettoBitmapCLUT16))
 		return 0;
 
+	if (NULL == gFromConverters[srcFormat - kCommodettoBitmapMonochrome])
+		return 0;
+
 	return (gFromConverters[srcFormat - kCommodettoBitmapMonochrome])[dstFormat - kCommodettoBitmapMonochrome];
 }
 
@@ -334,11 +453,11 @@ void ccGray256toRGB565LE(uint32_t pixelCount, void *srcPixels, void *dstPixels,
 
 void ccRGB565LEtoGray256(uint32_t pixelCount, void *srcPixels, void *dstPixels, void *clut)
 {
-	uint16_t *src = srcPixels;
+	uint8_t *src = srcPixels;
 	uint8_t *dst = dstPixels;
 
 	while (pixelCount--) {
-		uint16_t srcPixel = *src++;
+		uint16_t srcPixel = src[0] | (src[1] << 8);		// streamed input may not be aligned
 		uint8_t r = srcPixel >> 11;
 		uint8_t g = (srcPixel >> 5) & 0x3F;
 		uint8_t b = (srcPixel & 0x1F);
@@ -346,6 +465,7 @@ void ccRGB565LEtoGray256(uint32_t pixelCount, void *srcPixels, void *dstPixels,
 		r = (r << 3) | (r >> 2);
 		g = (g << 2) | (g >> 4);
 		b = (b << 3) | (b >> 2);
+		src += 2;
 
 		*dst++ = toGray(r, g, b);
 	}
@@ -569,3 +689,71 @@ void cc32RGBAtoCLUT16(uint32_t pixelCount, void *srcPixels, void *dstPixels, voi
 	if (pixelCount)
 		*dst++ = inverse[((src[0] & 0xF0) << 4) | (src[1] & 0xF0) | (src[2] >> 4)] << 4;
 }
+
+void ccGray256toCLUT16(uint32_t pixelCount, void *srcPixels, void *dstPixels, void *clut)
+{
+	uint8_t *src = srcPixels;
+	uint8_t *dst = dstPixels;
+	uint8_t *inverse = (uint8_t *)clut + (sizeof(uint16_t) * 16);
+
+	while (pixelCount >= 2) {
+		*dst++ = (inverse[(src[0] >> 4) * 0x111] << 4) | inverse[(src[1] >> 4) * 0x111];
+		src += 2;
+		pixelCount -= 2;
+	}
+
+	if (pixelCount)
+		*dst++ = inverse[(src[0] >> 4) * 0x111] << 4;
+}
+
+void ccRGB565LEtoCLUT16(uint32_t pixelCount, void *srcPixels, void *dstPixels, void *clut)
+{
+	uint8_t *src = srcPixels;
+	uint8_t *dst = dstPixels;
+	uint8_t *inverse = (uint8_t *)clut + (sizeof(uint16_t) * 16);
+
+	while (pixelCount >= 2) {
+		uint16_t pixelA = src[0] | (src[1] << 8);
+		uint16_t pixelB = src[2] | (src[3] << 8);
+		uint16_t colorA, colorB;
+
+		colorA = ((pixelA >> 4) & 0xF00) | ((pixelA >> 3) & 0xF0) | ((pixelA >> 1) & 0x0F);
+		colorB = ((pixelB >> 4) & 0xF00) | ((pixelB >> 3) & 0xF0) | ((pixelB >> 1) & 0x0F);
+		*dst++ = (inverse[colorA] << 4) | inverse[colorB];
+
+		src += 4;
+		pixelCount -= 2;
+	}
+
+	if (pixelCount) {
+		uint16_t pixelA = src[0] | (src[1] << 8);
+		*dst++ = inverse[((pixelA >> 4) & 0xF00) | ((pixelA >> 3) & 0xF0) | ((pixelA >> 1) & 0x0F)] << 4;
+	}
+}
+
+// nearest of the 16 4:4:4 colors for each 4:4:4 color, as buildclut computes at build time
+void buildInverseTable(uint16_t *colors, uint8_t *inverseTable)
+{
+	uint16_t color;
+
+	for (color = 0; color < 4096; color++) {
+		int r = color >> 8, g = (color >> 4) & 0x0F, b = color & 0x0F;
+		int bestDelta = 1000000;
+		uint8_t i, nearest = 0;
+
+		for (i = 0; i < 16; i++) {
+			uint16_t entry = colors[i];
+			int dr = ((entry >> 8) & 0x0F) - r;
+			int dg = ((entry >> 4) & 0x0F) - g;
+			int db = (entry & 0x0F) - b;
+			int delta = (dr * dr) + (dg * dg) + (db * db);
+
+			if (delta < bestDelta) {
+				nearest = i;
+				bestDelta = delta;
+			}
+		}
+
+		inverseTable[color] = nearest;
+	}
+}
@@ -21,8 +21,8 @@
 
 
 export default class Convert @ "xs_Convert_destructor" {
-	constructor(src, dst) @ "xs_Convert";
-	process(src, dst) @ "xs_convert_process";
+	constructor(src, dst, clut) @ "xs_Convert";
+	process(src, dst, stream) @ "xs_convert_process";
 }
 
 Object.freeze(Convert.prototype);
@@ -202,6 +202,16 @@ void xs_poco_end(xsMachine *the)
 	if (!(poco->flags & kPocoFlagFrameBuffer)) {
 		int result;
 
+		if ((xsmcArgc > 2) && PocoDrawingSplit(poco, xsmcGetHostChunk(xsArg(1)), xsmcGetHostChunk(xsArg(2)))) {
+			// display list overflowed. nothing has been sent; caller draws each area separately
+			if (poco->flags & kPocoFlagGCDisabled) {
+				xsEnableGarbageCollection(true);
+				poco->flags &= ~kPocoFlagGCDisabled;
+			}
+			xsmcSetTrue(xsResult);
+			return;
+		}
+
 		xsmcVars(5);
 
 		if (pixelsOutDispatch) {
@@ -408,6 +418,101 @@ void xs_poco_drawBitmap(xsMachine *the)
 	PocoBitmapDraw(poco, &bits, x, y, sx, sy, sw, sh);
 }
 
+void xs_poco_drawScaled(xsMachine *the)
+{
+	Poco poco = xsGetHostDataPoco(xsThis);
+	int argc = xsmcArgc;
+	PocoBitmapRecord bits;
+	PocoCoordinate x, y;
+	PocoDimension w, h, sx, sy, sw, sh;
+	PocoScaleMode mode = kPocoScaleNearest;
+	CommodettoBitmap cb;
+
+	xsmcVars(1);
+
+	cb = xsmcGetHostChunk(xsArg(0));
+	bits.width = cb->w;
+	bits.height = cb->h;
+	bits.format = cb->format;
+
+	if (cb->havePointer)
+		bits.pixels = cb->bits.data;
+	else {
+		xsmcGet(xsVar(0), xsArg(0), xsID_buffer);
+		bits.pixels = (PocoPixel *)((char *)xsmcToArrayBuffer(xsVar(0)) + cb->bits.offset);
+		PocoDisableGC(poco);
+	}
+
+	x = (PocoCoordinate)xsmcToInteger(xsArg(1)) + poco->xOrigin;
+	y = (PocoCoordinate)xsmcToInteger(xsArg(2)) + poco->yOrigin;
+	w = (PocoDimension)xsmcToInteger(xsArg(3));
+	h = (PocoDimension)xsmcToInteger(xsArg(4));
+
+	sx = 0, sy = 0;
+#if (90 == kPocoRotation) || (270 == kPocoRotation)
+	sw = bits.height, sh = bits.width;
+#else
+	sw = bits.width, sh = bits.height;
+#endif
+
+	if (argc > 5) {
+		sx = (PocoDimension)xsmcToInteger(xsArg(5));
+		sy = (PocoDimension)xsmcToInteger(xsArg(6));
+		sw = (PocoDimension)xsmcToInteger(xsArg(7));
+		sh = (PocoDimension)xsmcToInteger(xsArg(8));
+		if ((argc > 9) && xsmcTest(xsArg(9)))
+			mode = kPocoScaleBilinear;
+	}
+
+	PocoBitmapDrawScaled(poco, &bits, mode, x, y, w, h, sx, sy, sw, sh);
+}
+
+void xs_poco_drawRotated(xsMachine *the)
+{
+	Poco poco = xsGetHostDataPoco(xsThis);
+	int argc = xsmcArgc;
+	PocoBitmapRecord bits;
+	PocoCoordinate x, y;
+	PocoDimension sx, sy, sw, sh;
+	int rotation;
+	CommodettoBitmap cb;
+
+	xsmcVars(1);
+
+	cb = xsmcGetHostChunk(xsArg(0));
+	bits.width = cb->w;
+	bits.height = cb->h;
+	bits.format = cb->format;
+
+	if (cb->havePointer)
+		bits.pixels = cb->bits.data;
+	else {
+		xsmcGet(xsVar(0), xsArg(0), xsID_buffer);
+		bits.pixels = (PocoPixel *)((char *)xsmcToArrayBuffer(xsVar(0)) + cb->bits.offset);
+		PocoDisableGC(poco);
+	}
+
+	rotation = xsmcToInteger(xsArg(1));
+	x = (PocoCoordinate)xsmcToInteger(xsArg(2)) + poco->xOrigin;
+	y = (PocoCoordinate)xsmcToInteger(xsArg(3)) + poco->yOrigin;
+
+	sx = 0, sy = 0;
+#if (90 == kPocoRotation) || (270 == kPocoRotation)
+	sw = bits.height, sh = bits.width;
+#else
+	sw = bits.width, sh = bits.height;
+#endif
+
+	if (argc > 4) {
+		sx = (PocoDimension)xsmcToInteger(xsArg(4));
+		sy = (PocoDimension)xsmcToInteger(xsArg(5));
+		sw = (PocoDimension)xsmcToInteger(xsArg(6));
+		sh = (PocoDimension)xsmcToInteger(xsArg(7));
+	}
+
+	PocoBitmapDrawRotated(poco, &bits, (uint16_t)rotation, x, y, sx, sy, sw, sh);
+}
+
 void xs_poco_drawMonochrome(xsMachine *the)
 {
 	Poco poco = xsGetHostDataPoco(xsThis);
@@ -828,10 +933,10 @@ void xs_poco_drawText(xsMachine *the)
 				bits.width = sh;
 				bits.height = sw;
 #endif
-				PocoGrayBitmapDraw(poco, &bits, color, kPocoOpaque, cx, cy, 0, 0, sw, sh);
+				PocoGrayGlyphDraw(poco, &bits, color, kPocoOpaque, cx, cy, 0, 0, sw, sh);
 			}
 			else
-				PocoGrayBitmapDraw(poco, &bits, color, kPocoOpaque, cx, cy, sx, sy, sw, sh);
+				PocoGrayGlyphDraw(poco, &bits, color, kPocoOpaque, cx, cy, sx, sy, sw, sh);
 		}
 
 		x += xadvance;
@@ -58,6 +58,16 @@ export default class Poco @ "xs_poco_destructor" {
 		this.end(true);
 		this.begin(x, y, w, h);
 	}
+	draw(render, x = 0, y = 0, width = this.width - x, height = this.height - y, more = false) {
+		const first = new Rectangle(0, 0, 0, 0), second = new Rectangle(0, 0, 0, 0);
+
+		this.begin(x, y, width, height);
+		render(this);
+		if (this.end(more, first, second)) {		// display list overflowed. draw each half of the area
+			this.draw(render, first.x, first.y, first.w, first.h, true);
+			this.draw(render, second.x, second.y, second.w, second.h, more);
+		}
+	}
 
 	// clip and origin stacks
 	clip(x, y, width, height) @ "xs_poco_clip"
@@ -73,6 +83,8 @@ export default class Poco @ "xs_poco_destructor" {
 	drawGray(bits, color, x, y, sx, sy, sw, sh, blend) @ "xs_poco_drawGray"
 	drawMasked(bits, x, y, sx, sy, sw, sh, mask, mask_sx, mask_sy, blend) @ "xs_poco_drawMasked"
 	fillPattern(bits, x, y, w, h, sx, sx, sx, sh) @ "xs_poco_fillPattern"
+	drawScaled(bits, x, y, w, h, sx, sy, sw, sh, smooth) @ "xs_poco_drawScaled"
+	drawRotated(bits, rotation, x, y, sx, sy, sw, sh) @ "xs_poco_drawRotated"
 
 	drawFrame(frame, stream, x, y) @ "xs_poco_drawFrame"
 
@@ -41,10 +41,15 @@ enum {
 	kPocoCommandGray16RLEBlendBitmapDraw,
 	kPocoCommandBitmapDrawMasked,
 	kPocoCommandBitmapPattern,
+	kPocoCommandBitmapDrawScaled,
+	kPocoCommandTextRun,
 	kPocoCommandFrame,
-	kPocoCommandDrawMax = kPocoCommandFrame + 1
+	kPocoCommandExternal,
+	kPocoCommandDrawMax = kPocoCommandExternal + 1
 };
 
+#define kPocoCommandHidden (0x80)		// set on a command while it is culled from the current slab
+
 typedef uint8_t PocoCommandID;
 
 #if kPocoPixelSize >= 8
@@ -81,10 +86,85 @@ static void doDrawGray16RLEBitmapPart(Poco poco, PocoCommand pc, PocoPixel *d, P
 static void doDrawGray16RLEBlendBitmapPart(Poco poco, PocoCommand pc, PocoPixel *d, PocoDimension h);
 static void doDrawMaskedBitmap(Poco poco, PocoCommand pc, PocoPixel *d, PocoDimension h);
 static void doDrawPattern(Poco poco, PocoCommand pc, PocoPixel *dst, PocoDimension h);
+static void doDrawScaledBitmap(Poco poco, PocoCommand pc, PocoPixel *dst, PocoDimension h);
+static void doDrawTextRun(Poco poco, PocoCommand pc, PocoPixel *dst, PocoDimension h);
 static void doDrawFrame(Poco poco, PocoCommand pc, PocoPixel *dst, PocoDimension h);
+static void doDrawExternal(Poco poco, PocoCommand pc, PocoPixel *dst, PocoDimension h);
 
 static uint8_t doSkipColorCells(Poco poco, PocoCommand pc, int cells);
 
+static void bitmapDrawTransformed(Poco poco, PocoBitmap bits, PocoScaleMode mode, uint16_t rotation, PocoCoordinate x, PocoCoordinate y, PocoDimension w, PocoDimension h, PocoDimension sx, PocoDimension sy, PocoDimension sw, PocoDimension sh);
+#if kPocoPixelFormat != kCommodettoBitmapCLUT16
+	static PocoPixel bilinearPixel(PocoPixel p00, PocoPixel p01, PocoPixel p10, PocoPixel p11, uint8_t fx, uint8_t fy);
+#endif
+
+/*
+	slab index built at end of frame in the unused tail of the display list.
+	commands are referenced by offset from the start of the display list in longs.
+*/
+
+typedef uint16_t PocoSlabEntry;
+
+typedef struct {
+	PocoSlabEntry	*order;			// commands grouped by first slab, in display list order within each slab
+	PocoSlabEntry	*slabStart;		// index into order of first command of each slab (slabCount + 1 entries)
+	PocoSlabEntry	*active;		// commands begun in an earlier slab and still visible, right aligned
+	PocoCoordinate	*cover;			// sorted, disjoint spans of the slab covered by opaque commands. NULL if no room
+	int				count;
+	int				activeCount;
+} PocoSlabIndexRecord, *PocoSlabIndex;
+
+static int buildSlabIndex(Poco poco, PocoSlabIndex index, int16_t displayLines, int16_t displayLinesAlt);
+static int slabFromY(Poco poco, PocoCoordinate y, int16_t displayLines, int16_t displayLinesAlt);
+static void renderSlabCommand(Poco poco, PocoCommand pc, PocoPixel *pixels, PocoCoordinate yMin, PocoCoordinate yMax);
+static void cullSlabCommands(Poco poco, PocoSlabIndex index, PocoSlabEntry *entries, int count, PocoCoordinate yMin, PocoCoordinate yMax);
+static void seekCommand(Poco poco, PocoCommand pc, PocoDimension rows, PocoPixel *scratch);
+
+/*
+	with kPocoThreads > 1, the frame is rendered in horizontal bands by a pool of threads before the slabs are output.
+	each band renders from its own copy of the display list because commands keep per row state.
+	external renderers may keep state of their own, so a display list with an external command is rendered on the calling thread.
+*/
+
+#if kPocoThreads > 1
+	#include <pthread.h>
+
+	typedef struct {
+		Poco				poco;
+		PocoCommand			displayList;
+		PocoPixel			*pixels;
+		PocoPixel			*scratch;
+		PocoCoordinate		yMin;
+		PocoCoordinate		yMax;
+	} PocoBandRecord, *PocoBand;
+
+	static PocoPixel *renderBands(Poco poco);
+	static void renderBand(PocoBand band);
+	static void *renderBandsThread(void *refcon);
+#endif
+
+/*
+	with kPocoVector, the RGB565LE and Gray256 blenders process 8 pixels at a time using the compiler's generic vectors,
+	which map to SSE2 and NEON. results are identical to the scalar blenders.
+*/
+
+#if kPocoVector && (kPocoPixelFormat != kCommodettoBitmapRGB565LE) && (kPocoPixelFormat != kCommodettoBitmapGray256)
+	#undef kPocoVector
+	#define kPocoVector 0
+#endif
+
+#if kPocoVector
+	typedef uint16_t PocoVector __attribute__((vector_size(16)));		// one pixel per lane
+#if kPocoPixelFormat == kCommodettoBitmapGray256
+	typedef uint8_t PocoVectorPixels __attribute__((vector_size(8)));
+#endif
+
+	static PocoVector loadVector(const PocoPixel *pixels);
+	static void storeVector(PocoPixel *pixels, PocoVector v);
+	static PocoVector alphaVector(uint32_t bits);
+	static PocoVector blendVector(PocoVector src, PocoVector dst, PocoVector blend);
+#endif
+
 static const PocoRenderCommandProc gDrawRenderCommand[kPocoCommandDrawMax] ICACHE_RODATA_ATTR = {
 	doFillRectangle,
 	doBlendRectangle,
@@ -97,7 +177,10 @@ static const PocoRenderCommandProc gDrawRenderCommand[kPocoCommandDrawMax] ICACH
 	doDrawGray16RLEBlendBitmapPart,
 	doDrawMaskedBitmap,
 	doDrawPattern,
-	doDrawFrame
+	doDrawScaledBitmap,
+	doDrawTextRun,
+	doDrawFrame,
+	doDrawExternal
 };
 
 #if !kPocoFrameBuffer
@@ -255,7 +338,7 @@ typedef struct RenderBitsRecord {
 #else
 	uint16_t	rowBytes;
 	void		*pixels;
-	PocoCopy4	doCopy;
+	uint8_t		sxphase;		// the copy is chosen when rendering, once xphase is relative to the update area
 	#if kPocoPixelFormat == kCommodettoBitmapCLUT16
 		uint8_t	remap[16];		//@@ HUGE... need a cache of these
 	#endif
@@ -342,11 +425,69 @@ typedef struct PatternBitsRecord {
 	uint16_t	patternW;
 	uint16_t	patternH;
 
+#if 4 == kPocoPixelSize
+	uint16_t	sx;				// pixels is the start of a row, so the copy is chosen by the source column
+#endif
 #if kPocoPixelFormat == kCommodettoBitmapCLUT16
 	uint8_t	remap[16];		//@@ HUGE... need a cache of these
 #endif
 } PatternBitsRecord, *PatternBits;
 
+/*
+	source pixels are addressed by index, row * rowPixels + column, with 4-bit rows rounded up to a whole byte.
+	each destination row walks one axis of the source (the column axis) while the other (the row axis) stays fixed.
+	positions are 16.16 fixed point at pixel centers, rounded down so they never leave the source rectangle.
+	a clipped draw starts where stepping from its unclipped first pixel arrives, so pixels do not depend on the clip.
+*/
+
+typedef struct ScaledBitsRecord {
+	PocoCommandFields;
+
+	const void	*pixels;
+	int32_t		origin;			// index of the source pixel where both axes start
+	int32_t		rowStride;		// index step for one pixel on the row axis
+	int32_t		colStride;		// index step for one pixel on the column axis
+	int32_t		row;			// position on the row axis of the next row
+	int32_t		rowStep;
+	int32_t		colStart;		// position on the column axis of the first pixel of each row
+	int32_t		colStep;
+	uint16_t	rowCount;		// source pixels on each axis, to clamp bilinear neighbors
+	uint16_t	colCount;
+	uint8_t		mode;
+
+#if kPocoPixelFormat == kCommodettoBitmapCLUT16
+	uint8_t	remap[16];		//@@ HUGE... need a cache of these
+#endif
+} ScaledBitsRecord, *ScaledBits;
+
+/*
+	a run of unclipped gray glyphs drawn with the same color, recorded as one command.
+	each glyph keeps the per row state of the gray or compressed gray command that draws it.
+*/
+
+typedef struct TextRunGlyphRecord {
+	const void	*pixels;
+	int16_t		dx;				// from left of run
+	int16_t		dy;				// from top of run
+	uint8_t		w;
+	uint8_t		h;
+	uint8_t		state;			// mask for gray glyphs, nybbleCount for compressed glyphs
+} TextRunGlyphRecord, *TextRunGlyph;
+
+typedef struct TextRunRecord {
+	PocoCommandFields;
+
+	PocoColor			color;
+	uint16_t			rowBump;		// gray glyphs only
+	PocoCoordinate		row;			// rows drawn
+	uint8_t				glyphCommand;
+	uint8_t				blendersOffset;
+	uint8_t				count;
+	TextRunGlyphRecord	glyph[1];
+} TextRunRecord, *TextRun;
+
+#define kPocoTextRunGlyphs ((252 - offsetof(TextRunRecord, glyph)) / sizeof(TextRunGlyphRecord))
+
 typedef struct FrameRecord {
 	PocoCommandFields;
 
@@ -361,6 +502,15 @@ typedef struct FrameRecord {
 	uint8_t			unclippedBlockWidth;
 } FrameRecord, *Frame;
 
+typedef struct ExternalRecord {
+	PocoCommandFields;
+
+	PocoDimension		sx;			// columns clipped from the left
+	PocoDimension		sy;			// next row to render, from the top of the unclipped area
+	PocoRenderExternal	doDrawExternal;
+	uint8_t				data[1];
+} ExternalRecord, *External;
+
 void PocoRectangleFill(Poco poco, PocoColor color, uint8_t blend, PocoCoordinate x, PocoCoordinate y, PocoDimension w, PocoDimension h)
 {
 	PocoCommand pc = poco->next;
@@ -472,7 +622,7 @@ void PocoBitmapDraw(Poco poco, PocoBitmap bits, PocoCoordinate x, PocoCoordinate
 	int16_t d;
 	PocoCommand pc = poco->next;
 
-	PocoReturnIfNoSpace(pc, sizeof(RenderMonochromeBitsRecord));
+	PocoReturnIfNoSpace(pc, (sizeof(RenderBitsRecord) > sizeof(RenderMonochromeBitsRecord)) ? sizeof(RenderBitsRecord) : sizeof(RenderMonochromeBitsRecord));		// RenderBits holds the remap of CLUT16
 
 	rotateCoordinates(poco->width, poco->height, x, y, sw, sh);
 #if (0 == kPocoRotation) || (180 == kPocoRotation)
@@ -522,9 +672,9 @@ void PocoBitmapDraw(Poco poco, PocoBitmap bits, PocoCoordinate x, PocoCoordinate
 		((RenderBits)pc)->pixels = (void *)(pixels + (sy * bits->width) + sx);
 		((RenderBits)pc)->rowPixels = bits->width;
 #else
-		((RenderBits)pc)->pixels = (void *)(pixels + ((sy * (bits->width + 1)) >> 1) + (sx >> 1));
+		((RenderBits)pc)->pixels = (void *)(pixels + (sy * ((bits->width + 1) >> 1)) + (sx >> 1));
 		((RenderBits)pc)->rowBytes = (bits->width + 1) >> 1;
-		((RenderBits)pc)->doCopy = getMemCpy4(sx, x - poco->x);
+		((RenderBits)pc)->sxphase = sx & 1;
 #if kPocoPixelFormat == kCommodettoBitmapCLUT16
 		buildColorMap((uint32_t *)((uint8_t *)bits->pixels) - 16, poco->clut + 32, ((RenderBits)pc)->remap);
 #endif
@@ -564,6 +714,9 @@ void PocoMonochromeBitmapDraw(Poco poco, PocoBitmap bits, PocoMonochromeMode mod
 	if (kCommodettoBitmapMonochrome != bits->format)
 		return;
 
+	PocoReturnIfNoSpace(pc, sizeof(RenderMonochromeBitsRecord));
+	pc->command = kPocoCommandDrawMax;		// PocoBitmapDraw leaves a stale command here when the bitmap is clipped out
+
 	PocoBitmapDraw(poco, bits, x, y, sx, sy, sw, sh);
 
 	if (kPocoCommandMonochromeBitmapDraw != pc->command)
@@ -724,6 +877,151 @@ void PocoGrayBitmapDraw(Poco poco, PocoBitmap bits, PocoColor color, uint8_t ble
 	PocoCommandBuilt(poco, pc);
 }
 
+/*
+	draws like PocoGrayBitmapDraw. a glyph that is not clipped is added to the text run that is the last command. otherwise it
+	is drawn as a gray command, which becomes a run when the next glyph matches it, so single glyphs take no more space.
+*/
+
+void PocoGrayGlyphDraw(Poco poco, PocoBitmap bits, PocoColor color, uint8_t blend, PocoCoordinate x, PocoCoordinate y, PocoDimension sx, PocoDimension sy, PocoDimension sw, PocoDimension sh)
+{
+	PocoCoordinate gx = x, gy = y;
+	PocoDimension gsx = sx, gsy = sy, gsw = sw, gsh = sh;
+	TextRun tr = (TextRun)poco->textRun;
+	TextRunGlyph glyph;
+	PocoCommand pc;
+	const void *pixels;
+	uint16_t rowBump = 0;
+	uint8_t glyphCommand, state;
+
+	if ((kCommodettoBitmapGray16 != (bits->format & ~kCommodettoBitmapPacked)) || !blend)
+		goto draw;
+
+#if kPocoFrameBuffer
+	if (poco->frameBuffer)
+		goto draw;
+#endif
+
+	rotateCoordinates(poco->width, poco->height, gx, gy, gsw, gsh);
+#if (0 == kPocoRotation) || (180 == kPocoRotation)
+	rotateCoordinatesAndDimensions(bits->width, bits->height, gsx, gsy, gsw, gsh);
+#elif (90 == kPocoRotation) || (270 == kPocoRotation)
+	rotateCoordinatesAndDimensions(bits->height, bits->width, gsx, gsy, gsw, gsh);
+#endif
+
+	if ((gx < poco->x) || (gy < poco->y) || ((gx + gsw) > poco->xMax) || ((gy + gsh) > poco->yMax) || !gsw || !gsh || (gsw > 255) || (gsh > 255))
+		goto draw;
+	if (((gsx + gsw) > bits->width) || ((gsy + gsh) > bits->height))
+		return;
+
+	if (!(bits->format & kCommodettoBitmapPacked)) {
+		pixels = ((uint8_t *)bits->pixels) + ((bits->width >> 1) * gsy) + (gsx >> 1);
+		rowBump = bits->width >> 1;
+		state = (gsx & 1) ? 0 : 4;
+		glyphCommand = kPocoCommandGray16BitmapDraw;
+	}
+	else {
+		if (gsx || gsy || (gsw != bits->width))
+			goto draw;
+		state = (4 - (3 & (uintptr_t)bits->pixels)) << 1;
+		pixels = 1 + (uint32_t *)(~3 & (uintptr_t)bits->pixels);
+		glyphCommand = (kPocoOpaque == blend) ? kPocoCommandGray16RLEBitmapDraw : kPocoCommandGray16RLEBlendBitmapDraw;
+	}
+
+	if (tr && (((char *)tr + tr->length) != (char *)poco->next))
+		tr = NULL;
+
+	if (tr && (kPocoCommandTextRun != tr->command)) {
+		TextRunGlyphRecord first;
+		PocoColor firstColor;
+		uint16_t firstRowBump = 0;
+		uint8_t firstBlendersOffset = 0xF0;
+
+		pc = (PocoCommand)tr;
+		if (pc->command != glyphCommand)
+			goto start;
+
+		if (kPocoCommandGray16BitmapDraw == glyphCommand) {
+			RenderGray16Bits srcBits = (RenderGray16Bits)pc;
+			first.pixels = srcBits->pixels;
+			first.state = srcBits->mask;
+			firstColor = srcBits->color;
+			firstRowBump = srcBits->rowBump;
+		}
+		else {
+			RenderGray16RLEBits srcBits = (RenderGray16RLEBits)pc;
+			first.pixels = srcBits->pixels;
+			first.state = srcBits->nybbleCount;
+			firstColor = srcBits->color;
+			if (kPocoCommandGray16RLEBlendBitmapDraw == glyphCommand)
+				firstBlendersOffset = srcBits->blendersOffset;
+		}
+		if ((firstColor != color) || (firstRowBump != rowBump) || (firstBlendersOffset != (blend & 0xF0)))
+			goto start;
+
+		PocoReturnIfNoSpace(pc, offsetof(TextRunRecord, glyph) + (2 * sizeof(TextRunGlyphRecord)));
+
+		first.dx = 0;
+		first.dy = 0;
+		first.w = (uint8_t)pc->w;
+		first.h = (uint8_t)pc->h;
+
+		tr->command = kPocoCommandTextRun;
+		tr->color = color;
+		tr->rowBump = rowBump;
+		tr->row = 0;
+		tr->glyphCommand = glyphCommand;
+		tr->blendersOffset = blend & 0xF0;		// (blend >> 4) << 4
+		tr->count = 1;
+		tr->glyph[0] = first;
+		PocoCommandSetLength(tr, offsetof(TextRunRecord, glyph) + sizeof(TextRunGlyphRecord));
+		poco->next = (PocoCommand)(tr->length + (char *)tr);
+	}
+
+	if (tr && (tr->count < kPocoTextRunGlyphs) &&
+		(tr->glyphCommand == glyphCommand) && (tr->color == color) && (tr->rowBump == rowBump) && (tr->blendersOffset == (blend & 0xF0))) {
+		PocoCoordinate xMin = (gx < tr->x) ? gx : tr->x, yMin = (gy < tr->y) ? gy : tr->y;
+		PocoCoordinate xMax = tr->x + tr->w, yMax = tr->y + tr->h;
+		int i;
+
+		PocoReturnIfNoSpace(poco->next, sizeof(TextRunGlyphRecord));
+
+		if ((xMin != tr->x) || (yMin != tr->y)) {
+			for (i = 0, glyph = tr->glyph; i < tr->count; i++, glyph++) {
+				glyph->dx += tr->x - xMin;
+				glyph->dy += tr->y - yMin;
+			}
+		}
+		if ((gx + gsw) > xMax)
+			xMax = gx + gsw;
+		if ((gy + gsh) > yMax)
+			yMax = gy + gsh;
+		tr->x = xMin, tr->y = yMin, tr->w = xMax - xMin, tr->h = yMax - yMin;
+	}
+	else
+		goto start;
+
+	glyph = &tr->glyph[tr->count++];
+	glyph->pixels = pixels;
+	glyph->dx = gx - tr->x;
+	glyph->dy = gy - tr->y;
+	glyph->w = (uint8_t)gsw;
+	glyph->h = (uint8_t)gsh;
+	glyph->state = state;
+
+	PocoCommandSetLength(tr, offsetof(TextRunRecord, glyph) + (tr->count * sizeof(TextRunGlyphRecord)));
+	poco->next = (PocoCommand)(tr->length + (char *)tr);
+	return;
+
+start:
+	pc = poco->next;
+	PocoGrayBitmapDraw(poco, bits, color, blend, x, y, sx, sy, sw, sh);
+	poco->textRun = (pc != poco->next) ? pc : NULL;
+	return;
+
+draw:
+	PocoGrayBitmapDraw(poco, bits, color, blend, x, y, sx, sy, sw, sh);
+}
+
 void PocoBitmapDrawMasked(Poco poco, uint8_t blend, PocoBitmap bits, PocoCoordinate x, PocoCoordinate y, PocoDimension sx, PocoDimension sy, PocoDimension sw, PocoDimension sh,
 			PocoBitmap mask, PocoDimension mask_sx, PocoDimension mask_sy)
 {
@@ -863,9 +1161,10 @@ void PocoBitmapPattern(Poco poco, PocoBitmap bits, PocoCoordinate x, PocoCoordin
 	pb->pixels = pb->patternStart + (pb->dy * bits->width);
 	pb->rowBump = bits->width + pb->xOffset;
 #else
-	pb->patternStart = ((PocoPixel *)bits->pixels) + (((sy * bits->width) + (sx + pb->xOffset)) >> 1);
-	pb->pixels = pb->patternStart + ((pb->dy * bits->width) >> 1);
-	pb->rowBump = (bits->width + pb->xOffset) >> 1;
+	pb->patternStart = ((PocoPixel *)bits->pixels) + (sy * ((bits->width + 1) >> 1));
+	pb->pixels = pb->patternStart + (pb->dy * ((bits->width + 1) >> 1));
+	pb->rowBump = (bits->width + 1) >> 1;
+	pb->sx = sx;
 
 #if kPocoPixelFormat == kCommodettoBitmapCLUT16
 	buildColorMap((uint32_t *)((uint8_t *)bits->pixels) - 16, poco->clut + 32, pb->remap);
@@ -875,6 +1174,105 @@ void PocoBitmapPattern(Poco poco, PocoBitmap bits, PocoCoordinate x, PocoCoordin
 	PocoCommandBuilt(poco, pc);
 }
 
+void PocoBitmapDrawScaled(Poco poco, PocoBitmap bits, PocoScaleMode mode, PocoCoordinate x, PocoCoordinate y, PocoDimension w, PocoDimension h, PocoDimension sx, PocoDimension sy, PocoDimension sw, PocoDimension sh)
+{
+	bitmapDrawTransformed(poco, bits, mode, 0, x, y, w, h, sx, sy, sw, sh);
+}
+
+void PocoBitmapDrawRotated(Poco poco, PocoBitmap bits, uint16_t rotation, PocoCoordinate x, PocoCoordinate y, PocoDimension sx, PocoDimension sy, PocoDimension sw, PocoDimension sh)
+{
+	if ((90 == rotation) || (270 == rotation))
+		bitmapDrawTransformed(poco, bits, kPocoScaleNearest, rotation, x, y, sh, sw, sx, sy, sw, sh);
+	else if ((0 == rotation) || (180 == rotation))
+		bitmapDrawTransformed(poco, bits, kPocoScaleNearest, rotation, x, y, sw, sh, sx, sy, sw, sh);
+}
+
+/*
+	the source rectangle is turned clockwise by rotation and stretched to fill the destination rectangle.
+	rotations commute, so after both rectangles are rotated to the display the same rotation applies.
+*/
+
+void bitmapDrawTransformed(Poco poco, PocoBitmap bits, PocoScaleMode mode, uint16_t rotation, PocoCoordinate x, PocoCoordinate y, PocoDimension w, PocoDimension h, PocoDimension sx, PocoDimension sy, PocoDimension sw, PocoDimension sh)
+{
+	PocoCommand pc = poco->next;
+	ScaledBits sb = (ScaledBits)pc;
+	PocoCoordinate xMax, yMax, dx = 0, dy = 0;
+	int32_t rowPixels, strideX, strideY;
+
+	PocoReturnIfNoSpace(pc, sizeof(ScaledBitsRecord));
+
+	if (kCommodettoBitmapFormat != bits->format)
+		return;
+
+	rotateCoordinatesAndDimensions(poco->width, poco->height, x, y, w, h);
+#if (0 == kPocoRotation) || (180 == kPocoRotation)
+	rotateCoordinatesAndDimensions(bits->width, bits->height, sx, sy, sw, sh);
+#elif (90 == kPocoRotation) || (270 == kPocoRotation)
+	rotateCoordinatesAndDimensions(bits->height, bits->width, sx, sy, sw, sh);
+#endif
+
+	if (!w || !h || !sw || !sh || ((sx + sw) > bits->width) || ((sy + sh) > bits->height))
+		return;
+
+	xMax = x + w;
+	yMax = y + h;
+
+	if (x < poco->x) {
+		dx = poco->x - x;
+		x = poco->x;
+	}
+
+	if (y < poco->y) {
+		dy = poco->y - y;
+		y = poco->y;
+	}
+
+	if (xMax > poco->xMax)
+		xMax = poco->xMax;
+
+	if (yMax > poco->yMax)
+		yMax = poco->yMax;
+
+	if ((x >= xMax) || (y >= yMax))
+		return;
+
+	pc->command = kPocoCommandBitmapDrawScaled;
+	PocoCommandSetLength(pc, sizeof(ScaledBitsRecord));
+	pc->x = x, pc->y = y, pc->w = xMax - x, pc->h = yMax - y;
+
+#if 4 != kPocoPixelSize
+	rowPixels = bits->width;
+#else
+	rowPixels = (bits->width + 1) & ~1;
+#endif
+	strideX = ((180 == rotation) || (270 == rotation)) ? -1 : 1;
+	strideY = ((90 == rotation) || (180 == rotation)) ? -rowPixels : rowPixels;
+
+	sb->pixels = bits->pixels;
+	sb->origin = (((strideY < 0) ? (sy + sh - 1) : sy) * rowPixels) + ((strideX < 0) ? (sx + sw - 1) : sx);
+	if ((90 == rotation) || (270 == rotation)) {
+		sb->colStride = strideY, sb->colCount = sh;
+		sb->rowStride = strideX, sb->rowCount = sw;
+	}
+	else {
+		sb->colStride = strideX, sb->colCount = sw;
+		sb->rowStride = strideY, sb->rowCount = sh;
+	}
+	sb->colStep = ((uint32_t)sb->colCount << 16) / w;
+	sb->colStart = (((uint32_t)sb->colCount << 16) / (w << 1)) + (dx * sb->colStep);
+	sb->rowStep = ((uint32_t)sb->rowCount << 16) / h;
+	sb->row = (((uint32_t)sb->rowCount << 16) / (h << 1)) + (dy * sb->rowStep);
+
+#if kPocoPixelFormat != kCommodettoBitmapCLUT16
+	sb->mode = mode;
+#else
+	sb->mode = kPocoScaleNearest;		// indices do not interpolate
+	buildColorMap((uint32_t *)((uint8_t *)bits->pixels) - 16, poco->clut + 32, sb->remap);
+#endif
+
+	PocoCommandBuilt(poco, pc);
+}
+
 void PocoDrawFrame(Poco poco, uint8_t *data, uint32_t dataSize, PocoCoordinate x, PocoCoordinate y, PocoDimension w, PocoDimension h)
 {
 	PocoCommand pc = poco->next;
@@ -935,12 +1333,74 @@ void PocoDrawFrame(Poco poco, uint8_t *data, uint32_t dataSize, PocoCoordinate x
 	PocoCommandBuilt(poco, pc);
 }
 
+/*
+	the external renderer draws the rows of its area that fall in each slab, in order from the top.
+	data is copied into the display list and passed back to the renderer.
+*/
+
+void PocoDrawExternal(Poco poco, PocoRenderExternal doDrawExternal, uint8_t *data, uint8_t dataSize, PocoCoordinate x, PocoCoordinate y, PocoDimension w, PocoDimension h)
+{
+	PocoCommand pc = poco->next;
+	External e = (External)pc;
+	PocoCoordinate xMax, yMax;
+
+	PocoReturnIfNoSpace(pc, offsetof(ExternalRecord, data) + dataSize);
+
+	rotateCoordinatesAndDimensions(poco->width, poco->height, x, y, w, h);
+
+	xMax = x + w;
+	yMax = y + h;
+
+	e->sx = 0;
+	if (x < poco->x) {
+		e->sx = poco->x - x;
+		x = poco->x;
+	}
+
+	if (xMax > poco->xMax)
+		xMax = poco->xMax;
+
+	if (x >= xMax)
+		return;
+
+	e->sy = 0;
+	if (y < poco->y) {
+		e->sy = poco->y - y;
+		y = poco->y;
+	}
+
+	if (yMax > poco->yMax)
+		yMax = poco->yMax;
+
+	if (y >= yMax)
+		return;
+
+	pc->command = kPocoCommandExternal;
+	PocoCommandSetLength(pc, offsetof(ExternalRecord, data) + dataSize);
+	pc->x = x, pc->y = y, pc->w = xMax - x, pc->h = yMax - y;
+	e->doDrawExternal = doDrawExternal;
+	c_memcpy(e->data, data, dataSize);
+
+	poco->flags |= kPocoFlagExternal;
+
+	PocoCommandBuilt(poco, pc);
+}
+
 /*
 	BMFont support
 */
 
 static int nextFromUTF8(uint8_t **src);
 
+/*
+	direct mapped cache of glyphs found by binary search, indexed by character code and font.
+	an entry is used only if it is a glyph of the font being searched, so entries of released fonts are harmless.
+*/
+
+#if kPocoGlyphCache
+	static const uint8_t *gGlyphCache[kPocoGlyphCache];
+#endif
+
 int nextFromUTF8(uint8_t **src)
 {
 	int result;
@@ -974,6 +1434,9 @@ int nextFromUTF8(uint8_t **src)
 const uint8_t *PocoBMFGlyphFromUTF8(uint8_t **src, const uint8_t *chars, int charCount)
 {
 	int min, max;
+#if kPocoGlyphCache
+	const uint8_t **slot;
+#endif
 	int c = nextFromUTF8(src);
 	if (!c)
 		return NULL;
@@ -992,8 +1455,14 @@ const uint8_t *PocoBMFGlyphFromUTF8(uint8_t **src, const uint8_t *chars, int cha
 	}
 
 	// ascending order, with gaps. binary search.
+#if kPocoGlyphCache
+	slot = &gGlyphCache[(c ^ ((uintptr_t)chars >> 2)) & (kPocoGlyphCache - 1)];
+	if ((*slot >= chars) && (*slot < (chars + (20 * charCount))) && !((*slot - chars) % 20) && (c_read32(*slot) == c))
+		return *slot;
+#endif
+
 	min = 0;
-	max = charCount;
+	max = charCount - 1;
 	do {
 		int mid = (min + max) >> 1;
 		const uint8_t *cc = (20 * mid) + chars;
@@ -1002,8 +1471,12 @@ const uint8_t *PocoBMFGlyphFromUTF8(uint8_t **src, const uint8_t *chars, int cha
 			min = mid + 1;
 		else if (c < code)
 			max = mid - 1;
-		else
+		else {
+#if kPocoGlyphCache
+			*slot = cc;
+#endif
 			return cc;
+		}
 	} while (min <= max);
 
 	return NULL;
@@ -1013,6 +1486,62 @@ const uint8_t *PocoBMFGlyphFromUTF8(uint8_t **src, const uint8_t *chars, int cha
 	here begin the functions to render the drawing list
 */
 
+#if kPocoVector
+
+PocoVector loadVector(const PocoPixel *pixels)
+{
+#if kPocoPixelFormat == kCommodettoBitmapRGB565LE
+	PocoVector v;
+	c_memcpy(&v, pixels, sizeof(v));
+	return v;
+#else
+	PocoVectorPixels v;
+	c_memcpy(&v, pixels, sizeof(v));
+	return __builtin_convertvector(v, PocoVector);
+#endif
+}
+
+void storeVector(PocoPixel *pixels, PocoVector v)
+{
+#if kPocoPixelFormat == kCommodettoBitmapRGB565LE
+	c_memcpy(pixels, &v, sizeof(v));
+#else
+	PocoVectorPixels p = __builtin_convertvector(v, PocoVectorPixels);
+	c_memcpy(pixels, &p, sizeof(p));
+#endif
+}
+
+// 8 4-bit values, first pixel in the high nybble
+PocoVector alphaVector(uint32_t bits)
+{
+	uint16_t hi = (uint16_t)(bits >> 16), lo = (uint16_t)bits;
+	PocoVector v = {hi, hi, hi, hi, lo, lo, lo, lo};
+	PocoVector shift = {1, 16, 256, 4096, 1, 16, 256, 4096};
+
+	return (v * shift) >> 12;
+}
+
+// 5-bit blend. same arithmetic as the scalar blenders, one color component at a time
+PocoVector blendVector(PocoVector src, PocoVector dst, PocoVector blend)
+{
+	PocoVector inverse = 31 - blend;
+#if kPocoPixelFormat == kCommodettoBitmapRGB565LE
+	PocoVector r = ((src >> 11) * blend) + ((dst >> 11) * inverse) + 16;
+	PocoVector g = (((src >> 5) & 0x3F) * blend) + (((dst >> 5) & 0x3F) * inverse) + 16;
+	PocoVector b = ((src & 0x1F) * blend) + ((dst & 0x1F) * inverse) + 16;
+
+	r += (r >> 5) & 0x1F;
+	g += (g >> 5) & 0x1F;
+	b += (b >> 5) & 0x1F;
+
+	return ((r >> 5) << 11) | ((g >> 5) << 5) | (b >> 5);
+#else
+	return ((dst * inverse) + (src * blend)) >> 5;
+#endif
+}
+
+#endif
+
 void doFillRectangle(Poco poco, PocoCommand pc, PocoPixel *dst, PocoDimension h)
 {
 	PocoCoordinate w = pc->w;
@@ -1164,6 +1693,11 @@ void doBlendRectangle(Poco poco, PocoCommand pc, PocoPixel *d, PocoDimension h)
 	uint8_t blend = bd->blend;		// 5 bit blend level
 	int src32;
 
+#if kPocoVector
+	PocoVector colors = {bd->color, bd->color, bd->color, bd->color, bd->color, bd->color, bd->color, bd->color};
+	PocoVector blends = {blend, blend, blend, blend, blend, blend, blend, blend};
+#endif
+
 	src32 = bd->color;
 	src32 |= src32 << 16;
 	src32 &= 0x07E0F81F;
@@ -1171,6 +1705,11 @@ void doBlendRectangle(Poco poco, PocoCommand pc, PocoPixel *d, PocoDimension h)
 	while (h--) {
 		PocoCoordinate tw = w;
 
+#if kPocoVector
+		for (; tw >= 8; tw -= 8, d += 8)
+			storeVector(d, blendVector(colors, loadVector(d), blends));
+#endif
+
 		while (tw--) {
 			int	dst, src;
 
@@ -1197,11 +1736,20 @@ void doBlendRectangle(Poco poco, PocoCommand pc, PocoPixel *dst, PocoDimension h
 	PocoCoordinate w = bd->w;
 	PocoCoordinate rowBump = (poco->rowBytes >> (sizeof(PocoPixel) - 1)) - w;
 	uint16_t srcColor = bd->color * blend;		//@@ move to set-up
+#if kPocoVector
+	PocoVector colors = {bd->color, bd->color, bd->color, bd->color, bd->color, bd->color, bd->color, bd->color};
+	PocoVector blends = {blend, blend, blend, blend, blend, blend, blend, blend};
+#endif
 	blend = (31 - blend);		//@@ move to set-up
 
 	while (h--) {
 		PocoCoordinate tw = w;
 
+#if kPocoVector
+		for (; tw >= 8; tw -= 8, dst += 8)
+			storeVector(dst, blendVector(colors, loadVector(dst), blends));
+#endif
+
 		while (tw--) {
 			uint16_t d = *dst;
 			*dst++ = ((d * blend) + srcColor) >> 5;
@@ -1214,7 +1762,7 @@ void doBlendRectangle(Poco poco, PocoCommand pc, PocoPixel *dst, PocoDimension h
 {
 	BlendDraw bd = (BlendDraw)pc;
 	PocoCoordinate w = bd->w;
-	PocoCoordinate rowBump = poco->rowBytes - ((bd->w + 1 + bd->xphase) >> 1);
+	PocoCoordinate rowBump = poco->rowBytes - ((bd->w + bd->xphase) >> 1);		// dst only advances past completed bytes
 	uint8_t blend = bd->blend;		// 5 bit blend level
 	uint16_t srcColor = bd->color * blend;		//@@ move to set-up
 	blend = (31 - blend);		//@@ move to set-up
@@ -1283,40 +1831,37 @@ void doBlendRectangle(Poco poco, PocoCommand pc, PocoPixel *dst, PocoDimension h
 	uint16_t *clut = (uint16_t *)poco->clut;
 	uint8_t *map = 32 + (uint8_t *)poco->clut;
 	uint8_t blend = 15 - (bd->blend >> 1);		// 4 bit blend level
-	PocoCoordinate rowBump = poco->rowBytes - ((bd->w + 1 + bd->xphase) >> 1);
+	PocoCoordinate rowBump = poco->rowBytes - ((bd->w + bd->xphase) >> 1);		// dst only advances past completed bytes
+	int8_t blended[16];		// result for each destination color index, computed on first use
 	src32 = c_read16(clut + bd->color);
 	src32 |= src32 << 16;
 	src32 &= 0x00F00F0F;
 
+	c_memset(blended, -1, sizeof(blended));
+
 	while (h--) {
 		PocoCoordinate tw = bd->w;
 		uint8_t xphase = bd->xphase;
 
 		while (tw--) {
-			uint8_t dstTwo = *dst;
+			uint8_t dstTwo = *dst, index;
 			if (xphase) {
 #if kPocoCLUT16_01
-				int ds = c_read16(clut + (dstTwo & 0x0F));
+				index = dstTwo & 0x0F;
 #else
-				int ds = c_read16(clut + (dstTwo >> 4));
+				index = dstTwo >> 4;
 #endif
-				ds |= ds << 16;
-				ds &= 0x00F00F0F;
-				ds = blend * (src32 - ds) + (ds << 4) - ds;
-				ds += (ds >> 4) & 0x00F00F0F;
-				ds >>= 4;
-				ds &= 0x00F00F0F;
-				ds |= ds >> 16;
-
-				*dst++ = (dstTwo & kPocoPixels4FirstMask) | (c_read8(map + (uint16_t)ds) << kPocoPixels4SecondShift);
-				xphase = 0;
 			}
 			else {
 #if kPocoCLUT16_01
-				int ds = c_read16(clut + (dstTwo >> 4));
+				index = dstTwo >> 4;
 #else
-				int ds = c_read16(clut + (dstTwo & 0x0F));
+				index = dstTwo & 0x0F;
 #endif
+			}
+
+			if (blended[index] < 0) {
+				int ds = c_read16(clut + index);
 				ds |= ds << 16;
 				ds &= 0x00F00F0F;
 				ds = blend * (src32 - ds) + (ds << 4) - ds;
@@ -1324,8 +1869,15 @@ void doBlendRectangle(Poco poco, PocoCommand pc, PocoPixel *dst, PocoDimension h
 				ds >>= 4;
 				ds &= 0x00F00F0F;
 				ds |= ds >> 16;
+				blended[index] = c_read8(map + (uint16_t)ds);
+			}
 
-				*dst = (dstTwo & kPocoPixels4SecondMask) | (c_read8(map + (uint16_t)ds) << kPocoPixels4FirstShift);
+			if (xphase) {
+				*dst++ = (dstTwo & kPocoPixels4FirstMask) | (blended[index] << kPocoPixels4SecondShift);
+				xphase = 0;
+			}
+			else {
+				*dst = (dstTwo & kPocoPixels4SecondMask) | (blended[index] << kPocoPixels4FirstShift);
 				xphase = 1;
 			}
 		}
@@ -1383,12 +1935,13 @@ void doDrawBitmap(Poco poco, PocoCommand pc, PocoPixel *dst, PocoDimension h)
 	PocoPixel *src = srcBits->pixels;
 	PocoCoordinate srcRowBytes = srcBits->rowBytes;
 	int dstRowBytes = poco->rowBytes;
+	PocoCopy4 doCopy = getMemCpy4(srcBits->sxphase, srcBits->xphase);
 
 	while (h--) {
 #if kPocoPixelFormat == kCommodettoBitmapGray16
-		(srcBits->doCopy)(dst, src, srcBits->w);
+		(doCopy)(dst, src, srcBits->w);
 #else
-		(srcBits->doCopy)(dst, src, srcBits->w, srcBits->remap);
+		(doCopy)(dst, src, srcBits->w, srcBits->remap);
 #endif
 		dst = (PocoPixel *)(dstRowBytes  + (char *)dst);
 		src += srcRowBytes;
@@ -1549,6 +2102,9 @@ void doDrawGray16BitmapPart(Poco poco, PocoCommand pc, PocoPixel *d, PocoDimensi
 	uint8_t *map = 32 + (uint8_t *)poco->clut;
 	color = c_read8(map + color);		// color index
 #endif
+#if kPocoVector
+	PocoVector colors = {color, color, color, color, color, color, color, color};
+#endif
 
 	while (h--) {
 #if 4 == kPocoPixelSize
@@ -1571,6 +2127,25 @@ void doDrawGray16BitmapPart(Poco poco, PocoCommand pc, PocoPixel *d, PocoDimensi
 				tm = 32 - 4;
 				bits = ~READ_PROG_MEM_UNSIGNED_LONG(srcLong++);
 				bits = SwapLong(bits);
+#if kPocoVector
+				if (tw >= 7) {		// this pixel and the next 7 use all of bits
+					if (bits) {
+						PocoVector alpha = alphaVector(bits), dst = loadVector(d), result;
+						PocoVector opaque = (PocoVector)(alpha == 15), clear = (PocoVector)(alpha == 0);
+#if kPocoPixelFormat == kCommodettoBitmapRGB565LE
+						result = blendVector(colors, dst, (alpha << 1) | (alpha >> 3));
+#else
+						result = ((dst * (15 - alpha)) + (colors * alpha)) >> 4;
+#endif
+						result = (result & ~opaque) | (colors & opaque);
+						storeVector(d, (result & ~clear) | (dst & clear));
+					}
+					d += 8;
+					tw -= 7;
+					tm = -4;
+					continue;
+				}
+#endif
 			}
 
 			blend = (bits >> tm) & 0x0f;
@@ -2302,6 +2877,25 @@ void doDrawMaskedBitmap(Poco poco, PocoCommand pc, PocoPixel *d, PocoDimension h
 				tm = 32 - 4;
 				bits = READ_PROG_MEM_UNSIGNED_LONG(maskBitsLong++);
 				bits = SwapLong(bits);
+#if kPocoVector
+				if (tw >= 7) {		// this pixel and the next 7 use all of bits
+					if (0xFFFFFFFF != bits) {
+						PocoVector alpha = alphaVector(bits), dst = loadVector(d), source = loadVector(src), result;
+						PocoVector blends = {blender[bits >> 28], blender[(bits >> 24) & 15], blender[(bits >> 20) & 15], blender[(bits >> 16) & 15],
+											blender[(bits >> 12) & 15], blender[(bits >> 8) & 15], blender[(bits >> 4) & 15], blender[bits & 15]};
+						PocoVector opaque = (PocoVector)(blends == 31), clear = (PocoVector)(alpha == 15);
+
+						result = blendVector(source, dst, blends);
+						result = (result & ~opaque) | (source & opaque);
+						storeVector(d, (result & ~clear) | (dst & clear));
+					}
+					src += 8;
+					d += 8;
+					tw -= 7;
+					tm = -4;
+					continue;
+				}
+#endif
 			}
 
 			blend = (bits >> tm) & 0x0f;		// 4-bit alpha
@@ -2600,46 +3194,23 @@ void doDrawPattern(Poco poco, PocoCommand pc, PocoPixel *dst, PocoDimension h)
 	while (h--) {
 		PocoCoordinate w = pb->w;
 		PocoPixel *d = dst;
-		PocoCoordinate use;
 		PocoCoordinate dx = pb->xphase;
-		PocoCoordinate sx = pb->xOffset;
+		PocoCoordinate sx = pb->sx + pb->xOffset;
+		PocoCoordinate use = pb->patternW - pb->xOffset;
 
-		if (sx) {
-			use = pb->patternW - sx;
+		while (w) {
 			if (use > w) use = w;
 
 #if kPocoPixelFormat == kCommodettoBitmapGray16
-			(getMemCpy4(sx, dx))(d, src, use);
-#else
-			(getMemCpy4(sx, dx))(d, src, use, pb->remap);
-#endif
-			src -= sx >> 1;
-			d += use >> 1;
-
-			w -= use;
-			sx += use, dx += use;
-		}
-
-		use = pb->patternW;
-		while (w >= use) {
-#if kPocoPixelFormat == kCommodettoBitmapGray16
-			(getMemCpy4(sx, dx))(d, src, use);
+			(getMemCpy4(sx, dx))(d, src + (sx >> 1), use);
 #else
-			(getMemCpy4(sx, dx))(d, src, use, pb->remap);
+			(getMemCpy4(sx, dx))(d, src + (sx >> 1), use, pb->remap);
 #endif
-			d += use >> 1;
+			d += (dx + use) >> 1;
+			dx = (dx + use) & 1;
 
 			w -= use;
-			sx += use, dx += use;
-		}
-
-		if (w) {
-#if kPocoPixelFormat == kCommodettoBitmapGray16
-			(getMemCpy4(sx, dx))(d, src, w);
-#else
-			(getMemCpy4(sx, dx))(d, src, w, pb->remap);
-#endif
-			d += w >> 1;
+			sx = pb->sx, use = pb->patternW;
 		}
 
 		src += pb->rowBump;
@@ -2657,6 +3228,195 @@ void doDrawPattern(Poco poco, PocoCommand pc, PocoPixel *dst, PocoDimension h)
 }
 #endif
 
+#if 4 != kPocoPixelSize
+	#define scaledPixel(pixels, index) ((pixels)[index])
+	#define scaledStore(d, xphase, pixel) *(d)++ = (pixel)
+#else
+	#define scaledPixel(pixels, index) (((pixels)[(index) >> 1] >> (((index) & 1) ? kPocoPixels4SecondShift : kPocoPixels4FirstShift)) & 0x0F)
+	#define scaledStore(d, xphase, pixel) \
+		do { \
+			if (xphase) { \
+				*(d) = (*(d) & ~(0x0F << kPocoPixels4SecondShift)) | ((pixel) << kPocoPixels4SecondShift); \
+				(d)++; \
+			} \
+			else \
+				*(d) = (*(d) & ~(0x0F << kPocoPixels4FirstShift)) | ((pixel) << kPocoPixels4FirstShift); \
+			xphase ^= 1; \
+		} while (0)
+#endif
+
+void doDrawScaledBitmap(Poco poco, PocoCommand pc, PocoPixel *dst, PocoDimension h)
+{
+	ScaledBits sb = (ScaledBits)pc;
+#if 4 != kPocoPixelSize
+	const PocoPixel *pixels = sb->pixels;
+#else
+	const uint8_t *pixels = sb->pixels;
+#endif
+	int32_t colStride = sb->colStride, colStep = sb->colStep;
+
+	while (h--) {
+		PocoCoordinate w = sb->w;
+		PocoPixel *d = dst;
+		int32_t col = sb->colStart;
+#if 4 == kPocoPixelSize
+		uint8_t xphase = sb->xphase;
+#endif
+
+		if (kPocoScaleNearest == sb->mode) {
+			int32_t row = sb->origin + ((sb->row >> 16) * sb->rowStride);
+
+			while (w--) {
+				int32_t index = row + ((col >> 16) * colStride);
+#if kPocoPixelFormat != kCommodettoBitmapCLUT16
+				scaledStore(d, xphase, scaledPixel(pixels, index));
+#else
+				scaledStore(d, xphase, sb->remap[scaledPixel(pixels, index)]);
+#endif
+				col += colStep;
+			}
+		}
+#if kPocoPixelFormat != kCommodettoBitmapCLUT16
+		else {
+			// sample the four pixels around each position, repeating the last pixel of an axis at its far edge
+			int32_t row = sb->row - 0x8000, top, bottom;
+			uint8_t fy;
+
+			if (row < 0)
+				row = 0;
+			fy = (uint8_t)(row >> 8);
+			top = sb->origin + ((row >> 16) * sb->rowStride);
+			bottom = (((row >> 16) + 1) < sb->rowCount) ? top + sb->rowStride : top;
+			col -= 0x8000;
+
+			while (w--) {
+				int32_t c = (col < 0) ? 0 : col;
+				int32_t offset = (c >> 16) * colStride;
+				int32_t next = (((c >> 16) + 1) < sb->colCount) ? offset + colStride : offset;
+				PocoPixel pixel = bilinearPixel(scaledPixel(pixels, top + offset), scaledPixel(pixels, top + next),
+											scaledPixel(pixels, bottom + offset), scaledPixel(pixels, bottom + next), (uint8_t)(c >> 8), fy);
+				scaledStore(d, xphase, pixel);
+				col += colStep;
+			}
+		}
+#endif
+
+		sb->row += sb->rowStep;
+		dst = (PocoPixel *)(poco->rowBytes + (char *)dst);
+	}
+}
+
+/*
+	blend four pixels by 8-bit horizontal (fx) and vertical (fy) fractions, at the precision of the format's blend
+*/
+
+#if kPocoPixelFormat == kCommodettoBitmapRGB565LE
+PocoPixel bilinearPixel(PocoPixel p00, PocoPixel p01, PocoPixel p10, PocoPixel p11, uint8_t fx, uint8_t fy)
+{
+	uint32_t a, b, top, bottom;
+
+	fx >>= 3, fy >>= 3;		// 5 bit blend level
+
+	a = (p00 | (p00 << 16)) & 0x07E0F81F;
+	b = (p01 | (p01 << 16)) & 0x07E0F81F;
+	top = ((a * (32 - fx) + b * fx) >> 5) & 0x07E0F81F;
+
+	a = (p10 | (p10 << 16)) & 0x07E0F81F;
+	b = (p11 | (p11 << 16)) & 0x07E0F81F;
+	bottom = ((a * (32 - fx) + b * fx) >> 5) & 0x07E0F81F;
+
+	top = ((top * (32 - fy) + bottom * fy) >> 5) & 0x07E0F81F;
+	return (PocoPixel)(top | (top >> 16));
+}
+#elif kPocoPixelFormat == kCommodettoBitmapRGB332
+PocoPixel bilinearPixel(PocoPixel p00, PocoPixel p01, PocoPixel p10, PocoPixel p11, uint8_t fx, uint8_t fy)
+{
+	uint32_t a, b, top, bottom;
+
+	fx >>= 5, fy >>= 5;		// 3 bit blend level
+
+	a = (p00 | (p00 << 16)) & 0x001C00E3;
+	b = (p01 | (p01 << 16)) & 0x001C00E3;
+	top = ((a * (8 - fx) + b * fx) >> 3) & 0x001C00E3;
+
+	a = (p10 | (p10 << 16)) & 0x001C00E3;
+	b = (p11 | (p11 << 16)) & 0x001C00E3;
+	bottom = ((a * (8 - fx) + b * fx) >> 3) & 0x001C00E3;
+
+	top = ((top * (8 - fy) + bottom * fy) >> 3) & 0x001C00E3;
+	return (PocoPixel)(top | (top >> 16));
+}
+#elif (kPocoPixelFormat == kCommodettoBitmapGray256) || (kPocoPixelFormat == kCommodettoBitmapGray16)
+PocoPixel bilinearPixel(PocoPixel p00, PocoPixel p01, PocoPixel p10, PocoPixel p11, uint8_t fx, uint8_t fy)
+{
+	uint32_t top = (p00 * (256 - fx)) + (p01 * fx);
+	uint32_t bottom = (p10 * (256 - fx)) + (p11 * fx);
+
+	return (PocoPixel)(((top * (256 - fy)) + (bottom * fy)) >> 16);
+}
+#endif
+
+/*
+	each glyph that overlaps the rows is drawn by its own command, using a record built on the stack
+*/
+
+void doDrawTextRun(Poco poco, PocoCommand pc, PocoPixel *dst, PocoDimension h)
+{
+	TextRun tr = (TextRun)pc;
+	TextRunGlyph glyph = tr->glyph;
+	PocoCoordinate row = tr->row;
+	PocoRenderCommandProc proc = gDrawRenderCommand[tr->glyphCommand];
+	union {
+		RenderGray16BitsRecord		gray;
+		RenderGray16RLEBitsRecord	rle;
+	} part;
+	int count;
+
+	if (kPocoCommandGray16BitmapDraw == tr->glyphCommand) {
+		part.gray.rowBump = tr->rowBump;
+		part.gray.color = tr->color;
+		PocoCommandSetLength(&part.gray, sizeof(RenderGray16BitsRecord));
+	}
+	else {
+		part.rle.color = tr->color;
+		part.rle.blendersOffset = tr->blendersOffset;
+		PocoCommandSetLength(&part.rle, offsetof(RenderGray16RLEBitsRecord, thisSkip));	// unclipped
+	}
+
+	for (count = tr->count; count--; glyph++) {
+		PocoCoordinate first = (glyph->dy > row) ? glyph->dy : row;
+		PocoCoordinate last = ((glyph->dy + glyph->h) < (row + h)) ? (glyph->dy + glyph->h) : (row + h);
+		PocoPixel *d;
+
+		if (first >= last)
+			continue;
+
+#if 4 != kPocoPixelSize
+		d = (PocoPixel *)(((first - row) * poco->rowBytes) + (char *)(dst + glyph->dx));
+#else
+		d = (PocoPixel *)(((first - row) * poco->rowBytes) + (char *)(dst + ((tr->xphase + glyph->dx) >> 1)));
+		part.gray.xphase = (tr->xphase + glyph->dx) & 1;
+#endif
+		part.gray.w = glyph->w;
+
+		if (kPocoCommandGray16BitmapDraw == tr->glyphCommand) {
+			part.gray.pixels = glyph->pixels;
+			part.gray.mask = glyph->state;
+			(proc)(poco, (PocoCommand)&part, d, last - first);
+			glyph->pixels = part.gray.pixels;
+		}
+		else {
+			part.rle.pixels = glyph->pixels;
+			part.rle.nybbleCount = glyph->state;
+			(proc)(poco, (PocoCommand)&part, d, last - first);
+			glyph->pixels = part.rle.pixels;
+			glyph->state = part.rle.nybbleCount;
+		}
+	}
+
+	tr->row = row + h;
+}
+
 #if 4 == kPocoPixelSize
 
 #if kPocoPixelFormat == kCommodettoBitmapGray16
@@ -2814,7 +3574,7 @@ void copy4AlignedSourceAlignedDest(uint8_t *to, const uint8_t *from, uint16_t pi
 		eightPixels = *(uint32_t *)(-offset + (uintptr_t)from);
 
 		pixel = eightPixels >> (((offset << 1) ^ 1) << 2);		// eightPixels pixels ordered: 6 7  4 5  2 3  0 1
-		*to = (remap[pixel] << kPocoPixels4FirstShift) | (*to & kPocoPixels4SecondMask);
+		*to = (remap[pixel & 0x0F] << kPocoPixels4FirstShift) | (*to & kPocoPixels4SecondMask);
 	}
 }
 
@@ -3284,6 +4044,18 @@ done:
 	return repeatSkip;
 }
 
+void doDrawExternal(Poco poco, PocoCommand pc, PocoPixel *dst, PocoDimension h)
+{
+	External e = (External)pc;
+
+#if 4 != kPocoPixelSize
+	(e->doDrawExternal)(poco, e->data, dst, e->sx, e->sy, pc->w, h, 0);
+#else
+	(e->doDrawExternal)(poco, e->data, dst, e->sx, e->sy, pc->w, h, pc->xphase);
+#endif
+	e->sy += h;
+}
+
 void PocoDrawingBegin(Poco poco, PocoCoordinate x, PocoCoordinate y, PocoDimension w, PocoDimension h)
 {
 	// clip against the display
@@ -3311,7 +4083,8 @@ void PocoDrawingBegin(Poco poco, PocoCoordinate x, PocoCoordinate y, PocoDimensi
 
 	// get started
 	poco->next = (PocoCommand)poco->displayList;
-	poco->flags &= ~(kPocoFlagErrorDisplayListOverflow | kPocoFlagErrorStackProblem);
+	poco->textRun = NULL;
+	poco->flags &= ~(kPocoFlagErrorDisplayListOverflow | kPocoFlagErrorStackProblem | kPocoFlagExternal);
 	poco->stackDepth = 0;
 	poco->xOrigin = poco->yOrigin = 0;
 
@@ -3336,6 +4109,11 @@ int PocoDrawingEnd(Poco poco, PocoPixel *pixels, int byteLength, PocoRenderedPix
 	PocoCommand displayList, displayListEnd;
 	PocoCommand walker;
 	PocoPixel *pixelsAlt;
+	PocoSlabIndexRecord index;
+	int slab;
+#if kPocoThreads > 1
+	PocoPixel *frame;
+#endif
 
 	if (poco->flags & kPocoFlagErrorDisplayListOverflow)
 		return 1;
@@ -3361,8 +4139,8 @@ int PocoDrawingEnd(Poco poco, PocoPixel *pixels, int byteLength, PocoRenderedPix
 		displayLinesAlt = displayLines >> 1;
 		displayLines -= displayLinesAlt;
 		pixelsAlt = (PocoPixel *)((displayLines * rowBytes) + (char *)pixels);
-		if (3 & (int)pixelsAlt)
-			pixelsAlt = (PocoPixel *)((4 + (int)pixelsAlt) & ~3);
+		if (3 & (uintptr_t)pixelsAlt)
+			pixelsAlt = (PocoPixel *)((4 + (uintptr_t)pixelsAlt) & ~(uintptr_t)3);
 	}
 	else {
 		displayLinesAlt = 0;
@@ -3380,38 +4158,74 @@ int PocoDrawingEnd(Poco poco, PocoPixel *pixels, int byteLength, PocoRenderedPix
 #endif
 	}
 
+#if kPocoThreads > 1
+	frame = renderBands(poco);
+	if (frame || !buildSlabIndex(poco, &index, displayLines, displayLinesAlt))
+#else
+	if (!buildSlabIndex(poco, &index, displayLines, displayLinesAlt))
+#endif
+		index.order = NULL;
+
 	// walk through a slab of displayList at a time
-	for (yMin = poco->y; yMin < poco->yMax; yMin = yMax) {
+	for (yMin = poco->y, slab = 0; yMin < poco->yMax; yMin = yMax, slab++) {
 		yMax = yMin + displayLines;
 		if (yMax > poco->yMax)
 			yMax = poco->yMax;
 
-		for (walker = displayList; walker != displayListEnd; walker = (PocoCommand)(walker->length + (char *)walker)) {
-			PocoCoordinate y = walker->y;
-			PocoDimension h;
+#if kPocoThreads > 1
+		if (frame)
+			c_memcpy(pixels, ((yMin - poco->y) * rowBytes) + (char *)frame, rowBytes * (yMax - yMin));
+		else
+#endif
+		if (index.order) {
+			// merge commands still active from earlier slabs with those starting in this slab, preserving display list order
+			PocoSlabEntry *active = index.active + (index.count - index.activeCount), *activeEnd = index.active + index.count;
+			PocoSlabEntry *start = index.order + index.slabStart[slab], *end = index.order + index.slabStart[slab + 1];
+			PocoSlabEntry *out = index.active, *entry;
+			int count;
+
+			while ((active < activeEnd) || (start < end)) {
+				if ((start == end) || ((active < activeEnd) && (*active < *start)))
+					*out++ = *active++;				// output never passes the unread active entries
+				else
+					*out++ = *start++;
+			}
+			count = out - index.active;
 
-			if (y >= yMax)
-				continue;						// completely below the slab being drawn
+			if (index.cover)
+				cullSlabCommands(poco, &index, index.active, count, yMin, yMax);
 
-			h = walker->h;
+			for (entry = out = index.active; count--; entry++) {
+				walker = (PocoCommand)((*entry << 2) + (char *)displayList);
+				if (walker->command & kPocoCommandHidden) {
+					walker->command &= ~kPocoCommandHidden;
+					if ((walker->y + walker->h) > yMax)		// only kinds that seek without drawing are hidden across slabs, so no scratch row is needed
+						seekCommand(poco, walker, yMax - ((walker->y > yMin) ? walker->y : yMin), NULL);
+				}
+				else
+					renderSlabCommand(poco, walker, pixels, yMin, yMax);
+				if ((walker->y + walker->h) > yMax)
+					*out++ = *entry;
+			}
 
-			if (y < yMin) {
-				if ((y + h) <= yMin) {				// full object above the slab being drawn
+			index.activeCount = out - index.active;
+			if (index.activeCount)
+				c_memmove(index.active + (index.count - index.activeCount), index.active, index.activeCount * sizeof(PocoSlabEntry));
+		}
+		else {
+			for (walker = displayList; walker != displayListEnd; walker = (PocoCommand)(walker->length + (char *)walker)) {
+				PocoCoordinate y = walker->y;
+
+				if (y >= yMax)
+					continue;						// completely below the slab being drawn
+
+				if ((y < yMin) && ((y + walker->h) <= yMin)) {		// full object above the slab being drawn
 					walker->y = poco->yMax;			// move it below bottom, so this loop can exit early next time
 					continue;
 				}
 
-				h -= (yMin - y);
-				y = yMin;
+				renderSlabCommand(poco, walker, pixels, yMin, yMax);
 			}
-			if ((y + h) > yMax)
-				h = yMax - y;
-
-#if 4 != kPocoPixelSize
-			(gDrawRenderCommand[walker->command])(poco, walker, pixels + ((y - yMin) * poco->w) + walker->x, h);
-#else
-			(gDrawRenderCommand[walker->command])(poco, walker, pixels + ((y - yMin) * rowBytes) + walker->x, h);
-#endif
 		}
 
 		(pixelReceiver)(pixels, rowBytes * (yMax - yMin), refCon);
@@ -3433,6 +4247,394 @@ int PocoDrawingEnd(Poco poco, PocoPixel *pixels, int byteLength, PocoRenderedPix
 	return 0;
 }
 
+/*
+	the index lives between the end of the display list and the end of its buffer.
+	when that space is too small, or there is only one slab, the display list is walked once per slab instead.
+*/
+
+int buildSlabIndex(Poco poco, PocoSlabIndex index, int16_t displayLines, int16_t displayLinesAlt)
+{
+	PocoCommand displayList = (PocoCommand)poco->displayList, displayListEnd = poco->next, walker;
+	int count = 0, slabCount, slab, spans;
+	char *buffer;
+
+	if (((char *)displayListEnd - (char *)displayList) > (65535 << 2))
+		return 0;
+
+	slabCount = slabFromY(poco, poco->yMax - 1, displayLines, displayLinesAlt) + 1;
+	if (slabCount <= 1)
+		return 0;
+
+	for (walker = displayList; walker != displayListEnd; walker = (PocoCommand)(walker->length + (char *)walker))
+		count++;
+
+	buffer = (char *)(((uintptr_t)displayListEnd + 1) & ~(uintptr_t)1);
+	if ((poco->displayListEnd - buffer) < (int)(((count << 1) + slabCount + 1) * sizeof(PocoSlabEntry)))
+		return 0;
+
+	index->slabStart = (PocoSlabEntry *)buffer;
+	index->order = index->slabStart + slabCount + 1;
+	index->active = index->order + count;
+	index->activeCount = 0;
+
+	// counting sort by first slab
+	c_memset(index->slabStart, 0, (slabCount + 1) * sizeof(PocoSlabEntry));
+	for (walker = displayList; walker != displayListEnd; walker = (PocoCommand)(walker->length + (char *)walker)) {
+		if (walker->y >= poco->yMax)
+			continue;
+		index->slabStart[slabFromY(poco, walker->y, displayLines, displayLinesAlt) + 1] += 1;
+	}
+
+	for (slab = 1; slab <= slabCount; slab++)
+		index->slabStart[slab] += index->slabStart[slab - 1];
+	index->count = index->slabStart[slabCount];
+
+	for (walker = displayList; walker != displayListEnd; walker = (PocoCommand)(walker->length + (char *)walker)) {
+		if (walker->y >= poco->yMax)
+			continue;
+		slab = slabFromY(poco, walker->y, displayLines, displayLinesAlt);
+		index->order[index->slabStart[slab]++] = (PocoSlabEntry)(((char *)walker - (char *)displayList) >> 2);
+	}
+
+	// placing advanced each start to the next slab's start
+	for (slab = slabCount; slab > 0; slab--)
+		index->slabStart[slab] = index->slabStart[slab - 1];
+	index->slabStart[0] = 0;
+
+	// each opaque command adds at most one span, and spans are separated by at least one pixel
+	index->cover = (PocoCoordinate *)(index->active + count);
+	spans = ((index->count < ((poco->w + 1) >> 1)) ? index->count : ((poco->w + 1) >> 1)) + 1;
+	if ((poco->displayListEnd - (char *)index->cover) < (int)((spans << 1) * sizeof(PocoCoordinate)))
+		index->cover = NULL;
+
+	return 1;
+}
+
+int slabFromY(Poco poco, PocoCoordinate y, int16_t displayLines, int16_t displayLinesAlt)
+{
+	int row = y - poco->y;
+
+	if (row <= 0)
+		return 0;
+
+	if (displayLinesAlt) {
+		int pair = displayLines + displayLinesAlt;
+		return ((row / pair) << 1) + ((row % pair) >= displayLines);
+	}
+
+	return row / displayLines;
+}
+
+void renderSlabCommand(Poco poco, PocoCommand pc, PocoPixel *pixels, PocoCoordinate yMin, PocoCoordinate yMax)
+{
+	PocoCoordinate y = pc->y;
+	PocoDimension h = pc->h;
+
+	if (y >= yMax)
+		return;
+
+	if (y < yMin) {
+		h -= (yMin - y);
+		y = yMin;
+	}
+	if ((y + h) > yMax)
+		h = yMax - y;
+
+#if 4 != kPocoPixelSize
+	(gDrawRenderCommand[pc->command])(poco, pc, pixels + ((y - yMin) * poco->w) + pc->x, h);
+#else
+	(gDrawRenderCommand[pc->command])(poco, pc, pixels + ((y - yMin) * poco->rowBytes) + pc->x, h);
+#endif
+}
+
+/*
+	walk the slab's commands from last to first, hiding those fully covered by later opaque commands.
+	only fills and bitmap draws that span every row of the slab add to the cover, patterns do not. a command continuing into the next slab
+	is hidden only if its per row state can be advanced without drawing.
+*/
+
+void cullSlabCommands(Poco poco, PocoSlabIndex index, PocoSlabEntry *entries, int count, PocoCoordinate yMin, PocoCoordinate yMax)
+{
+	PocoCoordinate *cover = index->cover;
+	int spans = 0;
+
+	while (count--) {
+		PocoCommand pc = (PocoCommand)((entries[count] << 2) + poco->displayList);
+		PocoCoordinate x0, x1;
+		int first, last;
+
+#if 4 != kPocoPixelSize
+		x0 = pc->x;
+#else
+		x0 = (pc->x << 1) + pc->xphase;
+#endif
+		x1 = x0 + pc->w;
+
+		for (first = 0; (first < spans) && (cover[(first << 1) + 1] < x1); first++)
+			;
+		if ((first < spans) && (cover[first << 1] <= x0)) {
+			switch (pc->command) {
+				case kPocoCommandRectangleFill:
+				case kPocoCommandRectangleBlend:
+				case kPocoCommandPixelDraw:
+				case kPocoCommandBitmapDraw:
+				case kPocoCommandBitmapDrawScaled:
+				case kPocoCommandExternal:
+					pc->command |= kPocoCommandHidden;
+					break;
+				default:
+					if ((pc->y + pc->h) <= yMax)
+						pc->command |= kPocoCommandHidden;
+					break;
+			}
+			continue;
+		}
+
+		if ((pc->y > yMin) || ((pc->y + pc->h) < yMax))
+			continue;
+		if ((kPocoCommandRectangleFill != pc->command) && (kPocoCommandBitmapDraw != pc->command) && (kPocoCommandBitmapDrawScaled != pc->command))
+			continue;
+
+		// merge [x0, x1) with the spans it overlaps or touches
+		for (first = 0; (first < spans) && (cover[(first << 1) + 1] < x0); first++)
+			;
+		for (last = first; (last < spans) && (cover[last << 1] <= x1); last++)
+			;
+		if (first == last) {
+			c_memmove(cover + ((first + 1) << 1), cover + (first << 1), ((spans - first) << 1) * sizeof(PocoCoordinate));
+			spans += 1;
+		}
+		else {
+			if (cover[first << 1] < x0)
+				x0 = cover[first << 1];
+			if (cover[((last - 1) << 1) + 1] > x1)
+				x1 = cover[((last - 1) << 1) + 1];
+			c_memmove(cover + ((first + 1) << 1), cover + (last << 1), ((spans - last) << 1) * sizeof(PocoCoordinate));
+			spans -= last - first - 1;
+		}
+		cover[first << 1] = x0;
+		cover[(first << 1) + 1] = x1;
+	}
+}
+
+/*
+	advance the per row state of a command past rows that are not drawn.
+	commands that step through their source by a fixed amount per row render one row to measure it.
+	the others render each skipped row to scratch. scratch is unused for fills, pixels, and bitmaps.
+*/
+
+void seekCommand(Poco poco, PocoCommand pc, PocoDimension rows, PocoPixel *scratch)
+{
+	switch (pc->command) {
+		case kPocoCommandRectangleFill:
+		case kPocoCommandRectangleBlend:
+		case kPocoCommandPixelDraw:
+			break;
+
+		case kPocoCommandBitmapDraw: {
+			RenderBits rb = (RenderBits)pc;
+#if 4 != kPocoPixelSize
+			rb->pixels = (PocoPixel *)rb->pixels + (rows * rb->rowPixels);
+#else
+			rb->pixels = (uint8_t *)rb->pixels + (rows * rb->rowBytes);
+#endif
+			} break;
+
+		case kPocoCommandBitmapDrawScaled:
+			((ScaledBits)pc)->row += rows * ((ScaledBits)pc)->rowStep;
+			break;
+
+		case kPocoCommandExternal:
+			((External)pc)->sy += rows;
+			break;
+
+		case kPocoCommandMonochromeBitmapDraw:
+		case kPocoCommandMonochromeForegroundBitmapDraw: {
+			RenderMonochromeBits mb = (RenderMonochromeBits)pc;
+			const unsigned char *pixels = mb->pixels;
+
+			(gDrawRenderCommand[pc->command])(poco, pc, scratch + pc->x, 1);
+			mb->pixels = pixels + ((mb->pixels - pixels) * rows);
+			} break;
+
+		case kPocoCommandGray16BitmapDraw: {
+			RenderGray16Bits gb = (RenderGray16Bits)pc;
+			const unsigned char *pixels = gb->pixels;
+
+			(gDrawRenderCommand[pc->command])(poco, pc, scratch + pc->x, 1);
+			gb->pixels = pixels + ((gb->pixels - pixels) * rows);
+			} break;
+
+		case kPocoCommandBitmapDrawMasked: {
+			RenderMaskedBits rmb = (RenderMaskedBits)pc;
+			const uint8_t *pixels = rmb->pixels, *maskBits = rmb->maskBits;
+
+			(gDrawRenderCommand[pc->command])(poco, pc, scratch + pc->x, 1);
+			rmb->pixels = pixels + (((const uint8_t *)rmb->pixels - pixels) * rows);
+			rmb->maskBits = maskBits + (((const uint8_t *)rmb->maskBits - maskBits) * rows);
+			} break;
+
+		default:
+			while (rows--)
+				(gDrawRenderCommand[pc->command])(poco, pc, scratch + pc->x, 1);
+			break;
+	}
+}
+
+#if kPocoThreads > 1
+
+static struct {
+	pthread_mutex_t		mutex;
+	pthread_cond_t		work;
+	pthread_cond_t		done;
+	uint32_t			generation;
+	int					threads;		// started, not counting the caller
+	int					pending;
+	int					bandCount;
+	const char			*displayList;
+	int					displayListUsed;
+	char				*buffer;
+	int					bufferLength;
+	PocoBandRecord		band[kPocoThreads];
+} gPocoBands = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER};
+
+PocoPixel *renderBands(Poco poco)
+{
+	int rows = poco->yMax - poco->y, rowBytes = poco->rowBytes;
+	int used = (char *)poco->next - poco->displayList;
+	int bandCount, bandRows, frameBytes, scratchBytes, length, i;
+	char *buffer;
+
+	while (gPocoBands.threads < (kPocoThreads - 1)) {
+		pthread_t thread;
+		if (pthread_create(&thread, NULL, renderBandsThread, (void *)(uintptr_t)(gPocoBands.threads + 1)))
+			break;
+		pthread_detach(thread);
+		gPocoBands.threads += 1;
+	}
+
+	bandCount = gPocoBands.threads + 1;
+	if ((bandCount < 2) || (rows < (bandCount << 3)) || (poco->flags & kPocoFlagExternal))
+		return NULL;
+
+	bandRows = (rows + bandCount - 1) / bandCount;
+	bandCount = (rows + bandRows - 1) / bandRows;
+
+	frameBytes = ((rows * rowBytes) + 3) & ~3;
+	scratchBytes = (rowBytes + 3) & ~3;
+	length = frameBytes + (bandCount * (scratchBytes + used));
+	if (length > gPocoBands.bufferLength) {
+		buffer = c_realloc(gPocoBands.buffer, length);
+		if (!buffer)
+			return NULL;
+		gPocoBands.buffer = buffer;
+		gPocoBands.bufferLength = length;
+	}
+	buffer = gPocoBands.buffer;
+
+	for (i = 0; i < bandCount; i++) {
+		PocoBand band = &gPocoBands.band[i];
+
+		band->poco = poco;
+		band->pixels = (PocoPixel *)(buffer + (i * bandRows * rowBytes));
+		band->scratch = (PocoPixel *)(buffer + frameBytes + (i * scratchBytes));
+		band->displayList = (PocoCommand)(buffer + frameBytes + (bandCount * scratchBytes) + (i * used));
+		band->yMin = poco->y + (i * bandRows);
+		band->yMax = band->yMin + bandRows;
+		if (band->yMax > poco->yMax)
+			band->yMax = poco->yMax;
+	}
+
+	pthread_mutex_lock(&gPocoBands.mutex);
+	gPocoBands.displayList = poco->displayList;
+	gPocoBands.displayListUsed = used;
+	gPocoBands.bandCount = bandCount;
+	gPocoBands.pending = bandCount - 1;
+	gPocoBands.generation += 1;
+	pthread_cond_broadcast(&gPocoBands.work);
+	pthread_mutex_unlock(&gPocoBands.mutex);
+
+	renderBand(&gPocoBands.band[0]);
+
+	pthread_mutex_lock(&gPocoBands.mutex);
+	while (gPocoBands.pending)
+		pthread_cond_wait(&gPocoBands.done, &gPocoBands.mutex);
+	pthread_mutex_unlock(&gPocoBands.mutex);
+
+	return (PocoPixel *)buffer;
+}
+
+void *renderBandsThread(void *refcon)
+{
+	int index = (int)(uintptr_t)refcon;
+	uint32_t generation = 0;
+
+	pthread_mutex_lock(&gPocoBands.mutex);
+	while (1) {
+		while (generation == gPocoBands.generation)
+			pthread_cond_wait(&gPocoBands.work, &gPocoBands.mutex);
+		generation = gPocoBands.generation;
+
+		if (index < gPocoBands.bandCount) {
+			pthread_mutex_unlock(&gPocoBands.mutex);
+			renderBand(&gPocoBands.band[index]);
+			pthread_mutex_lock(&gPocoBands.mutex);
+
+			gPocoBands.pending -= 1;
+			if (0 == gPocoBands.pending)
+				pthread_cond_signal(&gPocoBands.done);
+		}
+	}
+
+	return NULL;
+}
+
+void renderBand(PocoBand band)
+{
+	Poco poco = band->poco;
+	PocoCommand walker, displayListEnd;
+
+	c_memcpy(band->displayList, gPocoBands.displayList, gPocoBands.displayListUsed);
+	displayListEnd = (PocoCommand)(gPocoBands.displayListUsed + (char *)band->displayList);
+
+	for (walker = band->displayList; walker != displayListEnd; walker = (PocoCommand)(walker->length + (char *)walker)) {
+		PocoCoordinate y = walker->y;
+
+		if ((y >= band->yMax) || ((y + walker->h) <= band->yMin))
+			continue;
+
+		if (y < band->yMin)
+			seekCommand(poco, walker, band->yMin - y, band->scratch);
+
+		renderSlabCommand(poco, walker, band->pixels, band->yMin, band->yMax);
+	}
+}
+
+
+#endif
+
+/*
+	when the display list overflows, the update area can be drawn again as two smaller areas.
+	the split is between rows of the display, so adjustments made by adaptInvalid to x and w are preserved.
+*/
+
+int PocoDrawingSplit(Poco poco, PocoRectangle first, PocoRectangle second)
+{
+	PocoCoordinate x = poco->x, y = poco->y;
+	PocoDimension w = poco->w, h = poco->h >> 1;
+
+	if (!(poco->flags & kPocoFlagErrorDisplayListOverflow) || (0 == h))
+		return 0;
+
+	first->x = x, first->y = y, first->w = w, first->h = h;
+	unrotateCoordinatesAndDimensions(poco->width, poco->height, first->x, first->y, first->w, first->h);
+
+	second->x = x, second->y = y + h, second->w = w, second->h = poco->h - h;
+	unrotateCoordinatesAndDimensions(poco->width, poco->height, second->x, second->y, second->w, second->h);
+
+	return 1;
+}
+
 #if kPocoFrameBuffer
 void PocoDrawingBeginFrameBuffer(Poco poco, PocoCoordinate x, PocoCoordinate y, PocoDimension w, PocoDimension h, PocoPixel *frameBuffer, int16_t rowBytes)
 {
@@ -53,6 +53,22 @@
 	#define kPocoRotation 0
 #endif
 
+#ifndef kPocoThreads
+	#define kPocoThreads 0
+#endif
+
+#ifndef kPocoGlyphCache
+	#define kPocoGlyphCache 64		// entries, a power of two or 0
+#endif
+
+#ifndef kPocoVector
+	#if (defined(__clang__) || (__GNUC__ >= 9)) && (defined(__SSE2__) || defined(__ARM_NEON))
+		#define kPocoVector 1
+	#else
+		#define kPocoVector 0
+	#endif
+#endif
+
 #if !defined(kPocoCLUT16_01) || kPocoCLUT16_01
 	// first pixel is in high nybble (4-bit format in BMP)
 	#undef kPocoCLUT16_01
@@ -82,6 +98,11 @@ typedef enum {
 	kPocoMonochromeForeAndBackground = (kPocoMonochromeForeground | kPocoMonochromeBackground)
  }  PocoMonochromeMode;
 
+typedef enum {
+	kPocoScaleNearest = 0,
+	kPocoScaleBilinear = 1
+} PocoScaleMode;
+
 #define kPocoOpaque (255)
 
 typedef CommodettoCoordinate PocoCoordinate;
@@ -112,6 +133,7 @@ enum {
 	kPocoFlagFrameBuffer = 1 << 3,
 	kPocoFlagErrorDisplayListOverflow = 1 << 4,
 	kPocoFlagErrorStackProblem = 1 << 5,
+	kPocoFlagExternal = 1 << 6,
 };
 
 struct PocoRecord {
@@ -123,6 +145,7 @@ struct PocoRecord {
 	char				*displayList;
 	const char			*displayListEnd;
 	PocoCommand			next;
+	PocoCommand			textRun;		// the last glyph command, which later glyphs join while it is the last command
 
 	// clip rectangle of active drawing operation (rotation removed - physical)
 	PocoCoordinate		x;
@@ -167,6 +190,7 @@ typedef struct PocoBitmapRecord {
 } PocoBitmapRecord, *PocoBitmap;
 
 typedef void (*PocoRenderedPixelsReceiver)(PocoPixel *pixels, int byteCount, void *refCon);
+typedef void (*PocoRenderExternal)(Poco poco, uint8_t *data, PocoPixel *dst, PocoDimension sx, PocoDimension sy, PocoDimension w, PocoDimension h, uint8_t xphase);
 
 #define READ_PROG_MEM_UNSIGNED_BYTE(a) (*(unsigned char *)(a))
 #define READ_PROG_MEM_UNSIGNED_LONG(a) (*(uint32_t *)(a))
@@ -197,6 +221,7 @@ extern "C" {
 
 void PocoDrawingBegin(Poco poco, PocoCoordinate x, PocoCoordinate y, PocoDimension w, PocoDimension h);
 int PocoDrawingEnd(Poco poco, PocoPixel *pixels, int byteLength, PocoRenderedPixelsReceiver pixelReceiver, void *refCon);
+int PocoDrawingSplit(Poco poco, PocoRectangle first, PocoRectangle second);
 
 #if kPocoFrameBuffer
 void PocoDrawingBeginFrameBuffer(Poco poco, PocoCoordinate x, PocoCoordinate y, PocoDimension w, PocoDimension h, PocoPixel *pixels, int16_t rowBytes);
@@ -209,13 +234,18 @@ void PocoPixelDraw(Poco poco, PocoColor color, PocoCoordinate x, PocoCoordinate
 void PocoBitmapDraw(Poco poco, PocoBitmap bits, PocoCoordinate x, PocoCoordinate y, PocoDimension sx, PocoDimension sy, PocoDimension sw, PocoDimension sh);
 void PocoMonochromeBitmapDraw(Poco poco, PocoBitmap bits, PocoMonochromeMode mode, PocoColor fgColor, PocoColor bgColor, PocoCoordinate x, PocoCoordinate y, PocoDimension sx, PocoDimension sy, PocoDimension sw, PocoDimension sh);
 void PocoGrayBitmapDraw(Poco poco, PocoBitmap bits, PocoColor color, uint8_t blend, PocoCoordinate x, PocoCoordinate y, PocoDimension sx, PocoDimension sy, PocoDimension sw, PocoDimension sh);
+void PocoGrayGlyphDraw(Poco poco, PocoBitmap bits, PocoColor color, uint8_t blend, PocoCoordinate x, PocoCoordinate y, PocoDimension sx, PocoDimension sy, PocoDimension sw, PocoDimension sh);
 
 void PocoBitmapDrawMasked(Poco poco, uint8_t blend, PocoBitmap bits, PocoCoordinate x, PocoCoordinate y, PocoDimension sx, PocoDimension sy, PocoDimension sw, PocoDimension sh,
 			PocoBitmap mask, PocoDimension mask_sx, PocoDimension mask_sy);
 
 void PocoBitmapPattern(Poco poco, PocoBitmap bits, PocoCoordinate x, PocoCoordinate y, PocoDimension w, PocoDimension h, PocoDimension sx, PocoDimension sy, PocoDimension sw, PocoDimension sh);
 
+void PocoBitmapDrawScaled(Poco poco, PocoBitmap bits, PocoScaleMode mode, PocoCoordinate x, PocoCoordinate y, PocoDimension w, PocoDimension h, PocoDimension sx, PocoDimension sy, PocoDimension sw, PocoDimension sh);
+void PocoBitmapDrawRotated(Poco poco, PocoBitmap bits, uint16_t rotation, PocoCoordinate x, PocoCoordinate y, PocoDimension sx, PocoDimension sy, PocoDimension sw, PocoDimension sh);
+
 void PocoDrawFrame(Poco poco, uint8_t *data, uint32_t dataSize, PocoCoordinate x, PocoCoordinate y, PocoDimension w, PocoDimension h);
+void PocoDrawExternal(Poco poco, PocoRenderExternal doDrawExternal, uint8_t *data, uint8_t dataSize, PocoCoordinate x, PocoCoordinate y, PocoDimension w, PocoDimension h);
 
 void PocoClipPush(Poco poco, PocoCoordinate x, PocoCoordinate y, PocoDimension w, PocoDimension h);
 void PocoClipPop(Poco poco);
@@ -23,10 +23,12 @@
 	Commodetto readJPEG
 
 		wraps picojpeg
-		
-	To do:
 
-		PJPG_YH2V2
+		scale reduces the image by 1/2, 1/4, or 1/8 in the DCT domain, so each 8x8 block decodes to 4x4, 2x2, or 1x1 pixels
+		area limits the blocks returned to those that intersect a rectangle. MCUs outside it are entropy decoded, as
+			required by the DC predictors, but are not transformed, and decoding ends after the last row of the area
+
+	To do:
 
 		sliding CommodettoBitmap
 
@@ -57,12 +59,18 @@ typedef struct {
 	convertto			convert;
 	char				isArrayBuffer;
 
-	unsigned char		blockWidth;
-	unsigned char		blockYMax;			 // info.m_MCUSPerCol - 1
-	unsigned char		blockX;
-	unsigned char		blockY;
+	uint16_t			blockWidth;			// info.m_MCUSPerRow
+	uint16_t			blockYMax;			// info.m_MCUSPerCol - 1
+	uint16_t			blockX;
+	uint16_t			blockY;
 
-	unsigned char		mcuWidth;
+	uint16_t			areaXMin;			// MCUs that intersect the area
+	uint16_t			areaXMax;
+	uint16_t			areaYMin;
+	uint16_t			areaYMax;
+
+	unsigned char		blockSize;			// pixels across a decoded block (8 >> scale)
+	unsigned char		mcuWidth;			// scaled
 	unsigned char		mcuHeight;
 	unsigned char		mcuWidthRight;
 	unsigned char		mcuHeightBottom;
@@ -77,6 +85,9 @@ typedef struct {
 } JPEGRecord, *JPEG;
 
 static unsigned char needBytes(unsigned char* pBuf, unsigned char buf_size, unsigned char *pBytes_actually_read, void *pCallback_data);
+static void jpegBlocks(JPEG jpeg, pjpeg_image_info_t *info, unsigned char scale);
+static void jpegArea(JPEG jpeg, int x, int y, int w, int h);
+static unsigned char jpegRead(JPEG jpeg, CommodettoBitmap cb, int *x, int *y);
 
 #if (16 == kPocoPixelSize) || (8 == kPocoPixelSize)
 	static void convertto_16and8(JPEG jpeg, CommodettoBitmap cb, PocoPixel *pixels);
@@ -100,11 +111,11 @@ static void pixelsDestructor(void *data)
 
 void xs_JPEG_constructor(xsMachine *the)
 {
-	unsigned char result;
+	unsigned char result, scale = 0;
 	pjpeg_image_info_t info;
 	CommodettoBitmapFormat pixelFormat;
 	uint8_t pixelSize;
-	int argc = xsmcArgc, pixelsLength;
+	int argc = xsmcArgc, pixelsLength, width, height;
 
 	JPEG jpeg = c_malloc(sizeof(JPEGRecord));
 	if (!jpeg)
@@ -122,31 +133,46 @@ void xs_JPEG_constructor(xsMachine *the)
 
  	jpeg->isArrayBuffer = xsmcIsInstanceOf(xsArg(0), xsArrayBufferPrototype);
 
-	result = pjpeg_decode_init(&info, needBytes, jpeg, 0);
+	pixelFormat = kCommodettoBitmapFormat;
+	if ((argc > 1) && (xsUndefinedType != xsmcTypeOf(xsArg(1)))) {
+		if (xsmcHas(xsArg(1), xsID_pixelFormat)) {
+			xsmcGet(xsVar(0), xsArg(1), xsID_pixelFormat);
+			pixelFormat = xsmcToInteger(xsVar(0));
+		}
+		if (xsmcHas(xsArg(1), xsID_scale)) {
+			double value;
+
+			xsmcGet(xsVar(0), xsArg(1), xsID_scale);
+			value = xsmcToNumber(xsVar(0));
+			while ((scale <= 3) && (value != (1.0 / (1 << scale))))
+				scale++;
+			if (scale > 3)
+				xsErrorPrintf("unsupported scale");
+		}
+	}
+
+	result = pjpeg_decode_init(&info, needBytes, jpeg, scale);
 	if (0 != result)
 		xsErrorPrintf("jpeg init failed");
 
-	jpeg->blockWidth = info.m_MCUSPerRow;
-	jpeg->blockYMax = info.m_MCUSPerCol - 1;
-	jpeg->blockX = 0;
-	jpeg->blockY = 0;
-	jpeg->mcuWidth = info.m_MCUWidth;
-	jpeg->mcuHeight = info.m_MCUHeight;
-	jpeg->mcuWidthRight = info.m_width % jpeg->mcuWidth;
-	if (!jpeg->mcuWidthRight)
-		jpeg->mcuWidthRight = jpeg->mcuWidth;
-	jpeg->mcuHeightBottom = info.m_height % jpeg->mcuHeight;
-	if (!jpeg->mcuHeightBottom)
-		jpeg->mcuHeightBottom = jpeg->mcuHeight;
-	jpeg->scanType = info.m_scanType;
-	jpeg->r = info.m_pMCUBufR;
-	jpeg->g = info.m_pMCUBufG;
-	jpeg->b = info.m_pMCUBufB;
+	width = (info.m_width + (1 << scale) - 1) >> scale;
+	height = (info.m_height + (1 << scale) - 1) >> scale;
 
-	pixelFormat = kCommodettoBitmapFormat;
-	if ((argc > 1) && (xsUndefinedType != xsmcTypeOf(xsArg(1))) && xsmcHas(xsArg(1), xsID_pixelFormat)) {
-		xsmcGet(xsVar(0), xsArg(1), xsID_pixelFormat);
-		pixelFormat = xsmcToInteger(xsVar(0));
+	jpegBlocks(jpeg, &info, scale);
+	if ((argc > 1) && (xsUndefinedType != xsmcTypeOf(xsArg(1))) && xsmcHas(xsArg(1), xsID_area)) {
+		int x, y, w, h;
+
+		xsmcGet(xsVar(1), xsArg(1), xsID_area);
+		xsmcGet(xsVar(0), xsVar(1), xsID_x);
+		x = xsmcToInteger(xsVar(0));
+		xsmcGet(xsVar(0), xsVar(1), xsID_y);
+		y = xsmcToInteger(xsVar(0));
+		xsmcGet(xsVar(0), xsVar(1), xsID_width);
+		w = xsmcToInteger(xsVar(0));
+		xsmcGet(xsVar(0), xsVar(1), xsID_height);
+		h = xsmcToInteger(xsVar(0));
+
+		jpegArea(jpeg, x, y, w, h);
 	}
 
 #if (16 == kPocoPixelSize) || (8 == kPocoPixelSize)
@@ -164,7 +190,7 @@ void xs_JPEG_constructor(xsMachine *the)
 	else if (kCommodettoBitmapFormat != pixelFormat)
 		xsErrorPrintf("unsupported pixel format");
 
-	pixelsLength = (jpeg->mcuWidth * jpeg->mcuHeight * pixelSize) >> 3;
+	pixelsLength = (((jpeg->mcuWidth * pixelSize) + 7) >> 3) * jpeg->mcuHeight;
 	jpeg->pixels = c_malloc(pixelsLength);
 	if (!jpeg->pixels)
 		xsUnknownError("out of memory");
@@ -174,9 +200,9 @@ void xs_JPEG_constructor(xsMachine *the)
 	xsmcSet(xsVar(0), xsID_byteLength, xsVar(1));
 	xsmcSet(xsThis, xsID_pixels, xsVar(0));
 
-	xsmcSetInteger(xsVar(0), info.m_width);
+	xsmcSetInteger(xsVar(0), width);
 	xsmcSet(xsThis, xsID_width, xsVar(0));
-	xsmcSetInteger(xsVar(0), info.m_height);
+	xsmcSetInteger(xsVar(0), height);
 	xsmcSet(xsThis, xsID_height, xsVar(0));
 
 	xsmcSetInteger(xsVar(0), pixelFormat);
@@ -187,11 +213,13 @@ void xs_JPEG_read(xsMachine *the)
 {
 	JPEG jpeg = xsmcGetHostData(xsThis);
 	unsigned char result;
+	CommodettoBitmapRecord block;
 	CommodettoBitmap cb;
+	int x, y;
 
 	xsmcVars(2);
 
-	result = pjpeg_decode_mcu();
+	result = jpegRead(jpeg, &block, &x, &y);
 	if (0 != result) {
 		if (PJPG_NO_MORE_BLOCKS == result)
 			return;
@@ -199,12 +227,113 @@ void xs_JPEG_read(xsMachine *the)
 	}
 
 	xsmcGet(xsVar(1), xsThis, xsID_bitmap);
-	xsmcSetInteger(xsVar(0), jpeg->blockX * jpeg->mcuWidth);
+	xsmcSetInteger(xsVar(0), x);
 	xsmcSet(xsVar(1), xsID_x, xsVar(0));
-	xsmcSetInteger(xsVar(0), jpeg->blockY * jpeg->mcuHeight);
+	xsmcSetInteger(xsVar(0), y);
 	xsmcSet(xsVar(1), xsID_y, xsVar(0));
 
 	cb = xsmcGetHostChunk(xsVar(1));
+	cb->w = block.w;
+	cb->h = block.h;
+
+	xsResult = xsVar(1);
+}
+
+/*
+	set up the MCU geometry of the image at 1 / (1 << scale), with the area covering all of it
+*/
+
+void jpegBlocks(JPEG jpeg, pjpeg_image_info_t *info, unsigned char scale)
+{
+	int width = (info->m_width + (1 << scale) - 1) >> scale;
+	int height = (info->m_height + (1 << scale) - 1) >> scale;
+
+	jpeg->blockWidth = info->m_MCUSPerRow;
+	jpeg->blockYMax = info->m_MCUSPerCol - 1;
+	jpeg->blockX = 0;
+	jpeg->blockY = 0;
+	jpeg->blockSize = 8 >> scale;
+	jpeg->mcuWidth = info->m_MCUWidth >> scale;
+	jpeg->mcuHeight = info->m_MCUHeight >> scale;
+	jpeg->mcuWidthRight = width - ((jpeg->blockWidth - 1) * jpeg->mcuWidth);
+	jpeg->mcuHeightBottom = height - (jpeg->blockYMax * jpeg->mcuHeight);
+	jpeg->scanType = info->m_scanType;
+	jpeg->r = info->m_pMCUBufR;
+	jpeg->g = info->m_pMCUBufG;
+	jpeg->b = info->m_pMCUBufB;
+
+	jpeg->areaXMin = 0;
+	jpeg->areaXMax = jpeg->blockWidth - 1;
+	jpeg->areaYMin = 0;
+	jpeg->areaYMax = jpeg->blockYMax;
+}
+
+/*
+	limit reading to the MCUs that intersect an area of the scaled image
+*/
+
+void jpegArea(JPEG jpeg, int x, int y, int w, int h)
+{
+	int width = ((jpeg->blockWidth - 1) * jpeg->mcuWidth) + jpeg->mcuWidthRight;
+	int height = (jpeg->blockYMax * jpeg->mcuHeight) + jpeg->mcuHeightBottom;
+
+	if (x < 0) {
+		w += x;
+		x = 0;
+	}
+	if (y < 0) {
+		h += y;
+		y = 0;
+	}
+	if ((x + w) > width)
+		w = width - x;
+	if ((y + h) > height)
+		h = height - y;
+
+	if ((w <= 0) || (h <= 0))
+		jpeg->blockY = jpeg->blockYMax + 1;		// nothing to read
+	else {
+		jpeg->areaXMin = x / jpeg->mcuWidth;
+		jpeg->areaXMax = (x + w - 1) / jpeg->mcuWidth;
+		jpeg->areaYMin = y / jpeg->mcuHeight;
+		jpeg->areaYMax = (y + h - 1) / jpeg->mcuHeight;
+	}
+}
+
+/*
+	decode the next MCU in the area into the pixels, skipping the MCUs before it. sets the size of cb and the position
+	of the block. returns 0, PJPG_NO_MORE_BLOCKS after the last block of the area, or another picojpeg error.
+*/
+
+unsigned char jpegRead(JPEG jpeg, CommodettoBitmap cb, int *x, int *y)
+{
+	unsigned char result;
+
+	while (true) {
+		if (jpeg->blockY > jpeg->areaYMax)
+			return PJPG_NO_MORE_BLOCKS;
+
+		if ((jpeg->blockY >= jpeg->areaYMin) && (jpeg->blockX >= jpeg->areaXMin) && (jpeg->blockX <= jpeg->areaXMax))
+			break;
+
+		result = pjpeg_skip_mcu();
+		if (0 != result)
+			return result;
+
+		jpeg->blockX += 1;
+		if (jpeg->blockX == jpeg->blockWidth) {
+			jpeg->blockX = 0;
+			jpeg->blockY += 1;
+		}
+	}
+
+	result = pjpeg_decode_mcu();
+	if (0 != result)
+		return result;
+
+	*x = jpeg->blockX * jpeg->mcuWidth;
+	*y = jpeg->blockY * jpeg->mcuHeight;
+
 	if (jpeg->blockY == jpeg->blockYMax)
 		cb->h = jpeg->mcuHeightBottom;
 	else
@@ -224,9 +353,15 @@ void xs_JPEG_read(xsMachine *the)
 
 	(jpeg->convert)(jpeg, cb, (void *)jpeg->pixels);
 
-	xsResult = xsVar(1);
+	return 0;
 }
 
+/*
+	picojpeg leaves each block of the MCU at offset 64 * blockX + 128 * blockY, as rows of 8 bytes, with only the top-left
+	blockSize x blockSize pixels valid when scaled. grayscale is expanded to all three components.
+	each output row is converted as two contiguous runs, one from each block across, without per pixel branches.
+*/
+
 #if (kPocoPixelSize == 16) || (kPocoPixelSize == 8)
 
 #if kCommodettoBitmapGray256 == kPocoPixelFormat
@@ -241,78 +376,21 @@ void xs_JPEG_read(xsMachine *the)
 
 void convertto_16and8(JPEG jpeg, CommodettoBitmap cb, PocoPixel *pixels)
 {
-	int i;
-	int outWidth = cb->w;
-	int outHeight = cb->h;
-
-	if (PJPG_YH1V1 == jpeg->scanType) {
-		if (jpeg->mcuWidth == outWidth) {		// no horizontal clipping
-			int pixelCount;
-			for (i = 0, pixelCount = jpeg->mcuWidth * outHeight; i < pixelCount; i++)
-				*pixels++ =	makePixel(jpeg->r[i], jpeg->g[i], jpeg->b[i]);
-		}
-		else {									// horizontal clipping (right edge)
-			int x, y;
-			i = 0;
-			for (y = 0; y < outHeight; y++) {
-				for (x = 0; x < outWidth; x++, i++)
-					*pixels++ = makePixel(jpeg->r[i], jpeg->g[i], jpeg->b[i]);
-				i += jpeg->mcuWidth - outWidth;
-			}
-		}
-	}
-	else if (PJPG_YH2V2 == jpeg->scanType) {
-		unsigned char *r, *g, *b;
-		uint8_t jMaxLeft, jMaxRight;
-		int j;
-
-		if (jpeg->mcuWidth == outWidth) {
-			jMaxLeft = 8;
-			jMaxRight = 72;
-		}
-		else if (outWidth <= 8) {
-			jMaxLeft = outWidth;
-			jMaxRight = 0;
-		} else {
-			jMaxLeft = 8;
-			jMaxRight = 56 + outWidth;
-		}
+	int n = jpeg->blockSize, y;
+	int left = (cb->w < n) ? cb->w : n, right = cb->w - left;
 
-		r = jpeg->r, g = jpeg->g, b = jpeg->b;
-		for (i = (outHeight >= 8) ? 8 : outHeight; i > 0; i--, r += 8, g += 8, b += 8) {
-			for (j = 0; j < jMaxLeft; j++)
-				*pixels++ =	makePixel(r[j], g[j], b[j]);
-			for (j = 64; j < jMaxRight; j++)
-				*pixels++ =	makePixel(r[j], g[j], b[j]);
-		}
+	for (y = 0; y < cb->h; y++) {
+		int offset = ((y >= n) ? 128 : 0) + ((y & (n - 1)) << 3), i;
+		const unsigned char *r = jpeg->r + offset, *g = jpeg->g + offset, *b = jpeg->b + offset;
 
-		r = jpeg->r + 128, g = jpeg->g + 128, b = jpeg->b + 128;
-		for (i = (outHeight > 8) ? outHeight - 8 : 0; i > 0; i--, r += 8, g += 8, b += 8) {
-			for (j = 0; j < jMaxLeft; j++)
-				*pixels++ =	makePixel(r[j], g[j], b[j]);
-			for (j = 64; j < jMaxRight; j++)
-				*pixels++ =	makePixel(r[j], g[j], b[j]);
-		}
-	}
-	else if (PJPG_GRAYSCALE == jpeg->scanType) {
-		if (jpeg->mcuWidth == outWidth) {		// no horizontal clipping
-			int pixelCount;
-			for (i = 0, pixelCount = jpeg->mcuWidth * outHeight; i < pixelCount; i++) {
-				PocoPixel gray = ~jpeg->r[i];
-				*pixels++ = makePixel(gray, gray, gray);
-			}
-		}
-		else {									// horizontal clipping (right edge)
-			int x, y;
-			i = 0;
-			for (y = 0; y < outHeight; y++) {
-				for (x = 0; x < outWidth; x++, i++) {
-					PocoPixel gray = ~jpeg->r[i];
-					*pixels++ = makePixel(gray, gray, gray);
-				}
-				i += jpeg->mcuWidth - outWidth;
-			}
-		}
+		for (i = 0; i < left; i++)
+			pixels[i] = makePixel(r[i], g[i], b[i]);
+		pixels += left;
+
+		r += 64, g += 64, b += 64;
+		for (i = 0; i < right; i++)
+			pixels[i] = makePixel(r[i], g[i], b[i]);
+		pixels += right;
 	}
 }
 #endif
@@ -329,109 +407,22 @@ void convertto_16and8(JPEG jpeg, CommodettoBitmap cb, PocoPixel *pixels)
 
 void convertto_4(JPEG jpeg, CommodettoBitmap cb, PocoPixel *pixels)
 {
-	int i, pixelCount;
-	int outWidth = cb->w;
-	int outHeight = cb->h;
-
-	if (PJPG_YH1V1 == jpeg->scanType) {
-		if (jpeg->mcuWidth == outWidth) {		// no horizontal clipping
-			for (i = 0, pixelCount = jpeg->mcuWidth * outHeight; i < pixelCount; i += 2) {
-				*pixels++ = (makePixel(jpeg->r[i], jpeg->g[i], jpeg->b[i]) << 4) |
-							makePixel(jpeg->r[i + 1], jpeg->g[i + 1], jpeg->b[i + 1]);;
-			}
-		}
-		else {									// horizontal clipping (right edge)
-			int x, y;
-			i = 0;
-			for (y = 0; y < outHeight; y++) {
-				for (x = 0; x < outWidth; x += 2) {
-					if ((outWidth - x) >= 2) {
-						*pixels++ = (makePixel(jpeg->r[i], jpeg->g[i], jpeg->b[i]) << 4) |
-									makePixel(jpeg->r[i + 1], jpeg->g[i + 1], jpeg->b[i + 1]);;
-						i += 2;
-					}
-					else {
-						PocoPixel twoPixels = *pixels;
-						*pixels++ = (makePixel(jpeg->r[i], jpeg->g[i], jpeg->b[i]) << 4) | (twoPixels & 0x0F);
-						i += 1;
-					}
-				}
-				i += jpeg->mcuWidth - outWidth;
-			}
-		}
-	}
-	else if (PJPG_YH2V2 == jpeg->scanType) {
-		unsigned char *r, *g, *b;
-		uint8_t jMaxLeft, jMaxRight;
-		int j;
-
-		if (jpeg->mcuWidth == outWidth) {
-			jMaxLeft = 8;
-			jMaxRight = 72;
-		}
-		else if (outWidth <= 8) {
-			jMaxLeft = outWidth;
-			jMaxRight = 0;
-		} else {
-			jMaxLeft = 8;
-			jMaxRight = 56 + outWidth;
-		}
+	int n = jpeg->blockSize, y;
 
-		r = jpeg->r, g = jpeg->g, b = jpeg->b;
-		for (i = (outHeight >= 8) ? 8 : outHeight; i > 0; i--, r += 8, g += 8, b += 8) {
-			for (j = 0; j < jMaxLeft; j += 2)
-				*pixels++ = (makePixel(r[j], g[j], b[j]) << 4) |
-							makePixel(r[j + 1], g[j + 1], b[j + 1]);;
-			for (j = 64; j < jMaxRight; j += 2)
-				*pixels++ = (makePixel(r[j], g[j], b[j]) << 4) |
-							makePixel(r[j + 1], g[j + 1], b[j + 1]);;
-		}
+	for (y = 0; y < cb->h; y++) {
+		int offset = ((y >= n) ? 128 : 0) + ((y & (n - 1)) << 3), x;
 
-		r = jpeg->r + 128, g = jpeg->g + 128, b = jpeg->b + 128;
-		for (i = (outHeight > 8) ? outHeight - 8 : 0; i > 0; i--, r += 8, g += 8, b += 8) {
-			for (j = 0; j < jMaxLeft; j += 2)
-				*pixels++ = (makePixel(r[j], g[j], b[j]) << 4) |
-							makePixel(r[j + 1], g[j + 1], b[j + 1]);;
-			for (j = 64; j < jMaxRight; j += 2)
-				*pixels++ = (makePixel(r[j], g[j], b[j]) << 4) |
-							makePixel(r[j + 1], g[j + 1], b[j + 1]);;
-		}
-	}
-	else if (PJPG_GRAYSCALE == jpeg->scanType) {
-		if (jpeg->mcuWidth == outWidth) {		// no horizontal clipping
-			for (i = 0, pixelCount = jpeg->mcuWidth * outHeight; i < pixelCount; i += 2) {
-				PocoPixel twoPixels;
-				PocoPixel gray = ~jpeg->r[i];
-				twoPixels = makePixel(gray, gray, gray) << 4;
-				gray = ~jpeg->r[i + 1];
-				twoPixels |= makePixel(gray, gray, gray);
-				*pixels++ = twoPixels;
-			}
-		}
-		else {									// horizontal clipping (right edge)
-			int x, y;
-			i = 0;
-			for (y = 0; y < outHeight; y++) {
-				for (x = 0; x < outWidth; x += 2, i += 2) {
-					if ((outWidth - x) >= 2) {
-						PocoPixel twoPixels = *pixels;
-						PocoPixel gray = ~jpeg->r[i];
-						twoPixels = makePixel(gray, gray, gray) << 4;
-						gray = ~jpeg->r[i + 1];
-						twoPixels |= makePixel(gray, gray, gray);
-						*pixels ++ = twoPixels;
-						i += 2;
-					}
-					else {
-						PocoPixel twoPixels = *pixels;
-						PocoPixel gray = ~jpeg->r[i];
-						*pixels++ = (makePixel(gray, gray, gray) >> 4) | (twoPixels & 0x0F);
-						i += 1;
-				}
-				}
-				i += jpeg->mcuWidth - outWidth;
-			}
+		for (x = 0; x < cb->w; x++) {
+			int i = offset + ((x < n) ? x : (x + 64 - n));
+			PocoPixel pixel = makePixel(jpeg->r[i], jpeg->g[i], jpeg->b[i]);
+
+			if (x & 1)
+				*pixels++ |= pixel;
+			else
+				*pixels = pixel << 4;
 		}
+		if (cb->w & 1)
+			pixels++;
 	}
 }
 #endif
@@ -439,97 +430,24 @@ void convertto_4(JPEG jpeg, CommodettoBitmap cb, PocoPixel *pixels)
 void convertto_24(JPEG jpeg, CommodettoBitmap cb, PocoPixel *pixelsIn)
 {
 	uint8_t *pixels = (uint8_t *)pixelsIn;
-	int i, pixelCount;
-	int outWidth = cb->w;
-	int outHeight = cb->h;
-
-	if (PJPG_YH1V1 == jpeg->scanType) {
-		if (jpeg->mcuWidth == outWidth) {		// no horizontal clipping
-			for (i = 0, pixelCount = jpeg->mcuWidth * outHeight; i < pixelCount; i++, pixels += 3) {
-				pixels[0] = jpeg->r[i];
-				pixels[1] = jpeg->g[i];
-				pixels[2] = jpeg->b[i];
-			}
-		}
-		else {									// horizontal clipping (right edge)
-			int x, y;
-			i = 0;
-			for (y = 0; y < outHeight; y++) {
-				for (x = 0; x < outWidth; x++, i++, pixels += 3) {
-					pixels[0] = jpeg->r[i];
-					pixels[1] = jpeg->g[i];
-					pixels[2] = jpeg->b[i];
-				}
-				i += jpeg->mcuWidth - outWidth;
-			}
-		}
-	}
-	else if (PJPG_YH2V2 == jpeg->scanType) {
-		unsigned char *r, *g, *b;
-		uint8_t jMaxLeft, jMaxRight;
-		int j;
-
-		if (jpeg->mcuWidth == outWidth) {
-			jMaxLeft = 8;
-			jMaxRight = 72;
-		}
-		else if (outWidth <= 8) {
-			jMaxLeft = outWidth;
-			jMaxRight = 0;
-		} else {
-			jMaxLeft = 8;
-			jMaxRight = 56 + outWidth;
-		}
+	int n = jpeg->blockSize, y;
+	int left = (cb->w < n) ? cb->w : n, right = cb->w - left;
 
-		r = jpeg->r, g = jpeg->g, b = jpeg->b;
-		for (i = (outHeight >= 8) ? 8 : outHeight; i > 0; i--, r += 8, g += 8, b += 8) {
-			for (j = 0; j < jMaxLeft; j++, pixels += 3) {
-				pixels[0] = r[j];
-				pixels[1] = g[j];
-				pixels[2] = b[j];
-			}
-			for (j = 64; j < jMaxRight; j++, pixels += 3) {
-				pixels[0] = r[j];
-				pixels[1] = g[j];
-				pixels[2] = b[j];
-			}
-		}
+	for (y = 0; y < cb->h; y++) {
+		int offset = ((y >= n) ? 128 : 0) + ((y & (n - 1)) << 3), i;
+		const unsigned char *r = jpeg->r + offset, *g = jpeg->g + offset, *b = jpeg->b + offset;
 
-		r = jpeg->r + 128, g = jpeg->g + 128, b = jpeg->b + 128;
-		for (i = (outHeight > 8) ? outHeight - 8 : 0; i > 0; i--, r += 8, g += 8, b += 8) {
-			for (j = 0; j < jMaxLeft; j++, pixels += 3) {
-				pixels[0] = r[j];
-				pixels[1] = g[j];
-				pixels[2] = b[j];
-			}
-			for (j = 64; j < jMaxRight; j++, pixels += 3) {
-				pixels[0] = r[j];
-				pixels[1] = g[j];
-				pixels[2] = b[j];
-			}
+		for (i = 0; i < left; i++, pixels += 3) {
+			pixels[0] = r[i];
+			pixels[1] = g[i];
+			pixels[2] = b[i];
 		}
-	}
-	else if (PJPG_GRAYSCALE == jpeg->scanType) {
-		if (jpeg->mcuWidth == outWidth) {		// no horizontal clipping
-			for (i = 0, pixelCount = jpeg->mcuWidth * outHeight; i < pixelCount; i++, pixels += 3) {
-				uint8_t gray = ~jpeg->r[i];
-				pixels[0] = gray;
-				pixels[1] = gray;
-				pixels[2] = gray;
-			}
-		}
-		else {									// horizontal clipping (right edge)
-			int x, y;
-			i = 0;
-			for (y = 0; y < outHeight; y++) {
-				for (x = 0; x < outWidth; x++, i++, pixels += 3) {
-					uint8_t gray = ~jpeg->r[i];
-					pixels[0] = gray;
-					pixels[1] = gray;
-					pixels[2] = gray;
-				}
-				i += jpeg->mcuWidth - outWidth;
-			}
+
+		r += 64, g += 64, b += 64;
+		for (i = 0; i < right; i++, pixels += 3) {
+			pixels[0] = r[i];
+			pixels[1] = g[i];
+			pixels[2] = b[i];
 		}
 	}
 }
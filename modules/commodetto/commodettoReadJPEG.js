@@ -24,6 +24,7 @@
 		
 		Pull model - returns block of pixels on each call to read
 		Uses picojpeg decoder
+		Optional scale (1/2, 1/4, 1/8) and area (in scaled coordinates) in dictionary
 
 	To do:
 
@@ -45,7 +46,16 @@ export default class JPEG @ "xs_JPEG_destructor" {
 		let Poco = require("Poco");
 		let jpeg = new JPEG(data, dictionary);
 
-		let offscreen = new BufferOut({width: jpeg.width, height: jpeg.height, pixelFormat: jpeg.bitmap.pixelFormat});
+		let x = 0, y = 0, width = jpeg.width, height = jpeg.height;
+		if (dictionary && dictionary.area) {
+			let area = dictionary.area;
+			x = Math.max(area.x, 0);
+			y = Math.max(area.y, 0);
+			width = Math.min(area.x + area.width, width) - x;
+			height = Math.min(area.y + area.height, height) - y;
+		}
+
+		let offscreen = new BufferOut({width, height, pixelFormat: jpeg.bitmap.pixelFormat});
 		let render = new Poco(offscreen);
 
 		while (true) {
@@ -53,8 +63,8 @@ export default class JPEG @ "xs_JPEG_destructor" {
 			if (!block)
 				break;
 
-			render.begin(block.x, block.y, block.width, block.height);
-				render.drawBitmap(block, block.x, block.y);
+			render.begin(block.x - x, block.y - y, block.width, block.height);
+				render.drawBitmap(block, block.x - x, block.y - y);
 			render.end();
 		}
 
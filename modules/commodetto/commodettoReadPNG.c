@@ -22,8 +22,8 @@
 /*
 	Commodetto readPNG
 
-		no interlace
 		no 16-bit channels
+		interlaced images are decoded to a full image of scan lines
 
 	To do:
 
@@ -34,6 +34,8 @@
 		Modeled on FskPngDecode.c (Apache License, Marvell Semiconductor)
 */
 
+#include "string.h"
+
 #include "xs.h"
 #include "mc.xs.h"			// for xsID_ values
 
@@ -41,6 +43,7 @@
 #include "miniz.c"
 
 #include "commodettoPocoBlit.h"
+#include "commodettoConvert.h"
 
 #if defined(__GNUC__) /* GCC */
 	#pragma GCC diagnostic ignored "-Wmultichar"
@@ -54,14 +57,19 @@ typedef struct {
 	xsSlot			data;
 	int				byteLength;
 	int				idatBytes;
+	int				dataLength;
+	int				idatStart;			// first IDAT, to rewind
+	int				idatStartBytes;
 
 	int				width;
 	int				height;
-	int				row;
+	int				row;				// next row to decode
 	mz_ulong		scanLineByteCount;
 	uint8_t			channelCount;
 	uint8_t			bitDepth;
+	uint8_t			bitsPerPixel;
 	uint8_t			filterBytesPerPixel;
+	uint8_t			interlaced;
 
 	uint8_t			zlibInited;
 
@@ -71,9 +79,31 @@ typedef struct {
 	unsigned char	*scanLine;
 	unsigned char	*prevScanLine;
 
+	unsigned char	*image;				// interlaced only. scan lines of the full image
+	unsigned char	*drawBuffer;
+
 	z_stream		zlib;
 } PNGRecord, *PNG;
 
+typedef struct {
+	PNG							png;
+	const unsigned char			*bytes;
+	const unsigned char			*palette;
+	CommodettoConverter			converter;
+	void						*clut;
+	PocoDimension				sx;
+	PocoDimension				sy;
+} PNGDrawRecord, *PNGDraw;
+
+static const char *pngHeader(PNG png, const unsigned char *ihdr);
+static int pngRewind(PNG png);
+static int pngInflate(PNG png, const unsigned char *bytes, unsigned char *out, uint32_t count);
+static unsigned char *pngNextRow(PNG png, const unsigned char *bytes, uint32_t byteCount);
+static const unsigned char *pngGetRow(PNG png, const unsigned char *bytes, int row);
+static int pngDeinterlace(PNG png, const unsigned char *bytes);
+static const unsigned char *pngGetBytes(xsMachine *the, PNG png);
+static void pngRender(Poco poco, uint8_t *data, PocoPixel *dst, PocoDimension sx, PocoDimension sy, PocoDimension w, PocoDimension h, uint8_t xphase);
+
 static void *zAlloc(void *opaque, size_t items, size_t size)
 {
 	return malloc(items * size);
@@ -95,6 +125,14 @@ void pngClose(PNG png)
 		free(png->scanBuffers);
 		png->scanBuffers = NULL;
 	}
+	if (png->image) {
+		free(png->image);
+		png->image = NULL;
+	}
+	if (png->drawBuffer) {
+		free(png->drawBuffer);
+		png->drawBuffer = NULL;
+	}
 }
 
 void xs_PNG_destructor(void *data)
@@ -117,6 +155,32 @@ static void emptyFilter(uint8_t *pix, uint8_t* prev, uint32_t width, uint8_t bpp
 
 static void subFilter(uint8_t *pix, uint8_t* prev, uint32_t width, uint8_t bpp)
 {
+	if (4 == bpp) {
+		uint8_t r = 0, g = 0, b = 0, a = 0;
+		for (; width >= 4; width -= 4, pix += 4) {
+			pix[0] = r += pix[0];
+			pix[1] = g += pix[1];
+			pix[2] = b += pix[2];
+			pix[3] = a += pix[3];
+		}
+	}
+	else if (3 == bpp) {
+		uint8_t r = 0, g = 0, b = 0;
+		for (; width >= 3; width -= 3, pix += 3) {
+			pix[0] = r += pix[0];
+			pix[1] = g += pix[1];
+			pix[2] = b += pix[2];
+		}
+	}
+	else if (1 == bpp) {
+		uint8_t v = 0;
+		while (width--) {
+			v += *pix;
+			*pix++ = v;
+		}
+		return;
+	}
+
 	prev = pix - bpp;
 	while (width--)
 		*pix++ += *prev++;
@@ -124,6 +188,17 @@ static void subFilter(uint8_t *pix, uint8_t* prev, uint32_t width, uint8_t bpp)
 
 static void upFilter(uint8_t *pix, uint8_t* prev, uint32_t width, uint8_t bpp)
 {
+	if (!(3 & ((uintptr_t)pix | (uintptr_t)prev))) {
+		// four bytes at a time, without carries between bytes
+		uint32_t *p = (uint32_t *)pix, *q = (uint32_t *)prev;
+		for (; width >= 4; width -= 4) {
+			uint32_t x = *p, y = *q++;
+			*p++ = ((x & 0x7F7F7F7F) + (y & 0x7F7F7F7F)) ^ ((x ^ y) & 0x80808080);
+		}
+		pix = (uint8_t *)p;
+		prev = (uint8_t *)q;
+	}
+
 	while (width--)
 		*pix++ += *prev++;
 }
@@ -137,9 +212,15 @@ static void averageFilter(uint8_t *pix, uint8_t *prev, uint32_t width, uint8_t b
 
 static void paethFilter(uint8_t *pix, uint8_t *prev, uint32_t width, uint8_t bpp)
 {
-	unsigned char *prior = pix - bpp;
-	unsigned char *prevPrior = prev - bpp;
+	unsigned char *prior, *prevPrior;
+	uint32_t i;
 
+	// no pixel to the left, so the predictor is the pixel above
+	for (i = 0; (i < bpp) && width; i++, width--)
+		*pix++ += *prev++;
+
+	prior = pix - bpp;
+	prevPrior = prev - bpp;
 	while (width--) {
 		int16_t a = *prior++;
 		int16_t b = *prev++;
@@ -177,7 +258,6 @@ void xs_PNG_constructor(xsMachine *the)
 	PNG png;
 	const unsigned char *pngBytes, *pngBytesInitial;
 	int tagCount = 0;
-	int8_t colorType, compressionMethod, filterMethod, interlaceMethod, bitsPerPixel;
 
 	png = calloc(1, sizeof(PNGRecord));
 	if (!png)
@@ -196,6 +276,7 @@ void xs_PNG_constructor(xsMachine *the)
 
 	xsVar(0) = xsGet(xsArg(0), xsID_byteLength);
 	png->byteLength = xsToInteger(xsVar(0));
+	png->dataLength = png->byteLength;
 
 	if ((0x89 != pngBytes[0]) || (0x50 != pngBytes[1]) || (0x4e != pngBytes[2]) || (0x47 != pngBytes[3]) ||
 		(0x0d != pngBytes[4]) || (0x0a != pngBytes[5]) || (0x1a != pngBytes[6]) || (0x0a != pngBytes[7]))
@@ -225,55 +306,11 @@ void xs_PNG_constructor(xsMachine *the)
 		}
 
 		switch (tag) {
-			case 'IHDR':
-				png->width = (pngBytes[0] << 24) | (pngBytes[1] << 16) | (pngBytes[2] << 8) | pngBytes[3];
-				png->height = (pngBytes[4] << 24) | (pngBytes[5] << 16) | (pngBytes[6] << 8) | pngBytes[7];
-
-				png->bitDepth = pngBytes[8];
-				colorType = pngBytes[9];
-				compressionMethod = pngBytes[10];
-				filterMethod = pngBytes[11];
-				interlaceMethod = pngBytes[12];
-
-				// check for undefined values
-				if ((compressionMethod != 0) || (filterMethod != 0) || (interlaceMethod != 0))
-					xsErrorPrintf("invalid compresson, filter, or interlace method");
-
-				// sort ouf the bitmap format
-				if (6 == colorType)
-					png->channelCount = 4;
-				else if (2 == colorType)
-					png->channelCount = 3;
-				else if (3 == colorType)
-					png->channelCount = 1;
-				else if (0 == colorType)
-					png->channelCount = 1;
-				else if (4 == colorType)
-					png->channelCount = 2;
-				bitsPerPixel = png->channelCount * png->bitDepth;
-				png->filterBytesPerPixel = (bitsPerPixel + 7) >> 3;
-
-				//@@ check for supported combinations
-
-				png->scanLineByteCount = (png->width * bitsPerPixel + 7) >> 3;
-				png->scanBuffers = malloc((png->scanLineByteCount + kScanLineSlop) * 2);
-				if (!png->scanBuffers)
-					xsErrorPrintf("no memory for scan line buffers");
-
-				png->scanLine = png->scanBuffers;
-				png->prevScanLine = png->scanBuffers + (png->scanLineByteCount + kScanLineSlop);
-#if 4 == kScanLineSlop
-				*(uint32_t *)png->scanLine = 0;
-				*(uint32_t *)png->prevScanLine = 0;
-#else
-				need to implement clear of kScanLineSlop
-#endif
-
-				png->zlib.zalloc = zAlloc;
-				png->zlib.zfree = zFree;
-				if (Z_OK != inflateInit2(&png->zlib, 15))		//@@ FskPNGDecode uses -15. which fails here. 15 works. why?
-					xsErrorPrintf("can't init zlib");
-				png->zlibInited = 1;
+			case 'IHDR': {
+				const char *error = pngHeader(png, pngBytes);
+				if (error)
+					xsErrorPrintf(error);
+				}
 				break;
 
 			case 'PLTE': {
@@ -313,8 +350,8 @@ void xs_PNG_constructor(xsMachine *the)
 				break;
 
 			case 'IDAT':
-				png->idatBytes = tagLen;
-				png->byteOffset = pngBytes - pngBytesInitial;
+				png->idatBytes = png->idatStartBytes = tagLen;
+				png->byteOffset = png->idatStart = pngBytes - pngBytesInitial;
 
 				xsVar(1) = xsNewHostObject(scanDestructor);
 				xsVar(0) = xsInteger(png->scanLineByteCount);
@@ -330,72 +367,420 @@ void xs_PNG_constructor(xsMachine *the)
 	}
 }
 
+/*
+	set up decoding from the IHDR chunk. returns an error message, or NULL.
+*/
+
+const char *pngHeader(PNG png, const unsigned char *ihdr)
+{
+	int8_t colorType, compressionMethod, filterMethod, interlaceMethod, bitsPerPixel;
+
+	png->width = (ihdr[0] << 24) | (ihdr[1] << 16) | (ihdr[2] << 8) | ihdr[3];
+	png->height = (ihdr[4] << 24) | (ihdr[5] << 16) | (ihdr[6] << 8) | ihdr[7];
+
+	png->bitDepth = ihdr[8];
+	colorType = ihdr[9];
+	compressionMethod = ihdr[10];
+	filterMethod = ihdr[11];
+	interlaceMethod = ihdr[12];
+
+	// check for undefined values
+	if ((compressionMethod != 0) || (filterMethod != 0) || ((interlaceMethod != 0) && (interlaceMethod != 1)))
+		return "invalid compresson, filter, or interlace method";
+	png->interlaced = interlaceMethod;
+
+	// sort ouf the bitmap format
+	if (6 == colorType)
+		png->channelCount = 4;
+	else if (2 == colorType)
+		png->channelCount = 3;
+	else if (3 == colorType)
+		png->channelCount = 1;
+	else if (0 == colorType)
+		png->channelCount = 1;
+	else if (4 == colorType)
+		png->channelCount = 2;
+	bitsPerPixel = png->channelCount * png->bitDepth;
+	png->bitsPerPixel = bitsPerPixel;
+	png->filterBytesPerPixel = (bitsPerPixel + 7) >> 3;
+
+	//@@ check for supported combinations
+
+	png->scanLineByteCount = (png->width * bitsPerPixel + 7) >> 3;
+	png->scanBuffers = calloc(2, (png->scanLineByteCount + kScanLineSlop + 3) & ~3);		// zero, as the row above the first
+	if (!png->scanBuffers)
+		return "no memory for scan line buffers";
+
+	png->scanLine = png->scanBuffers;
+	png->prevScanLine = png->scanBuffers + ((png->scanLineByteCount + kScanLineSlop + 3) & ~3);
+
+	png->zlib.zalloc = zAlloc;
+	png->zlib.zfree = zFree;
+	if (Z_OK != inflateInit2(&png->zlib, 15))		//@@ FskPNGDecode uses -15. which fails here. 15 works. why?
+		return "can't init zlib";
+	png->zlibInited = 1;
+
+	return NULL;
+}
+
 void xs_PNG_read(xsMachine *the)
 {
 	PNG png = xsGetHostData(xsThis);
-	const unsigned char *pngBytes, *pngBytesInitial;
-	unsigned char *swap;
-	int result;
-	uint8_t filter;
+	const unsigned char *bytes, *scanLine;
 
-	if (png->row++ >= png->height)
+	if (png->row >= png->height)
 		return;
 
-	// refresh source data pointer
-	if (xsIsInstanceOf(png->data, xsArrayBufferPrototype))
-		pngBytesInitial = xsToArrayBuffer(png->data);
+	bytes = pngGetBytes(the, png);
+	if (png->interlaced && !png->image && pngDeinterlace(png, bytes))
+		xsErrorPrintf("bad zlib data");
+
+	scanLine = pngGetRow(png, bytes, png->row);
+	if (!scanLine)
+		xsErrorPrintf("bad zlib data");
+	if (png->interlaced)
+		png->row += 1;
+
+	// return a scan line of data
+	xsResult = xsGet(xsThis, xsID_data);
+	xsSetHostData(png->scanLineSlot, (void *)scanLine);
+}
+
+void xs_PNG_draw(xsMachine *the)
+{
+	PNG png = xsGetHostData(xsThis);
+	Poco poco = (Poco)((char *)xsGetHostData(xsArg(0)) - offsetof(PocoRecord, pixels));
+	int argc = xsToInteger(xsArgc);
+	PocoCoordinate x = (PocoCoordinate)xsToInteger(xsArg(1)) + poco->xOrigin;
+	PocoCoordinate y = (PocoCoordinate)xsToInteger(xsArg(2)) + poco->yOrigin;
+	PocoDimension sx = 0, sy = 0, sw = png->width, sh = png->height;
+	CommodettoBitmapFormat srcFormat;
+	PNGDrawRecord draw;
+
+	xsVars(1);
+
+	if (argc > 3) {
+		sx = (PocoDimension)xsToInteger(xsArg(3));
+		sy = (PocoDimension)xsToInteger(xsArg(4));
+		sw = (PocoDimension)xsToInteger(xsArg(5));
+		sh = (PocoDimension)xsToInteger(xsArg(6));
+	}
+	if ((sx >= png->width) || (sy >= png->height))
+		return;
+	if ((sx + sw) > png->width)
+		sw = png->width - sx;
+	if ((sy + sh) > png->height)
+		sh = png->height - sy;
+
+#if 0 != kPocoRotation
+	xsErrorPrintf("PNG draw requires rotation 0");
+#endif
+
+	draw.palette = NULL;
+	xsVar(0) = xsGet(xsThis, xsID_palette);
+	if (8 != png->bitDepth)
+		srcFormat = 0;
+	else if (3 == png->channelCount)
+		srcFormat = kCommodettoBitmap24RGB;
+	else if (4 == png->channelCount)
+		srcFormat = kCommodettoBitmap32RGBA;
+	else if ((1 == png->channelCount) && xsTest(xsVar(0))) {
+		srcFormat = kCommodettoBitmap32RGBA;
+		draw.palette = xsToArrayBuffer(xsVar(0));
+	}
+	else if (1 == png->channelCount)
+		srcFormat = kCommodettoBitmapGray256;
 	else
-		pngBytesInitial = xsGetHostData(png->data);
-	pngBytes = pngBytesInitial + png->byteOffset;
+		srcFormat = 0;
+
+	draw.converter = srcFormat ? CommodettoPixelsConverterGet(srcFormat, kPocoPixelFormat) : NULL;
+	if (!draw.converter)
+		xsErrorPrintf("PNG variant not supported for draw");
+
+	if (!png->drawBuffer) {
+		png->drawBuffer = malloc((png->width * 4) + ((png->width + 1) >> 1) + 4);		// palette expanded to RGBA, and 4-bit pixels
+		if (!png->drawBuffer)
+			xsErrorPrintf("no memory for PNG draw");
+	}
+
+	draw.png = png;
+	draw.bytes = pngGetBytes(the, png);
+	if (png->interlaced && !png->image && pngDeinterlace(png, draw.bytes))
+		xsErrorPrintf("bad zlib data");
 
-	// decompress another scan line
-	png->zlib.next_out	= png->scanLine + kScanLineSlop - 1;
-	png->zlib.avail_out	= png->scanLineByteCount + 1;
-	png->zlib.total_out	= 0;
+	// the display list refers to the data until rendering is done
+	if (draw.palette || xsIsInstanceOf(png->data, xsArrayBufferPrototype)) {
+		if (!(poco->flags & kPocoFlagGCDisabled)) {
+			poco->flags |= kPocoFlagGCDisabled;
+			xsEnableGarbageCollection(0);
+		}
+	}
+
+#if kPocoPixelFormat == kCommodettoBitmapCLUT16
+	draw.clut = poco->clut;
+#else
+	draw.clut = NULL;
+#endif
+	draw.sx = sx;
+	draw.sy = sy;
+
+	PocoDrawExternal(poco, pngRender, (uint8_t *)&draw, sizeof(draw), x, y, sw, sh);
+}
+
+/*
+	decode rows for the external renderer. runs while rendering, so it reports errors by leaving the pixels undrawn.
+*/
+
+void pngRender(Poco poco, uint8_t *data, PocoPixel *dst, PocoDimension sx, PocoDimension sy, PocoDimension w, PocoDimension h, uint8_t xphase)
+{
+	PNGDrawRecord draw;
+	PNG png;
+	uint8_t bytesPerPixel;
+
+	memcpy(&draw, data, sizeof(draw));
+	png = draw.png;
+	sx += draw.sx;
+	sy += draw.sy;
+	bytesPerPixel = draw.palette ? 1 : png->channelCount;
+
+	while (h--) {
+		const unsigned char *src = pngGetRow(png, draw.bytes, sy++);
+		unsigned char *out;
+
+		if (!src)
+			return;
+		src += sx * bytesPerPixel;
+
+		if (draw.palette) {
+			uint32_t *expand = (uint32_t *)png->drawBuffer;
+			PocoDimension i;
+
+			for (i = 0; i < w; i++)
+				memcpy(&expand[i], draw.palette + (src[i] << 2), 4);
+			src = png->drawBuffer;
+		}
+
+#if 4 != kPocoPixelSize
+		out = (unsigned char *)dst;
+		(draw.converter)(w, (void *)src, out, draw.clut);
+#else
+		out = png->drawBuffer + (png->width * 4);
+		(draw.converter)(w, (void *)src, out, draw.clut);
+		{
+			// converters output the first pixel in the high nybble
+			unsigned char *d = (unsigned char *)dst;
+			uint8_t phase = xphase;
+			PocoDimension i;
+
+			for (i = 0; i < w; i++) {
+				uint8_t pixel = (i & 1) ? (out[i >> 1] & 0x0F) : (out[i >> 1] >> 4);
+				if (phase) {
+					*d = (*d & ~kPocoPixels4SecondMask) | (pixel << kPocoPixels4SecondShift);
+					d++;
+				}
+				else
+					*d = (*d & ~kPocoPixels4FirstMask) | (pixel << kPocoPixels4FirstShift);
+				phase ^= 1;
+			}
+		}
+#endif
+
+		dst = (PocoPixel *)(poco->rowBytes + (char *)dst);
+	}
+}
+
+const unsigned char *pngGetBytes(xsMachine *the, PNG png)
+{
+	if (xsIsInstanceOf(png->data, xsArrayBufferPrototype))
+		return xsToArrayBuffer(png->data);
+	return xsGetHostData(png->data);
+}
+
+/*
+	returns a decoded scan line. rows are decoded in order, so an earlier row than the last one rewinds to the first IDAT.
+*/
+
+const unsigned char *pngGetRow(PNG png, const unsigned char *bytes, int row)
+{
+	if ((row < 0) || (row >= png->height))
+		return NULL;
+
+	if (png->interlaced)
+		return png->image ? (png->image + (row * png->scanLineByteCount)) : NULL;
+
+	if (row == (png->row - 1))
+		return png->prevScanLine + kScanLineSlop;		// most recently decoded
+
+	if ((row < png->row) && pngRewind(png))
+		return NULL;
+
+	while (png->row < row) {
+		if (!pngNextRow(png, bytes, png->scanLineByteCount))
+			return NULL;
+	}
+
+	return pngNextRow(png, bytes, png->scanLineByteCount);
+}
+
+int pngRewind(PNG png)
+{
+	if (png->zlibInited) {
+		inflateEnd(&png->zlib);
+		png->zlibInited = 0;
+	}
+	memset(&png->zlib, 0, sizeof(png->zlib));
+	png->zlib.zalloc = zAlloc;
+	png->zlib.zfree = zFree;
+	if (Z_OK != inflateInit2(&png->zlib, 15))
+		return -1;
+	png->zlibInited = 1;
+
+	png->byteOffset = png->idatStart;
+	png->idatBytes = png->idatStartBytes;
+	png->row = 0;
+	memset(png->prevScanLine, 0, png->scanLineByteCount + kScanLineSlop);
+
+	return 0;
+}
+
+int pngInflate(PNG png, const unsigned char *bytes, unsigned char *out, uint32_t count)
+{
+	const unsigned char *pngBytes = bytes + png->byteOffset;
+	int result;
+
+	png->zlib.next_out	= out;
+	png->zlib.avail_out	= count;
+
+	while (png->zlib.avail_out) {
+		uint32_t avail = png->zlib.avail_out;
+
+		while ((png->idatBytes <= 0) && (((pngBytes - bytes) + 12) <= png->dataLength)) {
+			// look for next IDAT (required to be consecutive). if there is none, inflate only flushes what it holds.
+			uint32_t tag = (pngBytes[8] << 24) | (pngBytes[9] << 16) | (pngBytes[10] << 8) | pngBytes[11];
+			int tagLen = (pngBytes[4] << 24) | (pngBytes[5] << 16) | (pngBytes[6] << 8) | pngBytes[7];
+			if ('IDAT' != tag)
+				break;
+			if ((tagLen < 0) || (((pngBytes - bytes) + 12 + tagLen + 4) > png->dataLength))		// inflate may read ahead into the CRC
+				return -1;
+			png->idatBytes = tagLen;
+			pngBytes += 12;
+		}
 
-	do {
 		png->zlib.next_in = pngBytes;
-		png->zlib.avail_in = png->idatBytes;
+		png->zlib.avail_in = (png->idatBytes > 0) ? png->idatBytes : 0;
 		png->zlib.total_in = 0;
 
 		result = inflate(&png->zlib, Z_PARTIAL_FLUSH);
-		if ((Z_OK != result) && (Z_STREAM_END != result)) {
-			if (Z_DATA_ERROR == result)
-				xsErrorPrintf("bad zlib data");
-		}
+		if ((Z_OK != result) && (Z_STREAM_END != result) && (Z_BUF_ERROR != result))
+			return -1;
 
 		pngBytes += png->zlib.total_in;
 		png->idatBytes -= png->zlib.total_in;
-		if (png->idatBytes <= 0) {
-			// look for next IDAT (required to be consecutive)
-			uint32_t tag;
-
-			tag = (pngBytes[8] << 24) | (pngBytes[9] << 16) | (pngBytes[10] << 8) | pngBytes[11];
-			if ('IDAT' == tag) {
-				png->idatBytes = (pngBytes[4] << 24) | (pngBytes[5] << 16) | (pngBytes[6] << 8) | pngBytes[7];
-				pngBytes += 12;
-			}
-		}
-	} while (png->zlib.total_out != (png->scanLineByteCount + 1));
+
+		if ((avail == png->zlib.avail_out) && (0 == png->zlib.total_in))
+			return -1;		// no progress, so the data is truncated
+	}
+
+	// update source data offset
+	png->byteOffset = pngBytes - bytes;
+
+	return 0;
+}
+
+/*
+	decompress and filter the next scan line of byteCount bytes. returns the scan line, which stays valid until the next one is decoded.
+*/
+
+unsigned char *pngNextRow(PNG png, const unsigned char *bytes, uint32_t byteCount)
+{
+	unsigned char *swap;
+	uint8_t filter;
+
+	if (pngInflate(png, bytes, png->scanLine + kScanLineSlop - 1, byteCount + 1))
+		return NULL;
 
 	// filter scan line
 	filter = png->scanLine[kScanLineSlop - 1];
 	if (filter > 4)
-		xsErrorPrintf("invalid scan line filter");
+		return NULL;
 	png->scanLine[kScanLineSlop - 1] = 0;
-	gFilters[filter](png->scanLine + kScanLineSlop, png->prevScanLine + kScanLineSlop, png->scanLineByteCount, png->filterBytesPerPixel);
-
-	// return a scan line of data
-	xsResult = xsGet(xsThis, xsID_data);
-	xsSetHostData(png->scanLineSlot, png->scanLine + kScanLineSlop);
+	gFilters[filter](png->scanLine + kScanLineSlop, png->prevScanLine + kScanLineSlop, byteCount, png->filterBytesPerPixel);
 
 	// swap previous and current scan line buffers
 	swap = png->prevScanLine;
 	png->prevScanLine = png->scanLine;
 	png->scanLine = swap;
+	png->row += 1;
 
-	// update source data offset
-	png->byteOffset = pngBytes - pngBytesInitial;
+	return png->prevScanLine + kScanLineSlop;
+}
+
+/*
+	decode the seven Adam7 passes into a full image of scan lines
+*/
+
+static const uint8_t gAdam7[7][4] = {		// x, y, dx, dy
+	{0, 0, 8, 8},
+	{4, 0, 8, 8},
+	{0, 4, 4, 8},
+	{2, 0, 4, 4},
+	{0, 2, 2, 4},
+	{1, 0, 2, 2},
+	{0, 1, 1, 2}
+};
+
+int pngDeinterlace(PNG png, const unsigned char *bytes)
+{
+	uint8_t bitsPerPixel = png->bitsPerPixel, pass;
+
+	png->image = calloc(png->height, png->scanLineByteCount);
+	if (!png->image)
+		return -1;
+
+	if (pngRewind(png))
+		goto bail;
+
+	for (pass = 0; pass < 7; pass++) {
+		int x0 = gAdam7[pass][0], y0 = gAdam7[pass][1], dx = gAdam7[pass][2], dy = gAdam7[pass][3];
+		int w = (png->width > x0) ? ((png->width - x0 + dx - 1) / dx) : 0;
+		int h = (png->height > y0) ? ((png->height - y0 + dy - 1) / dy) : 0;
+		int y;
+
+		if (!w || !h)
+			continue;
+
+		memset(png->prevScanLine, 0, png->scanLineByteCount + kScanLineSlop);		// each pass starts without a row above
+		for (y = y0; y < png->height; y += dy) {
+			const unsigned char *src = pngNextRow(png, bytes, ((w * bitsPerPixel) + 7) >> 3);
+			unsigned char *dst = png->image + (y * png->scanLineByteCount);
+			int i, x;
+
+			if (!src)
+				goto bail;
+
+			if (bitsPerPixel >= 8) {
+				uint8_t bytesPerPixel = bitsPerPixel >> 3;
+				for (i = 0, x = x0; i < w; i++, x += dx, src += bytesPerPixel)
+					memcpy(dst + (x * bytesPerPixel), src, bytesPerPixel);
+			}
+			else {
+				uint8_t mask = (1 << bitsPerPixel) - 1;
+				for (i = 0, x = x0; i < w; i++, x += dx) {
+					int from = i * bitsPerPixel, to = x * bitsPerPixel;
+					uint8_t pixel = (src[from >> 3] >> (8 - bitsPerPixel - (from & 7))) & mask;
+					dst[to >> 3] |= pixel << (8 - bitsPerPixel - (to & 7));
+				}
+			}
+		}
+	}
+
+	png->row = 0;
+	return 0;
+
+bail:
+	free(png->image);
+	png->image = NULL;
+	return -1;
 }
 
 void xs_PNG_get_width(xsMachine *the)
@@ -47,6 +47,7 @@ import Converter from "commodetto/Convert";
 export default class PNG @ "xs_PNG_destructor" {
 	constructor(buffer) @ "xs_PNG_constructor"
 	read() @ "xs_PNG_read"
+	draw(poco, x, y, sx, sy, sw, sh) @ "xs_PNG_draw"
 
 	get width() @ "xs_PNG_get_width"
 	get height() @ "xs_PNG_get_height"
@@ -1904,17 +1904,162 @@ static void transformBlock(uint8 mcuBlock)
    }      
 }
 //------------------------------------------------------------------------------
-static void transformBlockReduce(uint8 mcuBlock)
+// Reduced IDCT, for decoding at 1/2, 1/4 and 1/8 scale.
+// Each of the n x n output pixels samples the block's low frequency content at the center of the area it covers, so only
+// the coefficients with u, v < n contribute. The coefficients are prescaled for the Winograd IDCT, so the constants fold
+// the inverse of those scale factors, 1 / cos(u*pi/16), into cos((2i+1)*u*pi/(2n)).
+static PJPG_INLINE int16 imulScaled(int16 w, int16 k)
 {
-   uint8 c = clamp(PJPG_DESCALE(gCoeffBuf[0]) + 128);
-   int16 cbG, cbB, crR, crG;
+   long x = (w * (long)k);
+   x += 128L;
+   return (int16)(PJPG_ARITH_SHIFT_RIGHT_8_L(x));
+}
+
+static void idctScaled(uint8 n)
+{
+   uint8 i;
+   int16* pSrc;
+
+   if (n == 1)
+   {
+      gCoeffBuf[0] = clamp(PJPG_DESCALE(gCoeffBuf[0]) + 128);
+      return;
+   }
+
+   pSrc = gCoeffBuf;
+   for (i = 0; i < n; i++, pSrc += 8)
+   {
+      int16 src0 = *(pSrc+0);
+
+      if (n == 2)
+      {
+         int16 odd = imulScaled(*(pSrc+1), 185);
+
+         *(pSrc+0) = src0 + odd;
+         *(pSrc+1) = src0 - odd;
+      }
+      else
+      {
+         int16 even = imulScaled(*(pSrc+2), 196);
+         int16 odd0 = imulScaled(*(pSrc+1), 241) + imulScaled(*(pSrc+3), 118);
+         int16 odd1 = imulScaled(*(pSrc+1), 100) - imulScaled(*(pSrc+3), 284);
+
+         *(pSrc+0) = src0 + even + odd0;
+         *(pSrc+1) = src0 - even + odd1;
+         *(pSrc+2) = src0 - even - odd1;
+         *(pSrc+3) = src0 + even - odd0;
+      }
+   }
+
+   pSrc = gCoeffBuf;
+   for (i = 0; i < n; i++, pSrc++)
+   {
+      int16 src0 = *(pSrc+0*8);
+
+      // descale, convert to unsigned and clamp to 8-bit
+      if (n == 2)
+      {
+         int16 odd = imulScaled(*(pSrc+1*8), 185);
+
+         *(pSrc+0*8) = clamp(PJPG_DESCALE(src0 + odd) + 128);
+         *(pSrc+1*8) = clamp(PJPG_DESCALE(src0 - odd) + 128);
+      }
+      else
+      {
+         int16 even = imulScaled(*(pSrc+2*8), 196);
+         int16 odd0 = imulScaled(*(pSrc+1*8), 241) + imulScaled(*(pSrc+3*8), 118);
+         int16 odd1 = imulScaled(*(pSrc+1*8), 100) - imulScaled(*(pSrc+3*8), 284);
+
+         *(pSrc+0*8) = clamp(PJPG_DESCALE(src0 + even + odd0) + 128);
+         *(pSrc+1*8) = clamp(PJPG_DESCALE(src0 - even + odd1) + 128);
+         *(pSrc+2*8) = clamp(PJPG_DESCALE(src0 - even - odd1) + 128);
+         *(pSrc+3*8) = clamp(PJPG_DESCALE(src0 + even - odd0) + 128);
+      }
+   }
+}
+/*----------------------------------------------------------------------------*/
+// Convert Y to RGB, n x n pixels
+static void copyYScaled(uint8 dstOfs, uint8 n)
+{
+   uint8 x, y;
+   int16* pSrc = gCoeffBuf;
+
+   for (y = 0; y < n; y++, pSrc += 8, dstOfs += 8)
+   {
+      for (x = 0; x < n; x++)
+      {
+         uint8 c = (uint8)pSrc[x];
+
+         gMCUBufR[dstOfs + x] = c;
+         gMCUBufG[dstOfs + x] = c;
+         gMCUBufB[dstOfs + x] = c;
+      }
+   }
+}
+/*----------------------------------------------------------------------------*/
+// Cb convert to RGB and accumulate, n x n pixels upsampled by (1 << hShift) x (1 << vShift) from srcOfs
+static void convertCbScaled(uint8 srcOfs, uint8 dstOfs, uint8 n, uint8 hShift, uint8 vShift)
+{
+   uint8 x, y;
+
+   for (y = 0; y < n; y++, dstOfs += 8)
+   {
+      int16* pSrc = gCoeffBuf + srcOfs + ((y >> vShift) << 3);
+      uint8* pDstG = gMCUBufG + dstOfs;
+      uint8* pDstB = gMCUBufB + dstOfs;
+
+      for (x = 0; x < n; x++)
+      {
+         uint8 cb = (uint8)pSrc[x >> hShift];
+         int16 cbG, cbB;
+
+         cbG = ((cb * 88U) >> 8U) - 44U;
+         pDstG[x] = subAndClamp(pDstG[x], cbG);
+
+         cbB = (cb + ((cb * 198U) >> 8U)) - 227U;
+         pDstB[x] = addAndClamp(pDstB[x], cbB);
+      }
+   }
+}
+/*----------------------------------------------------------------------------*/
+// Cr convert to RGB and accumulate, n x n pixels upsampled by (1 << hShift) x (1 << vShift) from srcOfs
+static void convertCrScaled(uint8 srcOfs, uint8 dstOfs, uint8 n, uint8 hShift, uint8 vShift)
+{
+   uint8 x, y;
+
+   for (y = 0; y < n; y++, dstOfs += 8)
+   {
+      int16* pSrc = gCoeffBuf + srcOfs + ((y >> vShift) << 3);
+      uint8* pDstR = gMCUBufR + dstOfs;
+      uint8* pDstG = gMCUBufG + dstOfs;
+
+      for (x = 0; x < n; x++)
+      {
+         uint8 cr = (uint8)pSrc[x >> hShift];
+         int16 crR, crG;
+
+         crR = (cr + ((cr * 103U) >> 8U)) - 179;
+         pDstR[x] = addAndClamp(pDstR[x], crR);
+
+         crG = ((cr * 183U) >> 8U) - 91;
+         pDstG[x] = subAndClamp(pDstG[x], crG);
+      }
+   }
+}
+//------------------------------------------------------------------------------
+static void transformBlockScaled(uint8 mcuBlock)
+{
+   uint8 n = 8 >> gReduce;
+   uint8 h = n >> 1;       // offset to the second half of a subsampled chroma block
+
+   idctScaled(n);
 
    switch (gScanType)
    {
       case PJPG_GRAYSCALE:
       {
          // MCU size: 1, 1 block per MCU
-         gMCUBufR[0] = c;
+         copyYScaled(0, n);
          break;
       }
       case PJPG_YH1V1:
@@ -1924,31 +2069,20 @@ static void transformBlockReduce(uint8 mcuBlock)
          {
             case 0:
             {
-               gMCUBufR[0] = c;
-               gMCUBufG[0] = c;
-               gMCUBufB[0] = c;
+               copyYScaled(0, n);
                break;
             }
             case 1:
             {
-               cbG = ((c * 88U) >> 8U) - 44U;
-               gMCUBufG[0] = subAndClamp(gMCUBufG[0], cbG);
-
-               cbB = (c + ((c * 198U) >> 8U)) - 227U;
-               gMCUBufB[0] = addAndClamp(gMCUBufB[0], cbB);
+               convertCbScaled(0, 0, n, 0, 0);
                break;
             }
             case 2:
             {
-               crR = (c + ((c * 103U) >> 8U)) - 179;
-               gMCUBufR[0] = addAndClamp(gMCUBufR[0], crR);
-
-               crG = ((c * 183U) >> 8U) - 91;
-               gMCUBufG[0] = subAndClamp(gMCUBufG[0], crG);
+               convertCrScaled(0, 0, n, 0, 0);
                break;
             }
          }
-
          break;
       }
       case PJPG_YH1V2:
@@ -1958,40 +2092,24 @@ static void transformBlockReduce(uint8 mcuBlock)
          {
             case 0:
             {
-               gMCUBufR[0] = c;
-               gMCUBufG[0] = c;
-               gMCUBufB[0] = c;
+               copyYScaled(0, n);
                break;
             }
             case 1:
             {
-               gMCUBufR[128] = c;
-               gMCUBufG[128] = c;
-               gMCUBufB[128] = c;
+               copyYScaled(128, n);
                break;
             }
             case 2:
             {
-               cbG = ((c * 88U) >> 8U) - 44U;
-               gMCUBufG[0] = subAndClamp(gMCUBufG[0], cbG);
-               gMCUBufG[128] = subAndClamp(gMCUBufG[128], cbG);
-
-               cbB = (c + ((c * 198U) >> 8U)) - 227U;
-               gMCUBufB[0] = addAndClamp(gMCUBufB[0], cbB);
-               gMCUBufB[128] = addAndClamp(gMCUBufB[128], cbB);
-
+               convertCbScaled(0, 0, n, 0, 1);
+               convertCbScaled(h*8, 128, n, 0, 1);
                break;
             }
             case 3:
             {
-               crR = (c + ((c * 103U) >> 8U)) - 179;
-               gMCUBufR[0] = addAndClamp(gMCUBufR[0], crR);
-               gMCUBufR[128] = addAndClamp(gMCUBufR[128], crR);
-
-               crG = ((c * 183U) >> 8U) - 91;
-               gMCUBufG[0] = subAndClamp(gMCUBufG[0], crG);
-               gMCUBufG[128] = subAndClamp(gMCUBufG[128], crG);
-
+               convertCrScaled(0, 0, n, 0, 1);
+               convertCrScaled(h*8, 128, n, 0, 1);
                break;
             }
          }
@@ -2004,40 +2122,24 @@ static void transformBlockReduce(uint8 mcuBlock)
          {
             case 0:
             {
-               gMCUBufR[0] = c;
-               gMCUBufG[0] = c;
-               gMCUBufB[0] = c;
+               copyYScaled(0, n);
                break;
             }
             case 1:
             {
-               gMCUBufR[64] = c;
-               gMCUBufG[64] = c;
-               gMCUBufB[64] = c;
+               copyYScaled(64, n);
                break;
             }
             case 2:
             {
-               cbG = ((c * 88U) >> 8U) - 44U;
-               gMCUBufG[0] = subAndClamp(gMCUBufG[0], cbG);
-               gMCUBufG[64] = subAndClamp(gMCUBufG[64], cbG);
-
-               cbB = (c + ((c * 198U) >> 8U)) - 227U;
-               gMCUBufB[0] = addAndClamp(gMCUBufB[0], cbB);
-               gMCUBufB[64] = addAndClamp(gMCUBufB[64], cbB);
-
+               convertCbScaled(0, 0, n, 1, 0);
+               convertCbScaled(h, 64, n, 1, 0);
                break;
             }
             case 3:
             {
-               crR = (c + ((c * 103U) >> 8U)) - 179;
-               gMCUBufR[0] = addAndClamp(gMCUBufR[0], crR);
-               gMCUBufR[64] = addAndClamp(gMCUBufR[64], crR);
-
-               crG = ((c * 183U) >> 8U) - 91;
-               gMCUBufG[0] = subAndClamp(gMCUBufG[0], crG);
-               gMCUBufG[64] = subAndClamp(gMCUBufG[64], crG);
-
+               convertCrScaled(0, 0, n, 1, 0);
+               convertCrScaled(h, 64, n, 1, 0);
                break;
             }
          }
@@ -2050,62 +2152,38 @@ static void transformBlockReduce(uint8 mcuBlock)
          {
             case 0:
             {
-               gMCUBufR[0] = c;
-               gMCUBufG[0] = c;
-               gMCUBufB[0] = c;
+               copyYScaled(0, n);
                break;
             }
             case 1:
             {
-               gMCUBufR[64] = c;
-               gMCUBufG[64] = c;
-               gMCUBufB[64] = c;
+               copyYScaled(64, n);
                break;
             }
             case 2:
             {
-               gMCUBufR[128] = c;
-               gMCUBufG[128] = c;
-               gMCUBufB[128] = c;
+               copyYScaled(128, n);
                break;
             }
             case 3:
             {
-               gMCUBufR[192] = c;
-               gMCUBufG[192] = c;
-               gMCUBufB[192] = c;
+               copyYScaled(192, n);
                break;
             }
             case 4:
             {
-               cbG = ((c * 88U) >> 8U) - 44U;
-               gMCUBufG[0] = subAndClamp(gMCUBufG[0], cbG);
-               gMCUBufG[64] = subAndClamp(gMCUBufG[64], cbG);
-               gMCUBufG[128] = subAndClamp(gMCUBufG[128], cbG);
-               gMCUBufG[192] = subAndClamp(gMCUBufG[192], cbG);
-
-               cbB = (c + ((c * 198U) >> 8U)) - 227U;
-               gMCUBufB[0] = addAndClamp(gMCUBufB[0], cbB);
-               gMCUBufB[64] = addAndClamp(gMCUBufB[64], cbB);
-               gMCUBufB[128] = addAndClamp(gMCUBufB[128], cbB);
-               gMCUBufB[192] = addAndClamp(gMCUBufB[192], cbB);
-
+               convertCbScaled(0, 0, n, 1, 1);
+               convertCbScaled(h, 64, n, 1, 1);
+               convertCbScaled(h*8, 128, n, 1, 1);
+               convertCbScaled(h+h*8, 192, n, 1, 1);
                break;
             }
             case 5:
             {
-               crR = (c + ((c * 103U) >> 8U)) - 179;
-               gMCUBufR[0] = addAndClamp(gMCUBufR[0], crR);
-               gMCUBufR[64] = addAndClamp(gMCUBufR[64], crR);
-               gMCUBufR[128] = addAndClamp(gMCUBufR[128], crR);
-               gMCUBufR[192] = addAndClamp(gMCUBufR[192], crR);
-
-               crG = ((c * 183U) >> 8U) - 91;
-               gMCUBufG[0] = subAndClamp(gMCUBufG[0], crG);
-               gMCUBufG[64] = subAndClamp(gMCUBufG[64], crG);
-               gMCUBufG[128] = subAndClamp(gMCUBufG[128], crG);
-               gMCUBufG[192] = subAndClamp(gMCUBufG[192], crG);
-
+               convertCrScaled(0, 0, n, 1, 1);
+               convertCrScaled(h, 64, n, 1, 1);
+               convertCrScaled(h*8, 128, n, 1, 1);
+               convertCrScaled(h+h*8, 192, n, 1, 1);
                break;
             }
          }
@@ -2114,7 +2192,7 @@ static void transformBlockReduce(uint8 mcuBlock)
    }
 }
 //------------------------------------------------------------------------------
-static uint8 decodeNextMCU(void)
+static uint8 decodeNextMCU(uint8 skip)
 {
    uint8 status;
    uint8 mcuBlock;   
@@ -2154,9 +2232,9 @@ static uint8 decodeNextMCU(void)
 
       compACTab = gCompACTab[componentID];
 
-      if (gReduce)
+      if (skip || (gReduce == 3))
       {
-         // Decode, but throw out the AC coefficients in reduce mode.
+         // Decode, but throw out the AC coefficients when skipping or when reduced to the DC coefficient.
          for (k = 1; k < 64; k++)
          {
             s = huffDecode(compACTab ? &gHuffTab3 : &gHuffTab2, compACTab ? gHuffVal3 : gHuffVal2);
@@ -2192,7 +2270,8 @@ static uint8 decodeNextMCU(void)
             }
          }
 
-         transformBlockReduce(mcuBlock); 
+         if (!skip)
+            transformBlockScaled(mcuBlock);
       }
       else
       {
@@ -2251,14 +2330,17 @@ static uint8 decodeNextMCU(void)
          while (k < 64)
             gCoeffBuf[ZAG[k++]] = 0;
 
-         transformBlock(mcuBlock); 
+         if (gReduce)
+            transformBlockScaled(mcuBlock);
+         else
+            transformBlock(mcuBlock); 
       }
    }
          
    return 0;
 }
 //------------------------------------------------------------------------------
-unsigned char pjpeg_decode_mcu(void)
+static uint8 nextMCU(uint8 skip)
 {
    uint8 status;
    
@@ -2268,7 +2350,7 @@ unsigned char pjpeg_decode_mcu(void)
    if (!gNumMCUSRemaining)
       return PJPG_NO_MORE_BLOCKS;
       
-   status = decodeNextMCU();
+   status = decodeNextMCU(skip);
    if ((status) || (gCallbackStatus))
       return gCallbackStatus ? gCallbackStatus : status;
       
@@ -2277,6 +2359,16 @@ unsigned char pjpeg_decode_mcu(void)
    return 0;
 }
 //------------------------------------------------------------------------------
+unsigned char pjpeg_decode_mcu(void)
+{
+   return nextMCU(0);
+}
+//------------------------------------------------------------------------------
+unsigned char pjpeg_skip_mcu(void)
+{
+   return nextMCU(1);
+}
+//------------------------------------------------------------------------------
 unsigned char pjpeg_decode_init(pjpeg_image_info_t *pInfo, pjpeg_need_bytes_callback_t pNeed_bytes_callback, void *pCallback_data, unsigned char reduce)
 {
    uint8 status;
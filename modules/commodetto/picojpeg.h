@@ -113,7 +113,9 @@ typedef unsigned char (*pjpeg_need_bytes_callback_t)(unsigned char* pBuf, unsign
 
 // Initializes the decompressor. Returns 0 on success, or one of the above error codes on failure.
 // pNeed_bytes_callback will be called to fill the decompressor's internal input buffer.
-// If reduce is 1, only the first pixel of each block will be decoded. This mode is much faster because it skips the AC dequantization, IDCT and chroma upsampling of every image pixel.
+// reduce scales the decoded image by 1 / (1 << reduce), from 0 (full size) to 3 (1/8).
+// Each block is decoded to (8 >> reduce) x (8 >> reduce) pixels, stored in the top-left of the block's 8x8 area in the MCU buffers.
+// The reduced IDCT works on only the low frequency coefficients, so it is much faster than decoding at full size. When reduce is 3, only the first pixel of each block is decoded, skipping the AC dequantization and IDCT entirely.
 // Not thread safe.
 unsigned char pjpeg_decode_init(pjpeg_image_info_t *pInfo, pjpeg_need_bytes_callback_t pNeed_bytes_callback, void *pCallback_data, unsigned char reduce);
 
@@ -122,6 +124,11 @@ unsigned char pjpeg_decode_init(pjpeg_image_info_t *pInfo, pjpeg_need_bytes_call
 // Not thread safe.
 unsigned char pjpeg_decode_mcu(void);
 
+// Skips the file's next MCU. The MCU is entropy decoded, as required to track the DC predictors, but is not dequantized or transformed, and the MCU buffers are unchanged.
+// Returns the same values as pjpeg_decode_mcu. Either function may be used for each of the m_MCUSPerRow*m_MCUSPerCol MCUs.
+// Not thread safe.
+unsigned char pjpeg_skip_mcu(void);
+
 #ifdef __cplusplus
 }
 #endif
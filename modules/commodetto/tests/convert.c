@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2016-2017  Moddable Tech, Inc.
+ *
+ *   This file is part of the Moddable SDK Runtime.
+ *
+ *   The Moddable SDK Runtime is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   The Moddable SDK Runtime is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with the Moddable SDK Runtime.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+	Pixel conversion of Convert, streamed and whole.
+
+	Random pixels of every supported pair of formats are converted in one call, and again split into chunks
+	of random sizes that end anywhere in a pixel, each chunk in a buffer of its exact size. The bytes written,
+	and the counts returned, must match. A destination one byte short must be refused.
+
+	The RGB565LE and Gray256 converters to CLUT16, and RGB565LE to Gray256, must convert each of their pixels
+	as its expansion to 24RGB converts. The inverse table built from only the 16 colors of a clut must map each
+	4:4:4 color to one of the nearest colors, and a full clut must be used as given.
+
+	The bindings of commodettoConvert.c are compiled but not called, so the Convert record is set up here, as
+	the constructor sets it up.
+*/
+
+#include "pocoTest.h"
+#include "commodettoConvert.c"
+
+#define kRounds (40)
+#define kMaxPixels (300)
+#define kGuardBytes (16)
+
+static void newConvert(xsConvert c, CommodettoBitmapFormat srcFormat, CommodettoBitmapFormat dstFormat, uint16_t *clut, uint32_t clutBytes)
+{
+	memset(c, 0, sizeof(xsConvertRecord));
+	convertFormats(c, srcFormat, dstFormat);
+	if (kCommodettoBitmapCLUT16 == dstFormat)
+		pocoTestCheck(NULL == convertClut(c, clut, clutBytes), "clut of %d bytes refused", (int)clutBytes);
+}
+
+static void checkStream(CommodettoBitmapFormat srcFormat, CommodettoBitmapFormat dstFormat, uint16_t *clut)
+{
+	xsConvertRecord whole, streamed;
+	int round;
+
+	for (round = 0; round < kRounds; round++) {
+		int srcDepth = CommodettoBitmapGetDepth(srcFormat), dstDepth = CommodettoBitmapGetDepth(dstFormat);
+		int pixelCount = pocoTestBetween(1, kMaxPixels), srcLength = ((pixelCount * srcDepth) + 7) >> 3, dstLength, i;
+		int expected, actual = 0, offset = 0, last = 0;
+		uint8_t *src, *expectedPixels, *actualPixels;
+
+		srcLength += pocoTestBetween(0, 1) ? 0 : pocoTestBetween(1, 3);		// a partial pixel at the end
+		pixelCount = (srcLength << 3) / srcDepth;
+		dstLength = ((pixelCount * dstDepth) + 7) >> 3;
+
+		src = malloc(srcLength);
+		expectedPixels = malloc(dstLength + kGuardBytes);
+		actualPixels = malloc(dstLength + kGuardBytes);
+		for (i = 0; i < srcLength; i++)
+			src[i] = (uint8_t)pocoTestRandom();
+		memset(expectedPixels, 0xA5, dstLength + kGuardBytes);
+		memset(actualPixels, 0xA5, dstLength + kGuardBytes);
+
+		newConvert(&whole, srcFormat, dstFormat, clut, (sizeof(uint16_t) * 16) + 4096);
+		newConvert(&streamed, srcFormat, dstFormat, clut, (sizeof(uint16_t) * 16) + 4096);
+
+		if (dstLength)
+			pocoTestCheck(-1 == convertProcess(&whole, src, srcLength, expectedPixels, dstLength - 1, 0), "%d to %d: %d pixels into %d bytes", srcFormat, dstFormat, pixelCount, dstLength - 1);
+		expected = convertProcess(&whole, src, srcLength, expectedPixels, dstLength, 0);
+		pocoTestCheck(expected == dstLength, "%d to %d: %d pixels wrote %d bytes, not %d", srcFormat, dstFormat, pixelCount, expected, dstLength);
+
+		while (offset < srcLength) {
+			int length = pocoTestBetween(0, 3) ? pocoTestBetween(1, 7) : pocoTestBetween(1, srcLength), written;
+			uint8_t *chunk;
+
+			if (length > (srcLength - offset))
+				length = srcLength - offset;
+			offset += length;
+			last = (offset == srcLength) && pocoTestBetween(0, 1);		// else an empty call ends the stream
+			chunk = malloc(length);
+			memcpy(chunk, src + offset - length, length);
+			written = convertProcess(&streamed, chunk, length, actualPixels + actual, dstLength - actual, !last);
+			free(chunk);
+			pocoTestCheck(written >= 0, "%d to %d: streamed dst buffer too small", srcFormat, dstFormat);
+			if (written < 0)
+				break;
+			actual += written;
+		}
+		if (!last && (offset == srcLength))
+			actual += convertProcess(&streamed, src, 0, actualPixels + actual, dstLength - actual, 0);
+
+		pocoTestCheck(expected == actual, "%d to %d: %d bytes streamed, not %d", srcFormat, dstFormat, actual, expected);
+		pocoTestCheck(0 == memcmp(expectedPixels, actualPixels, dstLength + kGuardBytes), "%d to %d: %d pixels streamed differ", srcFormat, dstFormat, pixelCount);
+
+		free(src);
+		free(expectedPixels);
+		free(actualPixels);
+		free(whole.clut);
+		free(streamed.clut);
+	}
+}
+
+static int distance(uint16_t color, int rgb444)
+{
+	int dr = ((color >> 8) & 0x0F) - (rgb444 >> 8), dg = ((color >> 4) & 0x0F) - ((rgb444 >> 4) & 0x0F), db = (color & 0x0F) - (rgb444 & 0x0F);
+	return (dr * dr) + (dg * dg) + (db * db);
+}
+
+static uint8_t toCLUT16(xsConvert c, CommodettoBitmapFormat srcFormat, uint8_t *src)
+{
+	uint8_t index;
+
+	CommodettoPixelsConverterGet(srcFormat, kCommodettoBitmapCLUT16)(1, src, &index, c->clut);
+	return index >> 4;
+}
+
+static void expand(CommodettoBitmapFormat srcFormat, int pixel, uint8_t *rgb)
+{
+	if (kCommodettoBitmapGray256 == srcFormat)
+		rgb[0] = rgb[1] = rgb[2] = (uint8_t)pixel;
+	else {
+		int r = pixel >> 11, g = (pixel >> 5) & 0x3F, b = pixel & 0x1F;
+		rgb[0] = (uint8_t)((r << 3) | (r >> 2));
+		rgb[1] = (uint8_t)((g << 2) | (g >> 4));
+		rgb[2] = (uint8_t)((b << 3) | (b >> 2));
+	}
+}
+
+/* each pixel, alone and in pairs, must convert as its expansion to 24RGB converts */
+static void checkExpanded(xsConvert c, CommodettoBitmapFormat srcFormat, CommodettoBitmapFormat dstFormat, int pixels)
+{
+	CommodettoConverter converter = CommodettoPixelsConverterGet(srcFormat, dstFormat), reference = CommodettoPixelsConverterGet(kCommodettoBitmap24RGB, dstFormat);
+	int srcBytes = CommodettoBitmapGetDepth(srcFormat) >> 3, i;
+
+	for (i = 0; i < pixels; i++) {
+		int other = pocoTestBetween(0, pixels - 1), count;
+		uint8_t src[4], rgb[6], expected[2], actual[2];
+
+		src[0] = (uint8_t)i, src[srcBytes] = (uint8_t)other;
+		if (2 == srcBytes)
+			src[1] = (uint8_t)(i >> 8), src[3] = (uint8_t)(other >> 8);
+		expand(srcFormat, i, rgb);
+		expand(srcFormat, other, rgb + 3);
+
+		for (count = 1; count <= 2; count++) {
+			memset(expected, 0, sizeof(expected));
+			memset(actual, 0, sizeof(actual));
+			(reference)(count, rgb, expected, c->clut);
+			(converter)(count, src, actual, c->clut);
+			pocoTestCheck(0 == memcmp(expected, actual, sizeof(actual)), "%d to %d: pixels %d and %d", srcFormat, dstFormat, i, other);
+		}
+	}
+}
+
+static void checkCLUT16(uint16_t *clut)
+{
+	xsConvertRecord c;
+	int i;
+
+	newConvert(&c, kCommodettoBitmap24RGB, kCommodettoBitmapCLUT16, clut, sizeof(uint16_t) * 16);
+
+	checkExpanded(&c, kCommodettoBitmapRGB565LE, kCommodettoBitmapCLUT16, 65536);
+	checkExpanded(&c, kCommodettoBitmapGray256, kCommodettoBitmapCLUT16, 256);
+	checkExpanded(&c, kCommodettoBitmapRGB565LE, kCommodettoBitmapGray256, 65536);
+
+	for (i = 0; i < 4096; i++) {
+		uint8_t rgb[3] = { (uint8_t)((i >> 8) << 4), (uint8_t)(i & 0xF0), (uint8_t)((i & 0x0F) << 4) };
+		int index = toCLUT16(&c, kCommodettoBitmap24RGB, rgb), nearest = 1000000, j;
+
+		for (j = 0; j < 16; j++) {
+			int delta = distance(clut[j], i);
+			if (delta < nearest)
+				nearest = delta;
+		}
+		pocoTestCheck(distance(clut[index], i) == nearest, "color %03X to index %d, not one of the nearest", i, index);
+	}
+	free(c.clut);
+}
+
+int main(int argc, char *argv[])
+{
+	uint16_t clut[16 + 2048];
+	xsConvertRecord c;
+	CommodettoBitmapFormat srcFormat, dstFormat;
+	int i, pairs = 0;
+
+	pocoTestSeed(0x9E3779B9);
+	for (i = 0; i < 16; i++)
+		clut[i] = (uint16_t)pocoTestBetween(0, 0x0FFF);
+	checkCLUT16(clut);
+
+	for (i = 0; i < 4096; i++)
+		((uint8_t *)(clut + 16))[i] = (uint8_t)pocoTestBetween(0, 15);		// a full clut is not rebuilt
+	newConvert(&c, kCommodettoBitmap24RGB, kCommodettoBitmapCLUT16, clut, sizeof(clut));
+	for (i = 0; i < 4096; i++) {
+		uint8_t rgb[3] = { (uint8_t)((i >> 8) << 4), (uint8_t)(i & 0xF0), (uint8_t)((i & 0x0F) << 4) };
+		pocoTestCheck(toCLUT16(&c, kCommodettoBitmap24RGB, rgb) == ((uint8_t *)(clut + 16))[i], "color %03X not looked up in the full clut", i);
+	}
+	free(c.clut);
+
+	pocoTestCheck(NULL != convertClut(&c, clut, (sizeof(uint16_t) * 16) - 1), "short clut accepted");
+
+	for (srcFormat = kCommodettoBitmapMonochrome; srcFormat <= kCommodettoBitmap32RGBA; srcFormat++) {
+		for (dstFormat = kCommodettoBitmapMonochrome; dstFormat <= kCommodettoBitmapCLUT16; dstFormat++) {
+			uint8_t supported = convertFormats(&c, srcFormat, dstFormat);
+
+			pocoTestCheck(supported == (NULL != CommodettoPixelsConverterGet(srcFormat, dstFormat)), "%d to %d", srcFormat, dstFormat);
+			if (supported) {
+				checkStream(srcFormat, dstFormat, clut);
+				pairs++;
+			}
+		}
+	}
+	pocoTestCheck(23 == pairs, "%d pairs of formats converted", pairs);
+
+	return pocoTestDone("convert");
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2016-2017  Moddable Tech, Inc.
+ *
+ *   This file is part of the Moddable SDK Runtime.
+ *
+ *   The Moddable SDK Runtime is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   The Moddable SDK Runtime is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with the Moddable SDK Runtime.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+	Blended rectangles over several rows of one slab.
+
+	The background has a different color in each column, so every row of a blended rectangle must match
+	its first row, and pixels around the rectangle must keep the background. The same frame rendered one
+	row per slab never advances between rows, so it must match too. In 4-bit formats, odd x and odd widths
+	leave rows ending in the middle of a byte.
+*/
+
+#include "pocoTest.h"
+
+#define kWidth (32)
+#define kHeight (12)
+
+static void render(Poco poco, uint8_t *frame, PocoColor color, uint8_t blend, int x, int y, int w, int h)
+{
+	int column;
+
+	PocoDrawingBegin(poco, 0, 0, kWidth, kHeight);
+	for (column = 0; column < kWidth; column++)
+		PocoRectangleFill(poco, pocoTestMakeColor((column * 7) + 3), kPocoOpaque, column, 0, 1, kHeight);
+	PocoRectangleFill(poco, color, blend, x, y, w, h);
+	pocoTestCheck(0 == pocoTestEnd(poco, frame), "render failed");
+}
+
+int main(int argc, char *argv[])
+{
+	Poco tall = pocoTestNew(kWidth, kHeight, kHeight, 4096);
+	Poco strip = pocoTestNew(kWidth, kHeight, 1, 4096);
+	uint8_t *expected = pocoTestNewFrame(tall), *actual = pocoTestNewFrame(tall);
+	int rowBytes = pocoTestRowBytes(kWidth);
+	static const uint8_t blends[] = { 32, 128, 200 };
+	int x, w, h, b, i, j;
+
+	for (b = 0; b < (int)sizeof(blends); b++) {
+		for (x = 0; x < 4; x++) {
+			for (w = 1; w <= 9; w++) {
+				for (h = 2; h <= 5; h++) {
+					PocoColor color = pocoTestMakeColor(0x5A5A + b);
+					int y = 3;
+					render(strip, expected, color, blends[b], x, y, w, h);
+					render(tall, actual, color, blends[b], x, y, w, h);
+					pocoTestCheck(0 == memcmp(expected, actual, rowBytes * kHeight), "x %d w %d h %d blend %d: one slab differs from one row per slab", x, w, h, blends[b]);
+
+					for (j = 0; j < kHeight; j++) {
+						for (i = 0; i < kWidth; i++) {
+							int pixel = pocoTestGetPixel(actual, rowBytes, i, j);
+							if ((i < x) || (i >= (x + w)) || (j < y) || (j >= (y + h)))
+								pocoTestCheck(pixel == pocoTestGetPixel(actual, rowBytes, i, 0), "x %d w %d h %d blend %d: pixel %d,%d outside changed", x, w, h, blends[b], i, j);
+							else
+								pocoTestCheck(pixel == pocoTestGetPixel(actual, rowBytes, i, y), "x %d w %d h %d blend %d: pixel %d,%d differs from first row", x, w, h, blends[b], i, j);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	free(expected);
+	free(actual);
+	pocoTestDispose(tall);
+	pocoTestDispose(strip);
+
+	return pocoTestDone("pocoBlend");
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2016-2017  Moddable Tech, Inc.
+ *
+ *   This file is part of the Moddable SDK Runtime.
+ *
+ *   The Moddable SDK Runtime is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   The Moddable SDK Runtime is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with the Moddable SDK Runtime.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+	Scenes of stacked opaque panels, like a screen of backgrounds and opaque bitmaps, with random commands
+	of every kind between them.
+
+	Rendered in several slabs through the slab index, commands hidden by later opaque fills and bitmaps are
+	skipped, and commands that continue into the next slab are advanced without drawing. The frames must
+	match the same scenes rendered in a single slab, where nothing is culled, and in several slabs without
+	the index. Patterns look opaque but must never hide what is below them.
+*/
+
+#include "pocoTest.h"
+
+#define kWidth (160)
+#define kHeight (120)
+#define kScenes (200)
+
+static const int gRows[] = { 1, 4, 8, 16 };
+
+static void panel(Poco poco)
+{
+	int x = pocoTestBetween(-20, kWidth - 20), y = pocoTestBetween(-20, kHeight - 20);
+	int w = pocoTestBetween(20, kWidth + 20), h = pocoTestBetween(4, kHeight);
+	int sx = pocoTestBetween(0, 7), sy = pocoTestBetween(0, 7);
+
+	switch (pocoTestBetween(0, 3)) {
+		case 0:
+			PocoRectangleFill(poco, pocoTestColor(), kPocoOpaque, x, y, w, h);
+			break;
+		case 1:
+			PocoRectangleFill(poco, pocoTestColor(), kPocoOpaque, 0, y, kWidth, h);
+			break;
+		case 2:
+			PocoBitmapDraw(poco, &gPocoTestSource, x, y, sx, sy, kPocoTestSourceWidth - sx, kPocoTestSourceHeight - sy);
+			break;
+		case 3:
+			PocoBitmapPattern(poco, &gPocoTestSource, x, y, w, h, sx, sy, pocoTestBetween(1, 16), pocoTestBetween(1, 16));
+			break;
+	}
+}
+
+static void draw(Poco poco, uint32_t seed)
+{
+	int layers;
+
+	pocoTestSeed(seed);
+	PocoDrawingBegin(poco, 0, 0, kWidth, kHeight);
+	PocoRectangleFill(poco, pocoTestMakeColor(0), kPocoOpaque, 0, 0, kWidth, kHeight);
+	for (layers = pocoTestBetween(1, 12); layers > 0; layers--) {
+		panel(poco);
+		pocoTestScene(poco, pocoTestBetween(0, 24), kPocoTestAll & ~kPocoTestClip);
+	}
+}
+
+/* leaves no room for the slab index after the display list, so every slab walks the whole display list */
+static int endLinear(Poco poco, uint8_t *frame)
+{
+	const char *displayListEnd = poco->displayListEnd;
+	int result;
+
+	poco->displayListEnd = (char *)poco->next;
+	result = pocoTestEnd(poco, frame);
+	poco->displayListEnd = displayListEnd;
+
+	return result;
+}
+
+int main(int argc, char *argv[])
+{
+	Poco whole = pocoTestNew(kWidth, kHeight, kHeight, 65536);
+	uint8_t *expected = pocoTestNewFrame(whole), *actual = pocoTestNewFrame(whole);
+	int frameLength = pocoTestRowBytes(kWidth) * kHeight;
+	int scene, r;
+
+	pocoTestSetup();
+	for (r = 0; r < (int)(sizeof(gRows) / sizeof(gRows[0])); r++) {
+		Poco strip = pocoTestNew(kWidth, kHeight, gRows[r], 65536);
+
+		for (scene = 0; scene < kScenes; scene++) {
+			uint32_t seed = 0x9E3779B9 * (scene + 1);
+
+			draw(whole, seed);
+			pocoTestCheck(0 == pocoTestEnd(whole, expected), "scene %d: render failed", scene);
+
+			draw(strip, seed);
+			pocoTestCheck(0 == pocoTestEnd(strip, actual), "scene %d rows %d: culled render failed", scene, gRows[r]);
+			pocoTestCheck(0 == memcmp(expected, actual, frameLength), "scene %d rows %d: culled slabs differ from one slab", scene, gRows[r]);
+
+			draw(strip, seed);
+			pocoTestCheck(0 == endLinear(strip, actual), "scene %d rows %d: linear render failed", scene, gRows[r]);
+			pocoTestCheck(0 == memcmp(expected, actual, frameLength), "scene %d rows %d: linear slabs differ from one slab", scene, gRows[r]);
+		}
+
+		pocoTestDispose(strip);
+	}
+
+	free(expected);
+	free(actual);
+	pocoTestDispose(whole);
+
+	return pocoTestDone("pocoCull");
+}
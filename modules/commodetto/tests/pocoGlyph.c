@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2016-2017  Moddable Tech, Inc.
+ *
+ *   This file is part of the Moddable SDK Runtime.
+ *
+ *   The Moddable SDK Runtime is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   The Moddable SDK Runtime is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with the Moddable SDK Runtime.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+	Gray glyphs collected into text runs, and the glyph cache of BMFonts.
+
+	Scenes of compressed and uncompressed gray glyphs, set like lines of text or scattered, with fills and
+	clips between them, are drawn with PocoGrayGlyphDraw and with PocoGrayBitmapDraw. The frames must match,
+	and text runs must take less of the display list than gray bitmaps for lines of text. Compressed glyphs
+	start at every byte alignment.
+
+	PocoBMFGlyphFromUTF8 must find the same glyph as a linear search of fonts with gaps in their characters,
+	including after a font is replaced by another at the same address.
+*/
+
+#include "pocoTest.h"
+
+#define kWidth (160)
+#define kHeight (120)
+#define kScenes (200)
+#define kGlyphs (32)
+#define kGlyphBytes (1024)
+#define kLookups (100000)
+
+static uint32_t gGlyphData[kGlyphs][kGlyphBytes / 4];
+static PocoBitmapRecord gGlyph[kGlyphs];
+
+static void putNybble(uint8_t *data, int *nybbles, int value)
+{
+	if (*nybbles & 1)
+		data[*nybbles >> 1] |= value << 4;
+	else
+		data[*nybbles >> 1] = (uint8_t)value;
+	*nybbles += 1;
+}
+
+/* compressed gray rows: 0-7 repeats transparent 2-9 times, 8-11 repeats opaque 2-5 times, 12-15 is followed by 1-4 literal levels */
+static void makeGlyph(int index)
+{
+	uint8_t *data = (uint8_t *)gGlyphData[index];
+	int w = pocoTestBetween(1, 30), h = pocoTestBetween(1, 30), offset = pocoTestBetween(0, 3), nybbles = offset << 1, y;
+
+	for (y = 0; y < h; y++) {
+		int x = 0;
+		while (x < w) {
+			int left = w - x, kind = pocoTestBetween(0, 2), count;
+			if ((0 == kind) && (left >= 2)) {
+				count = pocoTestBetween(2, (left < 9) ? left : 9);
+				putNybble(data, &nybbles, count - 2);
+			}
+			else if ((1 == kind) && (left >= 2)) {
+				count = pocoTestBetween(2, (left < 5) ? left : 5);
+				putNybble(data, &nybbles, 0x08 | (count - 2));
+			}
+			else {
+				int i;
+				count = pocoTestBetween(1, (left < 4) ? left : 4);
+				putNybble(data, &nybbles, 0x0C | (count - 1));
+				for (i = 0; i < count; i++)
+					putNybble(data, &nybbles, pocoTestBetween(0, 15));
+			}
+			x += count;
+		}
+	}
+
+	gGlyph[index].width = w;
+	gGlyph[index].height = h;
+	gGlyph[index].format = kCommodettoBitmapGray16 | kCommodettoBitmapPacked;
+	gGlyph[index].pixels = (PocoPixel *)(data + offset);
+}
+
+/* returns whether the scene is set like text, in one font */
+static int draw(Poco poco, uint32_t seed, int runs)
+{
+	int count, clipped = 0, line, font, x = 0, y = 0;
+
+	pocoTestSeed(seed);
+	line = pocoTestBetween(0, 1);
+	font = pocoTestBetween(0, 1) ? 3 : 12;
+	PocoDrawingBegin(poco, 0, 0, kWidth, kHeight);
+	PocoRectangleFill(poco, pocoTestMakeColor(0), kPocoOpaque, 0, 0, kWidth, kHeight);
+
+	for (count = pocoTestBetween(1, 400); count > 0; count--) {
+		int kind = pocoTestBetween(0, 19);
+		PocoColor color = pocoTestMakeColor(pocoTestBetween(1, 3) * 4);
+		uint8_t blend = pocoTestBetween(0, 3) ? kPocoOpaque : (uint8_t)pocoTestBetween(0, 255);
+
+		if (line) {		// text: same color and font, advancing along lines
+			if (kind >= 3)
+				kind = font;
+			color = pocoTestMakeColor(12);
+			blend = kPocoOpaque;
+			x += pocoTestBetween(1, 14);
+			if (x > kWidth)
+				x = pocoTestBetween(-10, 10), y += 20;
+			if (y > kHeight)
+				y = pocoTestBetween(-10, 0);
+		}
+		else
+			x = pocoTestBetween(-20, kWidth), y = pocoTestBetween(-20, kHeight);
+
+		if (0 == kind)
+			PocoRectangleFill(poco, pocoTestColor(), kPocoOpaque, x, y, pocoTestBetween(1, 40), pocoTestBetween(1, 40));
+		else if (1 == kind) {
+			if (clipped)
+				PocoClipPop(poco);
+			PocoClipPush(poco, pocoTestBetween(0, kWidth), pocoTestBetween(0, kHeight), pocoTestBetween(0, kWidth), pocoTestBetween(0, kHeight));
+			clipped = 1;
+		}
+		else if (2 == kind) {
+			if (clipped)
+				PocoClipPop(poco);
+			clipped = 0;
+		}
+		else if (kind < 12) {
+			PocoBitmap glyph = &gGlyph[pocoTestBetween(0, kGlyphs - 1)];
+			if (runs)
+				PocoGrayGlyphDraw(poco, glyph, color, blend, x, y + pocoTestBetween(-4, 4), 0, 0, glyph->width, glyph->height);
+			else
+				PocoGrayBitmapDraw(poco, glyph, color, blend, x, y + pocoTestBetween(-4, 4), 0, 0, glyph->width, glyph->height);
+		}
+		else {
+			int sx = pocoTestBetween(0, kPocoTestSourceWidth - 1), sy = pocoTestBetween(0, kPocoTestSourceHeight - 1);
+			int sw = pocoTestBetween(1, kPocoTestSourceWidth - sx), sh = pocoTestBetween(1, kPocoTestSourceHeight - sy);
+			if (runs)
+				PocoGrayGlyphDraw(poco, &gPocoTestGray, color, blend, x, y, sx, sy, sw, sh);
+			else
+				PocoGrayBitmapDraw(poco, &gPocoTestGray, color, blend, x, y, sx, sy, sw, sh);
+		}
+	}
+	if (clipped)
+		PocoClipPop(poco);
+
+	return line;
+}
+
+static int putUTF8(uint8_t *text, int c)
+{
+	if (c < 0x80) {
+		text[0] = (uint8_t)c;
+		return 1;
+	}
+	if (c < 0x800) {
+		text[0] = 0xC0 | (c >> 6);
+		text[1] = 0x80 | (c & 0x3F);
+		return 2;
+	}
+	text[0] = 0xE0 | (c >> 12);
+	text[1] = 0x80 | ((c >> 6) & 0x3F);
+	text[2] = 0x80 | (c & 0x3F);
+	return 3;
+}
+
+/* 20 byte char records of a BMFont, in ascending order with gaps of up to gap characters */
+static void makeFont(uint8_t *chars, int charCount, int first, int gap)
+{
+	int i, c = first;
+
+	memset(chars, 0, 20 * charCount);
+	for (i = 0; i < charCount; i++, c += pocoTestBetween(1, gap))
+		memcpy(chars + (20 * i), &c, 4);
+}
+
+static void lookup(uint8_t *chars, int charCount, int lookups)
+{
+	while (lookups--) {
+		int c = pocoTestBetween(1, (pocoTestBetween(0, 7) ? 0x800 : 0xFFFF)), i;
+		uint8_t text[4], *src = text;
+		const uint8_t *expected = NULL, *actual;
+
+		text[putUTF8(text, c)] = 0;
+		for (i = 0; i < charCount; i++) {
+			if (!memcmp(chars + (20 * i), &c, 4))
+				expected = chars + (20 * i);
+		}
+		actual = PocoBMFGlyphFromUTF8(&src, chars, charCount);
+		pocoTestCheck(expected == actual, "char %d of %d chars: found %d, not %d", c, charCount,
+			actual ? (int)((actual - chars) / 20) : -1, expected ? (int)((expected - chars) / 20) : -1);
+		pocoTestCheck(0 == *src, "char %d: text not consumed", c);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	Poco poco = pocoTestNew(kWidth, kHeight, 16, 65536);
+	uint8_t *expected = pocoTestNewFrame(poco), *actual = pocoTestNewFrame(poco);
+	int frameLength = pocoTestRowBytes(kWidth) * kHeight;
+	int commandBytes = 0, runBytes = 0, scene, i;
+	uint8_t *sparse = malloc(20 * 300), *dense = malloc(20 * 500), *single = malloc(20);
+
+	pocoTestSetup();
+	for (i = 0; i < kGlyphs; i++)
+		makeGlyph(i);
+
+	for (scene = 0; scene < kScenes; scene++) {
+		uint32_t seed = 0x9E3779B9 * (scene + 1);
+
+		if (draw(poco, seed, 0))
+			commandBytes += (char *)poco->next - poco->displayList;
+		pocoTestCheck(0 == pocoTestEnd(poco, expected), "scene %d: render failed", scene);
+
+		if (draw(poco, seed, 1))
+			runBytes += (char *)poco->next - poco->displayList;
+		pocoTestCheck(0 == pocoTestEnd(poco, actual), "scene %d: text run render failed", scene);
+
+		pocoTestCheck(0 == memcmp(expected, actual, frameLength), "scene %d: text runs differ from gray bitmaps", scene);
+	}
+	pocoTestCheck(runBytes < commandBytes, "text takes %d bytes in runs, %d in gray bitmaps", runBytes, commandBytes);
+
+	pocoTestSeed(54321);
+	makeFont(sparse, 300, 32, 5);
+	makeFont(dense, 500, 20, 3);
+	makeFont(single, 1, pocoTestBetween(1, 0x800), 1);
+	for (i = 0; i < 10; i++) {
+		lookup(sparse, 300, kLookups / 20);
+		lookup(dense, 500, kLookups / 20);
+		lookup(single, 1, 100);
+		makeFont(sparse, 300, pocoTestBetween(1, 200), 5);		// another font where the first was
+	}
+
+	free(sparse);
+	free(dense);
+	free(single);
+	free(expected);
+	free(actual);
+	pocoTestDispose(poco);
+
+	return pocoTestDone("pocoGlyph");
+}
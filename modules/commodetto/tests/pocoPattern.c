@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2016-2017  Moddable Tech, Inc.
+ *
+ *   This file is part of the Moddable SDK Runtime.
+ *
+ *   The Moddable SDK Runtime is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   The Moddable SDK Runtime is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with the Moddable SDK Runtime.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+	Random patterns, each compared with its tile drawn by PocoBitmapDraw at every step inside a clip.
+
+	In 4-bit formats, odd source columns, odd destination columns and odd tile widths leave tiles starting
+	in the middle of a byte.
+*/
+
+#include "pocoTest.h"
+
+#define kWidth (64)
+#define kHeight (48)
+#define kPatterns (4000)
+
+static void begin(Poco poco, int cx, int cy)
+{
+	PocoDrawingBegin(poco, 0, 0, kWidth, kHeight);
+	PocoRectangleFill(poco, pocoTestMakeColor(5), kPocoOpaque, 0, 0, kWidth, kHeight);
+	PocoClipPush(poco, cx, cy, kWidth, kHeight);
+}
+
+int main(int argc, char *argv[])
+{
+	Poco poco = pocoTestNew(kWidth, kHeight, kHeight, 65536);
+	uint8_t *expected = pocoTestNewFrame(poco), *actual = pocoTestNewFrame(poco);
+	int frameLength = pocoTestRowBytes(kWidth) * kHeight;
+	int pattern;
+
+	pocoTestSetup();
+	for (pattern = 0; pattern < kPatterns; pattern++) {
+		int x = pocoTestBetween(-20, kWidth - 4), y = pocoTestBetween(-20, kHeight - 4);
+		int w = pocoTestBetween(1, kWidth + 6), h = pocoTestBetween(1, kHeight + 2);
+		int sx = pocoTestBetween(0, kPocoTestSourceWidth - 1), sy = pocoTestBetween(0, kPocoTestSourceHeight - 1);
+		int sw = pocoTestBetween(1, kPocoTestSourceWidth - sx), sh = pocoTestBetween(1, kPocoTestSourceHeight - sy);
+		int cx = pocoTestBetween(0, kWidth / 2), cy = pocoTestBetween(0, kHeight / 2);
+		int tx, ty;
+
+		begin(poco, cx, cy);
+		PocoClipPush(poco, x, y, w, h);
+		for (ty = y; ty < (y + h); ty += sh) {
+			for (tx = x; tx < (x + w); tx += sw)
+				PocoBitmapDraw(poco, &gPocoTestSource, tx, ty, sx, sy, sw, sh);
+		}
+		PocoClipPop(poco);
+		PocoClipPop(poco);
+		if (pocoTestEnd(poco, expected))
+			continue;						// too many tiles for the display list
+
+		begin(poco, cx, cy);
+		PocoBitmapPattern(poco, &gPocoTestSource, x, y, w, h, sx, sy, sw, sh);
+		PocoClipPop(poco);
+		pocoTestCheck(0 == pocoTestEnd(poco, actual), "pattern %d: render failed", pattern);
+
+		pocoTestCheck(0 == memcmp(expected, actual, frameLength), "pattern %d: %d %d %d %d from %d %d %d %d clipped at %d %d differs from tiles", pattern, x, y, w, h, sx, sy, sw, sh, cx, cy);
+	}
+
+	free(expected);
+	free(actual);
+	pocoTestDispose(poco);
+
+	return pocoTestDone("pocoPattern");
+}
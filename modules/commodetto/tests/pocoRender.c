@@ -0,0 +1,69 @@
+/*
+ * Copyright (c) 2016-2017  Moddable Tech, Inc.
+ *
+ *   This file is part of the Moddable SDK Runtime.
+ *
+ *   The Moddable SDK Runtime is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   The Moddable SDK Runtime is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with the Moddable SDK Runtime.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+	Renders random scenes and writes the frames to the file named by the first argument.
+
+	The makefile builds this test with different options, like kPocoVector and kPocoThreads, and compares the
+	frames with those of the default build, which serve as golden images.
+*/
+
+#include "pocoTest.h"
+
+#define kWidth (160)
+#define kHeight (120)
+#define kRows (16)
+#define kScenes (200)
+
+int main(int argc, char *argv[])
+{
+	Poco poco = pocoTestNew(kWidth, kHeight, kRows, 65536);
+	uint8_t *frame = pocoTestNewFrame(poco);
+	int frameLength = pocoTestRowBytes(kWidth) * kHeight;
+	FILE *file;
+	int scene;
+
+	if (argc < 2) {
+		fprintf(stderr, "usage: %s frames\n", argv[0]);
+		return 1;
+	}
+	file = fopen(argv[1], "wb");
+	if (!file) {
+		fprintf(stderr, "# cannot create %s\n", argv[1]);
+		return 1;
+	}
+
+	pocoTestSetup();
+	for (scene = 0; scene < kScenes; scene++) {
+		pocoTestSeed(0x9E3779B9 * (scene + 1));
+		memset(frame, 0, frameLength);
+		PocoDrawingBegin(poco, 0, 0, kWidth, kHeight);
+		PocoRectangleFill(poco, pocoTestMakeColor(0), kPocoOpaque, 0, 0, kWidth, kHeight);		// slabs are not cleared between uses
+		pocoTestScene(poco, pocoTestBetween(1, 300), kPocoTestAll);
+		pocoTestCheck(0 == pocoTestEnd(poco, frame), "scene %d: render failed", scene);
+		fwrite(frame, 1, frameLength, file);
+	}
+
+	fclose(file);
+	free(frame);
+	pocoTestDispose(poco);
+
+	return gPocoTestFailures ? 1 : 0;
+}
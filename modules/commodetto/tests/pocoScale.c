@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2016-2017  Moddable Tech, Inc.
+ *
+ *   This file is part of the Moddable SDK Runtime.
+ *
+ *   The Moddable SDK Runtime is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   The Moddable SDK Runtime is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with the Moddable SDK Runtime.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+	Rotated and scaled bitmaps.
+
+	A rotated draw must match PocoBitmapDraw of a copy of the source turned clockwise beforehand, and a
+	nearest neighbor draw at a whole multiple of the source size must match a copy enlarged beforehand,
+	both inside a random clip. Scaled draws of any size, nearest and bilinear, must draw the same pixels
+	inside a clip as without it, wherever the clip starts.
+*/
+
+#include "pocoTest.h"
+
+#define kWidth (96)
+#define kHeight (80)
+#define kDraws (3000)
+
+static void begin(Poco poco)
+{
+	PocoDrawingBegin(poco, 0, 0, kWidth, kHeight);
+	PocoRectangleFill(poco, pocoTestMakeColor(5), kPocoOpaque, 0, 0, kWidth, kHeight);
+}
+
+/* the area sx, sy, sw, sh of the source, turned clockwise by rotation and enlarged by scale */
+static void transform(PocoBitmap bits, int rotation, int scale, int sx, int sy, int sw, int sh)
+{
+	int width = ((90 == rotation) || (270 == rotation)) ? sh : sw, height = ((90 == rotation) || (270 == rotation)) ? sw : sh;
+	int rowBytes = pocoTestRowBytes(width * scale), sourceRowBytes = pocoTestRowBytes(kPocoTestSourceWidth);
+	uint8_t *pixels = pocoTestAllocateBitmap(bits, kPocoPixelFormat, width * scale, height * scale);
+	int i, j;
+
+	for (j = 0; j < (height * scale); j++) {
+		for (i = 0; i < (width * scale); i++) {
+			int x = i / scale, y = j / scale, u, v;
+
+			switch (rotation) {
+				case 0:		u = x, v = y; break;
+				case 90:	u = y, v = sh - 1 - x; break;
+				case 180:	u = sw - 1 - x, v = sh - 1 - y; break;
+				default:	u = sw - 1 - y, v = x; break;
+			}
+			pocoTestSetPixel(pixels, rowBytes, i, j, pocoTestGetPixel((const uint8_t *)gPocoTestSource.pixels, sourceRowBytes, sx + u, sy + v));
+		}
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	Poco poco = pocoTestNew(kWidth, kHeight, 16, 65536);
+	uint8_t *expected = pocoTestNewFrame(poco), *actual = pocoTestNewFrame(poco), *background = pocoTestNewFrame(poco);
+	int rowBytes = pocoTestRowBytes(kWidth), frameLength = rowBytes * kHeight;
+	int draw, i, j;
+
+	pocoTestSetup();
+	begin(poco);
+	pocoTestEnd(poco, background);
+
+	for (draw = 0; draw < kDraws; draw++) {
+		int sx = pocoTestBetween(0, kPocoTestSourceWidth - 1), sy = pocoTestBetween(0, kPocoTestSourceHeight - 1);
+		int sw = pocoTestBetween(1, kPocoTestSourceWidth - sx), sh = pocoTestBetween(1, kPocoTestSourceHeight - sy);
+		int x = pocoTestBetween(-40, kWidth - 8), y = pocoTestBetween(-40, kHeight - 8);
+		int cx = pocoTestBetween(0, kWidth / 2), cy = pocoTestBetween(0, kHeight / 2);
+		int cw = pocoTestBetween(1, kWidth), ch = pocoTestBetween(1, kHeight);
+		int rotation = 90 * pocoTestBetween(0, 3), scale = pocoTestBetween(1, 3);
+		int w = pocoTestBetween(1, 160), h = pocoTestBetween(1, 160);
+		PocoScaleMode mode = (PocoScaleMode)pocoTestBetween(0, 1);
+		PocoBitmapRecord bits;
+
+		if (draw & 1)
+			scale = 1;
+		else
+			rotation = 0;
+		transform(&bits, rotation, scale, sx, sy, sw, sh);
+
+		begin(poco);
+		PocoClipPush(poco, cx, cy, cw, ch);
+		PocoBitmapDraw(poco, &bits, x, y, 0, 0, bits.width, bits.height);
+		PocoClipPop(poco);
+		pocoTestCheck(0 == pocoTestEnd(poco, expected), "draw %d: render failed", draw);
+
+		begin(poco);
+		PocoClipPush(poco, cx, cy, cw, ch);
+		if (draw & 1)
+			PocoBitmapDrawRotated(poco, &gPocoTestSource, rotation, x, y, sx, sy, sw, sh);
+		else
+			PocoBitmapDrawScaled(poco, &gPocoTestSource, kPocoScaleNearest, x, y, sw * scale, sh * scale, sx, sy, sw, sh);
+		PocoClipPop(poco);
+		pocoTestCheck(0 == pocoTestEnd(poco, actual), "draw %d: render failed", draw);
+		pocoTestCheck(0 == memcmp(expected, actual, frameLength), "draw %d: %d %d %d %d rotated %d scaled %d at %d %d differs from a transformed copy", draw, sx, sy, sw, sh, rotation, scale, x, y);
+
+		pocoTestFreeBitmap(&bits);
+
+		begin(poco);
+		PocoBitmapDrawScaled(poco, &gPocoTestSource, mode, x, y, w, h, sx, sy, sw, sh);
+		pocoTestCheck(0 == pocoTestEnd(poco, expected), "draw %d: render failed", draw);
+		for (j = 0; j < kHeight; j++) {
+			for (i = 0; i < kWidth; i++) {
+				if ((i < cx) || (i >= (cx + cw)) || (j < cy) || (j >= (cy + ch)))
+					pocoTestSetPixel(expected, rowBytes, i, j, pocoTestGetPixel(background, rowBytes, i, j));
+			}
+		}
+
+		begin(poco);
+		PocoClipPush(poco, cx, cy, cw, ch);
+		PocoBitmapDrawScaled(poco, &gPocoTestSource, mode, x, y, w, h, sx, sy, sw, sh);
+		PocoClipPop(poco);
+		pocoTestCheck(0 == pocoTestEnd(poco, actual), "draw %d: render failed", draw);
+		pocoTestCheck(0 == memcmp(expected, actual, frameLength), "draw %d: %d %d %d %d scaled to %d %d at %d %d mode %d differs when clipped at %d %d", draw, sx, sy, sw, sh, w, h, x, y, mode, cx, cy);
+	}
+
+	free(expected);
+	free(actual);
+	free(background);
+	pocoTestDispose(poco);
+
+	return pocoTestDone("pocoScale");
+}
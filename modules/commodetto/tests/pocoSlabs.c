@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2016-2017  Moddable Tech, Inc.
+ *
+ *   This file is part of the Moddable SDK Runtime.
+ *
+ *   The Moddable SDK Runtime is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   The Moddable SDK Runtime is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with the Moddable SDK Runtime.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+	Random scenes rendered one slab at a time.
+
+	A frame rendered in a single slab walks the display list once, which is the reference. Rendered in
+	several slabs, PocoDrawingEnd visits the commands through the slab index when the display list buffer
+	has room for it, and walks the whole display list for each slab when it does not. Both must match the
+	reference, for slabs of any height, for double buffered slabs, and for update areas that do not start
+	at the top of the screen.
+*/
+
+#include "pocoTest.h"
+
+#define kWidth (160)
+#define kHeight (120)
+#define kScenes (100)
+
+static const int gRows[] = { 1, 3, 8, 17 };
+
+static void draw(Poco poco, uint32_t seed, int x, int y, int w, int h, int count)
+{
+	pocoTestSeed(seed);
+	PocoDrawingBegin(poco, x, y, w, h);
+	PocoRectangleFill(poco, pocoTestMakeColor(0), kPocoOpaque, 0, 0, kWidth, kHeight);		// slabs are not cleared between uses
+	pocoTestScene(poco, count, kPocoTestAll);
+}
+
+/* leaves no room for the slab index after the display list, so every slab walks the whole display list */
+static int endLinear(Poco poco, uint8_t *frame)
+{
+	const char *displayListEnd = poco->displayListEnd;
+	int result;
+
+	poco->displayListEnd = (char *)poco->next;
+	result = pocoTestEnd(poco, frame);
+	poco->displayListEnd = displayListEnd;
+
+	return result;
+}
+
+int main(int argc, char *argv[])
+{
+	Poco whole = pocoTestNew(kWidth, kHeight, kHeight, 65536);
+	uint8_t *expected = pocoTestNewFrame(whole), *actual = pocoTestNewFrame(whole);
+	int frameLength = pocoTestRowBytes(kWidth) * kHeight;
+	int scene, r;
+
+	pocoTestSetup();
+	for (r = 0; r < (int)(sizeof(gRows) / sizeof(gRows[0])); r++) {
+		Poco strip = pocoTestNew(kWidth, kHeight, gRows[r], 65536);
+		Poco pair = pocoTestNew(kWidth, kHeight, gRows[r] * 2, 65536);
+
+		pair->flags |= kPocoFlagDoubleBuffer;
+
+		for (scene = 0; scene < kScenes; scene++) {
+			uint32_t seed = 0x9E3779B9 * (scene + 1);
+			int count, x, y, w, h;
+
+			pocoTestSeed(seed ^ 0x5555);
+			count = pocoTestBetween(1, 300);
+			x = pocoTestBetween(0, kWidth / 2) & ~1;
+			y = pocoTestBetween(0, kHeight / 2);
+			w = (kWidth - x) - (pocoTestBetween(0, kWidth / 4) & ~1);
+			h = (kHeight - y) - pocoTestBetween(0, kHeight / 4);
+			if (scene & 1)
+				x = 0, y = 0, w = kWidth, h = kHeight;
+
+			memset(expected, 0, frameLength);
+			draw(whole, seed, x, y, w, h, count);
+			pocoTestCheck(0 == pocoTestEnd(whole, expected), "scene %d: render failed", scene);
+
+			memset(actual, 0, frameLength);
+			draw(strip, seed, x, y, w, h, count);
+			pocoTestCheck(0 == pocoTestEnd(strip, actual), "scene %d rows %d: indexed render failed", scene, gRows[r]);
+			pocoTestCheck(0 == memcmp(expected, actual, frameLength), "scene %d rows %d: indexed slabs differ from one slab", scene, gRows[r]);
+
+			memset(actual, 0, frameLength);
+			draw(strip, seed, x, y, w, h, count);
+			pocoTestCheck(0 == endLinear(strip, actual), "scene %d rows %d: linear render failed", scene, gRows[r]);
+			pocoTestCheck(0 == memcmp(expected, actual, frameLength), "scene %d rows %d: linear slabs differ from one slab", scene, gRows[r]);
+
+			if (scene & 1) {		// the second buffer starts on a long, so it fits only when rows are whole longs, as they are at full width
+				memset(actual, 0, frameLength);
+				draw(pair, seed, x, y, w, h, count);
+				pocoTestCheck(0 == pocoTestEnd(pair, actual), "scene %d rows %d: double buffered render failed", scene, gRows[r]);
+				pocoTestCheck(0 == memcmp(expected, actual, frameLength), "scene %d rows %d: double buffered slabs differ from one slab", scene, gRows[r]);
+			}
+		}
+
+		pocoTestDispose(strip);
+		pocoTestDispose(pair);
+	}
+
+	free(expected);
+	free(actual);
+	pocoTestDispose(whole);
+
+	return pocoTestDone("pocoSlabs");
+}
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2016-2017  Moddable Tech, Inc.
+ *
+ *   This file is part of the Moddable SDK Runtime.
+ *
+ *   The Moddable SDK Runtime is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   The Moddable SDK Runtime is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with the Moddable SDK Runtime.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+	Random scenes drawn through a small display list.
+
+	When the display list overflows, PocoDrawingSplit divides the update area in two and the scene is drawn
+	again for each half, as Piu and poco.draw do. The frames must match the same scenes drawn through a display
+	list large enough for any of them. An area of one row cannot be split, so scenes that overflow even then
+	are skipped.
+*/
+
+#include "pocoTest.h"
+
+#define kWidth (160)
+#define kHeight (120)
+#define kRows (16)
+#define kScenes (300)
+
+typedef struct {
+	uint32_t	seed;
+	int			count;
+	int			splits;
+	int			overflows;
+} SceneRecord, *Scene;
+
+static void draw(Poco poco, Scene scene, int x, int y, int w, int h)
+{
+	pocoTestSeed(scene->seed);
+	PocoDrawingBegin(poco, x, y, w, h);
+	PocoRectangleFill(poco, pocoTestMakeColor(0), kPocoOpaque, 0, 0, kWidth, kHeight);
+	pocoTestScene(poco, scene->count, kPocoTestAll);
+}
+
+static void render(Poco poco, Scene scene, uint8_t *frame, int x, int y, int w, int h)
+{
+	PocoRectangleRecord first, second;
+
+	draw(poco, scene, x, y, w, h);
+	if (PocoDrawingSplit(poco, &first, &second)) {
+		scene->splits += 1;
+		render(poco, scene, frame, first.x, first.y, first.w, first.h);
+		render(poco, scene, frame, second.x, second.y, second.w, second.h);
+	}
+	else if (pocoTestEnd(poco, frame))
+		scene->overflows += 1;
+}
+
+int main(int argc, char *argv[])
+{
+	Poco large = pocoTestNew(kWidth, kHeight, kRows, 65536);
+	uint8_t *expected = pocoTestNewFrame(large), *actual = pocoTestNewFrame(large);
+	int frameLength = pocoTestRowBytes(kWidth) * kHeight;
+	int splits = 0, i;
+
+	pocoTestSetup();
+	for (i = 0; i < kScenes; i++) {
+		SceneRecord scene;
+		Poco small;
+		int x, y, w, h;
+
+		pocoTestSeed(0x9E3779B9 * (i + 1));
+		scene.seed = pocoTestRandom();
+		scene.count = pocoTestBetween(1, 200);
+		scene.splits = 0;
+		scene.overflows = 0;
+		x = pocoTestBetween(0, kWidth / 2) & ~1;
+		y = pocoTestBetween(0, kHeight / 2);
+		w = (kWidth - x) - (pocoTestBetween(0, kWidth / 4) & ~1);
+		h = (kHeight - y) - pocoTestBetween(0, kHeight / 4);
+		small = pocoTestNew(kWidth, kHeight, kRows, pocoTestBetween(256, 1280));
+
+		memset(expected, 0, frameLength);
+		draw(large, &scene, x, y, w, h);
+		pocoTestCheck(0 == pocoTestEnd(large, expected), "scene %d: render failed", i);
+
+		memset(actual, 0, frameLength);
+		render(small, &scene, actual, x, y, w, h);
+		if (!scene.overflows)
+			pocoTestCheck(0 == memcmp(expected, actual, frameLength), "scene %d: drawn in %d splits differs from one pass", i, scene.splits);
+		splits += scene.splits;
+
+		pocoTestDispose(small);
+	}
+	pocoTestCheck(splits > kScenes, "only %d splits", splits);
+
+	free(expected);
+	free(actual);
+	pocoTestDispose(large);
+
+	return pocoTestDone("pocoSplit");
+}
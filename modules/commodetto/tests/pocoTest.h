@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) 2016-2017  Moddable Tech, Inc.
+ *
+ *   This file is part of the Moddable SDK Runtime.
+ *
+ *   The Moddable SDK Runtime is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   The Moddable SDK Runtime is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with the Moddable SDK Runtime.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+	Helpers shared by the host tests of the Poco blitters.
+
+	Each test is built once per pixel format, with kCommodettoBitmapFormat set by the makefile. Frames are
+	rendered into a full screen buffer, with the rows of 4-bit formats rounded up to whole bytes. Update areas
+	of 4-bit formats start at even x.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "commodettoPocoBlit.h"
+
+#define kPocoTestSourceWidth (64)
+#define kPocoTestSourceHeight (64)
+
+enum {
+	kPocoTestFill = 1 << 0,
+	kPocoTestBlend = 1 << 1,
+	kPocoTestPixel = 1 << 2,
+	kPocoTestBitmap = 1 << 3,
+	kPocoTestMonochrome = 1 << 4,
+	kPocoTestGray = 1 << 5,
+	kPocoTestMasked = 1 << 6,
+	kPocoTestPattern = 1 << 7,
+	kPocoTestScaled = 1 << 8,
+	kPocoTestRotated = 1 << 9,
+	kPocoTestClip = 1 << 10,
+	kPocoTestAll = (1 << 11) - 1
+};
+
+typedef struct {
+	Poco			poco;
+	uint8_t			*frame;
+	int				frameRowBytes;
+	int				row;
+} PocoTestFrameRecord, *PocoTestFrame;
+
+static int gPocoTestFailures = 0;
+static uint32_t gPocoTestSeed = 1;
+
+static PocoBitmapRecord gPocoTestSource;
+static PocoBitmapRecord gPocoTestGray;
+static PocoBitmapRecord gPocoTestMonochrome;
+static PocoBitmapRecord gPocoTestMask;
+
+#define pocoTestCheck(condition, ...) \
+	do { \
+		if (!(condition)) { \
+			if (gPocoTestFailures++ < 10) { \
+				fprintf(stderr, "# %s:%d: ", __FILE__, __LINE__); \
+				fprintf(stderr, __VA_ARGS__); \
+				fprintf(stderr, "\n"); \
+			} \
+		} \
+	} while (0)
+
+static uint32_t pocoTestRandom(void)
+{
+	uint32_t x = gPocoTestSeed;		// xorshift32
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return gPocoTestSeed = x;
+}
+
+static int pocoTestBetween(int min, int max)
+{
+	return min + (int)(pocoTestRandom() % (uint32_t)(max - min + 1));
+}
+
+static void pocoTestSeed(uint32_t seed)
+{
+	gPocoTestSeed = seed ? seed : 1;
+}
+
+static int pocoTestRowBytes(int width)
+{
+	return ((width * kPocoPixelSize) + 7) >> 3;
+}
+
+static int pocoTestGetPixel(const uint8_t *pixels, int rowBytes, int x, int y)
+{
+#if 4 == kPocoPixelSize
+	uint8_t twoPixels = pixels[(y * rowBytes) + (x >> 1)];
+	return (x & 1) ? ((twoPixels >> kPocoPixels4SecondShift) & 0x0F) : ((twoPixels >> kPocoPixels4FirstShift) & 0x0F);
+#else
+	return ((const PocoPixel *)(pixels + (y * rowBytes)))[x];
+#endif
+}
+
+static void pocoTestSetPixel(uint8_t *pixels, int rowBytes, int x, int y, int pixel)
+{
+#if 4 == kPocoPixelSize
+	uint8_t *twoPixels = &pixels[(y * rowBytes) + (x >> 1)];
+	if (x & 1)
+		*twoPixels = (*twoPixels & kPocoPixels4FirstMask) | (pixel << kPocoPixels4SecondShift);
+	else
+		*twoPixels = (*twoPixels & kPocoPixels4SecondMask) | (pixel << kPocoPixels4FirstShift);
+#else
+	((PocoPixel *)(pixels + (y * rowBytes)))[x] = (PocoPixel)pixel;
+#endif
+}
+
+static int pocoTestBitmapBytes(PocoBitmapFormat format, int width, int height)
+{
+	int depth = (kCommodettoBitmapMonochrome == format) ? 1 : (kCommodettoBitmapGray16 == format) ? 4 : kPocoPixelSize;
+	return (((width * depth) + 7) >> 3) * height;
+}
+
+/*
+	CLUT16 bitmaps are preceded by their 16 entry color table, stored as 32-bit RGB. The tests use a
+	gray ramp everywhere, so the inverse table of the Poco maps colors back to the same indices.
+*/
+
+static uint8_t *pocoTestAllocateBitmap(PocoBitmap bits, PocoBitmapFormat format, int width, int height)
+{
+	int size = pocoTestBitmapBytes(format, width, height);
+	uint8_t *buffer = calloc(1, 64 + size + 16);
+	int i;
+
+	for (i = 0; i < 16; i++) {
+		uint32_t entry = (i << 4) * 0x010101;
+		memcpy(buffer + (i * 4), &entry, 4);
+	}
+	bits->width = width;
+	bits->height = height;
+	bits->format = format;
+	bits->pixels = (PocoPixel *)(buffer + 64);
+	return buffer + 64;
+}
+
+static void pocoTestFreeBitmap(PocoBitmap bits)
+{
+	free(((uint8_t *)bits->pixels) - 64);
+}
+
+static void pocoTestRandomBitmap(PocoBitmap bits, PocoBitmapFormat format, int width, int height)
+{
+	int size = pocoTestBitmapBytes(format, width, height);
+	uint8_t *pixels = pocoTestAllocateBitmap(bits, format, width, height);
+	while (size--)
+		*pixels++ = (uint8_t)pocoTestRandom();
+}
+
+static void pocoTestSetup(void)
+{
+	pocoTestSeed(12345);
+	pocoTestRandomBitmap(&gPocoTestSource, kPocoPixelFormat, kPocoTestSourceWidth, kPocoTestSourceHeight);
+	pocoTestRandomBitmap(&gPocoTestGray, kCommodettoBitmapGray16, kPocoTestSourceWidth, kPocoTestSourceHeight);
+	pocoTestRandomBitmap(&gPocoTestMonochrome, kCommodettoBitmapMonochrome, kPocoTestSourceWidth, kPocoTestSourceHeight);
+	pocoTestRandomBitmap(&gPocoTestMask, kCommodettoBitmapGray16, kPocoTestSourceWidth, kPocoTestSourceHeight);
+}
+
+static Poco pocoTestNew(PocoDimension width, PocoDimension height, int rows, int displayListLength)
+{
+	int pixelsLength = pocoTestRowBytes(width) * rows;
+	Poco poco = calloc(1, sizeof(PocoRecord) + pixelsLength);
+
+	poco->width = width;
+	poco->height = height;
+	poco->pixelsLength = pixelsLength;
+	poco->displayList = malloc(displayListLength);		// apart from the pixels, so that tools catch rows written past the slab
+	poco->displayListEnd = poco->displayList + displayListLength;
+#if kCommodettoBitmapCLUT16 == kPocoPixelFormat
+	{
+		int i;
+		poco->clut = malloc(32 + 4096);
+		for (i = 0; i < 16; i++)
+			((uint16_t *)poco->clut)[i] = i * 0x111;
+		for (i = 0; i < 4096; i++)
+			poco->clut[32 + i] = (i >> 4) & 0x0F;
+	}
+#endif
+	return poco;
+}
+
+static void pocoTestDispose(Poco poco)
+{
+#if kCommodettoBitmapCLUT16 == kPocoPixelFormat
+	free(poco->clut);
+#endif
+	free(poco->displayList);
+	free(poco);
+}
+
+static PocoColor pocoTestMakeColor(uint32_t value)
+{
+#if 4 == kPocoPixelSize
+	return (PocoColor)(value & 0x0F);
+#else
+	return (PocoColor)value;
+#endif
+}
+
+static PocoColor pocoTestColor(void)
+{
+	return pocoTestMakeColor(pocoTestRandom());
+}
+
+static void pocoTestReceiver(PocoPixel *pixels, int byteCount, void *refCon)
+{
+	PocoTestFrame frame = refCon;
+	Poco poco = frame->poco;
+	int rowBytes = poco->rowBytes, offset;
+
+	for (offset = 0; offset < byteCount; offset += rowBytes, frame->row++)
+		memcpy(frame->frame + ((poco->y + frame->row) * frame->frameRowBytes) + ((poco->x * kPocoPixelSize) >> 3), offset + (uint8_t *)pixels, rowBytes);
+}
+
+/* renders the display list into the frame, which is poco->width by poco->height */
+static int pocoTestEnd(Poco poco, uint8_t *frame)
+{
+	PocoTestFrameRecord record;
+
+	record.poco = poco;
+	record.frame = frame;
+	record.frameRowBytes = pocoTestRowBytes(poco->width);
+	record.row = 0;
+	return PocoDrawingEnd(poco, poco->pixels, poco->pixelsLength, pocoTestReceiver, &record);
+}
+
+static uint8_t *pocoTestNewFrame(Poco poco)
+{
+	return calloc(1, pocoTestRowBytes(poco->width) * poco->height);
+}
+
+/* adds count random commands of the given kinds, drawn from the current seed, to the display list */
+static void pocoTestScene(Poco poco, int count, int kinds)
+{
+	int clips = 0;
+
+	while (count--) {
+		int x = pocoTestBetween(-40, poco->width), y = pocoTestBetween(-40, poco->height);
+		int w = pocoTestBetween(0, 120), h = pocoTestBetween(0, 120);
+		int sx = pocoTestBetween(0, kPocoTestSourceWidth - 1), sy = pocoTestBetween(0, kPocoTestSourceHeight - 1);
+		int sw = pocoTestBetween(1, kPocoTestSourceWidth - sx), sh = pocoTestBetween(1, kPocoTestSourceHeight - sy);
+		PocoColor color = pocoTestColor();
+		int kind = pocoTestBetween(0, 10);
+
+		if (!(kinds & (1 << kind)))
+			kind = 0;
+		if (!(kinds & (1 << kind)))
+			continue;
+
+		switch (1 << kind) {
+			case kPocoTestFill:
+				PocoRectangleFill(poco, color, kPocoOpaque, x, y, w, h);
+				break;
+			case kPocoTestBlend:
+				PocoRectangleFill(poco, color, (uint8_t)pocoTestBetween(0, 254), x, y, w, h);
+				break;
+			case kPocoTestPixel:
+				PocoPixelDraw(poco, color, x, y);
+				break;
+			case kPocoTestBitmap:
+				PocoBitmapDraw(poco, &gPocoTestSource, x, y, sx, sy, sw, sh);
+				break;
+			case kPocoTestMonochrome:
+				PocoMonochromeBitmapDraw(poco, &gPocoTestMonochrome, (PocoMonochromeMode)pocoTestBetween(1, 3), color, pocoTestColor(), x, y, sx, sy, sw, sh);
+				break;
+			case kPocoTestGray:
+				PocoGrayBitmapDraw(poco, &gPocoTestGray, color, (uint8_t)pocoTestBetween(0, 255), x, y, sx & ~1, sy, sw & ~1, sh);
+				break;
+			case kPocoTestMasked:
+				PocoBitmapDrawMasked(poco, (uint8_t)pocoTestBetween(0, 255), &gPocoTestSource, x, y, sx & ~1, sy, sw & ~1, sh, &gPocoTestMask, sx & ~1, sy);
+				break;
+			case kPocoTestPattern:
+				PocoBitmapPattern(poco, &gPocoTestSource, x, y, w, h, sx, sy, sw, sh);
+				break;
+			case kPocoTestScaled:
+				PocoBitmapDrawScaled(poco, &gPocoTestSource, (PocoScaleMode)pocoTestBetween(0, 1), x, y, w, h, sx, sy, sw, sh);
+				break;
+			case kPocoTestRotated:
+				PocoBitmapDrawRotated(poco, &gPocoTestSource, 90 * pocoTestBetween(0, 3), x, y, sx, sy, sw, sh);
+				break;
+			case kPocoTestClip:
+				if ((clips < 4) && pocoTestBetween(0, 1)) {
+					PocoClipPush(poco, x, y, w + 20, h + 20);
+					clips++;
+				}
+				else if (clips) {
+					PocoClipPop(poco);
+					clips--;
+				}
+				break;
+		}
+	}
+	while (clips--)
+		PocoClipPop(poco);
+}
+
+static int pocoTestDone(const char *name)
+{
+	printf("%s %d: %s\n", name, kPocoPixelFormat, gPocoTestFailures ? "FAILED" : "passed");
+	return gPocoTestFailures ? 1 : 0;
+}
@@ -0,0 +1,580 @@
+/*
+ * Copyright (c) 2016-2017  Moddable Tech, Inc.
+ *
+ *   This file is part of the Moddable SDK Runtime.
+ *
+ *   The Moddable SDK Runtime is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   The Moddable SDK Runtime is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with the Moddable SDK Runtime.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+	JPEG blocks decoded at every scale and within areas.
+
+	Random smooth images are encoded here as baseline JPEG, grayscale or with H1V1, H2V1, H1V2 or H2V2
+	sampling, with and without restart intervals. Decoded at full size, 1/2, 1/4 and 1/8, they must be close to
+	the pixels encoded, averaged over the pixels each one covers, and for subsampled chroma over the pixels its
+	chroma covers. Decoded within a random area, the blocks returned must be the ones that intersect it, with
+	the same pixels as the whole image decoded at the same scale. Blocks of the pixel format must match blocks
+	of 24-bit RGB converted one pixel at a time, except for CLUT16, and truncated files must fail without
+	reading past their end.
+
+	The bindings of commodettoReadJPEG.c are compiled but not called, so its reader is driven here, as the
+	constructor and read drive it.
+*/
+
+#include "pocoTest.h"
+#include "xsPlatform.h"			// c_malloc and the rest, which device builds get from their platform
+#include "commodettoReadJPEG.c"
+
+#include <math.h>
+
+#define kImages (100)
+#define kAreas (8)
+
+#if kCommodettoBitmapCLUT16 == kPocoPixelFormat
+	#define expectedPixel(r, g, b) (-1)		// the reader has no color table to find indices in, so the pixels are not checked
+#else
+	#define expectedPixel(r, g, b) ((PocoPixel)makePixel(r, g, b))
+#endif
+
+typedef struct {
+	uint8_t		*bytes;
+	int			length;
+
+	int			width;
+	int			height;
+	int			gray;
+	int			hs;
+	int			vs;
+	int			restart;
+	uint8_t		*rgb;
+} TestImageRecord, *TestImage;
+
+static const uint8_t gZigZag[64] = {
+	0, 1, 8, 16, 9, 2, 3, 10, 17, 24, 32, 25, 18, 11, 4, 5, 12, 19, 26, 33, 40, 48, 41, 34, 27, 20, 13, 6, 7, 14, 21, 28,
+	35, 42, 49, 56, 57, 50, 43, 36, 29, 22, 15, 23, 30, 37, 44, 51, 58, 59, 52, 45, 38, 31, 39, 46, 53, 60, 61, 54, 47, 55, 62, 63
+};
+static const uint8_t gQuantization[2][64] = {
+	{
+		16, 11, 10, 16, 24, 40, 51, 61, 12, 12, 14, 19, 26, 58, 60, 55, 14, 13, 16, 24, 40, 57, 69, 56, 14, 17, 22, 29, 51, 87, 80, 62,
+		18, 22, 37, 56, 68, 109, 103, 77, 24, 35, 55, 64, 81, 104, 113, 92, 49, 64, 78, 87, 103, 121, 120, 101, 72, 92, 95, 98, 112, 100, 103, 99
+	},
+	{
+		17, 18, 24, 47, 99, 99, 99, 99, 18, 21, 26, 66, 99, 99, 99, 99, 24, 26, 56, 99, 99, 99, 99, 99, 47, 66, 99, 99, 99, 99, 99, 99,
+		99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99, 99
+	}
+};
+static const uint8_t gDCBits[2][16] = {
+	{ 0, 1, 5, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0 },
+	{ 0, 3, 1, 1, 1, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0 }
+};
+static const uint8_t gDCValues[12] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11 };
+static const uint8_t gACBits[2][16] = {
+	{ 0, 2, 1, 3, 3, 2, 4, 3, 5, 5, 4, 4, 0, 0, 1, 0x7D },
+	{ 0, 2, 1, 2, 4, 4, 3, 4, 7, 5, 4, 4, 0, 1, 2, 0x77 }
+};
+static const uint8_t gACValues[2][162] = {
+	{
+		0x01, 0x02, 0x03, 0x00, 0x04, 0x11, 0x05, 0x12, 0x21, 0x31, 0x41, 0x06, 0x13, 0x51, 0x61, 0x07, 0x22, 0x71, 0x14, 0x32, 0x81, 0x91, 0xA1, 0x08,
+		0x23, 0x42, 0xB1, 0xC1, 0x15, 0x52, 0xD1, 0xF0, 0x24, 0x33, 0x62, 0x72, 0x82, 0x09, 0x0A, 0x16, 0x17, 0x18, 0x19, 0x1A, 0x25, 0x26, 0x27, 0x28,
+		0x29, 0x2A, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4A, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58, 0x59,
+		0x5A, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6A, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x83, 0x84, 0x85, 0x86, 0x87, 0x88, 0x89,
+		0x8A, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7, 0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4, 0xB5, 0xB6,
+		0xB7, 0xB8, 0xB9, 0xBA, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA, 0xE1, 0xE2,
+		0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA, 0xF1, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8, 0xF9, 0xFA
+	},
+	{
+		0x00, 0x01, 0x02, 0x03, 0x11, 0x04, 0x05, 0x21, 0x31, 0x06, 0x12, 0x41, 0x51, 0x07, 0x61, 0x71, 0x13, 0x22, 0x32, 0x81, 0x08, 0x14, 0x42, 0x91,
+		0xA1, 0xB1, 0xC1, 0x09, 0x23, 0x33, 0x52, 0xF0, 0x15, 0x62, 0x72, 0xD1, 0x0A, 0x16, 0x24, 0x34, 0xE1, 0x25, 0xF1, 0x17, 0x18, 0x19, 0x1A, 0x26,
+		0x27, 0x28, 0x29, 0x2A, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x43, 0x44, 0x45, 0x46, 0x47, 0x48, 0x49, 0x4A, 0x53, 0x54, 0x55, 0x56, 0x57, 0x58,
+		0x59, 0x5A, 0x63, 0x64, 0x65, 0x66, 0x67, 0x68, 0x69, 0x6A, 0x73, 0x74, 0x75, 0x76, 0x77, 0x78, 0x79, 0x7A, 0x82, 0x83, 0x84, 0x85, 0x86, 0x87,
+		0x88, 0x89, 0x8A, 0x92, 0x93, 0x94, 0x95, 0x96, 0x97, 0x98, 0x99, 0x9A, 0xA2, 0xA3, 0xA4, 0xA5, 0xA6, 0xA7, 0xA8, 0xA9, 0xAA, 0xB2, 0xB3, 0xB4,
+		0xB5, 0xB6, 0xB7, 0xB8, 0xB9, 0xBA, 0xC2, 0xC3, 0xC4, 0xC5, 0xC6, 0xC7, 0xC8, 0xC9, 0xCA, 0xD2, 0xD3, 0xD4, 0xD5, 0xD6, 0xD7, 0xD8, 0xD9, 0xDA,
+		0xE2, 0xE3, 0xE4, 0xE5, 0xE6, 0xE7, 0xE8, 0xE9, 0xEA, 0xF2, 0xF3, 0xF4, 0xF5, 0xF6, 0xF7, 0xF8, 0xF9, 0xFA
+	}
+};
+
+typedef struct {
+	uint16_t	code[256];
+	uint8_t		length[256];
+} HuffmanRecord, *Huffman;
+
+typedef struct {
+	uint8_t		*out;
+	uint32_t	bits;
+	int			count;
+} BitsRecord, *Bits;
+
+static void makeHuffman(Huffman huffman, const uint8_t *bits, const uint8_t *values)
+{
+	int code = 0, k = 0, length, i;
+
+	for (length = 1; length <= 16; length++) {
+		for (i = 0; i < bits[length - 1]; i++, k++, code++) {
+			huffman->code[values[k]] = (uint16_t)code;
+			huffman->length[values[k]] = (uint8_t)length;
+		}
+		code <<= 1;
+	}
+}
+
+static void putBits(Bits bits, int value, int count)
+{
+	bits->bits = (bits->bits << count) | (value & ((1 << count) - 1));
+	bits->count += count;
+	while (bits->count >= 8) {
+		uint8_t byte = (uint8_t)(bits->bits >> (bits->count - 8));
+		*bits->out++ = byte;
+		if (0xFF == byte)
+			*bits->out++ = 0;		// stuffed
+		bits->count -= 8;
+	}
+}
+
+static void flushBits(Bits bits)
+{
+	if (bits->count)
+		putBits(bits, 0x7F, 8 - bits->count);
+}
+
+static int magnitude(int value)
+{
+	int count = 0;
+
+	value = abs(value);
+	while (value) {
+		count++;
+		value >>= 1;
+	}
+	return count;
+}
+
+static uint8_t *putSegment(uint8_t *out, int marker, const uint8_t *data, int length)
+{
+	*out++ = 0xFF;
+	*out++ = (uint8_t)marker;
+	*out++ = (uint8_t)((length + 2) >> 8);
+	*out++ = (uint8_t)(length + 2);
+	memcpy(out, data, length);
+	return out + length;
+}
+
+/* the luminance or chrominance of the source pixel, with the edges repeated past the end */
+static double sample(TestImage image, int component, int x, int y)
+{
+	const uint8_t *p;
+
+	if (x >= image->width)
+		x = image->width - 1;
+	if (y >= image->height)
+		y = image->height - 1;
+	p = image->rgb + (((y * image->width) + x) * 3);
+	if (0 == component)
+		return (0.299 * p[0]) + (0.587 * p[1]) + (0.114 * p[2]);
+	if (1 == component)
+		return (-0.168736 * p[0]) - (0.331264 * p[1]) + (0.5 * p[2]) + 128;
+	return (0.5 * p[0]) - (0.418688 * p[1]) - (0.081312 * p[2]) + 128;
+}
+
+static void encodeBlock(TestImage image, Bits bits, int component, int x, int y, const uint8_t *q, Huffman dc, Huffman ac, int *predictor)
+{
+	double block[64], coefficient[64];
+	int zz[64], run = 0, i, j, u, v, k, difference, count;
+	int hs = component ? image->hs : 1, vs = component ? image->vs : 1;
+
+	for (j = 0; j < 8; j++) {
+		for (i = 0; i < 8; i++) {
+			double sum = 0;
+			for (v = 0; v < vs; v++) {
+				for (u = 0; u < hs; u++)
+					sum += sample(image, component, x + (i * hs) + u, y + (j * vs) + v);
+			}
+			block[(j * 8) + i] = (sum / (hs * vs)) - 128;
+		}
+	}
+	for (v = 0; v < 8; v++) {
+		for (u = 0; u < 8; u++) {
+			double sum = 0;
+			for (j = 0; j < 8; j++) {
+				for (i = 0; i < 8; i++)
+					sum += block[(j * 8) + i] * cos(((2 * i) + 1) * u * M_PI / 16) * cos(((2 * j) + 1) * v * M_PI / 16);
+			}
+			coefficient[(v * 8) + u] = sum * (u ? 0.5 : M_SQRT1_2 / 2) * (v ? 0.5 : M_SQRT1_2 / 2);
+		}
+	}
+	for (k = 0; k < 64; k++)
+		zz[k] = (int)lround(coefficient[gZigZag[k]] / q[k]);
+
+	difference = zz[0] - *predictor;
+	*predictor = zz[0];
+	count = magnitude(difference);
+	putBits(bits, dc->code[count], dc->length[count]);
+	if (count)
+		putBits(bits, (difference > 0) ? difference : (difference - 1), count);
+	for (k = 1; k < 64; k++) {
+		if (0 == zz[k]) {
+			run++;
+			continue;
+		}
+		for (; run > 15; run -= 16)
+			putBits(bits, ac->code[0xF0], ac->length[0xF0]);
+		count = magnitude(zz[k]);
+		putBits(bits, ac->code[(run << 4) | count], ac->length[(run << 4) | count]);
+		putBits(bits, (zz[k] > 0) ? zz[k] : (zz[k] - 1), count);
+		run = 0;
+	}
+	if (run)
+		putBits(bits, ac->code[0], ac->length[0]);
+}
+
+static void makeImage(TestImage image)
+{
+	static const int sampling[5][3] = { { 1, 1, 1 }, { 0, 1, 1 }, { 0, 2, 1 }, { 0, 1, 2 }, { 0, 2, 2 } };
+	const int *mode = sampling[pocoTestBetween(0, 4)];
+	int quality = pocoTestBetween(50, 95), factor = 200 - (quality * 2), components, mcuWidth, mcuHeight, mcuX, mcuY, count = 0, i, x, y;
+	double cx, cy, a, b;
+	uint8_t q[2][64], segment[256], *out;
+	HuffmanRecord dc[2], ac[2];
+	BitsRecord bits;
+	int predictor[3] = { 0 };
+
+	image->width = pocoTestBetween(1, 90);
+	image->height = pocoTestBetween(1, 70);
+	image->gray = mode[0];
+	image->hs = mode[1];
+	image->vs = mode[2];
+	image->restart = pocoTestBetween(0, 1) ? 0 : pocoTestBetween(1, 7);
+	components = image->gray ? 1 : 3;
+
+	// gradients and waves, smooth enough to survive quantization and chroma subsampling
+	image->rgb = malloc(image->width * image->height * 3);
+	cx = pocoTestBetween(0, image->width);
+	cy = pocoTestBetween(0, image->height);
+	a = pocoTestBetween(8, 16);
+	b = pocoTestBetween(8, 16);
+	for (y = 0, out = image->rgb; y < image->height; y++) {
+		for (x = 0; x < image->width; x++, out += 3) {
+			out[0] = (uint8_t)(128 + (100 * sin((x / a) + (y / 23.0))));
+			out[1] = (uint8_t)(128 + (100 * cos(hypot(x - cx, y - cy) / b)));
+			out[2] = (uint8_t)(((x + y) * 255) / (image->width + image->height));
+			if (image->gray)
+				out[0] = out[1] = out[2] = (uint8_t)lround(sample(image, 0, x, y));
+		}
+	}
+
+	for (i = 0; i < 64; i++) {
+		int value = ((gQuantization[0][gZigZag[i]] * factor) + 50) / 100;
+		q[0][i] = (uint8_t)((value < 1) ? 1 : (value > 255) ? 255 : value);
+		value = ((gQuantization[1][gZigZag[i]] * factor) + 50) / 100;
+		q[1][i] = (uint8_t)((value < 1) ? 1 : (value > 255) ? 255 : value);
+	}
+	for (i = 0; i < 2; i++) {
+		makeHuffman(&dc[i], gDCBits[i], gDCValues);
+		makeHuffman(&ac[i], gACBits[i], gACValues[i]);
+	}
+
+	image->bytes = malloc(2048 + (image->width * image->height * 8));
+	out = image->bytes;
+	*out++ = 0xFF;
+	*out++ = 0xD8;
+	segment[0] = 0;
+	memcpy(segment + 1, q[0], 64);
+	segment[65] = 1;
+	memcpy(segment + 66, q[1], 64);
+	out = putSegment(out, 0xDB, segment, 130);
+	segment[0] = 8;
+	segment[1] = (uint8_t)(image->height >> 8), segment[2] = (uint8_t)image->height;
+	segment[3] = (uint8_t)(image->width >> 8), segment[4] = (uint8_t)image->width;
+	segment[5] = (uint8_t)components;
+	segment[6] = 1, segment[7] = (uint8_t)((image->hs << 4) | image->vs), segment[8] = 0;
+	segment[9] = 2, segment[10] = 0x11, segment[11] = 1;
+	segment[12] = 3, segment[13] = 0x11, segment[14] = 1;
+	out = putSegment(out, 0xC0, segment, 6 + (components * 3));
+	for (i = 0; i < (image->gray ? 1 : 2); i++) {
+		segment[0] = (uint8_t)i;
+		memcpy(segment + 1, gDCBits[i], 16);
+		memcpy(segment + 17, gDCValues, 12);
+		out = putSegment(out, 0xC4, segment, 29);
+		segment[0] = (uint8_t)(0x10 | i);
+		memcpy(segment + 1, gACBits[i], 16);
+		memcpy(segment + 17, gACValues[i], 162);
+		out = putSegment(out, 0xC4, segment, 179);
+	}
+	if (image->restart) {
+		segment[0] = 0;
+		segment[1] = (uint8_t)image->restart;
+		out = putSegment(out, 0xDD, segment, 2);
+	}
+	segment[0] = (uint8_t)components;
+	segment[1] = 1, segment[2] = 0x00;
+	segment[3] = 2, segment[4] = 0x11;
+	segment[5] = 3, segment[6] = 0x11;
+	segment[(components * 2) + 1] = 0, segment[(components * 2) + 2] = 63, segment[(components * 2) + 3] = 0;
+	out = putSegment(out, 0xDA, segment, 4 + (components * 2));
+
+	bits.out = out;
+	bits.bits = 0;
+	bits.count = 0;
+	mcuWidth = 8 * image->hs;
+	mcuHeight = 8 * image->vs;
+	for (mcuY = 0; mcuY < image->height; mcuY += mcuHeight) {
+		for (mcuX = 0; mcuX < image->width; mcuX += mcuWidth, count++) {
+			if (image->restart && count && (0 == (count % image->restart))) {
+				flushBits(&bits);
+				*bits.out++ = 0xFF;
+				*bits.out++ = (uint8_t)(0xD0 + (((count / image->restart) - 1) & 7));
+				predictor[0] = predictor[1] = predictor[2] = 0;
+			}
+			for (y = 0; y < image->vs; y++) {
+				for (x = 0; x < image->hs; x++)
+					encodeBlock(image, &bits, 0, mcuX + (x * 8), mcuY + (y * 8), q[0], &dc[0], &ac[0], &predictor[0]);
+			}
+			if (!image->gray) {
+				encodeBlock(image, &bits, 1, mcuX, mcuY, q[1], &dc[1], &ac[1], &predictor[1]);
+				encodeBlock(image, &bits, 2, mcuX, mcuY, q[1], &dc[1], &ac[1], &predictor[2]);
+			}
+		}
+	}
+	flushBits(&bits);
+	out = bits.out;
+	*out++ = 0xFF;
+	*out++ = 0xD9;
+	image->length = out - image->bytes;
+}
+
+typedef struct {
+	const uint8_t	*bytes;
+	int				length;
+	int				position;
+} SourceRecord, *Source;
+
+static unsigned char sourceBytes(unsigned char* pBuf, unsigned char buf_size, unsigned char *pBytes_actually_read, void *pCallback_data)
+{
+	Source source = pCallback_data;
+
+	if (buf_size > (source->length - source->position))
+		buf_size = source->length - source->position;
+	memcpy(pBuf, source->bytes + source->position, buf_size);
+	*pBytes_actually_read = buf_size;
+	source->position += buf_size;
+
+	return 0;
+}
+
+/*
+	decodes the blocks of an area of the image into a frame the size of the scaled image, as 24-bit RGB or in the pixel
+	format. area is NULL for all of it. returns the result of the last read.
+*/
+
+static int decode(TestImage image, const uint8_t *bytes, int length, int scale, int rgb, PocoRectangle area, uint8_t *frame, uint8_t *covered, int index)
+{
+	pjpeg_image_info_t info;
+	SourceRecord source = { bytes, length, 0 };
+	JPEGRecord record = { 0 };
+	JPEG jpeg = &record;
+	int width = (image->width + (1 << scale) - 1) >> scale, height = (image->height + (1 << scale) - 1) >> scale;
+	int pixelSize = rgb ? 24 : kPocoPixelSize, frameRowBytes = rgb ? (width * 3) : pocoTestRowBytes(width), result, i, j;
+
+	result = pjpeg_decode_init(&info, sourceBytes, &source, (unsigned char)scale);
+	if (result)
+		return result;
+
+	jpegBlocks(jpeg, &info, (unsigned char)scale);
+	if (area)
+		jpegArea(jpeg, area->x, area->y, area->w, area->h);
+#if (16 == kPocoPixelSize) || (8 == kPocoPixelSize)
+	jpeg->convert = (convertto)convertto_16and8;
+#else
+	jpeg->convert = (convertto)convertto_4;
+#endif
+	if (rgb)
+		jpeg->convert = (convertto)convertto_24;
+	jpeg->pixels = malloc((((jpeg->mcuWidth * pixelSize) + 7) >> 3) * jpeg->mcuHeight);		// as the constructor allocates them
+
+	memset(covered, 0, width * height);
+	while (1) {
+		CommodettoBitmapRecord block;
+		int x, y, rowBytes;
+
+		result = jpegRead(jpeg, &block, &x, &y);
+		if (result)
+			break;
+
+		pocoTestCheck((x >= 0) && (y >= 0) && ((x + block.w) <= width) && ((y + block.h) <= height), "image %d scale %d: block %d %d %d %d outside %d x %d", index, scale, x, y, block.w, block.h, width, height);
+		if (area)
+			pocoTestCheck((x < (area->x + area->w)) && ((x + block.w) > area->x) && (y < (area->y + area->h)) && ((y + block.h) > area->y),
+				"image %d scale %d: block %d %d %d %d outside the area %d %d %d %d", index, scale, x, y, block.w, block.h, area->x, area->y, area->w, area->h);
+		if ((x < 0) || (y < 0) || ((x + block.w) > width) || ((y + block.h) > height))
+			continue;
+
+		rowBytes = ((block.w * pixelSize) + 7) >> 3;
+		for (j = 0; j < block.h; j++) {
+			for (i = 0; i < block.w; i++) {
+				covered[((y + j) * width) + x + i] += 1;
+				if (rgb)
+					memcpy(frame + ((y + j) * frameRowBytes) + ((x + i) * 3), jpeg->pixels + (j * rowBytes) + (i * 3), 3);
+				else
+					pocoTestSetPixel(frame, frameRowBytes, x + i, y + j, pocoTestGetPixel(jpeg->pixels, rowBytes, i, j));
+			}
+		}
+	}
+
+	free(jpeg->pixels);
+	return result;
+}
+
+/* the average of a component of the source over an area, with the edges repeated past the end, as the encoder repeats them */
+static double average(TestImage image, int component, int x, int y, int w, int h)
+{
+	double sum = 0;
+	int i, j;
+
+	for (j = y; j < (y + h); j++) {
+		for (i = x; i < (x + w); i++)
+			sum += sample(image, component, i, j);
+	}
+	return sum / (w * h);
+}
+
+static int clampByte(double value)
+{
+	return (value < 0) ? 0 : (value > 255) ? 255 : (int)lround(value);
+}
+
+/*
+	the mean difference of the decode at 1 / (1 << scale) from the source averaged over the pixels each one covers:
+	the luminance over the scaled pixel, and the chroma over the pixels its subsampled chroma covers
+*/
+
+static double scaledError(TestImage image, const uint8_t *frame, int scale)
+{
+	int width = (image->width + (1 << scale) - 1) >> scale, height = (image->height + (1 << scale) - 1) >> scale, n = 1 << scale;
+	int hs = image->gray ? 1 : image->hs, vs = image->gray ? 1 : image->vs;
+	double error = 0;
+	int x, y;
+
+	for (y = 0; y < height; y++) {
+		for (x = 0; x < width; x++) {
+			const uint8_t *p = frame + (((y * width) + x) * 3);
+			double luminance = average(image, 0, x * n, y * n, n, n), cb = 128, cr = 128;
+
+			if (!image->gray) {
+				cb = average(image, 1, (x / hs) * hs * n, (y / vs) * vs * n, hs * n, vs * n);
+				cr = average(image, 2, (x / hs) * hs * n, (y / vs) * vs * n, hs * n, vs * n);
+			}
+			error += abs(p[0] - clampByte(luminance + (1.402 * (cr - 128))));
+			error += abs(p[1] - clampByte(luminance - (0.344136 * (cb - 128)) - (0.714136 * (cr - 128))));
+			error += abs(p[2] - clampByte(luminance + (1.772 * (cb - 128))));
+		}
+	}
+	return error / (width * height * 3);
+}
+
+static void checkImage(TestImage image, int index)
+{
+	int scale, a, x, y;
+
+	for (scale = 0; scale < 4; scale++) {
+		int width = (image->width + (1 << scale) - 1) >> scale, height = (image->height + (1 << scale) - 1) >> scale;
+		int rowBytes = pocoTestRowBytes(width);
+		uint8_t *rgb = calloc(width * height, 3), *pixels = calloc(rowBytes, height), *covered = malloc(width * height);
+		uint8_t *areaRGB = calloc(width * height, 3), *areaPixels = calloc(rowBytes, height), *areaCovered = malloc(width * height);
+		double error;
+		int count = 0;
+
+		pocoTestCheck(PJPG_NO_MORE_BLOCKS == decode(image, image->bytes, image->length, scale, 1, NULL, rgb, covered, index), "image %d scale %d: decode failed", index, scale);
+		pocoTestCheck(PJPG_NO_MORE_BLOCKS == decode(image, image->bytes, image->length, scale, 0, NULL, pixels, covered, index), "image %d scale %d: decode to pixels failed", index, scale);
+		for (y = 0; y < height; y++) {
+			for (x = 0; x < width; x++) {
+				const uint8_t *p = rgb + (((y * width) + x) * 3);
+				count += (1 != covered[(y * width) + x]);
+				if ((expectedPixel(p[0], p[1], p[2]) >= 0) && (pocoTestGetPixel(pixels, rowBytes, x, y) != expectedPixel(p[0], p[1], p[2])))
+					count += 1;
+			}
+		}
+		pocoTestCheck(0 == count, "image %d scale %d: %d pixels differ from 24-bit RGB or are not decoded once", index, scale, count);
+
+		error = scaledError(image, rgb, scale);
+		pocoTestCheck(error < 6, "image %d scale %d: %d x %d %s restart %d differs from its pixels by %g", index, scale, image->width, image->height,
+			image->gray ? "gray" : (1 == image->hs) ? ((1 == image->vs) ? "H1V1" : "H1V2") : ((1 == image->vs) ? "H2V1" : "H2V2"), image->restart, error);
+
+		for (a = 0; a < kAreas; a++) {
+			PocoRectangleRecord area;
+			int areaCount = 0;
+
+			area.x = pocoTestBetween(-8, width);
+			area.y = pocoTestBetween(-8, height);
+			area.w = pocoTestBetween(0, width + 8);
+			area.h = pocoTestBetween(0, height + 8);
+
+			pocoTestCheck(PJPG_NO_MORE_BLOCKS == decode(image, image->bytes, image->length, scale, a & 1, &area, (a & 1) ? areaRGB : areaPixels, areaCovered, index),
+				"image %d scale %d: area decode failed", index, scale);
+			for (y = 0; y < height; y++) {
+				for (x = 0; x < width; x++) {
+					int inside = (x >= area.x) && (x < (area.x + area.w)) && (y >= area.y) && (y < (area.y + area.h));
+					if (areaCovered[(y * width) + x] > 1)
+						areaCount++;
+					else if (!areaCovered[(y * width) + x])
+						areaCount += inside;
+					else if (a & 1)
+						areaCount += memcmp(areaRGB + (((y * width) + x) * 3), rgb + (((y * width) + x) * 3), 3) ? 1 : 0;
+					else
+						areaCount += pocoTestGetPixel(areaPixels, rowBytes, x, y) != pocoTestGetPixel(pixels, rowBytes, x, y);
+				}
+			}
+			pocoTestCheck(0 == areaCount, "image %d scale %d: %d pixels of the area %d %d %d %d differ from the whole image", index, scale, areaCount, area.x, area.y, area.w, area.h);
+		}
+
+		free(rgb);
+		free(pixels);
+		free(covered);
+		free(areaRGB);
+		free(areaPixels);
+		free(areaCovered);
+	}
+}
+
+static void checkTruncated(TestImage image, int index)
+{
+	int length = pocoTestBetween(2, image->length - 1), width = image->width, height = image->height;
+	uint8_t *bytes = malloc(length);		// exactly, so that tools catch reading past the end
+	uint8_t *rgb = malloc(width * height * 3), *covered = malloc(width * height);
+
+	memcpy(bytes, image->bytes, length);
+	decode(image, bytes, length, pocoTestBetween(0, 3), 1, NULL, rgb, covered, index);
+
+	free(bytes);
+	free(rgb);
+	free(covered);
+}
+
+int main(int argc, char *argv[])
+{
+	int i;
+
+	pocoTestSetup();
+	for (i = 0; i < kImages; i++) {
+		TestImageRecord image;
+
+		pocoTestSeed(0x9E3779B9 * (i + 1));
+		makeImage(&image);
+		checkImage(&image, i);
+		checkTruncated(&image, i);
+
+		free(image.bytes);
+		free(image.rgb);
+	}
+
+	return pocoTestDone("readJPEG");
+}
@@ -0,0 +1,414 @@
+/*
+ * Copyright (c) 2016-2017  Moddable Tech, Inc.
+ *
+ *   This file is part of the Moddable SDK Runtime.
+ *
+ *   The Moddable SDK Runtime is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   The Moddable SDK Runtime is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with the Moddable SDK Runtime.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+	PNG scan lines and PNG images drawn by Poco.
+
+	Random images of every color type and bit depth are encoded here, interlaced or not, with a random filter
+	on each scan line and the compressed data split into IDAT chunks of random sizes. The decoded scan lines
+	must match the pixels encoded, read in order and at random, and truncated files must fail without
+	returning wrong scan lines.
+
+	Images of 8-bit gray, RGB, RGBA and indexed colors are drawn twice in scenes with random clips, slab
+	heights and fills that hide some of their rows. The frames must match the same scenes drawn with
+	PocoBitmapDraw from the pixels converted beforehand.
+
+	The bindings of commodettoReadPNG.c are compiled but not called, so the chunks are read here, as the
+	constructor reads them.
+*/
+
+#include "pocoTest.h"
+#include "commodettoReadPNG.c"
+
+#define kWidth (96)
+#define kHeight (80)
+#define kImages (80)
+#define kScenes (20)
+
+typedef struct {
+	uint8_t		*bytes;
+	int			length;
+
+	int			width;
+	int			height;
+	int			colorType;
+	int			bitDepth;
+	int			interlaced;
+	int			rowBytes;
+	uint8_t		*raw;				// scan lines without filter bytes
+	uint8_t		palette[256 * 4];	// RGBA
+} TestImageRecord, *TestImage;
+
+static const int gChannels[7] = { 1, 0, 3, 1, 2, 0, 4 };
+
+static uint8_t *putChunk(uint8_t *out, const char *tag, const uint8_t *data, int length)
+{
+	uint32_t crc;
+
+	out[0] = (uint8_t)(length >> 24), out[1] = (uint8_t)(length >> 16), out[2] = (uint8_t)(length >> 8), out[3] = (uint8_t)length;
+	memcpy(out + 4, tag, 4);
+	if (length)
+		memcpy(out + 8, data, length);
+	crc = (uint32_t)mz_crc32(MZ_CRC32_INIT, out + 4, length + 4);
+	out += 8 + length;
+	out[0] = (uint8_t)(crc >> 24), out[1] = (uint8_t)(crc >> 16), out[2] = (uint8_t)(crc >> 8), out[3] = (uint8_t)crc;
+	return out + 4;
+}
+
+static int paeth(int a, int b, int c)
+{
+	int p = a + b - c, pa = abs(p - a), pb = abs(p - b), pc = abs(p - c);
+	if ((pa <= pb) && (pa <= pc))
+		return a;
+	return (pb <= pc) ? b : c;
+}
+
+/* the filter byte and the filtered scan line of count bytes */
+static uint8_t *filterRow(uint8_t *out, const uint8_t *row, const uint8_t *prev, int count, int bpp)
+{
+	int filter = pocoTestBetween(0, 4), i;
+
+	*out++ = (uint8_t)filter;
+	for (i = 0; i < count; i++) {
+		int left = (i >= bpp) ? row[i - bpp] : 0, up = prev[i], upLeft = (i >= bpp) ? prev[i - bpp] : 0;
+		switch (filter) {
+			case 0: *out++ = row[i]; break;
+			case 1: *out++ = (uint8_t)(row[i] - left); break;
+			case 2: *out++ = (uint8_t)(row[i] - up); break;
+			case 3: *out++ = (uint8_t)(row[i] - ((left + up) >> 1)); break;
+			case 4: *out++ = (uint8_t)(row[i] - paeth(left, up, upLeft)); break;
+		}
+	}
+	return out;
+}
+
+static int getBits(const uint8_t *row, int x, int bits)
+{
+	int at = x * bits;
+	return (row[at >> 3] >> (8 - bits - (at & 7))) & ((1 << bits) - 1);
+}
+
+static void setBits(uint8_t *row, int x, int bits, int value)
+{
+	int at = x * bits;
+	row[at >> 3] |= value << (8 - bits - (at & 7));
+}
+
+static void makeImage(TestImage image)
+{
+	static const int colorTypes[] = { 0, 0, 2, 3, 3, 4, 6 };
+	int bitsPerPixel, bpp, filteredLength = 0, i, y;
+	uint8_t *filtered, *out, *prev, header[13];
+	mz_ulong compressedLength;
+	uint8_t *compressed;
+
+	image->colorType = colorTypes[pocoTestBetween(0, 6)];
+	image->bitDepth = ((0 == image->colorType) || (3 == image->colorType)) && pocoTestBetween(0, 1) ? (1 << pocoTestBetween(0, 2)) : 8;
+	image->width = pocoTestBetween(1, 80);
+	image->height = pocoTestBetween(1, 60);
+	image->interlaced = pocoTestBetween(0, 1);
+	bitsPerPixel = gChannels[image->colorType] * image->bitDepth;
+	bpp = (bitsPerPixel + 7) >> 3;
+	image->rowBytes = ((image->width * bitsPerPixel) + 7) >> 3;
+
+	image->raw = calloc(image->height, image->rowBytes);
+	for (i = 0; i < (image->height * image->rowBytes); i++)
+		image->raw[i] = (uint8_t)pocoTestRandom();
+	if (bitsPerPixel < 8) {			// keep the padding bits at the end of each scan line clear, as the decoder leaves them
+		for (y = 0; y < image->height; y++) {
+			uint8_t *row = image->raw + (y * image->rowBytes);
+			int x;
+			memset(row, 0, image->rowBytes);
+			for (x = 0; x < image->width; x++)
+				setBits(row, x, bitsPerPixel, pocoTestBetween(0, (1 << bitsPerPixel) - 1));
+		}
+	}
+	for (i = 0; i < 256; i++) {
+		image->palette[(i * 4) + 0] = (uint8_t)pocoTestRandom();
+		image->palette[(i * 4) + 1] = (uint8_t)pocoTestRandom();
+		image->palette[(i * 4) + 2] = (uint8_t)pocoTestRandom();
+		image->palette[(i * 4) + 3] = 255;
+	}
+
+	filtered = malloc((image->height * (image->rowBytes + 1)) * 2);
+	prev = malloc(image->rowBytes + 1);
+	out = filtered;
+	if (!image->interlaced) {
+		memset(prev, 0, image->rowBytes);
+		for (y = 0; y < image->height; y++) {
+			out = filterRow(out, image->raw + (y * image->rowBytes), prev, image->rowBytes, bpp);
+			memcpy(prev, image->raw + (y * image->rowBytes), image->rowBytes);
+		}
+	}
+	else {
+		uint8_t *row = malloc(image->rowBytes + 1);
+		int pass;
+
+		for (pass = 0; pass < 7; pass++) {
+			int x0 = gAdam7[pass][0], y0 = gAdam7[pass][1], dx = gAdam7[pass][2], dy = gAdam7[pass][3];
+			int w = (image->width > x0) ? ((image->width - x0 + dx - 1) / dx) : 0;
+			int count = ((w * bitsPerPixel) + 7) >> 3;
+
+			if (!w)
+				continue;
+			memset(prev, 0, image->rowBytes);
+			for (y = y0; y < image->height; y += dy) {
+				const uint8_t *src = image->raw + (y * image->rowBytes);
+				int x;
+
+				memset(row, 0, image->rowBytes);
+				for (i = 0, x = x0; i < w; i++, x += dx) {
+					if (bitsPerPixel >= 8)
+						memcpy(row + (i * bpp), src + (x * bpp), bpp);
+					else
+						setBits(row, i, bitsPerPixel, getBits(src, x, bitsPerPixel));
+				}
+				out = filterRow(out, row, prev, count, bpp);
+				memcpy(prev, row, count);
+			}
+		}
+		free(row);
+	}
+	filteredLength = out - filtered;
+	free(prev);
+
+	compressedLength = mz_compressBound(filteredLength);
+	compressed = malloc(compressedLength);
+	mz_compress2(compressed, &compressedLength, filtered, filteredLength, pocoTestBetween(1, 9));
+	free(filtered);
+
+	image->bytes = malloc(8 + 25 + (12 + (256 * 3)) + (compressedLength * 13) + 12);
+	memcpy(image->bytes, "\x89PNG\r\n\x1a\n", 8);
+	header[0] = 0, header[1] = 0, header[2] = (uint8_t)(image->width >> 8), header[3] = (uint8_t)image->width;
+	header[4] = 0, header[5] = 0, header[6] = (uint8_t)(image->height >> 8), header[7] = (uint8_t)image->height;
+	header[8] = (uint8_t)image->bitDepth;
+	header[9] = (uint8_t)image->colorType;
+	header[10] = 0, header[11] = 0, header[12] = (uint8_t)image->interlaced;
+	out = putChunk(image->bytes + 8, "IHDR", header, 13);
+	if (3 == image->colorType) {
+		uint8_t plte[256 * 3];
+		for (i = 0; i < (1 << image->bitDepth); i++)
+			memcpy(plte + (i * 3), image->palette + (i * 4), 3);
+		out = putChunk(out, "PLTE", plte, (1 << image->bitDepth) * 3);
+	}
+	for (i = 0; i < (int)compressedLength; ) {
+		int use = pocoTestBetween(1, pocoTestBetween(0, 1) ? 12 : (int)compressedLength);
+		if (use > ((int)compressedLength - i))
+			use = (int)compressedLength - i;
+		out = putChunk(out, "IDAT", compressed + i, use);
+		i += use;
+	}
+	out = putChunk(out, "IEND", NULL, 0);
+	image->length = out - image->bytes;
+	free(compressed);
+}
+
+/* the chunks up to the first IDAT, as xs_PNG_constructor reads them */
+static int openImage(PNG png, const uint8_t *bytes, int length)
+{
+	const uint8_t *p = bytes + 8;
+
+	memset(png, 0, sizeof(PNGRecord));
+	png->dataLength = length;
+	while ((p - bytes) + 12 <= length) {
+		int tagLen = (p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+
+		if (((p - bytes) + 12 + tagLen) > length)
+			return -1;
+		if (!memcmp(p + 4, "IHDR", 4) && pngHeader(png, p + 8))
+			return -1;
+		if (!memcmp(p + 4, "IDAT", 4)) {
+			png->idatBytes = png->idatStartBytes = tagLen;
+			png->byteOffset = png->idatStart = (p + 8) - bytes;
+			return 0;
+		}
+		p += 12 + tagLen;
+	}
+	return -1;
+}
+
+static void checkRows(TestImage image, int index)
+{
+	PNGRecord record;
+	PNG png = &record;
+	int i, y;
+
+	pocoTestCheck(0 == openImage(png, image->bytes, image->length), "image %d: can't open", index);
+	pocoTestCheck(!png->interlaced || (0 == pngDeinterlace(png, image->bytes)), "image %d: can't deinterlace", index);
+	for (y = 0; y < image->height; y++) {
+		const unsigned char *row = pngGetRow(png, image->bytes, y);
+		pocoTestCheck(row && !memcmp(row, image->raw + (y * image->rowBytes), image->rowBytes), "image %d: row %d %s", index, y, row ? "differs" : "failed");
+	}
+	for (i = 0; i < 40; i++) {
+		const unsigned char *row;
+		y = pocoTestBetween(0, image->height - 1);
+		row = pngGetRow(png, image->bytes, y);
+		pocoTestCheck(row && !memcmp(row, image->raw + (y * image->rowBytes), image->rowBytes), "image %d: row %d out of order %s", index, y, row ? "differs" : "failed");
+	}
+	pocoTestCheck(NULL == pngGetRow(png, image->bytes, image->height), "image %d: row past the end", index);
+	pngClose(png);
+}
+
+static void checkTruncated(TestImage image, int index)
+{
+	int length = pocoTestBetween(60, image->length - 1), y;
+	uint8_t *bytes = malloc(length);		// exactly, so that tools catch reading past the end
+	PNGRecord record;
+	PNG png = &record;
+
+	memcpy(bytes, image->bytes, length);
+	if (0 == openImage(png, bytes, length)) {
+		if (!png->interlaced || (0 == pngDeinterlace(png, bytes))) {
+			for (y = 0; y < image->height; y++) {
+				const unsigned char *row = pngGetRow(png, bytes, y);
+				if (!row)
+					break;
+				pocoTestCheck(!memcmp(row, image->raw + (y * image->rowBytes), image->rowBytes), "image %d: row %d of %d bytes differs", index, y, length);
+			}
+		}
+		pngClose(png);
+	}
+	free(bytes);
+}
+
+static void draw(Poco poco, uint32_t seed, PNGDraw external, PocoBitmap bits)
+{
+	int x, y, i;
+
+	pocoTestSeed(seed);
+	x = pocoTestBetween(0, kWidth / 2) & ~1;
+	y = pocoTestBetween(0, kHeight / 2);
+	PocoDrawingBegin(poco, x, y, kWidth - x, kHeight - y);
+	PocoRectangleFill(poco, pocoTestMakeColor(0), kPocoOpaque, 0, 0, kWidth, kHeight);
+	PocoClipPush(poco, pocoTestBetween(0, kWidth / 2), pocoTestBetween(0, kHeight / 2), pocoTestBetween(1, kWidth), pocoTestBetween(1, kHeight));
+	for (i = 0; i < 2; i++) {
+		int sx = pocoTestBetween(0, 1) ? 0 : pocoTestBetween(0, bits->width - 1), sy = pocoTestBetween(0, 1) ? 0 : pocoTestBetween(0, bits->height - 1);
+		int sw = pocoTestBetween(1, bits->width - sx), sh = pocoTestBetween(1, bits->height - sy);
+
+		x = pocoTestBetween(-20, kWidth - 4);
+		y = pocoTestBetween(-20, kHeight - 4);
+		if (external) {
+			external->sx = sx;
+			external->sy = sy;
+			PocoDrawExternal(poco, pngRender, (uint8_t *)external, sizeof(PNGDrawRecord), x, y, sw, sh);
+		}
+		else
+			PocoBitmapDraw(poco, bits, x, y, sx, sy, sw, sh);
+		if (pocoTestBetween(0, 1))
+			PocoRectangleFill(poco, pocoTestColor(), kPocoOpaque, 0, y + pocoTestBetween(0, 10), kWidth, pocoTestBetween(1, 20));
+	}
+	PocoClipPop(poco);
+}
+
+static void checkDraw(TestImage image, int index)
+{
+	static const int rows[] = { 1, 5, 16, kHeight };
+	CommodettoBitmapFormat format = (2 == image->colorType) ? kCommodettoBitmap24RGB : (6 == image->colorType) ? kCommodettoBitmap32RGBA :
+		(3 == image->colorType) ? kCommodettoBitmap32RGBA : kCommodettoBitmapGray256;
+	int channels = gChannels[image->colorType], scene, x, y;
+	PNGRecord record;
+	PNG png = &record;
+	PNGDrawRecord external;
+	PocoBitmapRecord bits;
+	Poco poco;
+	uint8_t *pixels, *expected, *actual;
+	int bitsRowBytes = pocoTestRowBytes(image->width), frameLength = pocoTestRowBytes(kWidth) * kHeight;
+
+	if ((8 != image->bitDepth) || (4 == image->colorType))
+		return;
+
+	poco = pocoTestNew(kWidth, kHeight, rows[pocoTestBetween(0, 3)], 65536);
+	expected = pocoTestNewFrame(poco);
+	actual = pocoTestNewFrame(poco);
+
+	memset(&external, 0, sizeof(external));
+	external.converter = CommodettoPixelsConverterGet(format, kPocoPixelFormat);
+	external.palette = (3 == image->colorType) ? image->palette : NULL;
+#if kPocoPixelFormat == kCommodettoBitmapCLUT16
+	external.clut = poco->clut;
+#endif
+
+	pixels = pocoTestAllocateBitmap(&bits, kPocoPixelFormat, image->width, image->height);
+	for (y = 0; y < image->height; y++) {
+		for (x = 0; x < image->width; x++) {
+			const uint8_t *src = image->raw + (y * image->rowBytes) + (x * channels);
+			uint8_t out[4] = { 0 };
+
+			if (external.palette)
+				src = image->palette + (src[0] << 2);
+			(external.converter)(1, (void *)src, out, external.clut);
+#if 16 == kPocoPixelSize
+			pocoTestSetPixel(pixels, bitsRowBytes, x, y, out[0] | (out[1] << 8));
+#elif 8 == kPocoPixelSize
+			pocoTestSetPixel(pixels, bitsRowBytes, x, y, out[0]);
+#else
+			pocoTestSetPixel(pixels, bitsRowBytes, x, y, out[0] >> 4);		// converters put the first pixel in the high nybble
+#endif
+		}
+	}
+
+	pocoTestCheck(0 == openImage(png, image->bytes, image->length), "image %d: can't open", index);
+	pocoTestCheck(!png->interlaced || (0 == pngDeinterlace(png, image->bytes)), "image %d: can't deinterlace", index);
+	png->drawBuffer = malloc((png->width * 4) + ((png->width + 1) >> 1) + 4);		// as xs_PNG_draw allocates it
+	external.png = png;
+	external.bytes = image->bytes;
+
+	for (scene = 0; scene < kScenes; scene++) {
+		uint32_t seed = 0x9E3779B9 * ((index * kScenes) + scene + 1);
+
+		memset(expected, 0, frameLength);
+		draw(poco, seed, NULL, &bits);
+		pocoTestCheck(0 == pocoTestEnd(poco, expected), "image %d scene %d: render failed", index, scene);
+
+		memset(actual, 0, frameLength);
+		draw(poco, seed, &external, &bits);
+		pocoTestCheck(0 == pocoTestEnd(poco, actual), "image %d scene %d: PNG render failed", index, scene);
+
+		pocoTestCheck(0 == memcmp(expected, actual, frameLength), "image %d scene %d: %d x %d color type %d%s drawn differs from its pixels", index, scene,
+			image->width, image->height, image->colorType, image->interlaced ? " interlaced" : "");
+	}
+
+	pngClose(png);
+	pocoTestFreeBitmap(&bits);
+	free(expected);
+	free(actual);
+	pocoTestDispose(poco);
+}
+
+int main(int argc, char *argv[])
+{
+	int i;
+
+	pocoTestSetup();
+	for (i = 0; i < kImages; i++) {
+		TestImageRecord image;
+
+		pocoTestSeed(0x9E3779B9 * (i + 1));
+		makeImage(&image);
+		checkRows(&image, i);
+		checkTruncated(&image, i);
+		checkDraw(&image, i);
+
+		free(image.bytes);
+		free(image.raw);
+	}
+
+	return pocoTestDone("readPNG");
+}
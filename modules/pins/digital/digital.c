@@ -71,23 +71,22 @@ void xs_digital_mode(xsMachine *the)
 		xsUnknownError("unsupported mode");
 }
 
-void xs_digital_read(xsMachine *the)
+void xs_digital_read(xsMachine *the, xsSlot *self, xsFastValue *argv, xsFastValue *result)
 {
-	modGPIOConfiguration gpio = xsmcGetHostChunk(xsThis);
+	modGPIOConfiguration gpio = xsmcGetHostChunk(*self);
 	int value;
 
 	value = modGPIORead(gpio);
 	if (kModGPIOReadError == value)
 		xsUnknownError("can't read pin");
 
-	xsmcSetInteger(xsResult, value);
+	result->integer = value;
 }
 
-void xs_digital_write(xsMachine *the)
+void xs_digital_write(xsMachine *the, xsSlot *self, xsFastValue *argv, xsFastValue *result)
 {
-	modGPIOConfiguration gpio = xsmcGetHostChunk(xsThis);
-	int value = xsmcToInteger(xsArg(0));
-	modGPIOWrite(gpio, value);
+	modGPIOConfiguration gpio = xsmcGetHostChunk(*self);
+	modGPIOWrite(gpio, argv[0].integer);
 }
 
 void xs_digital_static_read(xsMachine *the)
@@ -24,8 +24,8 @@ class Digital @ "xs_digital_destructor" {
 
 	constructor(port, pin, mode) @ "xs_digital";// or (pin, mode) where port is implicitly NULL
 	mode(mode) @ "xs_digital_mode";				// change pin mode
-	read() @ "xs_digital_read";					// read pin
-	write(value) @ "xs_digital_write";			// write pin
+	read() @ "xs_digital_read()i";				// read pin
+	write(value) @ "xs_digital_write(i)";		// write pin
 	//@@ notify
 }
 Digital.Input = 0;
@@ -472,7 +472,7 @@ void PiuViewDrawStringAux(PiuView* self, xsSlot* string, xsIntegerValue offset,
 			if (bits)
 				PocoBitmapDrawMasked(poco, blend, bits, cx, cy, sx, sy, sw, sh, mask, sx, sy);
 			else
-				PocoGrayBitmapDraw(poco, mask, color, blend, cx, cy, sx, sy, sw, sh);
+				PocoGrayGlyphDraw(poco, mask, color, blend, cx, cy, sx, sy, sw, sh);
 		}
 		else {
 			if (bits)
@@ -486,7 +486,7 @@ void PiuViewDrawStringAux(PiuView* self, xsSlot* string, xsIntegerValue offset,
 				pack.width = sh;
 				pack.height = sw;
 #endif
-				PocoGrayBitmapDraw(poco, &pack, color, blend, cx, cy, 0, 0, sw, sh);
+				PocoGrayGlyphDraw(poco, &pack, color, blend, cx, cy, 0, 0, sw, sh);
 			}
 		}
 		x += xadvance;
@@ -980,6 +980,12 @@ done:
 	if (!(poco->flags & kPocoFlagFrameBuffer))
 #endif
 	{
+		PocoRectangleRecord first, second;
+		if (PocoDrawingSplit(poco, &first, &second)) {
+			PiuViewUpdateStep(self, first.x, first.y, first.w, first.h, 1);
+			PiuViewUpdateStep(self, second.x, second.y, second.w, second.h, flag);
+			return;
+		}
 		if (pixelsOutDispatch) {
 			(pixelsOutDispatch->doBegin)(poco->outputRefcon, poco->x, poco->y, poco->w, poco->h);
 			result = PocoDrawingEnd(poco, poco->pixels, poco->pixelsLength, pixelsOutDispatch->doSend, poco->outputRefcon);
@@ -57,11 +57,12 @@ class MakeFile extends MAKEFILE {
 				creation.chunk.incremental, ",", 
 				creation.heap.initial, ",", 
 				creation.heap.incremental, ",", 
-				creation.stack, ",", 
+				creation.stack.initial, ",", 
 				creation.keys.available, ",", 
 				creation.keys.name, ",", 
 				creation.keys.symbol, ",",
 				creation.static, ",", 
+				creation.stack.maximum, ",", 
 				creation.main);
 		this.line("");
 		this.write("MANIFEST =");
@@ -139,6 +140,7 @@ class MakeFile extends MAKEFILE {
 		if (tool.format) {
 			this.line("DISPLAY = ", formatValues[tool.format]);
 			this.line("ROTATION = ", tool.rotation);
+			this.line("POCO_THREADS = ", (tool.defines.poco && tool.defines.poco.threads) || 0);
 		}
 		this.write("HEADERS =");
 		for (var header of tool.hFiles) {
@@ -730,7 +732,10 @@ export default class extends Tool {
 		if (!creation.heap) creation.heap = { };
 		if (!creation.heap.initial) creation.heap.initial = 2048;
 		if (!creation.heap.incremental) creation.heap.incremental = 64;
-		if (!creation.stack) creation.stack = 512;
+		if (!creation.stack) creation.stack = { };
+		else if (typeof creation.stack == "number") creation.stack = { initial: creation.stack };
+		if (!creation.stack.initial) creation.stack.initial = 512;
+		if (!creation.stack.maximum) creation.stack.maximum = 0;
 		if (!creation.keys) creation.keys = {};
 		if (!creation.keys.available) creation.keys.available = 256;
 		if (!creation.keys.name) creation.keys.name = 127;
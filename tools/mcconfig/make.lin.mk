@@ -72,6 +72,7 @@ XS_OBJECTS = \
 	$(LIB_DIR)/xsProxy.c.o \
 	$(LIB_DIR)/xsRegExp.c.o \
 	$(LIB_DIR)/xsRun.c.o \
+	$(LIB_DIR)/xsSnapshot.c.o \
 	$(LIB_DIR)/xsString.c.o \
 	$(LIB_DIR)/xsSymbol.c.o \
 	$(LIB_DIR)/xsType.c.o \
@@ -91,7 +92,8 @@ C_DEFINES = \
 	-DmxHostFunctionPrimitive=1 \
 	-DmxFewGlobalsTable=1 \
 	-DkCommodettoBitmapFormat=$(DISPLAY) \
-	-DkPocoRotation=$(ROTATION)
+	-DkPocoRotation=$(ROTATION) \
+	-DkPocoThreads=$(POCO_THREADS)
 ifeq ($(INSTRUMENT),1)
 	C_DEFINES += -DMODINSTRUMENTATION=1 -DmxInstrument=1
 endif
@@ -107,7 +109,7 @@ else
 #	C_FLAGS += -DMC_MEMORY_DEBUG=1
 endif
 
-LINK_LIBRARIES = -lm -lc $(shell $(PKGCONFIG) --libs gio-2.0)
+LINK_LIBRARIES = -lm -lc -lpthread $(shell $(PKGCONFIG) --libs gio-2.0)
 
 LINK_OPTIONS = -fPIC -shared -Wl,-Bdynamic\,-Bsymbolic
 
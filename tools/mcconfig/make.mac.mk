@@ -70,6 +70,7 @@ XS_OBJECTS = \
 	$(LIB_DIR)/xsProxy.c.o \
 	$(LIB_DIR)/xsRegExp.c.o \
 	$(LIB_DIR)/xsRun.c.o \
+	$(LIB_DIR)/xsSnapshot.c.o \
 	$(LIB_DIR)/xsString.c.o \
 	$(LIB_DIR)/xsSymbol.c.o \
 	$(LIB_DIR)/xsType.c.o \
@@ -75,6 +75,7 @@ XS_OBJECTS = \
 	$(LIB_DIR)/xsRun.c.o \
 	$(LIB_DIR)/xsScope.c.o \
 	$(LIB_DIR)/xsScript.c.o \
+	$(LIB_DIR)/xsSnapshot.c.o \
 	$(LIB_DIR)/xsSourceMap.c.o \
 	$(LIB_DIR)/xsString.c.o \
 	$(LIB_DIR)/xsSymbol.c.o \
@@ -105,6 +105,7 @@ XS_OBJ = \
 	$(LIB_DIR)\xsProxy.o \
 	$(LIB_DIR)\xsRegExp.o \
 	$(LIB_DIR)\xsRun.o \
+	$(LIB_DIR)\xsSnapshot.o \
 	$(LIB_DIR)\xsString.o \
 	$(LIB_DIR)\xsSymbol.o \
 	$(LIB_DIR)\xsType.o \
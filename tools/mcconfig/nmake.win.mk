@@ -74,6 +74,7 @@ XS_OBJECTS = \
 	$(LIB_DIR)\xsProxy.o \
 	$(LIB_DIR)\xsRegExp.o \
 	$(LIB_DIR)\xsRun.o \
+	$(LIB_DIR)\xsSnapshot.o \
 	$(LIB_DIR)\xsString.o \
 	$(LIB_DIR)\xsSymbol.o \
 	$(LIB_DIR)\xsType.o \
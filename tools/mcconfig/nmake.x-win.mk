@@ -79,6 +79,7 @@ XS_OBJECTS = \
 	$(LIB_DIR)\xsRun.o \
 	$(LIB_DIR)\xsScope.o \
 	$(LIB_DIR)\xsScript.o \
+	$(LIB_DIR)\xsSnapshot.o \
 	$(LIB_DIR)\xsSourceMap.o \
 	$(LIB_DIR)\xsString.o \
 	$(LIB_DIR)\xsSymbol.o \
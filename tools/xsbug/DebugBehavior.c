@@ -132,6 +132,7 @@ enum {
 	mxClearBreakpoint,
 	mxGoCommand,
 	mxLogoutCommand,
+	mxReportAllocationsCommand,
 	mxSelectCommand,
 	mxSetAllBreakpointsCommand,
 	mxSetBreakpointCommand,
@@ -1070,6 +1071,9 @@ void PiuDebugMachine_doCommand(xsMachine* the)
 	case mxLogoutCommand:
 		c_strcat(buffer, "<logout/>");
 		break;
+	case mxReportAllocationsCommand:
+		c_strcat(buffer, "<report-allocations/>");
+		break;
 	case mxSelectCommand:
 		c_strcat(buffer, "<select id=\"");
 		c_strcat(buffer, xsToString(xsArg(1)));
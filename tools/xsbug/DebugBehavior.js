@@ -48,13 +48,14 @@ const mxClearAllBreakpointsCommand = 1;
 const mxClearBreakpointCommand = 2;
 const mxGoCommand = 3;
 const mxLogoutCommand = 4;
-const mxSelectCommand = 5;
-const mxSetAllBreakpointsCommand = 6;
-const mxSetBreakpointCommand = 7;
-const mxStepCommand = 8;
-const mxStepInCommand = 9;
-const mxStepOutCommand = 10;
-const mxToggleCommand = 11;
+const mxReportAllocationsCommand = 5;
+const mxSelectCommand = 6;
+const mxSetAllBreakpointsCommand = 7;
+const mxSetBreakpointCommand = 8;
+const mxStepCommand = 9;
+const mxStepInCommand = 10;
+const mxStepOutCommand = 11;
+const mxToggleCommand = 12;
 
 export class DebugBehavior @ "PiuDebugBehaviorDelete" {
 	constructor(application) @ "PiuDebugBehaviorCreate"
@@ -122,6 +123,10 @@ export class DebugBehavior @ "PiuDebugBehaviorDelete" {
 		let machine = this.currentMachine;
 		return machine && machine.broken;
 	}
+	canReportAllocations() {
+		let machine = this.currentMachine;
+		return machine ? true : false;
+	}
 	canStep() {
 		let machine = this.currentMachine;
 		return machine && machine.broken;
@@ -171,6 +176,10 @@ export class DebugBehavior @ "PiuDebugBehaviorDelete" {
 		machine.timeout = Date.now() + 500;
 		machine.doCommand(mxGoCommand);
 	}
+	doReportAllocations() {
+		let machine = this.currentMachine;
+		machine.doCommand(mxReportAllocationsCommand);
+	}
 	doSelectItem(application, value) {
 		this.currentMachine.doCommand(mxSelectCommand, value);
 	}
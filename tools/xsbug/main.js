@@ -611,6 +611,8 @@ let DebuggerApplication = Application.template($ => ({
 				{ state:0, titles: ["Set Breakpoint", "Clear Breakpoint"], shift:true, key:"B", command:"ToggleBreakpoint" },
 				{ state:0, titles: ["Enable Breakpoint", "Disable Breakpoint"], command:"DisableBreakpoint" },
 				{ title:"Clear All Breakpoints", option:true, key:"B", command:"ClearAllBreakpoints" },
+				null,
+				{ title:"Report Allocations", command:"ReportAllocations" },
 			],
 		},
 		{
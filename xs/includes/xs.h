@@ -170,14 +170,18 @@ typedef struct xsJumpRecord xsJump;
 typedef struct xsMachineRecord xsMachine;
 typedef struct xsSlotRecord xsSlot;
 typedef struct xsHostBuilderRecord xsHostBuilder;
+typedef union xsFastValueRecord xsFastValue;
 typedef struct xsHostHooksStruct xsHostHooks;
+typedef struct xsSnapshotRecord xsSnapshot;
 #else
 typedef struct sxCreation xsCreation;
 typedef struct sxJump xsJump;
 typedef struct sxMachine xsMachine;
 typedef struct sxSlot xsSlot;
 typedef struct sxHostFunctionBuilder xsHostBuilder;
+typedef union sxFastValue xsFastValue;
 typedef struct sxHostHooks xsHostHooks;
+typedef struct sxSnapshot xsSnapshot;
 #endif
 
 /* Slot */
@@ -848,10 +852,21 @@ typedef short xsIndex;
 
 typedef void (*xsCallback)(xsMachine*);
 
+union xsFastValueRecord {
+	xsIntegerValue integer;
+	xsNumberValue number;
+	xsBooleanValue boolean;
+	struct { void* data; xsIntegerValue length; } buffer;
+};
+
+typedef void (*xsFastCallback)(xsMachine*, xsSlot*, xsFastValue*, xsFastValue*);
+
 struct xsHostBuilderRecord {
 	xsCallback callback;
 	xsIndex length;
 	xsIndex id;
+	xsIndex signature;
+	xsFastCallback fastCallback;
 };
 	
 #define xsNewHostConstructor(_CALLBACK,_LENGTH,_PROTOTYPE) \
@@ -1108,6 +1123,7 @@ struct xsCreationRecord {
 	xsIntegerValue nameModulo;
 	xsIntegerValue symbolModulo;
 	xsIntegerValue staticSize;
+	xsIntegerValue maximumStackCount;
 };
 
 #define xsCreateMachine(_CREATION,_NAME,_CONTEXT) \
@@ -1122,6 +1138,36 @@ struct xsCreationRecord {
 #define xsShareMachine(_THE) \
 	fxShareMachine(_THE)
 
+/* Snapshot */
+
+#ifndef __XSALL__
+	enum {
+		XS_SNAPSHOT_NO_ERROR = 0,
+		XS_SNAPSHOT_STREAM_ERROR,
+		XS_SNAPSHOT_MEMORY_ERROR,
+		XS_SNAPSHOT_VERSION_ERROR,
+		XS_SNAPSHOT_SIGNATURE_ERROR,
+		XS_SNAPSHOT_FORMAT_ERROR,
+		XS_SNAPSHOT_STATE_ERROR,
+		XS_SNAPSHOT_HOST_ERROR
+	};
+#endif
+
+struct xsSnapshotRecord {
+	char* signature;
+	int signatureLength;
+	xsBooleanValue (*read)(void* stream, void* address, size_t size);
+	xsBooleanValue (*write)(void* stream, void* address, size_t size);
+	void* stream;
+	int error;
+};
+
+#define xsWriteSnapshot(_THE,_SNAPSHOT) \
+	fxWriteSnapshot(_THE, _SNAPSHOT)
+
+#define xsReadSnapshot(_SNAPSHOT,_NAME,_CONTEXT) \
+	fxReadSnapshot(_SNAPSHOT, _NAME, _CONTEXT)
+
 /* Context */	
 	
 #define xsGetContext(_THE) \
@@ -1325,6 +1371,9 @@ mxImport void fxDeleteMachine(xsMachine*);
 mxImport xsMachine* fxCloneMachine(xsCreation*, xsMachine*, xsStringValue, void*);
 mxImport void fxShareMachine(xsMachine*);
 
+mxImport xsBooleanValue fxWriteSnapshot(xsMachine*, xsSnapshot*);
+mxImport xsMachine* fxReadSnapshot(xsSnapshot*, xsStringValue, void*);
+
 mxImport xsMachine* fxBeginHost(xsMachine*);
 mxImport void fxEndHost(xsMachine*);
 
@@ -104,6 +104,7 @@ OBJECTS = \
 	$(TMP_DIR)/xsProxy.o \
 	$(TMP_DIR)/xsRegExp.o \
 	$(TMP_DIR)/xsRun.o \
+	$(TMP_DIR)/xsSnapshot.o \
 	$(TMP_DIR)/xsString.o \
 	$(TMP_DIR)/xsSymbol.o \
 	$(TMP_DIR)/xsType.o \
@@ -106,6 +106,7 @@ OBJECTS = \
 	$(TMP_DIR)/xsRun.o \
 	$(TMP_DIR)/xsScope.o \
 	$(TMP_DIR)/xsScript.o \
+	$(TMP_DIR)/xsSnapshot.o \
 	$(TMP_DIR)/xsSourceMap.o \
 	$(TMP_DIR)/xsString.o \
 	$(TMP_DIR)/xsSymbol.o \
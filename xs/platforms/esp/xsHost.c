@@ -1116,6 +1116,15 @@ static int32_t modInstrumentationStackRemain(void)
 	return (gInstrumentationThe->stackTop - gInstrumentationThe->stackPeak) * sizeof(txSlot);
 }
 
+static int32_t modInstrumentationStackHighWater(void)
+{
+	if (gInstrumentationThe->stackPeak > gInstrumentationThe->stack)
+		gInstrumentationThe->stackPeak = gInstrumentationThe->stack;
+	if (gInstrumentationThe->peakStackCount < (gInstrumentationThe->stackTop - gInstrumentationThe->stackPeak))
+		gInstrumentationThe->peakStackCount = gInstrumentationThe->stackTop - gInstrumentationThe->stackPeak;
+	return gInstrumentationThe->peakStackCount * sizeof(txSlot);
+}
+
 static modTimer gInstrumentationTimer;
 
 void espDebugBreak(txMachine* the, uint8_t stop)
@@ -1143,6 +1152,7 @@ void espStartInstrumentation(txMachine *the)
 	modInstrumentationSetCallback(GarbageCollectionCount, modInstrumentationGarbageCollectionCount);
 	modInstrumentationSetCallback(ModulesLoaded, modInstrumentationModulesLoaded);
 	modInstrumentationSetCallback(StackRemain, modInstrumentationStackRemain);
+	modInstrumentationSetCallback(StackHighWater, modInstrumentationStackHighWater);
 
 	fxDescribeInstrumentation(the, espInstrumentCount, espInstrumentNames, espInstrumentUnits);
 
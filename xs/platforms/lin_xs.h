@@ -69,6 +69,7 @@
 #define mxUseDefaultLoadModule 1
 #define mxUseDefaultParseScript 1
 #define mxUseDefaultSharedChunks 1
+#define mxUseDefaultHeapProtection 1
 
 #define mxMachinePlatform \
 	void* host; \
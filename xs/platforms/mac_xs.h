@@ -66,6 +66,7 @@
 #define mxUseDefaultLoadModule 1
 #define mxUseDefaultParseScript 1
 #define mxUseDefaultSharedChunks 1
+#define mxUseDefaultHeapProtection 1
 
 #define mxMachinePlatform \
 	CFSocketRef connection; \
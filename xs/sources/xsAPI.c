@@ -285,10 +285,20 @@ again:
 			fxCopyStringC(the, theSlot, "true");
 		break;
 	case XS_INTEGER_KIND:
-		fxCopyStringC(the, theSlot, fxIntegerToString(the->dtoa, theSlot->value.integer, aBuffer, sizeof(aBuffer)));
+		if ((0 <= theSlot->value.integer) && (theSlot->value.integer < mxSmallIntegerStringCount)) {
+			theSlot->value.string = mxSmallIntegerString(theSlot->value.integer);
+			theSlot->kind = XS_STRING_X_KIND;
+		}
+		else
+			fxCopyStringC(the, theSlot, fxIntegerToString(the->dtoa, theSlot->value.integer, aBuffer, sizeof(aBuffer)));
 		break;
 	case XS_NUMBER_KIND:
-		fxCopyStringC(the, theSlot, fxNumberToString(the->dtoa, theSlot->value.number, aBuffer, sizeof(aBuffer), 0, 0));
+		if ((0 <= theSlot->value.number) && (theSlot->value.number < mxSmallIntegerStringCount) && (theSlot->value.number == (txInteger)theSlot->value.number)) {
+			theSlot->value.string = mxSmallIntegerString((txInteger)theSlot->value.number);
+			theSlot->kind = XS_STRING_X_KIND;
+		}
+		else
+			fxCopyStringC(the, theSlot, fxNumberToString(the->dtoa, theSlot->value.number, aBuffer, sizeof(aBuffer), 0, 0));
 		break;
 	case XS_SYMBOL_KIND:
 		mxTypeError("Cannot coerce symbol to string");
@@ -467,6 +477,7 @@ txBoolean fxIsInstanceOf(txMachine* the)
 void fxArrayCacheBegin(txMachine* the, txSlot* reference)
 {
 	txSlot* array = reference->value.reference->next;
+	array->kind = XS_ARRAY_KIND;
 	array->value.array.address = C_NULL;
 	array->value.array.length = 0;
 }
@@ -523,7 +534,12 @@ void fxBuildHosts(txMachine* the, txInteger c, const txHostFunctionBuilder* buil
 			the->stack->value.hostFunction.builder = builder;
 			the->stack->value.hostFunction.IDs = (txID*)(the->code);
 		#else
-			fxNewHostFunction(the, builder->callback, builder->length, (the->code && (builder->id >= 0)) ? ((txID*)(the->code))[builder->id] : builder->id);
+			txSlot* instance = fxNewHostFunction(the, builder->callback, builder->length, (the->code && (builder->id >= 0)) ? ((txID*)(the->code))[builder->id] : builder->id);
+			if (builder->signature) {
+				instance->next->flag |= XS_FAST_FLAG;
+				instance->next->ID = builder->signature;
+				instance->next->value.fastCallback.address = builder->fastCallback;
+			}
 		#endif
 		}
 		else
@@ -536,6 +552,110 @@ void fxBuildHosts(txMachine* the, txInteger c, const txHostFunctionBuilder* buil
 	fxArrayCacheEnd(the, the->stack);
 }
 
+void fxCallFastHost(txMachine* the, txFastCallback callback, txID signature, txSlot* stack, txSlot* result)
+{
+	txFastValue values[mxFastArgumentCount];
+	txFastValue value;
+	txInteger depth = (txInteger)(the->stackTop - stack);
+	txInteger count = (stack + 2)->value.integer;
+	txSlot* argument = stack + 2 + count;
+	txInteger buffers = 0;
+	txInteger index = 0;
+	txInteger kind;
+	while ((index < mxFastArgumentCount) && (kind = mxFastArgument(signature, index))) {
+		if (kind == XS_FAST_INTEGER) {
+			if (index >= count)
+				values[index].integer = 0;
+			else if (argument->kind == XS_INTEGER_KIND)
+				values[index].integer = argument->value.integer;
+			else {
+				values[index].integer = fxToInteger(the, argument);
+				stack = the->stackTop - depth;
+			}
+		}
+		else if (kind == XS_FAST_NUMBER) {
+			if (index >= count)
+				values[index].number = C_NAN;
+			else if (argument->kind == XS_NUMBER_KIND)
+				values[index].number = argument->value.number;
+			else if (argument->kind == XS_INTEGER_KIND)
+				values[index].number = argument->value.integer;
+			else {
+				values[index].number = fxToNumber(the, argument);
+				stack = the->stackTop - depth;
+			}
+		}
+		else
+			buffers++;
+		index++;
+		argument = stack + 2 + count - index;
+	}
+	if (buffers) {
+		/* callbacks can write into buffers, so buffers of a shared machine are copied first, before any address is taken */
+		argument = stack + 2 + count;
+		for (index = 0; (index < mxFastArgumentCount) && (kind = mxFastArgument(signature, index)); index++, argument--) {
+			if ((kind == XS_FAST_BUFFER) && (index < count) && (argument->kind == XS_REFERENCE_KIND)) {
+				txSlot* instance = argument->value.reference;
+				txSlot* view = instance->next;
+				if (view && (view->kind == XS_TYPED_ARRAY_KIND))
+					view = view->next;
+				if (view && (view->kind == XS_DATA_VIEW_KIND))
+					instance = view->next->value.reference;
+				if ((instance->ID >= 0) && instance->next && (instance->next->kind == XS_ARRAY_BUFFER_KIND))
+					fxAliasInstance(the, instance);
+			}
+		}
+		argument = stack + 2 + count;
+		for (index = 0; (index < mxFastArgumentCount) && (kind = mxFastArgument(signature, index)); index++, argument--) {
+			if (kind == XS_FAST_BUFFER) {
+				txSlot* view = C_NULL;
+				txSlot* buffer = C_NULL;
+				if ((index < count) && (argument->kind == XS_REFERENCE_KIND)) {
+					view = mxAliasInstance(argument->value.reference)->next;
+					if (view && (view->kind == XS_TYPED_ARRAY_KIND))
+						view = view->next;
+					if (view && (view->kind == XS_ARRAY_BUFFER_KIND)) {
+						buffer = view;
+						view = C_NULL;
+					}
+					else if (view && (view->kind == XS_DATA_VIEW_KIND))
+						buffer = mxAliasInstance(view->next->value.reference)->next;
+				}
+				if (!buffer)
+					mxTypeError("argument %d: no buffer", index);
+				if (!buffer->value.arrayBuffer.address)
+					mxTypeError("argument %d: detached buffer", index);
+				if (view) {
+					values[index].buffer.data = buffer->value.arrayBuffer.address + view->value.dataView.offset;
+					values[index].buffer.length = view->value.dataView.size;
+				}
+				else {
+					values[index].buffer.data = buffer->value.arrayBuffer.address;
+					values[index].buffer.length = buffer->value.arrayBuffer.length;
+				}
+			}
+		}
+	}
+	(*callback)(the, stack + 1, values, &value);
+	switch (mxFastResult(signature)) {
+	case XS_FAST_INTEGER:
+		result->kind = XS_INTEGER_KIND;
+		result->value.integer = value.integer;
+		break;
+	case XS_FAST_NUMBER:
+		result->kind = XS_NUMBER_KIND;
+		result->value.number = value.number;
+		break;
+	case XS_FAST_BOOLEAN:
+		result->kind = XS_BOOLEAN_KIND;
+		result->value.boolean = value.boolean ? 1 : 0;
+		break;
+	default:
+		result->kind = XS_UNDEFINED_KIND;
+		break;
+	}
+}
+
 txSlot* fxNewHostConstructor(txMachine* the, txCallback theCallback, txInteger theLength, txInteger name)
 {
 	txSlot* aStack;
@@ -1440,6 +1560,8 @@ void fxDeleteMachine(txMachine* the)
 		fxLogout(the);
 	#endif
 	}
+	else
+		fxProtect(the, 0);
 	the->context = C_NULL;
 	aSlot = the->cRoot;
 	while (aSlot) {
@@ -1464,6 +1586,10 @@ void fxDeleteMachine(txMachine* the)
 		aSlot = aSlot->next;
 	}
 	fxDelete_dtoa(the->dtoa);
+	if (the->stringifyBuffer) {
+		c_free(the->stringifyBuffer);
+		the->stringifyBuffer = C_NULL;
+	}
 	if (!(the->shared)) {
 	#ifdef mxProfile
 		if (the->profileBottom) {
@@ -1641,6 +1767,7 @@ void fxShareMachine(txMachine* the)
 		fxLogout(the);
 	#endif
 		fxShare(the);
+		fxProtect(the, 1);
 		the->shared = 1;
 	#ifdef mxProfile
 		if (the->profileBottom) {
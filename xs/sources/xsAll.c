@@ -62,7 +62,7 @@ txSlot* fxArgToCallback(txMachine* the, txInteger argi)
 		txSlot* slot = mxArgv(argi);
 		if (slot->kind == XS_REFERENCE_KIND) {
 			slot = slot->value.reference;
-			if (slot->next && ((slot->next->kind == XS_CODE_KIND) || (slot->next->kind == XS_CODE_X_KIND) || (slot->next->kind == XS_CALLBACK_KIND)))
+			if (slot->next && ((slot->next->kind == XS_CODE_KIND) || (slot->next->kind == XS_CODE_X_KIND) || (slot->next->kind == XS_CALLBACK_KIND) || (slot->next->kind == XS_CALLBACK_X_KIND)))
 				return slot;
 		}
 	}
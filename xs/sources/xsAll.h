@@ -59,9 +59,13 @@ typedef struct sxBlock txBlock;
 typedef struct sxChunk txChunk;
 typedef struct sxJump txJump;
 typedef struct sxProfileRecord txProfileRecord;
+typedef struct sxAllocationSite txAllocationSite;
+typedef struct sxHeapWriter txHeapWriter;
 typedef struct sxCreation txCreation;
 typedef struct sxPreparation txPreparation;
+typedef struct sxSnapshot txSnapshot;
 typedef struct sxHostFunctionBuilder txHostFunctionBuilder;
+typedef union sxFastValue txFastValue;
 typedef struct sxHostHooks txHostHooks;
 typedef struct sxInspectorNameLink txInspectorNameLink;
 typedef struct sxInspectorNameList txInspectorNameList;
@@ -69,6 +73,7 @@ typedef struct sxInspectorNameList txInspectorNameList;
 typedef txBoolean (*txArchiveRead)(void* src, size_t offset, void* buffer, size_t size);
 typedef txBoolean (*txArchiveWrite)(void* dst, size_t offset, void* buffer, size_t size);
 typedef void (*txCallback)(txMachine*);
+typedef void (*txFastCallback)(txMachine*, txSlot*, txFastValue*, txFastValue*);
 typedef txCallback (*txCallbackAt)(txID index);
 typedef void (*txDestructor)(void*);
 typedef void (*txMarkRoot)(txMachine*, txSlot*);
@@ -143,6 +148,9 @@ typedef struct {
 #define mxSortThreshold 4
 #define mxSortStackSize 8 * sizeof(txUnsigned)
 
+/* when an array store has to move, keep half its length again as spare capacity behind it */
+#define mxIndexCapacity(_SIZE) (((_SIZE) < 0x01000000) ? ((_SIZE) + ((_SIZE) >> 1) + 4) : (_SIZE))
+
 #define mxTypeArrayCount 9
 
 typedef struct {
@@ -199,6 +207,7 @@ typedef union {
 	struct { txSlot* address; txIndex length; } array;
 	struct { txByte* address; txInteger length; } arrayBuffer;
 	struct { txCallback address; txID* IDs; } callback;
+	struct { txFastCallback address; txID* IDs; } fastCallback;
 	struct { txByte* address; txSlot* closures; } code;
 	struct { txInteger offset; txInteger size; } dataView;
 	struct { void* data; union { txDestructor destructor; txHostHooks* hooks; } variant; } host;
@@ -234,6 +243,8 @@ struct sxChunk {
 	txByte* temporary;
 };
 
+#define mxFreeChunkClassCount 24
+
 struct sxJump {
 	c_jmp_buf buffer; /* xs.h */
 	txJump* nextJump; /* xs.h */
@@ -273,6 +284,15 @@ struct sxProfileRecord {
 	txInteger profileID;
 };
 
+struct sxAllocationSite {
+	txID path;
+	txID name;
+	txInteger line;
+	txSize sampleCount;
+	txSize slotsSize;
+	txSize chunksSize;
+};
+
 struct sxMachine {
 	txSlot* stack; /* xs.h */
 	txSlot* scope; /* xs.h */
@@ -291,6 +311,9 @@ struct sxMachine {
 	txSlot* cRoot;
 
 	txBlock* firstBlock;
+	txByte* freeChunks[mxFreeChunkClassCount];
+	txSize freeChunksSize;
+	txByte* recycledChunk;
 
 	txSlot* freeHeap;
 	txSlot* firstHeap;
@@ -323,6 +346,8 @@ struct sxMachine {
 	txSize maximumHeapCount;
 	txSize minimumHeapCount;
 
+	txSize maximumStackCount;
+
 	txBoolean shared;
 	txMachine* sharedMachine;
 	txSlot* sharedModules;
@@ -331,6 +356,8 @@ struct sxMachine {
 	txFlag requireFlag;
 	void* dtoa;
 	void* preparation;
+	txString stringifyBuffer;
+	txSize stringifySize;
 
 	char nameBuffer[256];
 #ifdef mxDebug
@@ -355,12 +382,17 @@ struct sxMachine {
 	txNumber exits[XS_CODE_COUNT];
 	txNumber frequencies[XS_CODE_COUNT];
 #endif
-#ifdef mxInstrument
 	txSize garbageCollectionCount;
+#ifdef mxInstrument
 	txSize loadedModulesCount;
 	txSize parserTotal;
 	txSlot* stackPeak;
+	txSize peakStackCount;
 	void (*onBreak)(txMachine*, txU1 stop);
+	txAllocationSite* allocationSites;
+	txSize allocationInterval;
+	txSize allocationCountdown;
+	txHeapWriter* heapWriter;
 #endif
 #ifdef mxProfile
 	txString profileDirectory;
@@ -388,6 +420,16 @@ struct sxCreation {
 	txSize nameModulo; /* xs.h */
 	txSize symbolModulo; /* xs.h */
 	txSize staticSize; /* xs.h */
+	txSize maximumStackCount; /* xs.h */
+};
+
+struct sxSnapshot {
+	char* signature; /* xs.h */
+	int signatureLength; /* xs.h */
+	txBoolean (*read)(void* stream, void* address, size_t size); /* xs.h */
+	txBoolean (*write)(void* stream, void* address, size_t size); /* xs.h */
+	void* stream; /* xs.h */
+	int error; /* xs.h */
 };
 
 struct sxPreparation {
@@ -421,6 +463,15 @@ struct sxHostFunctionBuilder {
 	txCallback callback;
 	txID length;
 	txID id;
+	txID signature;
+	txFastCallback fastCallback;
+};
+
+union sxFastValue {
+	txInteger integer;
+	txNumber number;
+	txBoolean boolean;
+	struct { void* data; txInteger length; } buffer;
 };
 
 typedef struct {
@@ -470,6 +521,7 @@ mxExport void fxArrayCacheEnd(txMachine*, txSlot*);
 mxExport void fxArrayCacheItem(txMachine*, txSlot*, txSlot*);
 
 mxExport void fxBuildHosts(txMachine*, txInteger, const txHostFunctionBuilder*);
+extern void fxCallFastHost(txMachine* the, txFastCallback callback, txID signature, txSlot* stack, txSlot* result);
 mxExport txSlot* fxNewHostConstructor(txMachine*, txCallback, txInteger, txInteger);
 mxExport txSlot* fxNewHostFunction(txMachine*, txCallback, txInteger, txInteger);
 mxExport txSlot* fxNewHostInstance(txMachine* the);
@@ -552,6 +604,10 @@ mxExport void* fxGetArchiveCode(txMachine* the, txString path, txSize* size);
 mxExport void* fxGetArchiveData(txMachine* the, txString path, txSize* size);
 mxExport void* fxMapArchive(txPreparation* preparation, void* archive, void* stage, size_t bufferSize, txArchiveRead read, txArchiveWrite write);
 
+/* xsSnapshot.c */
+mxExport txBoolean fxWriteSnapshot(txMachine* the, txSnapshot* snapshot);
+mxExport txMachine* fxReadSnapshot(txSnapshot* snapshot, txString theName, void* theContext);
+
 /* xsmc.c */
 mxExport void _xsNewArray(txMachine *the, txSlot *res, txInteger length);
 mxExport void _xsNewObject(txMachine *the, txSlot *res);
@@ -580,6 +636,9 @@ extern void fxFreeChunks(txMachine* the, void* theChunks);
 extern void fxFreeSlots(txMachine* the, void* theSlots);
 extern void fxLoadModule(txMachine* the, txID moduleID);
 extern void fxMarkHost(txMachine* the, txMarkRoot markRoot);
+#ifdef mxUseDefaultHeapProtection
+extern void fxProtectHeap(txMachine* the, void* theAddress, txSize theSize, txBoolean theFlag);
+#endif
 extern txScript* fxParseScript(txMachine* the, void* stream, txGetter getter, txUnsigned flags);
 extern void fxQueuePromiseJobs(txMachine* the);
 extern void fxSweepHost(txMachine* the);
@@ -642,10 +701,20 @@ extern void fxAllocate(txMachine* the, txCreation* theCreation);
 extern void fxCollect(txMachine* the, txBoolean theFlag);
 mxExport txSlot* fxDuplicateSlot(txMachine* the, txSlot* theSlot);
 extern void fxFree(txMachine* the);
+extern void fxGrowStack(txMachine* the, txSize theCount);
 mxExport void* fxNewChunk(txMachine* the, txSize theSize);
 extern txSlot* fxNewSlot(txMachine* the);
+extern void fxProtect(txMachine* the, txBoolean theFlag);
 mxExport void* fxRenewChunk(txMachine* the, void* theData, txSize theSize);
+extern void* fxReserveChunk(txMachine* the, txSize theSize, txSize theCapacity);
 extern void fxShare(txMachine* the);
+extern void* fxSliceChunk(txMachine* the, void* theData, txSize theOffset);
+#ifdef mxInstrument
+mxExport void fxReportAllocations(txMachine* the, txInteger count);
+mxExport void fxStartAllocationSampling(txMachine* the, txSize interval);
+mxExport void fxStopAllocationSampling(txMachine* the);
+mxExport txBoolean fxWriteHeapSnapshot(txMachine* the, void* stream, txBoolean (*write)(void* stream, void* address, size_t size));
+#endif
 
 /* xsDebug.c */
 #ifdef mxDebug
@@ -673,9 +742,13 @@ extern txSlot* fxNewEnvironmentInstance(txMachine* the, txSlot* environment);
 extern txSlot* fxGetInstance(txMachine* the, txSlot* theSlot);
 extern void fxPushSpeciesConstructor(txMachine* the, txSlot* constructor);
 
+extern txSlot* fxAliasClosure(txMachine* the, txSlot* closure);
+extern txSlot* fxAliasInstance(txMachine* the, txSlot* instance);
+
 extern txSlot* fxNewInstance(txMachine* the);
 extern txSlot* fxToInstance(txMachine* the, txSlot* theSlot);
 extern void fxToPrimitive(txMachine* the, txSlot* theSlot, txBoolean theHint);
+extern void fxPushPrimitive(txMachine* the, txSlot* theSlot, txBoolean theHint);
 extern txFlag fxDescriptorToSlot(txMachine* the, txSlot* descriptor);
 extern void fxDescribeProperty(txMachine* the, txSlot* property, txFlag mask);
 extern txBoolean fxIsPropertyCompatible(txMachine* the, txSlot* property, txSlot* slot, txFlag mask);
@@ -1082,8 +1155,12 @@ extern txNumber fxArgToLastIndex(txMachine* the, txInteger argi, txNumber index,
 extern txNumber fxArgToRange(txMachine* the, txInteger argi, txNumber index, txNumber min, txNumber max);
 extern void fxCacheArray(txMachine* the, txSlot* theArray);
 extern void fxConstructArrayEntry(txMachine* the, txSlot* entry);
+extern void fxGetPackedItem(txMachine* the, txSlot* array, txIndex index, txSlot* slot);
+extern void fxIndexArray(txMachine* the, txSlot* array);
 extern txBoolean fxIsArray(txMachine* the, txSlot* instance);
 extern txSlot* fxNewArrayInstance(txMachine* the);
+extern txBoolean fxSetPackedItem(txMachine* the, txSlot* instance, txIndex index, txSlot* slot);
+extern void fxUnpackArray(txMachine* the, txSlot* array);
 extern txNumber fxToLength(txMachine* the, txSlot* slot);
 
 extern const txBehavior gxArgumentsSloppyBehavior;
@@ -1318,15 +1395,18 @@ mxExport void fx_WeakSet_prototype_add(txMachine* the);
 mxExport void fx_WeakSet_prototype_delete(txMachine* the);
 mxExport void fx_WeakSet_prototype_has(txMachine* the);
 
+extern void fxAliasEntries(txMachine* the, txSlot* from, txSlot* table, txSlot* list, txBoolean paired);
 extern void fxBuildMapSet(txMachine* the);
 extern txSlot* fxNewMapInstance(txMachine* the);
 extern txSlot* fxNewSetInstance(txMachine* the);
 extern txSlot* fxNewWeakMapInstance(txMachine* the);
 extern txSlot* fxNewWeakSetInstance(txMachine* the);
+extern void fxRehashEntries(txMachine* the, txSlot* table);
 
 /* xsJSON.c */
 mxExport void fx_JSON_parse(txMachine* the);
 mxExport void fx_JSON_stringify(txMachine* the);
+mxExport void fx_JSON_stringifyToArrayBuffer(txMachine* the);
 
 extern void fxBuildJSON(txMachine* the);
 
@@ -1354,6 +1434,7 @@ mxExport void fxOnResolvedPromise(txMachine* the);
 mxExport void fxRejectPromise(txMachine* the);
 mxExport void fxResolvePromise(txMachine* the);
 
+extern void fxAwaitPromise(txMachine* the, txSlot* value, txSlot* onFullfilled, txSlot* onRejected);
 extern void fxBuildPromise(txMachine* the);
 extern txSlot* fxNewPromiseAlready(txMachine* the);
 extern txSlot* fxNewPromiseFunction(txMachine* the, txSlot* already, txSlot* promise, txSlot* function);
@@ -1429,6 +1510,17 @@ enum {
 	XS_ERROR_COUNT
 };
 
+enum {
+	XS_SNAPSHOT_NO_ERROR = 0,
+	XS_SNAPSHOT_STREAM_ERROR,
+	XS_SNAPSHOT_MEMORY_ERROR,
+	XS_SNAPSHOT_VERSION_ERROR,
+	XS_SNAPSHOT_SIGNATURE_ERROR,
+	XS_SNAPSHOT_FORMAT_ERROR,
+	XS_SNAPSHOT_STATE_ERROR,
+	XS_SNAPSHOT_HOST_ERROR
+};
+
 enum {
 	XS_NO_STATUS = 0,
 	XS_RETURN_STATUS = 1,
@@ -1444,9 +1536,12 @@ enum {
 	
 	XS_OWN = 0,
 	XS_ANY = 1,
+	
+	XS_IMMUTABLE = 0,
+	XS_MUTABLE = 1,
 
 	/* frame flags */
-	/* ? = 1, */
+	XS_MOVABLE_FLAG = 1,
 	XS_C_FLAG = 2,
 	/* ? =  = 4, */
 	XS_STEP_INTO_FLAG = 8,
@@ -1471,8 +1566,8 @@ enum {
 	/* XS_DONT_ENUM_FLAG = 4, */
 	/* XS_DONT_SET_FLAG = 8 ,  */
 	XS_INSPECTOR_FLAG = 16,
-	/* ? = 32, */
-	/* ? = 64, */
+	XS_FAST_FLAG = 32,
+	XS_ALIAS_FLAG = 64,
 	/* XS_MARK_FLAG = 128, */
 
 	/* mxBehaviorOwnKeys flags */
@@ -1554,6 +1649,8 @@ enum {
 	XS_HOST_INSPECTOR_KIND,
 	XS_INSTANCE_INSPECTOR_KIND,
 	XS_EXPORT_KIND,
+	XS_PACKED_INTEGER_KIND,
+	XS_PACKED_NUMBER_KIND,
 };
 
 #define mxTry(THE_MACHINE) \
@@ -1640,6 +1737,8 @@ enum {
 	(/* (THE_SLOT) && */ ((THE_SLOT)->next) && ((THE_SLOT)->next->flag && XS_INTERNAL_FLAG) && ((THE_SLOT)->next->kind == XS_HOST_KIND))
 #define mxIsProxy(THE_SLOT) \
 	(/* (THE_SLOT) && */ ((THE_SLOT)->next) && ((THE_SLOT)->next->flag && XS_INTERNAL_FLAG) && ((THE_SLOT)->next->kind == XS_PROXY_KIND))
+#define mxIsPackedArray(THE_SLOT) \
+	(((THE_SLOT)->kind == XS_PACKED_INTEGER_KIND) || ((THE_SLOT)->kind == XS_PACKED_NUMBER_KIND))
 #define mxIsCallable(THE_SLOT) \
 	( (THE_SLOT) &&  ((THE_SLOT)->next) && (((THE_SLOT)->next->kind == XS_CALLBACK_KIND) || ((THE_SLOT)->next->kind == XS_CALLBACK_X_KIND) || ((THE_SLOT)->next->kind == XS_CODE_KIND) || ((THE_SLOT)->next->kind == XS_CODE_X_KIND) || ((THE_SLOT)->next->kind == XS_PROXY_KIND)))
 #define mxIsConstructor(THE_SLOT) \
@@ -1886,6 +1985,12 @@ enum {
 #define mxTransferClosure(TRANSFER)	(TRANSFER)->value.reference->next->next->next->next->next
 
 #define mxBehavior(INSTANCE) (gxBehaviors[((INSTANCE)->flag & XS_EXOTIC_FLAG) ? (INSTANCE)->next->ID : 0])
+
+#define mxAliasClosure(CLOSURE) \
+	((((CLOSURE)->flag & XS_ALIAS_FLAG) && the->aliasArray[(CLOSURE)->ID]) ? the->aliasArray[(CLOSURE)->ID] : (CLOSURE))
+#define mxAliasInstance(INSTANCE) \
+	((((INSTANCE)->ID >= 0) && the->aliasArray[(INSTANCE)->ID]) ? the->aliasArray[(INSTANCE)->ID] : (INSTANCE))
+
 #define mxBehaviorCall(THE, INSTANCE, THIS, ARGUMENTS) \
 	(*mxBehavior(INSTANCE)->call)(THE, INSTANCE, THIS, ARGUMENTS)
 #define mxBehaviorConstruct(THE, INSTANCE, ARGUMENTS, TARGET) \
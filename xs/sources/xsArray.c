@@ -42,16 +42,26 @@
 
 static txIndex fxCheckArrayLength(txMachine* the, txSlot* slot);
 static txBoolean fxCallThisItem(txMachine* the, txSlot* function, txIndex index, txSlot* item);
-static txSlot* fxCheckArray(txMachine* the, txSlot* slot);
+static txSlot* fxCheckArray(txMachine* the, txSlot* slot, txBoolean packed);
 static int fxCompareArrayItem(txMachine* the, txSlot* function, txSlot* array, txInteger i);
+static int fxComparePackedItem(txMachine* the, txSlot* function, txSlot* a, txSlot* b);
 static txSlot* fxCreateArray(txMachine* the, txFlag flag, txIndex length);
-static txSlot* fxCreateArraySpecies(txMachine* the, txNumber length);
+static txSlot* fxCheckArraySpecies(txMachine* the, txIndex length);
+static txSlot* fxCreateArraySpecies(txMachine* the, txNumber length, txFlag flag);
 static void fxFindThisItem(txMachine* the, txSlot* function, txIndex index, txSlot* item);
 static txNumber fxGetArrayLength(txMachine* the, txSlot* reference);
 static txIndex fxGetArrayLimit(txMachine* the, txSlot* reference);
+static txKind fxGetPackedKind(txMachine* the, txSlot* slot);
+static txBoolean fxGetThisItem(txMachine* the, txIndex index);
+static txBoolean fxIsPackableArray(txMachine* the, txSlot* instance);
 static void fxMoveThisItem(txMachine* the, txNumber from, txNumber to);
+static void fxPackArray(txMachine* the, txSlot* array);
 static void fxReduceThisItem(txMachine* the, txSlot* function, txIndex index);
 static txBoolean fxSetArrayLength(txMachine* the, txSlot* array, txIndex target);
+static void fxSetPackedLength(txMachine* the, txSlot* array, txIndex length);
+static void fxSortPackedArray(txMachine* the, txSlot* array, txSlot* function);
+static void fxStorePackedItem(txMachine* the, txSlot* array, txIndex index, txSlot* slot);
+static void fxWidenPackedArray(txMachine* the, txSlot* array);
 static void fx_Array_from_aux(txMachine* the, txSlot* function, txIndex index);
 
 static txBoolean fxArrayDefineOwnProperty(txMachine* the, txSlot* instance, txID id, txIndex index, txSlot* slot, txFlag mask);
@@ -289,11 +299,8 @@ void fxCacheArray(txMachine* the, txSlot* instance)
 
 txBoolean fxCallThisItem(txMachine* the, txSlot* function, txIndex index, txSlot* item)
 {
-	mxPushSlot(mxThis);
-	if (fxHasIndex(the, index)) {
-		/* ARG0 */
-		mxPushSlot(mxThis);
-		fxGetIndex(the, index);
+	/* ARG0 */
+	if (fxGetThisItem(the, index)) {
 		if (item) {
 			item->kind = the->stack->kind;
 			item->value = the->stack->value;
@@ -317,13 +324,26 @@ txBoolean fxCallThisItem(txMachine* the, txSlot* function, txIndex index, txSlot
 	return 0;
 }
 
-txSlot* fxCheckArray(txMachine* the, txSlot* slot)
+txSlot* fxCheckArray(txMachine* the, txSlot* slot, txBoolean packed)
 {
 	txSlot* instance = fxToInstance(the, slot);
-	txSlot* array = instance->next;
+	txSlot* array;
+	if (instance->ID >= 0) {
+		instance = the->aliasArray[instance->ID];
+		if (!instance)
+			return C_NULL;
+	}
+	array = instance->next;
 	if (array && (array->ID == XS_ARRAY_BEHAVIOR)) {
-		txSlot* address = array->value.array.address;
-		txIndex size = (address) ? (((txChunk*)(((txByte*)address) - sizeof(txChunk)))->size) / sizeof(txSlot) : 0;
+		txSlot* address;
+		txIndex size;
+		if (mxIsPackedArray(array)) {
+			if (packed)
+				return array;
+			fxUnpackArray(the, array);
+		}
+		address = array->value.array.address;
+		size = (address) ? (((txChunk*)(((txByte*)address) - sizeof(txChunk)))->size) / sizeof(txSlot) : 0;
 		if (array->value.array.length == size) {
 			return array;
 		}
@@ -396,6 +416,43 @@ int fxCompareArrayItem(txMachine* the, txSlot* function, txSlot* array, txIntege
 	return result;
 }
 
+int fxComparePackedItem(txMachine* the, txSlot* function, txSlot* a, txSlot* b)
+{
+	int result;
+	if (function) {
+		mxPushSlot(a);
+		mxPushSlot(b);
+		/* ARGC */
+		mxPushInteger(2);
+		/* THIS */
+		mxPushUndefined();
+		/* FUNCTION */
+		mxPushReference(function);
+		fxCall(the);
+		if (the->stack->kind == XS_INTEGER_KIND)
+			result = the->stack->value.integer;
+		else {
+			txNumber number = fxToNumber(the, the->stack);
+			result = (number < 0) ? -1 :  (number > 0) ? 1 : 0;
+		}
+		the->stack++;
+	}
+	else {
+		char aBuffer[256];
+		char bBuffer[256];
+		if (a->kind == XS_INTEGER_KIND)
+			fxIntegerToString(the->dtoa, a->value.integer, aBuffer, sizeof(aBuffer));
+		else
+			fxNumberToString(the->dtoa, a->value.number, aBuffer, sizeof(aBuffer), 0, 0);
+		if (b->kind == XS_INTEGER_KIND)
+			fxIntegerToString(the->dtoa, b->value.integer, bBuffer, sizeof(bBuffer));
+		else
+			fxNumberToString(the->dtoa, b->value.number, bBuffer, sizeof(bBuffer), 0, 0);
+		result = c_strcmp(aBuffer, bBuffer);
+	}
+	return result;
+}
+
 void fxConstructArrayEntry(txMachine* the, txSlot* entry)
 {
 	txSlot* value = the->stack;
@@ -441,10 +498,24 @@ txSlot* fxCreateArray(txMachine* the, txFlag flag, txIndex length)
 	mxPullSlot(mxResult);
 	if (flag)
 		fxSetIndexSize(the, mxResult->value.reference->next, length);
-	return fxCheckArray(the, mxResult);
+	return fxCheckArray(the, mxResult, 0);
 }
 
-txSlot* fxCreateArraySpecies(txMachine* the, txNumber length)
+txSlot* fxCheckArraySpecies(txMachine* the, txIndex length)
+{
+	/* only called when every item is copied right away, before any script can reach the result */
+	txSlot* instance = mxResult->value.reference;
+	txSlot* array = instance->next;
+	if (array && (array->ID == XS_ARRAY_BEHAVIOR) && (array->kind == XS_ARRAY_KIND) && !(array->flag & XS_DONT_SET_FLAG) && !(instance->flag & XS_DONT_PATCH_FLAG)) {
+		if (!array->value.array.address && (array->value.array.length == length)) {
+			array->value.array.length = 0;
+			fxSetIndexSize(the, array, length);
+		}
+	}
+	return fxCheckArray(the, mxResult, 0);
+}
+
+txSlot* fxCreateArraySpecies(txMachine* the, txNumber length, txFlag flag)
 {
 	txSlot* instance = fxToInstance(the, mxThis);
 	txSlot* array;
@@ -465,9 +536,13 @@ txSlot* fxCreateArraySpecies(txMachine* the, txNumber length)
 		*the->stack = mxArrayConstructor;
 	if (!mxIsReference(the->stack) || !mxIsConstructor(the->stack->value.reference))
 		mxTypeError("invalid constructor");
+	if (the->stack->value.reference != mxArrayConstructor.value.reference)
+		flag = 0;
 	fxNew(the);
 	mxPullSlot(mxResult);
-	array = fxCheckArray(the, mxResult);
+	if (flag)
+		return fxCheckArraySpecies(the, (txIndex)length);
+	array = fxCheckArray(the, mxResult, 0);
 	if (array && length)
 		fxSetIndexSize(the, array, (txIndex)length);
 	return array;
@@ -512,13 +587,13 @@ txIndex fxGetArrayLimit(txMachine* the, txSlot* reference)
 {
 	txNumber length;
 	txSlot* instance = fxToInstance(the, reference);
-	txSlot* array = instance->next;
+	txSlot* array = mxAliasInstance(instance)->next;
 	if (array && (array->ID == XS_ARRAY_BEHAVIOR))
 		return array->value.array.length;
 	if (array && (array->ID == XS_TYPED_ARRAY_BEHAVIOR)) {
 		txSlot* view = array->next;
 		txSlot* buffer = view->next;
-		txSlot* data = buffer->value.reference->next;
+		txSlot* data = mxAliasInstance(buffer->value.reference)->next;
 		if (data->value.arrayBuffer.address == C_NULL)
 			mxTypeError("detached buffer");
 		return view->value.dataView.size / array->value.typedArray.dispatch->size;
@@ -532,6 +607,55 @@ txIndex fxGetArrayLimit(txMachine* the, txSlot* reference)
 	return (txIndex)length;
 }
 
+void fxGetPackedItem(txMachine* the, txSlot* array, txIndex index, txSlot* slot)
+{
+	if (array->kind == XS_PACKED_INTEGER_KIND) {
+		slot->value.integer = ((txInteger*)array->value.array.address)[index];
+		slot->kind = XS_INTEGER_KIND;
+	}
+	else {
+		c_memcpy(&(slot->value.number), ((txNumber*)array->value.array.address) + index, sizeof(txNumber));
+		slot->kind = XS_NUMBER_KIND;
+	}
+}
+
+txKind fxGetPackedKind(txMachine* the, txSlot* slot)
+{
+	if (slot->kind == XS_INTEGER_KIND)
+		return XS_PACKED_INTEGER_KIND;
+	if (slot->kind == XS_NUMBER_KIND) {
+		txNumber number = slot->value.number;
+		/* the increment and decrement codes do not check integers for overflow, so numbers at the edges stay numbers */
+		if ((-2147483648.0 < number) && (number < 2147483647.0)) {
+			txInteger integer = (txInteger)number;
+			txNumber check = integer;
+			if ((number == check) && (number || !c_signbit(number)))
+				return XS_PACKED_INTEGER_KIND;
+		}
+		return XS_PACKED_NUMBER_KIND;
+	}
+	return XS_UNDEFINED_KIND;
+}
+
+txBoolean fxGetThisItem(txMachine* the, txIndex index)
+{
+	if (mxIsReference(mxThis)) {
+		txSlot* array = mxThis->value.reference->next;
+		if (array && mxIsPackedArray(array) && (index < array->value.array.length)) {
+			mxPushUndefined();
+			fxGetPackedItem(the, array, index, the->stack);
+			return 1;
+		}
+	}
+	mxPushSlot(mxThis);
+	if (fxHasIndex(the, index)) {
+		mxPushSlot(mxThis);
+		fxGetIndex(the, index);
+		return 1;
+	}
+	return 0;
+}
+
 void fxIndexArray(txMachine* the, txSlot* array) 
 {
 	txSlot* address = array->value.array.address;
@@ -566,6 +690,30 @@ again:
 	return 0;
 }
 
+txBoolean fxIsPackableArray(txMachine* the, txSlot* instance)
+{
+	txSlot* array = instance->next;
+	if ((instance->ID >= 0) || (instance->flag & XS_DONT_PATCH_FLAG) || (array->flag & XS_DONT_SET_FLAG))
+		return 0;
+	while ((instance = instance->value.instance.prototype)) {
+		txSlot* property;
+		if (instance->ID >= 0)
+			instance = mxAliasInstance(instance);
+		property = instance->next;
+		if (instance->flag & XS_EXOTIC_FLAG) {
+			if (!property || (property->ID != XS_ARRAY_BEHAVIOR) || property->value.array.length)
+				return 0;
+		}
+		else {
+			while (property && (property->flag & XS_INTERNAL_FLAG))
+				property = property->next;
+			if (property && (property->kind == XS_ARRAY_KIND) && property->value.array.address)
+				return 0;
+		}
+	}
+	return 1;
+}
+
 void fxMoveThisItem(txMachine* the, txNumber from, txNumber to)
 {
 	mxPushSlot(mxThis);
@@ -602,15 +750,38 @@ txSlot* fxNewArrayInstance(txMachine* the)
 	return instance;
 }
 
+void fxPackArray(txMachine* the, txSlot* array)
+{
+	txIndex length = array->value.array.length, index;
+	txKind kind = XS_PACKED_INTEGER_KIND;
+	txSlot* address = array->value.array.address;
+	txSlot* chunk;
+	if (!length || (fxGetIndexSize(the, array) != length))
+		return;
+	for (index = 0; index < length; index++) {
+		txKind itemKind = fxGetPackedKind(the, address);
+		if ((itemKind == XS_UNDEFINED_KIND) || (address->flag != XS_NO_FLAG))
+			return;
+		if (itemKind == XS_PACKED_NUMBER_KIND)
+			kind = XS_PACKED_NUMBER_KIND;
+		address++;
+	}
+	chunk = (txSlot*)fxNewChunk(the, length * ((kind == XS_PACKED_INTEGER_KIND) ? sizeof(txInteger) : sizeof(txNumber)));
+	address = array->value.array.address;
+	array->kind = kind;
+	array->value.array.address = chunk;
+	for (index = 0; index < length; index++) {
+		fxStorePackedItem(the, array, index, address);
+		address++;
+	}
+}
+
 void fxReduceThisItem(txMachine* the, txSlot* function, txIndex index)
 {
-	mxPushSlot(mxThis);
-	if (fxHasIndex(the, index)) {
-		/* ARG0 */
-		mxPushSlot(mxResult);
-		/* ARG1 */
-		mxPushSlot(mxThis);
-		fxGetIndex(the, index);
+	/* ARG0 */
+	mxPushSlot(mxResult);
+	/* ARG1 */
+	if (fxGetThisItem(the, index)) {
 		/* ARG2 */
 		mxPushUnsigned(index);
 		/* ARG3 */
@@ -624,21 +795,42 @@ void fxReduceThisItem(txMachine* the, txSlot* function, txIndex index)
 		fxCall(the);
 		mxPullSlot(mxResult);
 	}
+	else
+		mxPop();
 }
 
 txBoolean fxSetArrayLength(txMachine* the, txSlot* array, txIndex length)
 {
-	txSlot* address = array->value.array.address;
-	txSlot* chunk = address;
+	txSlot* address;
+	txSlot* chunk;
 	txBoolean success = 1;
+	txBoolean dense = 0;
+	if (mxIsPackedArray(array)) {
+		if (length <= array->value.array.length) {
+			if (length == 0)
+				array->value.array.address = C_NULL;
+			else {
+				txSize size = length * ((array->kind == XS_PACKED_INTEGER_KIND) ? sizeof(txInteger) : sizeof(txNumber));
+				txChunk* header = (txChunk*)(((txByte*)array->value.array.address) - sizeof(txChunk));
+				if ((header->size - (txSize)sizeof(txChunk) - size) >= (txSize)sizeof(txChunk))
+					fxRenewChunk(the, array->value.array.address, size);
+			}
+			array->value.array.length = length;
+			return 1;
+		}
+		fxUnpackArray(the, array);
+	}
+	address = array->value.array.address;
+	chunk = address;
 	if (address) {
 		txSize size = (((txChunk*)(((txByte*)chunk) - sizeof(txChunk)))->size) / sizeof(txSlot);
 		txSlot* result = address + size;
 		txSlot* limit = result;
 		txIndex at;
+		dense = (array->value.array.length == (txIndex)size) ? 1 : 0;
 		while (result > address) {
 			result--;
-			at = *((txIndex*)result);
+			at = (dense) ? (txIndex)(result - address) : *((txIndex*)result);
 			if (length > at) {
 				result++;
 				break;
@@ -663,9 +855,118 @@ txBoolean fxSetArrayLength(txMachine* the, txSlot* array, txIndex length)
 	}
 	array->value.array.length = length;
 	array->value.array.address = chunk;
+	if (dense && (length != fxGetIndexSize(the, array)))
+		fxIndexArray(the, array);
 	return success;
 }
 
+txBoolean fxSetPackedItem(txMachine* the, txSlot* instance, txIndex index, txSlot* slot)
+{
+	txSlot* array = instance->next;
+	txIndex length = array->value.array.length;
+	txKind kind = fxGetPackedKind(the, slot);
+	if ((kind == XS_UNDEFINED_KIND) || (index > length))
+		return 0;
+	if ((array->kind == XS_ARRAY_KIND) && (length || array->value.array.address))
+		return 0;
+	if ((index == length) && ((length == 0xFFFFFFFF) || !fxIsPackableArray(the, instance)))
+		return 0;
+	if (array->kind == XS_ARRAY_KIND)
+		array->kind = kind;
+	else if ((array->kind == XS_PACKED_INTEGER_KIND) && (kind == XS_PACKED_NUMBER_KIND))
+		fxWidenPackedArray(the, array);
+	if (index == length)
+		fxSetPackedLength(the, array, length + 1);
+	fxStorePackedItem(the, array, index, slot);
+	return 1;
+}
+
+void fxSetPackedLength(txMachine* the, txSlot* array, txIndex length)
+{
+	txSize size = (array->kind == XS_PACKED_INTEGER_KIND) ? sizeof(txInteger) : sizeof(txNumber);
+	txByte* address = (txByte*)array->value.array.address;
+	txIndex capacity = (address) ? (((txChunk*)(address - sizeof(txChunk)))->size - sizeof(txChunk)) / size : 0;
+	if (capacity < length) {
+		txByte* chunk = (address) ? (txByte*)fxRenewChunk(the, address, length * size) : C_NULL;
+		if (!chunk) {
+			chunk = (txByte*)fxReserveChunk(the, length * size, mxIndexCapacity(length) * size);
+			address = (txByte*)array->value.array.address;
+			if (address)
+				c_memcpy(chunk, address, array->value.array.length * size);
+			array->value.array.address = (txSlot*)chunk;
+		}
+	}
+	array->value.array.length = length;
+}
+
+void fxSortPackedArray(txMachine* the, txSlot* array, txSlot* function)
+{
+	txIndex length = array->value.array.length;
+	txSize size = (array->kind == XS_PACKED_INTEGER_KIND) ? sizeof(txInteger) : sizeof(txNumber);
+	txSlot* buffer;
+	txIndex from = 0, to = length, width, index;
+	txSlot a, b;
+	mxPushUndefined();
+	buffer = the->stack;
+	buffer->value.array.address = (txSlot*)fxNewChunk(the, 2 * length * size);
+	buffer->value.array.length = 2 * length;
+	buffer->kind = array->kind;
+	c_memcpy(buffer->value.array.address, array->value.array.address, length * size);
+	/* bottom-up merge sort, stable, between both halves of the buffer */
+	for (width = 1; width < length; width <<= 1) {
+		txIndex lo, mid, hi, i, j, k;
+		for (lo = 0; lo < length; lo += width << 1) {
+			mid = (lo + width < length) ? lo + width : length;
+			hi = (mid + width < length) ? mid + width : length;
+			i = lo;
+			j = mid;
+			k = lo;
+			while ((i < mid) && (j < hi)) {
+				fxGetPackedItem(the, buffer, from + i, &a);
+				fxGetPackedItem(the, buffer, from + j, &b);
+				if (fxComparePackedItem(the, function, &a, &b) <= 0) {
+					fxStorePackedItem(the, buffer, to + k, &a);
+					i++;
+				}
+				else {
+					fxStorePackedItem(the, buffer, to + k, &b);
+					j++;
+				}
+				k++;
+			}
+			if (i < mid)
+				c_memcpy(((txByte*)buffer->value.array.address) + ((to + k) * size), ((txByte*)buffer->value.array.address) + ((from + i) * size), (mid - i) * size);
+			else if (j < hi)
+				c_memcpy(((txByte*)buffer->value.array.address) + ((to + k) * size), ((txByte*)buffer->value.array.address) + ((from + j) * size), (hi - j) * size);
+		}
+		index = from;
+		from = to;
+		to = index;
+	}
+	if ((array->kind == buffer->kind) && (array->value.array.length == length))
+		c_memcpy(array->value.array.address, ((txByte*)buffer->value.array.address) + (from * size), length * size);
+	else {
+		for (index = 0; index < length; index++) {
+			mxPushUndefined();
+			fxGetPackedItem(the, buffer, from + index, the->stack);
+			mxPushSlot(mxThis);
+			fxSetIndex(the, index);
+			mxPop();
+		}
+	}
+	mxPop();
+}
+
+void fxStorePackedItem(txMachine* the, txSlot* array, txIndex index, txSlot* slot)
+{
+	if (array->kind == XS_PACKED_INTEGER_KIND)
+		((txInteger*)array->value.array.address)[index] = (slot->kind == XS_INTEGER_KIND) ? slot->value.integer : (txInteger)slot->value.number;
+	else {
+		txNumber number = (slot->kind == XS_INTEGER_KIND) ? (txNumber)slot->value.integer : slot->value.number;
+		c_memcpy(((txNumber*)array->value.array.address) + index, &number, sizeof(txNumber));
+	}
+}
+
 
 txNumber fxToLength(txMachine* the, txSlot* slot)
 {
@@ -692,13 +993,50 @@ again:
 	goto again;
 }
 
+void fxUnpackArray(txMachine* the, txSlot* array)
+{
+	txIndex length = array->value.array.length, index;
+	txSlot* chunk = C_NULL;
+	if (length) {
+		txSlot* slot;
+		chunk = (txSlot*)fxNewChunk(the, length * sizeof(txSlot));
+		slot = chunk;
+		for (index = 0; index < length; index++) {
+			*((txIndex*)slot) = index;
+			slot->ID = XS_NO_ID;
+			slot->flag = XS_NO_FLAG;
+			fxGetPackedItem(the, array, index, slot);
+			slot++;
+		}
+	}
+	array->kind = XS_ARRAY_KIND;
+	array->value.array.address = chunk;
+}
+
+void fxWidenPackedArray(txMachine* the, txSlot* array)
+{
+	txIndex length = array->value.array.length, index;
+	txNumber* chunk = C_NULL;
+	if (length) {
+		txInteger* address;
+		chunk = (txNumber*)fxReserveChunk(the, length * sizeof(txNumber), mxIndexCapacity(length) * sizeof(txNumber));
+		address = (txInteger*)array->value.array.address;
+		for (index = 0; index < length; index++) {
+			txNumber number = address[index];
+			c_memcpy(chunk + index, &number, sizeof(txNumber));
+		}
+	}
+	array->kind = XS_PACKED_NUMBER_KIND;
+	array->value.array.address = (txSlot*)chunk;
+}
+
 void fxArrayLengthGetter(txMachine* the)
 {
 	txSlot* instance = fxToInstance(the, mxThis);
 	txSlot* array;
 	while (instance) {
 		if (instance->flag & XS_EXOTIC_FLAG) {
-			array = instance->next;
+			array = mxAliasInstance(instance)->next;
 			if (array->ID == XS_ARRAY_BEHAVIOR)
 				break;
 		}
@@ -715,8 +1053,11 @@ void fxArrayLengthSetter(txMachine* the)
 	while (instance) {
 		if (instance->flag & XS_EXOTIC_FLAG) {
 			array = instance->next;
-			if (array->ID == XS_ARRAY_BEHAVIOR)
+			if (array->ID == XS_ARRAY_BEHAVIOR) {
+				if (instance->ID >= 0)
+					array = fxAliasInstance(the, instance)->next;
 				break;
+			}
 		}
 		instance = instance->value.instance.prototype;
 	}
@@ -727,6 +1068,8 @@ void fxArrayLengthSetter(txMachine* the)
 
 txBoolean fxArrayDefineOwnProperty(txMachine* the, txSlot* instance, txID id, txIndex index, txSlot* descriptor, txFlag mask) 
 {
+	if (instance->ID >= 0)
+		instance = fxAliasInstance(the, instance);
 	if (id == mxID(_length)) {
 		txSlot* array = instance->next;
 		txSlot slot;
@@ -743,6 +1086,8 @@ txBoolean fxArrayDefineOwnProperty(txMachine* the, txSlot* instance, txID id, tx
 			array->flag |= XS_DONT_SET_FLAG;
 		return result;
 	}
+	if (!id && mxIsPackedArray(instance->next))
+		fxUnpackArray(the, instance->next);
 	return fxOrdinaryDefineOwnProperty(the, instance, id, index, descriptor, mask);
 }
 
@@ -750,11 +1095,17 @@ txBoolean fxArrayDeleteProperty(txMachine* the, txSlot* instance, txID id, txInd
 {
 	if (id == mxID(_length))
 		return 0;
+	if (instance->ID >= 0)
+		instance = fxAliasInstance(the, instance);
+	if (!id && mxIsPackedArray(instance->next))
+		fxUnpackArray(the, instance->next);
 	return fxOrdinaryDeleteProperty(the, instance, id, index);
 }
 
 txBoolean fxArrayGetOwnProperty(txMachine* the, txSlot* instance, txID id, txIndex index, txSlot* descriptor)
 {
+	if (instance->ID >= 0)
+		instance = mxAliasInstance(instance);
 	if (id == mxID(_length)) {
 		txSlot* array = instance->next;
 		descriptor->flag = array->flag;
@@ -770,6 +1121,16 @@ txSlot* fxArrayGetProperty(txMachine* the, txSlot* instance, txID id, txIndex in
 {
 	if (id == mxID(_length))
 		return &mxArrayLengthAccessor;
+	if (instance->ID >= 0)
+		instance = mxAliasInstance(instance);
+	if (!id) {
+		txSlot* array = instance->next;
+		if (mxIsPackedArray(array) && (index < array->value.array.length)) {
+			fxGetPackedItem(the, array, index, &the->scratch);
+			the->scratch.flag = XS_NO_FLAG;
+			return &the->scratch;
+		}
+	}
 	return fxOrdinaryGetProperty(the, instance, id, index, flag);
 }
 
@@ -777,12 +1138,19 @@ txBoolean fxArrayHasProperty(txMachine* the, txSlot* instance, txID id, txIndex
 {
 	if (id == mxID(_length))
 		return 1;
+	if (instance->ID >= 0)
+		instance = mxAliasInstance(instance);
+	if (!id) {
+		txSlot* array = instance->next;
+		if (mxIsPackedArray(array) && (index < array->value.array.length))
+			return 1;
+	}
 	return fxOrdinaryHasProperty(the, instance, id, index);
 }
 
 void fxArrayOwnKeys(txMachine* the, txSlot* instance, txFlag flag, txSlot* keys)
 {
-	txSlot* property = instance->next;
+	txSlot* property = mxAliasInstance(instance)->next;
 	keys = fxQueueIndexKeys(the, property, flag, keys);
 	if (flag & XS_EACH_NAME_FLAG)
 		keys = fxQueueKey(the, mxID(_length), XS_NO_ID, keys);
@@ -793,11 +1161,15 @@ void fxArrayOwnKeys(txMachine* the, txSlot* instance, txFlag flag, txSlot* keys)
 txSlot* fxArraySetProperty(txMachine* the, txSlot* instance, txID id, txIndex index, txFlag flag)
 {
 	if (id == mxID(_length)) {
-		txSlot* array = instance->next;
+		txSlot* array = mxAliasInstance(instance)->next;
 		if (array->flag & XS_DONT_SET_FLAG)
 			return array;
 		return &mxArrayLengthAccessor;
 	}
+	if (instance->ID >= 0)
+		instance = fxAliasInstance(the, instance);
+	if (!id && mxIsPackedArray(instance->next))
+		fxUnpackArray(the, instance->next);
 	return fxOrdinarySetProperty(the, instance, id, index, flag);
 }
 
@@ -990,7 +1362,7 @@ void fx_Array_of(txMachine* the)
 
 void fx_Array_prototype_concat(txMachine* the)
 {
-	txSlot* resultArray = fxCreateArraySpecies(the, 0);
+	txSlot* resultArray = fxCreateArraySpecies(the, 0, 0);
 	txIndex resultLength = 0;
 	txInteger c = mxArgc;
 	txInteger i = -1;
@@ -1120,7 +1492,7 @@ void fx_Array_prototype_concat(txMachine* the)
 
 void fx_Array_prototype_copyWithin(txMachine* the)
 {
-	txSlot* array = fxCheckArray(the, mxThis);
+	txSlot* array = fxCheckArray(the, mxThis, 0);
 	if (array) {
 		txIndex length = array->value.array.length;
 		txIndex to = (txIndex)fxArgToIndex(the, 0, 0, length);
@@ -1203,32 +1575,54 @@ void fx_Array_prototype_fill(txMachine* the)
 		txIndex length = array->value.array.length;
 		txIndex start = (txIndex)fxArgToIndex(the, 1, 0, length);
 		txIndex end = (txIndex)fxArgToIndex(the, 2, length, length);
-		txSlot* address;
-		txIndex size;
-		if ((start == 0) && (end == length)) {
-			fxSetIndexSize(the, array, length);
-			fxIndexArray(the, array);
-		}
-		address = array->value.array.address;
-		size = (address) ? (((txChunk*)(((txByte*)address) - sizeof(txChunk)))->size) / sizeof(txSlot) : 0;
-		if (length == size) {
+		txKind kind = fxGetPackedKind(the, value);
+		if (mxIsPackedArray(array) && (kind != XS_UNDEFINED_KIND) && (end <= array->value.array.length)) {
+			if ((array->kind == XS_PACKED_INTEGER_KIND) && (kind == XS_PACKED_NUMBER_KIND) && (start < end))
+				fxWidenPackedArray(the, array);
 			while (start < end) {
-				txSlot* slot = array->value.array.address + start;
-				slot->ID = XS_NO_ID;
-				slot->kind = value->kind;
-				slot->value = value->value;
+				fxStorePackedItem(the, array, start, value);
 				start++;
 			}
 		}
-		else {
+		else if ((array->kind == XS_ARRAY_KIND) && !array->value.array.address && (kind != XS_UNDEFINED_KIND) && (start == 0) && length && (end == length) && (array->value.array.length == length) && fxIsPackableArray(the, instance)) {
+			array->kind = kind;
+			array->value.array.length = 0;
+			fxSetPackedLength(the, array, length);
 			while (start < end) {
-				mxPushSlot(value);
-				mxPushSlot(mxThis);
-				fxSetIndex(the, start);
-				mxPop();
+				fxStorePackedItem(the, array, start, value);
 				start++;
 			}
 		}
+		else {
+			txSlot* address;
+			txIndex size;
+			if (mxIsPackedArray(array))
+				fxUnpackArray(the, array);
+			if ((start == 0) && (end == length)) {
+				fxSetIndexSize(the, array, length);
+				fxIndexArray(the, array);
+			}
+			address = array->value.array.address;
+			size = (address) ? (((txChunk*)(((txByte*)address) - sizeof(txChunk)))->size) / sizeof(txSlot) : 0;
+			if (length == size) {
+				while (start < end) {
+					txSlot* slot = array->value.array.address + start;
+					slot->ID = XS_NO_ID;
+					slot->kind = value->kind;
+					slot->value = value->value;
+					start++;
+				}
+			}
+			else {
+				while (start < end) {
+					mxPushSlot(value);
+					mxPushSlot(mxThis);
+					fxSetIndex(the, start);
+					mxPop();
+					start++;
+				}
+			}
+		}
 	}
 	else {
 		txNumber length = fxGetArrayLength(the, mxThis);
@@ -1254,7 +1648,7 @@ void fx_Array_prototype_filter(txMachine* the)
 	txIndex length = fxGetArrayLimit(the, mxThis);
 	txIndex index = 0;
 	txSlot* function = fxArgToCallback(the, 0);
-	txSlot* resultArray = fxCreateArraySpecies(the, 0);
+	txSlot* resultArray = fxCreateArraySpecies(the, 0, 0);
 	txIndex resultLength = 0;
 	txSlot* item;
 	mxPushUndefined();
@@ -1356,7 +1750,7 @@ void fx_Array_prototype_forEach(txMachine* the)
 
 void fx_Array_prototype_includes(txMachine* the)
 {
-	txSlot* array = fxCheckArray(the, mxThis);
+	txSlot* array = fxCheckArray(the, mxThis, 1);
 	txSlot* argument;
 	if (mxArgc > 0)
 		mxPushSlot(mxArgv(0));
@@ -1368,6 +1762,20 @@ void fx_Array_prototype_includes(txMachine* the)
 		txIndex length = array->value.array.length;
 		if (length) {
 			txIndex index = (txIndex)fxArgToIndex(the, 1, 0, length);
+			if (mxIsPackedArray(array) && (length == array->value.array.length)) {
+				txSlot item;
+				if ((argument->kind == XS_INTEGER_KIND) || (argument->kind == XS_NUMBER_KIND)) {
+					while (index < length) {
+						fxGetPackedItem(the, array, index, &item);
+						if (fxIsSameValue(the, &item, argument, 1)) {
+							mxResult->value.boolean = 1;
+							break;
+						}
+						index++;
+					}
+				}
+				index = length;
+			}
 			while (index < length) {
 				mxPushSlot(mxThis);
 				fxGetIndex(the, index);
@@ -1400,7 +1808,7 @@ void fx_Array_prototype_includes(txMachine* the)
 
 void fx_Array_prototype_indexOf(txMachine* the)
 {
-	txSlot* array = fxCheckArray(the, mxThis);
+	txSlot* array = fxCheckArray(the, mxThis, 1);
 	txSlot* argument;
 	if (mxArgc > 0)
 		mxPushSlot(mxArgv(0));
@@ -1412,6 +1820,20 @@ void fx_Array_prototype_indexOf(txMachine* the)
 		txIndex length = array->value.array.length;
 		if (length) {
 			txIndex index = (txIndex)fxArgToIndex(the, 1, 0, length);
+			if (mxIsPackedArray(array) && (length == array->value.array.length)) {
+				txSlot item;
+				if ((argument->kind == XS_INTEGER_KIND) || (argument->kind == XS_NUMBER_KIND)) {
+					while (index < length) {
+						fxGetPackedItem(the, array, index, &item);
+						if (fxIsSameSlot(the, &item, argument)) {
+							fxUnsigned(the, mxResult, index);
+							break;
+						}
+						index++;
+					}
+				}
+				index = length;
+			}
 			while (index < length) {
 				mxPushSlot(mxThis);
 				if (fxHasIndex(the, index)) {
@@ -1458,6 +1880,7 @@ void fx_Array_prototype_join(txMachine* the)
 	txSlot* slot = list;
 	txBoolean comma = 0;
 	txInteger size = 0;
+	txSlot* array = (mxIsReference(mxThis)) ? mxThis->value.reference->next : C_NULL;
 	if ((mxArgc > 0) && (mxArgv(0)->kind != XS_UNDEFINED_KIND)) {
 		mxPushSlot(mxArgv(0));
 		string = fxToString(the, the->stack);
@@ -1469,32 +1892,70 @@ void fx_Array_prototype_join(txMachine* the)
 		the->stack->kind += XS_KEY_KIND - XS_STRING_KIND;
 		the->stack->value.key.sum = 1;
 	}
-	while (index < length) {
-		if (comma) {
-			slot = fxNextSlotProperty(the, slot, the->stack, XS_NO_ID, XS_NO_FLAG);
-			size += slot->value.key.sum;
+	if (array && mxIsPackedArray(array) && (array->value.array.length == length)) {
+		txSlot* separator = the->stack;
+		txSlot item;
+		char buffer[256];
+		/* items are numbers: measure them all, then format them again straight into the result */
+		while (index < length) {
+			fxGetPackedItem(the, array, index, &item);
+			if (item.kind == XS_INTEGER_KIND)
+				fxIntegerToString(the->dtoa, item.value.integer, buffer, sizeof(buffer));
+			else
+				fxNumberToString(the->dtoa, item.value.number, buffer, sizeof(buffer), 0, 0);
+			size += c_strlen(buffer);
+			index++;
 		}
-		else
-			comma = 1;
-		mxPushSlot(mxThis);
-		fxGetIndex(the, index);
-		if ((the->stack->kind != XS_UNDEFINED_KIND) && (the->stack->kind != XS_NULL_KIND)) {
-			slot = fxNextSlotProperty(the, slot, the->stack, XS_NO_ID, XS_NO_FLAG);
-			string = fxToString(the, slot);
-			slot->kind += XS_KEY_KIND - XS_STRING_KIND;
-			slot->value.key.sum = c_strlen(string);
-			size += slot->value.key.sum;
+		if (length)
+			size += (length - 1) * separator->value.key.sum;
+		string = mxResult->value.string = fxNewChunk(the, size + 1);
+		index = 0;
+		while (index < length) {
+			txInteger sum;
+			if (index) {
+				c_memcpy(string, separator->value.key.string, separator->value.key.sum);
+				string += separator->value.key.sum;
+			}
+			fxGetPackedItem(the, array, index, &item);
+			if (item.kind == XS_INTEGER_KIND)
+				fxIntegerToString(the->dtoa, item.value.integer, buffer, sizeof(buffer));
+			else
+				fxNumberToString(the->dtoa, item.value.number, buffer, sizeof(buffer), 0, 0);
+			sum = c_strlen(buffer);
+			c_memcpy(string, buffer, sum);
+			string += sum;
+			index++;
 		}
 		mxPop();
-		index++;
 	}
-	mxPop();
-	string = mxResult->value.string = fxNewChunk(the, size + 1);
-	slot = list->next;
-	while (slot) {
-		c_memcpy(string, slot->value.key.string, slot->value.key.sum);
-		string += slot->value.key.sum;
-		slot = slot->next;
+	else {
+		while (index < length) {
+			if (comma) {
+				slot = fxNextSlotProperty(the, slot, the->stack, XS_NO_ID, XS_NO_FLAG);
+				size += slot->value.key.sum;
+			}
+			else
+				comma = 1;
+			mxPushSlot(mxThis);
+			fxGetIndex(the, index);
+			if ((the->stack->kind != XS_UNDEFINED_KIND) && (the->stack->kind != XS_NULL_KIND)) {
+				slot = fxNextSlotProperty(the, slot, the->stack, XS_NO_ID, XS_NO_FLAG);
+				string = fxToString(the, slot);
+				slot->kind += XS_KEY_KIND - XS_STRING_KIND;
+				slot->value.key.sum = c_strlen(string);
+				size += slot->value.key.sum;
+			}
+			mxPop();
+			index++;
+		}
+		mxPop();
+		string = mxResult->value.string = fxNewChunk(the, size + 1);
+		slot = list->next;
+		while (slot) {
+			c_memcpy(string, slot->value.key.string, slot->value.key.sum);
+			string += slot->value.key.sum;
+			slot = slot->next;
+		}
 	}
 	*string = 0;
 	mxResult->kind = XS_STRING_KIND;
@@ -1513,7 +1974,7 @@ void fx_Array_prototype_keys(txMachine* the)
 
 void fx_Array_prototype_lastIndexOf(txMachine* the)
 {
-	txSlot* array = fxCheckArray(the, mxThis);
+	txSlot* array = fxCheckArray(the, mxThis, 1);
 	txSlot* argument;
 	if (mxArgc > 0)
 		mxPushSlot(mxArgv(0));
@@ -1525,6 +1986,20 @@ void fx_Array_prototype_lastIndexOf(txMachine* the)
 		txIndex length = array->value.array.length;
 		if (length) {
 			txIndex index = (txIndex)fxArgToLastIndex(the, 1, length, length);
+			if (mxIsPackedArray(array) && (length == array->value.array.length)) {
+				txSlot item;
+				if ((argument->kind == XS_INTEGER_KIND) || (argument->kind == XS_NUMBER_KIND)) {
+					while (index > 0) {
+						index--;
+						fxGetPackedItem(the, array, index, &item);
+						if (fxIsSameSlot(the, &item, argument)) {
+							fxUnsigned(the, mxResult, index);
+							break;
+						}
+					}
+				}
+				index = 0;
+			}
 			while (index > 0) {
 				index--;
 				mxPushSlot(mxThis);
@@ -1566,7 +2041,7 @@ void fx_Array_prototype_map(txMachine* the)
 {
 	txNumber LENGTH = fxGetArrayLength(the, mxThis);
 	txSlot* function = fxArgToCallback(the, 0);
-	txSlot* resultArray = fxCreateArraySpecies(the, LENGTH);
+	txSlot* resultArray = fxCreateArraySpecies(the, LENGTH, 1);
 	txIndex length = (txIndex)LENGTH;
 	txIndex index = 0;
 	if (resultArray) {
@@ -1587,6 +2062,8 @@ void fx_Array_prototype_map(txMachine* the)
 			fxSetIndexSize(the, resultArray, resultLength);
 			resultArray->value.array.length = length;
 		}
+		else if (fxIsPackableArray(the, mxResult->value.reference))
+			fxPackArray(the, resultArray);
 	}
 	else {
 		while (index < length) {
@@ -1602,16 +2079,25 @@ void fx_Array_prototype_map(txMachine* the)
 
 void fx_Array_prototype_pop(txMachine* the)
 {
-	txSlot* array = fxCheckArray(the, mxThis);
+	txSlot* array = fxCheckArray(the, mxThis, 1);
 	if (array) {
 		txIndex length = array->value.array.length;
 		txSlot* address;
 		if (length > 0) {
 			length--;
-			address = array->value.array.address + length;
-			mxResult->kind = address->kind;
-			mxResult->value = address->value;
-			fxSetIndexSize(the, array, length);
+			if (mxIsPackedArray(array)) {
+				if (array->flag & XS_DONT_SET_FLAG)
+					mxTypeError("set length: not writable");
+				/* keep the capacity for the next push */
+				fxGetPackedItem(the, array, length, mxResult);
+				array->value.array.length = length;
+			}
+			else {
+				address = array->value.array.address + length;
+				mxResult->kind = address->kind;
+				mxResult->value = address->value;
+				fxSetIndexSize(the, array, length);
+			}
 		}
 	}
 	else {
@@ -1637,8 +2123,36 @@ void fx_Array_prototype_pop(txMachine* the)
 void fx_Array_prototype_push(txMachine* the)
 {
 	txIndex c = mxArgc, i = 0;
-	txSlot* array = fxCheckArray(the, mxThis);
-	if (array) {
+	txSlot* array = fxCheckArray(the, mxThis, 1);
+	txKind kind = XS_UNDEFINED_KIND;
+	if (array && (mxIsPackedArray(array) || (!array->value.array.length && !array->value.array.address))) {
+		kind = XS_PACKED_INTEGER_KIND;
+		while ((i < c) && (kind != XS_UNDEFINED_KIND)) {
+			txKind argumentKind = fxGetPackedKind(the, mxArgv(i));
+			if (argumentKind != XS_PACKED_INTEGER_KIND)
+				kind = argumentKind;
+			i++;
+		}
+		i = 0;
+		if ((kind != XS_UNDEFINED_KIND) && !fxIsPackableArray(the, mxThis->value.reference))
+			kind = XS_UNDEFINED_KIND;
+	}
+	if (kind != XS_UNDEFINED_KIND) {
+		txIndex length = array->value.array.length;
+		if (length + c < length)
+			mxRangeError("array overflow");
+		if (array->kind == XS_ARRAY_KIND)
+			array->kind = kind;
+		else if ((array->kind == XS_PACKED_INTEGER_KIND) && (kind == XS_PACKED_NUMBER_KIND))
+			fxWidenPackedArray(the, array);
+		fxSetPackedLength(the, array, length + c);
+		while (i < c) {
+			fxStorePackedItem(the, array, length + i, mxArgv(i));
+			i++;
+		}
+		mxPushUnsigned(length + c);
+	}
+	else if ((array = fxCheckArray(the, mxThis, 0))) {
 		txIndex length = array->value.array.length;
 		txSlot* address;
 		if (length + c < length)
@@ -1805,7 +2319,7 @@ void fx_Array_prototype_reverse(txMachine* the)
 
 void fx_Array_prototype_shift(txMachine* the)
 {
-	txSlot* array = fxCheckArray(the, mxThis);
+	txSlot* array = fxCheckArray(the, mxThis, 0);
 	if (array) {
 		txIndex length = array->value.array.length;
 		txSlot* address;
@@ -1814,9 +2328,15 @@ void fx_Array_prototype_shift(txMachine* the)
 			length--;
 			mxResult->kind = address->kind;
 			mxResult->value = address->value;
-			c_memmove(address, address + 1, length * sizeof(txSlot));
-			fxSetIndexSize(the, array, length);
-			fxIndexArray(the, array);
+			if (length && !(array->flag & XS_DONT_SET_FLAG) && ((address = (txSlot*)fxSliceChunk(the, address, sizeof(txSlot))))) {
+				array->value.array.length = length;
+				array->value.array.address = address;
+			}
+			else {
+				address = array->value.array.address;
+				c_memmove(address, address + 1, length * sizeof(txSlot));
+				fxSetIndexSize(the, array, length);
+			}
 		}
 	}
 	else {
@@ -1864,14 +2384,38 @@ void fx_Array_prototype_slice(txMachine* the)
 	txNumber START = fxArgToIndex(the, 0, 0, LENGTH);
 	txNumber END = fxArgToIndex(the, 1, LENGTH, LENGTH);
 	txNumber COUNT = (END > START) ? END - START : 0;
-	txSlot* array = fxCheckArray(the, mxThis);
-	txSlot* resultArray = fxCreateArraySpecies(the, COUNT);
-	if (array && resultArray) {
+	txSlot* resultArray = fxCreateArraySpecies(the, COUNT, 0);
+	txSlot* array = fxCheckArray(the, mxThis, 1);
+	if (array && (array->value.array.length >= END))
+		resultArray = fxCheckArraySpecies(the, (txIndex)COUNT);
+	if (array && resultArray && (array->value.array.length >= END)) {
 		txIndex start = (txIndex)START;
 		txIndex count = (txIndex)COUNT;
 		if (count) {
-			c_memcpy(resultArray->value.array.address, array->value.array.address + start, count * sizeof(txSlot));
-			fxIndexArray(the, resultArray);
+			if (mxIsPackedArray(array)) {
+				if (fxIsPackableArray(the, mxResult->value.reference)) {
+					txSize size = (array->kind == XS_PACKED_INTEGER_KIND) ? sizeof(txInteger) : sizeof(txNumber);
+					txSlot* chunk = (txSlot*)fxNewChunk(the, count * size);
+					c_memcpy(chunk, ((txByte*)array->value.array.address) + (start * size), count * size);
+					resultArray->kind = array->kind;
+					resultArray->value.array.address = chunk;
+				}
+				else {
+					txSlot* address = resultArray->value.array.address;
+					txIndex index;
+					for (index = 0; index < count; index++) {
+						*((txIndex*)address) = index;
+						address->ID = XS_NO_ID;
+						address->flag = XS_NO_FLAG;
+						fxGetPackedItem(the, array, start + index, address);
+						address++;
+					}
+				}
+			}
+			else {
+				c_memcpy(resultArray->value.array.address, array->value.array.address + start, count * sizeof(txSlot));
+				fxIndexArray(the, resultArray);
+			}
 		}
 	}
 	else {
@@ -1917,7 +2461,7 @@ void fx_Array_prototype_some(txMachine* the)
 
 void fx_Array_prototype_sort(txMachine* the)
 {
-	txSlot* array = fxCheckArray(the, mxThis);
+	txSlot* array = fxCheckArray(the, mxThis, 1);
 	txSlot* function = C_NULL;
  	txNumber LENGTH;
  	txIndex index, length;
@@ -1933,6 +2477,16 @@ void fx_Array_prototype_sort(txMachine* the)
 				mxTypeError("compare is no function");
 		}
 	}
+	if (array && mxIsPackedArray(array)) {
+		if (array->value.array.length < 0x01000000) {
+			if (array->value.array.length > 1)
+				fxSortPackedArray(the, array, function);
+			mxResult->kind = mxThis->kind;
+			mxResult->value = mxThis->value;
+			return;
+		}
+		array = fxCheckArray(the, mxThis, 0);
+	}
 	if (!array) {
 		LENGTH = fxGetArrayLength(the, mxThis);
 		if (LENGTH > 0xFFFFFFFF)
@@ -2086,7 +2640,7 @@ void fx_Array_prototype_splice(txMachine* the)
 	txNumber LENGTH = fxGetArrayLength(the, mxThis);
 	txNumber START = fxArgToIndex(the, 0, 0, LENGTH);
 	txNumber INSERTIONS, DELETIONS;
-	txSlot* array = fxCheckArray(the, mxThis);
+	txSlot* array;
 	txSlot* resultArray;
 	if (c == 0) {
 		INSERTIONS = 0;
@@ -2102,7 +2656,12 @@ void fx_Array_prototype_splice(txMachine* the)
 	}
 	if (LENGTH + INSERTIONS - DELETIONS > C_MAX_SAFE_INTEGER)
 		mxTypeError("unsafe integer");
-	resultArray = fxCreateArraySpecies(the, DELETIONS);
+	resultArray = fxCreateArraySpecies(the, DELETIONS, 0);
+	array = fxCheckArray(the, mxThis, 0);
+	if (array && (array->value.array.length == LENGTH))
+		resultArray = fxCheckArraySpecies(the, (txIndex)DELETIONS);
+	else
+		array = C_NULL;
 	if (array && resultArray) {
 		txSlot* address;
 		txIndex length = (txIndex)LENGTH;
@@ -2252,7 +2811,7 @@ void fx_Array_prototype_toString(txMachine* the)
 void fx_Array_prototype_unshift(txMachine* the)
 {
 	txIndex c = mxArgc, i;
-	txSlot* array = fxCheckArray(the, mxThis);
+	txSlot* array = fxCheckArray(the, mxThis, 0);
 	if (array) {
 		txSlot* address;
 		txIndex length = array->value.array.length;
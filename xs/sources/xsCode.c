@@ -883,7 +883,7 @@ txScript* fxParserCode(txParser* parser)
 		size = 2;
 		node = parser->firstHostNode;
 		while (node) {
-			size += 3 + node->at->length + 1;
+			size += 5 + node->nameLength + 1;
 			node = node->nextHostNode;
 		}
 	
@@ -901,8 +901,10 @@ txScript* fxParserCode(txParser* parser)
 			else
 				c = -1;
 			mxEncode2(p, c);
-			c_memcpy(p, node->at->value, node->at->length);
-			p += node->at->length;
+			c = node->signature;
+			mxEncode2(p, c);
+			c_memcpy(p, node->at->value, node->nameLength);
+			p += node->nameLength;
 			*p++ = 0;
 			node = node->nextHostNode;
 		}
@@ -1349,6 +1351,8 @@ void fxScopeCodeRetrieve(txScope* self, txCoder* coder)
 	node = self->firstDeclareNode;
 	while (node) {
 		if ((node->flags & mxDeclareNodeUseClosureFlag) && node->symbol) {
+			if (node->declaration && !(node->declaration->flags & mxDeclareNodeClosureFlag))
+				node->flags &= ~mxDeclareNodeClosureFlag;
 			node->index = coder->scopeLevel++;
 			count++;
 		}
@@ -2647,6 +2651,9 @@ void fxHostNodeCode(void* it, void* param)
 		self->paramsCount = fxCoderCountParameters(coder, self->params);
 	else
 		self->paramsCount = -1;	
+	self->signature = fxParseFastSignature(self->at->value, &self->nameLength);
+	if ((self->signature == XS_NO_ID) || (self->signature && (self->paramsCount < 0)))
+		fxReportLineError(parser, self->line, "invalid host signature %s", self->at->value);
 	if (parser->firstHostNode)
 		parser->lastHostNode->nextHostNode = self;
 	else
@@ -917,6 +917,58 @@ txInteger fxUnicodeToUTF8Offset(txString theString, txInteger theOffset)
 		return -1;
 }
 
+#define mxDigits10(PREFIX) PREFIX "0", PREFIX "1", PREFIX "2", PREFIX "3", PREFIX "4", PREFIX "5", PREFIX "6", PREFIX "7", PREFIX "8", PREFIX "9"
+#define mxDigits100(PREFIX) mxDigits10(PREFIX "0"), mxDigits10(PREFIX "1"), mxDigits10(PREFIX "2"), mxDigits10(PREFIX "3"), mxDigits10(PREFIX "4"), \
+	mxDigits10(PREFIX "5"), mxDigits10(PREFIX "6"), mxDigits10(PREFIX "7"), mxDigits10(PREFIX "8"), mxDigits10(PREFIX "9")
+
+const char gxSmallIntegerStrings[mxSmallIntegerStringCount][mxSmallIntegerStringSize] ICACHE_XS6RO_ATTR = {
+	mxDigits10(""),
+	mxDigits10("1"), mxDigits10("2"), mxDigits10("3"), mxDigits10("4"), mxDigits10("5"), mxDigits10("6"), mxDigits10("7"), mxDigits10("8"), mxDigits10("9"),
+	mxDigits100("1"), mxDigits100("2"), mxDigits100("3"), mxDigits100("4"), mxDigits100("5"), mxDigits100("6"), mxDigits100("7"), mxDigits100("8"), mxDigits100("9"),
+	mxDigits10("100"), mxDigits10("101"), "1020", "1021", "1022", "1023"
+};
+
+txID fxParseFastSignature(txString name, txSize* length)
+{
+	txString p = c_strchr(name, '(');
+	txID signature = mxFastSignatureFlag;
+	txInteger index = 0;
+	char c;
+	if (!p) {
+		*length = (txSize)c_strlen(name);
+		return 0;
+	}
+	*length = (txSize)(p - name);
+	p++;
+	while ((c = *p++) != ')') {
+		if (index == mxFastArgumentCount)
+			return XS_NO_ID;
+		if (c == 'i')
+			signature |= XS_FAST_INTEGER << (2 + (index << 1));
+		else if (c == 'n')
+			signature |= XS_FAST_NUMBER << (2 + (index << 1));
+		else if (c == 'p')
+			signature |= XS_FAST_BUFFER << (2 + (index << 1));
+		else
+			return XS_NO_ID;
+		index++;
+	}
+	c = *p;
+	if (c) {
+		if (c == 'i')
+			signature |= XS_FAST_INTEGER;
+		else if (c == 'n')
+			signature |= XS_FAST_NUMBER;
+		else if (c == 'b')
+			signature |= XS_FAST_BOOLEAN;
+		else if (c != 'v')
+			return XS_NO_ID;
+		if (*(p + 1))
+			return XS_NO_ID;
+	}
+	return signature;
+}
+
 txFlag fxIntegerToIndex(void* dtoa, txInteger theInteger, txIndex* theIndex)
 {
 	if (0 <= theInteger) {
@@ -943,10 +995,27 @@ txFlag fxStringToIndex(void* dtoa, txString theString, txIndex* theIndex)
 	txNumber number;
 	txIndex integer;
 	txNumber check;
+	txString p;
 
+	if ((gxSmallIntegerStrings[0] <= theString) && (theString < gxSmallIntegerStrings[mxSmallIntegerStringCount])) {
+		*theIndex = (txIndex)((theString - gxSmallIntegerStrings[0]) / mxSmallIntegerStringSize);
+		return 1;
+	}
 	c = c_read8(theString);
 	if (('+' != c) && ('-' != c) && ('.' != c) && !(('0' <= c) && ('9' >= c)))
 		return 0;
+	integer = 0;
+	p = theString;
+	while (('0' <= c) && ('9' >= c) && (p - theString < 9)) {
+		integer = (integer * 10) + (c - '0');
+		c = c_read8(++p);
+	}
+	if (c == 0) {
+		if ((c_read8(theString) == '0') && (p - theString > 1))
+			return 0;
+		*theIndex = integer;
+		return 1;
+	}
 	number = fxStringToNumber(dtoa, theString, 1);
 	integer = (txIndex)number;
 	check = integer;
@@ -1303,6 +1372,7 @@ const txString gxIDStrings[XS_ID_COUNT] = {
 	"sticky",
 	"store",
 	"stringify",
+	"stringifyToArrayBuffer",
 	"sub",
 	"subarray",
 	"substr",
@@ -86,6 +86,29 @@ typedef int (*txPutter)(txString, void*);
 #define XS_MINOR_VERSION 2
 #define XS_PATCH_VERSION 0
 
+#define XS_HEAP_SNAPSHOT_VERSION 1
+enum {
+	XS_HEAP_EDGE_RECORD = 'E',
+	XS_HEAP_NAME_RECORD = 'N',
+	XS_HEAP_NODE_RECORD = 'O',
+};
+enum {
+	XS_HEAP_ROOT_NODE = 0,
+	XS_HEAP_OBJECT_NODE,
+	XS_HEAP_ARRAY_NODE,
+	XS_HEAP_FUNCTION_NODE,
+	XS_HEAP_HOST_NODE,
+	XS_HEAP_CLOSURE_NODE,
+	XS_HEAP_STRING_NODE,
+	XS_HEAP_NODE_KIND_COUNT
+};
+enum {
+	XS_HEAP_PROPERTY_EDGE = 0,
+	XS_HEAP_ELEMENT_EDGE,
+	XS_HEAP_INTERNAL_EDGE,
+	XS_HEAP_PROTOTYPE_EDGE,
+};
+
 #define XS_DIGEST_SIZE 16
 #define XS_VERSION_SIZE 4
 
@@ -329,6 +352,20 @@ enum {
 	XS_SETTER_FLAG = 64,
 };
 
+enum {
+	XS_FAST_NONE = 0,
+	XS_FAST_INTEGER = 1,
+	XS_FAST_NUMBER = 2,
+	XS_FAST_BUFFER = 3,
+	XS_FAST_BOOLEAN = 3,
+};
+#define mxFastArgumentCount 6
+#define mxFastSignatureFlag 0x4000
+#define mxFastArgument(SIGNATURE, INDEX) (((SIGNATURE) >> (2 + ((INDEX) << 1))) & 3)
+#define mxFastResult(SIGNATURE) ((SIGNATURE) & 3)
+
+extern txID fxParseFastSignature(txString name, txSize* length);
+
 enum {
 	mxEnumeratorIntrinsic = 0,
 	mxEvalIntrinsic,
@@ -414,6 +451,11 @@ txFlag fxIntegerToIndex(void* dtoa, txInteger theInteger, txIndex* theIndex);
 txFlag fxNumberToIndex(void* dtoa, txNumber theNumber, txIndex* theIndex);
 txFlag fxStringToIndex(void* dtoa, txString theString, txIndex* theIndex);
 
+#define mxSmallIntegerStringCount 1024
+#define mxSmallIntegerStringSize 5
+#define mxSmallIntegerString(INDEX) ((txString)gxSmallIntegerStrings[INDEX])
+extern const char gxSmallIntegerStrings[mxSmallIntegerStringCount][mxSmallIntegerStringSize];
+
 /* ? */
 mxExport void fxVReport(void* console, txString theFormat, c_va_list theArguments);
 mxExport void fxVReportError(void* console, txString thePath, txInteger theLine, txString theFormat, c_va_list theArguments);
@@ -923,6 +965,7 @@ enum {
 	_sticky,
 	_store,
 	_stringify,
+	_stringifyToArrayBuffer,
 	_sub,
 	_subarray,
 	_substr,
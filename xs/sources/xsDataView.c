@@ -41,7 +41,7 @@ static txNumber fxArgToByteOffset(txMachine* the, txInteger argi, txNumber offse
 static txSlot* fxArgToInstance(txMachine* the, txInteger i);
 static txBoolean fxCheckLength(txMachine* the, txSlot* slot, txInteger* index);
 
-static txSlot* fxCheckArrayBufferInstance(txMachine* the, txSlot* slot);
+static txSlot* fxCheckArrayBufferInstance(txMachine* the, txSlot* slot, txBoolean mutable);
 static void fxConstructArrayBufferResult(txMachine* the, txSlot* constructor, txInteger length);
 static txSlot* fxNewArrayBufferInstance(txMachine* the);
 
@@ -113,7 +113,7 @@ void fxArrayBuffer(txMachine* the, txSlot* slot, void* data, txInteger byteLengt
 
 void fxGetArrayBufferData(txMachine* the, txSlot* slot, txInteger byteOffset, void* data, txInteger byteLength)
 {
-	txSlot* instance = fxCheckArrayBufferInstance(the, slot);
+	txSlot* instance = fxCheckArrayBufferInstance(the, slot, XS_IMMUTABLE);
 	txSlot* arrayBuffer = instance->next;
 	txInteger length = arrayBuffer->value.arrayBuffer.length;
 	if ((byteOffset < 0) || (length < byteOffset))
@@ -125,14 +125,14 @@ void fxGetArrayBufferData(txMachine* the, txSlot* slot, txInteger byteOffset, vo
 
 txInteger fxGetArrayBufferLength(txMachine* the, txSlot* slot)
 {
-	txSlot* instance = fxCheckArrayBufferInstance(the, slot);
+	txSlot* instance = fxCheckArrayBufferInstance(the, slot, XS_IMMUTABLE);
 	txSlot* arrayBuffer = instance->next;
 	return arrayBuffer->value.arrayBuffer.length;
 }
 
 void fxSetArrayBufferData(txMachine* the, txSlot* slot, txInteger byteOffset, void* data, txInteger byteLength)
 {
-	txSlot* instance = fxCheckArrayBufferInstance(the, slot);
+	txSlot* instance = fxCheckArrayBufferInstance(the, slot, XS_MUTABLE);
 	txSlot* arrayBuffer = instance->next;
 	txInteger length = arrayBuffer->value.arrayBuffer.length;
 	if ((byteOffset < 0) || (length < byteOffset))
@@ -144,7 +144,7 @@ void fxSetArrayBufferData(txMachine* the, txSlot* slot, txInteger byteOffset, vo
 
 void fxSetArrayBufferLength(txMachine* the, txSlot* slot, txInteger target)
 {
-	txSlot* instance = fxCheckArrayBufferInstance(the, slot);
+	txSlot* instance = fxCheckArrayBufferInstance(the, slot, XS_MUTABLE);
 	txSlot* arrayBuffer = instance->next;
 	txInteger length = arrayBuffer->value.arrayBuffer.length;
 	txByte* address = arrayBuffer->value.arrayBuffer.address;
@@ -171,7 +171,7 @@ void fxSetArrayBufferLength(txMachine* the, txSlot* slot, txInteger target)
 
 void* fxToArrayBuffer(txMachine* the, txSlot* slot)
 {
-	txSlot* instance = fxCheckArrayBufferInstance(the, slot);
+	txSlot* instance = fxCheckArrayBufferInstance(the, slot, XS_MUTABLE);
 	txSlot* arrayBuffer = instance->next;
 	return arrayBuffer->value.arrayBuffer.address;
 }
@@ -331,20 +331,23 @@ txBoolean fxCheckLength(txMachine* the, txSlot* slot, txInteger* index)
 	return 0;
 }
 
-txSlot* fxCheckArrayBufferDetached(txMachine* the, txSlot* slot)
+txSlot* fxCheckArrayBufferDetached(txMachine* the, txSlot* slot, txBoolean mutable)
 {
-	slot = slot->value.reference->next;
+	txSlot* instance = slot->value.reference;
+	if (instance->ID >= 0)
+		instance = (mutable) ? fxAliasInstance(the, instance) : mxAliasInstance(instance);
+	slot = instance->next;
 	if (slot->value.arrayBuffer.address == C_NULL)
 		mxTypeError("detached buffer");
 	return slot;
 }
 
-txSlot* fxCheckArrayBufferInstance(txMachine* the, txSlot* slot)
+txSlot* fxCheckArrayBufferInstance(txMachine* the, txSlot* slot, txBoolean mutable)
 {
 	if (slot->kind == XS_REFERENCE_KIND) {
 		txSlot* instance = slot->value.reference;
 		if (((slot = instance->next)) && (slot->flag & XS_INTERNAL_FLAG) && (slot->kind == XS_ARRAY_BUFFER_KIND))
-			return instance;
+			return (instance->ID >= 0) ? ((mutable) ? fxAliasInstance(the, instance) : mxAliasInstance(instance)) : instance;
 	}
 	mxTypeError("this is no ArrayBuffer instance");
 	return C_NULL;
@@ -468,15 +471,15 @@ void fx_ArrayBuffer_isView(txMachine* the)
 
 void fx_ArrayBuffer_prototype_get_byteLength(txMachine* the)
 {
-	txSlot* instance = fxCheckArrayBufferInstance(the, mxThis);
-	fxCheckArrayBufferDetached(the, mxThis);
+	txSlot* instance = fxCheckArrayBufferInstance(the, mxThis, XS_IMMUTABLE);
+	fxCheckArrayBufferDetached(the, mxThis, XS_IMMUTABLE);
 	mxResult->kind = XS_INTEGER_KIND;
 	mxResult->value.integer = instance->next->value.arrayBuffer.length;
 }
 
 void fx_ArrayBuffer_prototype_concat(txMachine* the)
 {
-	txSlot* instance = fxCheckArrayBufferInstance(the, mxThis);
+	txSlot* instance = fxCheckArrayBufferInstance(the, mxThis, XS_IMMUTABLE);
 	txSlot* arrayBuffer = instance->next;
 	txInteger length = arrayBuffer->value.arrayBuffer.length;
 	txInteger c = mxArgc, i = 0;
@@ -486,7 +489,7 @@ void fx_ArrayBuffer_prototype_concat(txMachine* the)
 		arrayBuffer = C_NULL;
 		slot = mxArgv(i);
 		if (slot->kind == XS_REFERENCE_KIND) {
-			slot = slot->value.reference->next;
+			slot = mxAliasInstance(slot->value.reference)->next;
 			if (slot && (slot->kind == XS_ARRAY_BUFFER_KIND))
 				arrayBuffer = slot;
 		}
@@ -498,13 +501,13 @@ void fx_ArrayBuffer_prototype_concat(txMachine* the)
 	}
 	fxConstructArrayBufferResult(the, C_NULL, length);
 	address = mxResult->value.reference->next->value.arrayBuffer.address;
-	arrayBuffer = instance->next;
+	arrayBuffer = mxAliasInstance(instance)->next;
 	length = arrayBuffer->value.arrayBuffer.length;
 	c_memcpy(address, arrayBuffer->value.arrayBuffer.address, length);
 	address += length;
 	i = 0;
 	while (i < c) {
-		arrayBuffer = mxArgv(i)->value.reference->next;
+		arrayBuffer = mxAliasInstance(mxArgv(i)->value.reference)->next;
 		length = arrayBuffer->value.arrayBuffer.length;
 		c_memcpy(address, arrayBuffer->value.arrayBuffer.address, length);
 		address += length;
@@ -514,7 +517,7 @@ void fx_ArrayBuffer_prototype_concat(txMachine* the)
 
 void fx_ArrayBuffer_prototype_slice(txMachine* the)
 {
-	txSlot* instance = fxCheckArrayBufferInstance(the, mxThis);
+	txSlot* instance = fxCheckArrayBufferInstance(the, mxThis, XS_IMMUTABLE);
 	txSlot* arrayBuffer = instance->next;
 	txInteger length = arrayBuffer->value.arrayBuffer.length;
 	txInteger start = (txInteger)fxArgToIndex(the, 0, 0, length);
@@ -583,7 +586,7 @@ void fx_DataView(txMachine* the)
 	if (!flag)
 		mxTypeError("buffer is no ArrayBuffer instance");
 	offset = (txInteger)fxArgToByteOffset(the, 1, 0);
-	fxCheckArrayBufferDetached(the, mxArgv(0));
+	fxCheckArrayBufferDetached(the, mxArgv(0), XS_IMMUTABLE);
 	if (limit < offset)
 		mxRangeError("out of range byteOffset %ld", offset);
 	size = (txInteger)fxArgToByteLength(the, 2, limit - offset);
@@ -609,7 +612,7 @@ void fx_DataView_prototype_byteLength_get(txMachine* the)
 	txSlot* instance = fxCheckDataViewInstance(the, mxThis);
 	txSlot* view = instance->next;
 	txSlot* buffer = view->next;
-	fxCheckArrayBufferDetached(the, buffer);
+	fxCheckArrayBufferDetached(the, buffer, XS_IMMUTABLE);
 	mxResult->kind = XS_INTEGER_KIND;
 	mxResult->value.integer = view->value.dataView.size;
 }
@@ -619,7 +622,7 @@ void fx_DataView_prototype_byteOffset_get(txMachine* the)
 	txSlot* instance = fxCheckDataViewInstance(the, mxThis);
 	txSlot* view = instance->next;
 	txSlot* buffer = view->next;
-	fxCheckArrayBufferDetached(the, buffer);
+	fxCheckArrayBufferDetached(the, buffer, XS_IMMUTABLE);
 	mxResult->kind = XS_INTEGER_KIND;
 	mxResult->value.integer = view->value.dataView.offset;
 }
@@ -629,15 +632,16 @@ void fx_DataView_prototype_get(txMachine* the, txNumber delta, txTypeCallback ge
 	txSlot* instance = fxCheckDataViewInstance(the, mxThis);
 	txSlot* view = instance->next;
 	txSlot* buffer = view->next;
+	txSlot* data;
 	txNumber offset = fxArgToByteOffset(the, 0, 0);
 	int endian = EndianBig;
 	if ((mxArgc > 1) && fxToBoolean(the, mxArgv(1)))
 		endian = EndianLittle;
-	fxCheckArrayBufferDetached(the, buffer);
+	data = fxCheckArrayBufferDetached(the, buffer, XS_IMMUTABLE);
 	if ((txNumber)view->value.dataView.size < (offset + delta))
 		mxRangeError("out of range byteOffset");
 	offset += (txNumber)view->value.dataView.offset;
-	(*getter)(the, buffer->value.reference->next,  (txInteger)offset, mxResult, endian);
+	(*getter)(the, data, (txInteger)offset, mxResult, endian);
 }
 
 void fx_DataView_prototype_getFloat32(txMachine* the)
@@ -685,17 +689,18 @@ void fx_DataView_prototype_set(txMachine* the, txNumber delta, txTypeCallback se
 	txSlot* instance = fxCheckDataViewInstance(the, mxThis);
 	txSlot* view = instance->next;
 	txSlot* buffer = view->next;
+	txSlot* data;
 	txNumber offset = fxArgToByteOffset(the, 0, 0);
 	int endian = EndianBig;
 	if (mxArgc > 1)
 		fxToNumber(the, mxArgv(1));
 	if ((mxArgc > 2) && fxToBoolean(the, mxArgv(2)))
 		endian = EndianLittle;
-	fxCheckArrayBufferDetached(the, buffer);
+	data = fxCheckArrayBufferDetached(the, buffer, XS_MUTABLE);
 	if ((txNumber)view->value.dataView.size < (offset + delta))
 		mxRangeError("out of range byteOffset");
 	offset += (txNumber)view->value.dataView.offset;
-	(*setter)(the, buffer->value.reference->next, (txInteger)offset, (mxArgc < 2) ? &mxUndefined : mxArgv(1), endian);
+	(*setter)(the, data, (txInteger)offset, (mxArgc < 2) ? &mxUndefined : mxArgv(1), endian);
 }
 
 void fx_DataView_prototype_setFloat32(txMachine* the)
@@ -749,7 +754,16 @@ void fx_DataView_prototype_setUint8Clamped(txMachine* the)
 	txSlot* dispatch = instance->next; \
 	txSlot* view = dispatch->next; \
 	txSlot* buffer = view->next; \
-	txSlot* data = fxCheckArrayBufferDetached(the, buffer); \
+	txSlot* data = fxCheckArrayBufferDetached(the, buffer, XS_IMMUTABLE); \
+	txInteger delta = dispatch->value.typedArray.dispatch->size; \
+	txInteger length = view->value.dataView.size / delta
+
+#define mxMutableTypedArrayDeclarations \
+	txSlot* instance = fxCheckTypedArrayInstance(the, mxThis); \
+	txSlot* dispatch = instance->next; \
+	txSlot* view = dispatch->next; \
+	txSlot* buffer = view->next; \
+	txSlot* data = fxCheckArrayBufferDetached(the, buffer, XS_MUTABLE); \
 	txInteger delta = dispatch->value.typedArray.dispatch->size; \
 	txInteger length = view->value.dataView.size / delta
 
@@ -758,7 +772,7 @@ void fx_DataView_prototype_setUint8Clamped(txMachine* the)
 	txSlot* resultDispatch = resultInstance->next; \
 	txSlot* resultView = resultDispatch->next; \
 	txSlot* resultBuffer = resultView->next; \
-	txSlot* resultData = fxCheckArrayBufferDetached(the, resultBuffer); \
+	txSlot* resultData = fxCheckArrayBufferDetached(the, resultBuffer, XS_MUTABLE); \
 	txInteger resultDelta = resultDispatch->value.typedArray.dispatch->size; \
 	txInteger resultLength = resultView->value.dataView.size / resultDelta
 	
@@ -777,7 +791,7 @@ void fxTypedArrayGetter(txMachine* the)
 	if (instance) {
 		txSlot* view = dispatch->next;
 		txSlot* buffer = view->next;
-		txSlot* data = fxCheckArrayBufferDetached(the, buffer);
+		txSlot* data = fxCheckArrayBufferDetached(the, buffer, XS_IMMUTABLE);
 		txInteger delta = dispatch->value.typedArray.dispatch->size;
 		txIndex length = view->value.dataView.size / delta;
 		txIndex index = the->scratch.value.at.index;
@@ -808,7 +822,7 @@ void fxTypedArraySetter(txMachine* the)
 		txIndex index = the->scratch.value.at.index;
 		txSlot* slot = mxArgv(0);
 		fxToNumber(the, slot);
-		data = fxCheckArrayBufferDetached(the, buffer);
+		data = fxCheckArrayBufferDetached(the, buffer, XS_MUTABLE);
 		if (index < length) {
 			(*dispatch->value.typedArray.dispatch->setter)(the, data, view->value.dataView.offset + delta * index, slot, EndianNative);
 		}
@@ -836,7 +850,7 @@ txBoolean fxTypedArrayDefineOwnProperty(txMachine* the, txSlot* instance, txID i
 		if (slot->kind != XS_UNINITIALIZED_KIND) {
 			txSlot* data;
 			fxToNumber(the, slot);
-			data = fxCheckArrayBufferDetached(the, buffer);
+			data = fxCheckArrayBufferDetached(the, buffer, XS_MUTABLE);
 			(*dispatch->value.typedArray.dispatch->setter)(the, data, view->value.dataView.offset + delta * index, slot, EndianNative);
 		}
 		return 1;
@@ -865,7 +879,7 @@ txBoolean fxTypedArrayGetOwnProperty(txMachine* the, txSlot* instance, txID id,
 		txInteger delta = dispatch->value.typedArray.dispatch->size;
 		txIndex length = view->value.dataView.size / delta;
 		if (index < length) {
-			txSlot* data = fxCheckArrayBufferDetached(the, buffer);
+			txSlot* data = fxCheckArrayBufferDetached(the, buffer, XS_IMMUTABLE);
 			(*dispatch->value.typedArray.dispatch->getter)(the, data, view->value.dataView.offset + delta * index, slot, EndianNative);
 			slot->flag = XS_DONT_DELETE_FLAG;
 			return 1;
@@ -892,7 +906,7 @@ txBoolean fxTypedArrayGetPropertyValue(txMachine* the, txSlot* instance, txID id
 		txSlot* dispatch = instance->next;
 		txSlot* view = dispatch->next;
 		txSlot* buffer = view->next;
-		txSlot* data = fxCheckArrayBufferDetached(the, buffer);
+		txSlot* data = fxCheckArrayBufferDetached(the, buffer, XS_IMMUTABLE);
 		txInteger delta = dispatch->value.typedArray.dispatch->size;
 		txIndex length = view->value.dataView.size / delta;
 		if (index < length) {
@@ -913,7 +927,7 @@ txBoolean fxTypedArrayHasProperty(txMachine* the, txSlot* instance, txID id, txI
 		txSlot* buffer = view->next;
 		txInteger delta = dispatch->value.typedArray.dispatch->size;
 		txIndex length = view->value.dataView.size / delta;
-		fxCheckArrayBufferDetached(the, buffer);
+		fxCheckArrayBufferDetached(the, buffer, XS_IMMUTABLE);
 		return (index < length) ? 1 : 0;
 	}
 	return fxOrdinaryHasProperty(the, instance, id, index);
@@ -929,7 +943,7 @@ void fxTypedArrayOwnKeys(txMachine* the, txSlot* instance, txFlag flag, txSlot*
 		txIndex length = view->value.dataView.size / delta;
 		if (length) {
 			txIndex index;
-			fxCheckArrayBufferDetached(the, buffer);
+			fxCheckArrayBufferDetached(the, buffer, XS_IMMUTABLE);
 			for (index = 0; index < length; index++)
 				keys = fxQueueKey(the, 0, index, keys);
 		}
@@ -956,7 +970,7 @@ txBoolean fxTypedArraySetPropertyValue(txMachine* the, txSlot* instance, txID id
 		txInteger delta = dispatch->value.typedArray.dispatch->size;
 		txIndex length = view->value.dataView.size / delta;
 		fxToNumber(the, value);
-		data = fxCheckArrayBufferDetached(the, buffer);
+		data = fxCheckArrayBufferDetached(the, buffer, XS_MUTABLE);
 		if (index < length) {
 			(*dispatch->value.typedArray.dispatch->setter)(the, data, view->value.dataView.offset + delta * index, value, EndianNative);
 			return 1;
@@ -1075,7 +1089,7 @@ txSlot* fxGetTypedArrayValue(txMachine* the, txSlot* instance, txInteger index)
 	txSlot* dispatch = instance->next;
 	txSlot* view = dispatch->next;
 	txSlot* buffer = view->next;
-	txSlot* data = mxIsReference(buffer) ? fxCheckArrayBufferDetached(the, buffer) : C_NULL;
+	txSlot* data = mxIsReference(buffer) ? fxCheckArrayBufferDetached(the, buffer, XS_IMMUTABLE) : C_NULL;
 	txInteger delta = dispatch->value.typedArray.dispatch->size;
 	index *= delta;
 	if ((0 <= index) && ((index + delta) <= view->value.dataView.size)) {
@@ -1132,7 +1146,7 @@ txSlot* fxSetTypedArrayValue(txMachine* the, txSlot* instance, txInteger index)
 	txInteger delta = dispatch->value.typedArray.dispatch->size;
 	index *= delta;
 	fxToNumber(the, the->stack);
-	data = fxCheckArrayBufferDetached(the, buffer);
+	data = fxCheckArrayBufferDetached(the, buffer, XS_MUTABLE);
 	if ((0 <= index) && ((index + delta) <= view->value.dataView.size))
 		(*dispatch->value.typedArray.dispatch->setter)(the, data, view->value.dataView.offset + index, the->stack, EndianNative);
 	the->scratch.kind = XS_UNDEFINED_KIND;
@@ -1158,7 +1172,7 @@ void fx_TypedArray(txMachine* the)
 			if (offset % delta)
 				mxRangeError("invalid byteOffset %ld", offset);
 			size = (txInteger)fxArgToByteOffset(the, 2, -1);
-			fxCheckArrayBufferDetached(the, mxArgv(0));
+			fxCheckArrayBufferDetached(the, mxArgv(0), XS_IMMUTABLE);
 			limit = slot->value.arrayBuffer.length;
 			if (size >= 0) {
 				size *= delta;
@@ -1181,7 +1195,7 @@ void fx_TypedArray(txMachine* the)
 			txSlot* arrayDispatch = slot;
 			txSlot* arrayView = arrayDispatch->next;
 			txSlot* arrayBuffer = arrayView->next;
-			txSlot* arrayData = fxCheckArrayBufferDetached(the, arrayBuffer);
+			txSlot* arrayData = fxCheckArrayBufferDetached(the, arrayBuffer, XS_IMMUTABLE);
 			txInteger arrayDelta = arrayDispatch->value.typedArray.dispatch->size;
 			txInteger arrayLength = arrayView->value.dataView.size / arrayDelta;
 			txInteger arrayOffset = arrayView->value.dataView.offset;
@@ -1206,7 +1220,7 @@ void fx_TypedArray(txMachine* the)
 			mxPushUndefined();	
 			fxRunID(the, C_NULL, XS_NO_ID);
 			mxPullSlot(buffer);
-			data = fxCheckArrayBufferDetached(the, buffer);
+			data = fxCheckArrayBufferDetached(the, buffer, XS_MUTABLE);
 			view->value.dataView.offset = offset;
 			view->value.dataView.size = size;
 			if (dispatch == arrayDispatch)
@@ -1345,7 +1359,7 @@ void fx_TypedArray_from_object(txMachine* the, txSlot* instance, txSlot* functio
 		mxPush(mxGlobal);
 		fxNewID(the, mxID(_ArrayBuffer));
 		mxPullSlot(buffer);
-		data = fxCheckArrayBufferDetached(the, buffer);
+		data = fxCheckArrayBufferDetached(the, buffer, XS_MUTABLE);
 		view->value.dataView.offset = 0;
 		view->value.dataView.size = data->value.arrayBuffer.length;
 	}
@@ -1360,7 +1374,7 @@ void fx_TypedArray_from_object(txMachine* the, txSlot* instance, txSlot* functio
 			dispatch = instance->next;
 			view = dispatch->next;
 			buffer = view->next;
-			data = fxCheckArrayBufferDetached(the, buffer);
+			data = fxCheckArrayBufferDetached(the, buffer, XS_MUTABLE);
 			delta = dispatch->value.typedArray.dispatch->size;
 			if (view->value.dataView.size < length * delta)
 				mxTypeError("too small TypedArray");
@@ -1460,7 +1474,7 @@ void fx_TypedArray_prototype_byteLength_get(txMachine* the)
 	txSlot* view = dispatch->next;
 	txSlot* buffer = view->next;
 	mxResult->kind = XS_INTEGER_KIND;
-	mxResult->value.integer = (buffer->value.reference->next->value.arrayBuffer.address == C_NULL) ? 0 : view->value.dataView.size;
+	mxResult->value.integer = (mxAliasInstance(buffer->value.reference)->next->value.arrayBuffer.address == C_NULL) ? 0 : view->value.dataView.size;
 }
 
 void fx_TypedArray_prototype_byteOffset_get(txMachine* the)
@@ -1470,12 +1484,12 @@ void fx_TypedArray_prototype_byteOffset_get(txMachine* the)
 	txSlot* view = dispatch->next;
 	txSlot* buffer = view->next;
 	mxResult->kind = XS_INTEGER_KIND;
-	mxResult->value.integer = (buffer->value.reference->next->value.arrayBuffer.address == C_NULL) ? 0 : view->value.dataView.offset;
+	mxResult->value.integer = (mxAliasInstance(buffer->value.reference)->next->value.arrayBuffer.address == C_NULL) ? 0 : view->value.dataView.offset;
 }
 
 void fx_TypedArray_prototype_copyWithin(txMachine* the)
 {
-	mxTypedArrayDeclarations;
+	mxMutableTypedArrayDeclarations;
 	txByte* address = data->value.arrayBuffer.address + view->value.dataView.offset;
 	txInteger target = (txInteger)fxArgToIndex(the, 0, 0, length);
 	txInteger start = (txInteger)fxArgToIndex(the, 1, 0, length);
@@ -1493,7 +1507,7 @@ void fx_TypedArray_prototype_entries(txMachine* the)
 {
 	txSlot* instance = fxCheckTypedArrayInstance(the, mxThis);
 	txSlot* property;
-	fxCheckArrayBufferDetached(the, instance->next->next->next);
+	fxCheckArrayBufferDetached(the, instance->next->next->next, XS_IMMUTABLE);
 	mxPush(mxArrayIteratorPrototype);
 	property = fxLastProperty(the, fxNewIteratorInstance(the, mxThis));
 	property = fxNextIntegerProperty(the, property, 2, XS_NO_ID, XS_INTERNAL_FLAG | XS_GET_ONLY);
@@ -1518,7 +1532,7 @@ void fx_TypedArray_prototype_every(txMachine* the)
 
 void fx_TypedArray_prototype_fill(txMachine* the)
 {
-	mxTypedArrayDeclarations;
+	mxMutableTypedArrayDeclarations;
 	txInteger start = (txInteger)fxArgToIndex(the, 1, 0, length);
 	txInteger end = (txInteger)fxArgToIndex(the, 2, length, length);
 	start *= delta;
@@ -1674,7 +1688,7 @@ void fx_TypedArray_prototype_join(txMachine* the)
 	txSlot* dispatch = instance->next;
 	txSlot* view = dispatch->next;
 	txSlot* buffer = view->next;
-	txSlot* data = fxCheckArrayBufferDetached(the, buffer);
+	txSlot* data = fxCheckArrayBufferDetached(the, buffer, XS_IMMUTABLE);
 	txInteger delta = dispatch->value.typedArray.dispatch->size;
 	txInteger offset = view->value.dataView.offset;
 	txInteger limit = offset + view->value.dataView.size;
@@ -1728,7 +1742,7 @@ void fx_TypedArray_prototype_keys(txMachine* the)
 {
 	txSlot* instance = fxCheckTypedArrayInstance(the, mxThis);
 	txSlot* property;
-	fxCheckArrayBufferDetached(the, instance->next->next->next);
+	fxCheckArrayBufferDetached(the, instance->next->next->next, XS_IMMUTABLE);
 	mxPush(mxArrayIteratorPrototype);
 	property = fxLastProperty(the, fxNewIteratorInstance(the, mxThis));
 	property = fxNextIntegerProperty(the, property, 1, XS_NO_ID, XS_INTERNAL_FLAG | XS_GET_ONLY);
@@ -1765,7 +1779,7 @@ void fx_TypedArray_prototype_length_get(txMachine* the)
 	txSlot* view = dispatch->next;
 	txSlot* buffer = view->next;
 	mxResult->kind = XS_INTEGER_KIND;
-	mxResult->value.integer = (buffer->value.reference->next->value.arrayBuffer.address == C_NULL) ? 0 : view->value.dataView.size / dispatch->value.typedArray.dispatch->size;
+	mxResult->value.integer = (mxAliasInstance(buffer->value.reference)->next->value.arrayBuffer.address == C_NULL) ? 0 : view->value.dataView.size / dispatch->value.typedArray.dispatch->size;
 }
 
 void fx_TypedArray_prototype_map(txMachine* the)
@@ -1833,7 +1847,7 @@ void fx_TypedArray_prototype_reduceRight(txMachine* the)
 
 void fx_TypedArray_prototype_reverse(txMachine* the)
 {
-	mxTypedArrayDeclarations;
+	mxMutableTypedArrayDeclarations;
 	if (length) {
 		txByte buffer;
 		txByte* first = data->value.arrayBuffer.address + view->value.dataView.offset;
@@ -1855,7 +1869,7 @@ void fx_TypedArray_prototype_reverse(txMachine* the)
 
 void fx_TypedArray_prototype_set(txMachine* the)
 {
-	mxTypedArrayDeclarations;
+	mxMutableTypedArrayDeclarations;
 	txSlot* array = fxArgToInstance(the, 0);
 	txInteger target = (txInteger)fxArgToByteOffset(the, 1, 0);
 	txInteger offset = view->value.dataView.offset + (target * delta);	
@@ -1970,7 +1984,7 @@ void fx_TypedArray_prototype_some(txMachine* the)
 
 void fx_TypedArray_prototype_sort(txMachine* the)
 {
-	mxTypedArrayDeclarations;
+	mxMutableTypedArrayDeclarations;
 	txSlot* function = C_NULL;
 	if (mxArgc > 0) {
 		txSlot* slot = mxArgv(0);
@@ -2093,7 +2107,7 @@ void fx_TypedArray_prototype_subarray(txMachine* the)
 	txInteger stop = (txInteger)fxArgToIndex(the, 1, length, length);
 	if (stop < start) 
 		stop = start;
-	fxCheckArrayBufferDetached(the, buffer);
+	fxCheckArrayBufferDetached(the, buffer, XS_IMMUTABLE);
 	mxPushSlot(buffer);
 	mxPushInteger(view->value.dataView.offset + (start * delta));
 	mxPushInteger(stop - start);
@@ -2174,7 +2188,7 @@ void fx_TypedArray_prototype_values(txMachine* the)
 {
 	txSlot* instance = fxCheckTypedArrayInstance(the, mxThis);
 	txSlot* property;
-	fxCheckArrayBufferDetached(the, instance->next->next->next);
+	fxCheckArrayBufferDetached(the, instance->next->next->next, XS_IMMUTABLE);
 	mxPush(mxArrayIteratorPrototype);
 	property = fxLastProperty(the, fxNewIteratorInstance(the, mxThis));
 	property = fxNextIntegerProperty(the, property, 0, XS_NO_ID, XS_INTERNAL_FLAG | XS_GET_ONLY);
@@ -56,7 +56,7 @@ static txInteger fx_Date_parse_fraction(txByte* theCharacter, txString* theStrin
 static txBoolean fx_Date_prototype_get_aux(txMachine* the, txDateTime* td, txBoolean utc, txSlot* slot);
 static void fx_Date_prototype_set_aux(txMachine* the, txDateTime* td, txBoolean utc, txSlot* slot);
 
-static txSlot* fxDateCheck(txMachine* the);
+static txSlot* fxDateCheck(txMachine* the, txBoolean mutable);
 static txNumber fxDateClip(txNumber value);
 static txNumber fxDateFullYear(txMachine* the, txSlot* slot);
 static txNumber fxDateMerge(txDateTime* dt, txBoolean utc);
@@ -584,7 +584,7 @@ void fx_Date_prototype_set_aux(txMachine* the, txDateTime* dt, txBoolean utc, tx
 void fx_Date_prototype_getMilliseconds(txMachine* the)
 {
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_IMMUTABLE);
 	if (fx_Date_prototype_get_aux(the, &dt, 0, slot)) {
 		mxResult->value.integer = (txInteger)dt.milliseconds;
 		mxResult->kind = XS_INTEGER_KIND;
@@ -594,7 +594,7 @@ void fx_Date_prototype_getMilliseconds(txMachine* the)
 void fx_Date_prototype_getSeconds(txMachine* the)
 {
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_IMMUTABLE);
 	if (fx_Date_prototype_get_aux(the, &dt, 0, slot)) {
 		mxResult->value.integer = (txInteger)dt.seconds;
 		mxResult->kind = XS_INTEGER_KIND;
@@ -604,7 +604,7 @@ void fx_Date_prototype_getSeconds(txMachine* the)
 void fx_Date_prototype_getMinutes(txMachine* the)
 {
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_IMMUTABLE);
 	if (fx_Date_prototype_get_aux(the, &dt, 0, slot)) {
 		mxResult->value.integer = (txInteger)dt.minutes;
 		mxResult->kind = XS_INTEGER_KIND;
@@ -614,7 +614,7 @@ void fx_Date_prototype_getMinutes(txMachine* the)
 void fx_Date_prototype_getHours(txMachine* the)
 {
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_IMMUTABLE);
 	if (fx_Date_prototype_get_aux(the, &dt, 0, slot)) {
 		mxResult->value.integer = (txInteger)dt.hours;
 		mxResult->kind = XS_INTEGER_KIND;
@@ -624,7 +624,7 @@ void fx_Date_prototype_getHours(txMachine* the)
 void fx_Date_prototype_getDay(txMachine* the)
 {
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_IMMUTABLE);
 	if (fx_Date_prototype_get_aux(the, &dt, 0, slot)) {
 		mxResult->value.integer = dt.day;
 		mxResult->kind = XS_INTEGER_KIND;
@@ -634,7 +634,7 @@ void fx_Date_prototype_getDay(txMachine* the)
 void fx_Date_prototype_getDate(txMachine* the)
 {
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_IMMUTABLE);
 	if (fx_Date_prototype_get_aux(the, &dt, 0, slot)) {
 		mxResult->value.integer = (txInteger)dt.date;
 		mxResult->kind = XS_INTEGER_KIND;
@@ -644,7 +644,7 @@ void fx_Date_prototype_getDate(txMachine* the)
 void fx_Date_prototype_getMonth(txMachine* the)
 {
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_IMMUTABLE);
 	if (fx_Date_prototype_get_aux(the, &dt, 0, slot)) {
 		mxResult->value.integer = (txInteger)dt.month;
 		mxResult->kind = XS_INTEGER_KIND;
@@ -654,7 +654,7 @@ void fx_Date_prototype_getMonth(txMachine* the)
 void fx_Date_prototype_getYear(txMachine* the)
 {
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_IMMUTABLE);
 	if (fx_Date_prototype_get_aux(the, &dt, 0, slot)) {
 		mxResult->value.integer = (txInteger)dt.year - 1900;
 		mxResult->kind = XS_INTEGER_KIND;
@@ -664,7 +664,7 @@ void fx_Date_prototype_getYear(txMachine* the)
 void fx_Date_prototype_getFullYear(txMachine* the)
 {
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_IMMUTABLE);
 	if (fx_Date_prototype_get_aux(the, &dt, 0, slot)) {
 		mxResult->value.integer = (txInteger)dt.year;
 		mxResult->kind = XS_INTEGER_KIND;
@@ -674,7 +674,7 @@ void fx_Date_prototype_getFullYear(txMachine* the)
 void fx_Date_prototype_getUTCMilliseconds(txMachine* the)
 {
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_IMMUTABLE);
 	if (fx_Date_prototype_get_aux(the, &dt, 1, slot)) {
 		mxResult->value.integer = (txInteger)dt.milliseconds;
 		mxResult->kind = XS_INTEGER_KIND;
@@ -684,7 +684,7 @@ void fx_Date_prototype_getUTCMilliseconds(txMachine* the)
 void fx_Date_prototype_getUTCSeconds(txMachine* the)
 {
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_IMMUTABLE);
 	if (fx_Date_prototype_get_aux(the, &dt, 1, slot)) {
 		mxResult->value.integer = (txInteger)dt.seconds;
 		mxResult->kind = XS_INTEGER_KIND;
@@ -694,7 +694,7 @@ void fx_Date_prototype_getUTCSeconds(txMachine* the)
 void fx_Date_prototype_getUTCMinutes(txMachine* the)
 {
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_IMMUTABLE);
 	if (fx_Date_prototype_get_aux(the, &dt, 1, slot)) {
 		mxResult->value.integer = (txInteger)dt.minutes;
 		mxResult->kind = XS_INTEGER_KIND;
@@ -704,7 +704,7 @@ void fx_Date_prototype_getUTCMinutes(txMachine* the)
 void fx_Date_prototype_getUTCHours(txMachine* the)
 {
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_IMMUTABLE);
 	if (fx_Date_prototype_get_aux(the, &dt, 1, slot)) {
 		mxResult->value.integer = (txInteger)dt.hours;
 		mxResult->kind = XS_INTEGER_KIND;
@@ -714,7 +714,7 @@ void fx_Date_prototype_getUTCHours(txMachine* the)
 void fx_Date_prototype_getUTCDay(txMachine* the)
 {
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_IMMUTABLE);
 	if (fx_Date_prototype_get_aux(the, &dt, 1, slot)) {
 		mxResult->value.integer = dt.day;
 		mxResult->kind = XS_INTEGER_KIND;
@@ -724,7 +724,7 @@ void fx_Date_prototype_getUTCDay(txMachine* the)
 void fx_Date_prototype_getUTCDate(txMachine* the)
 {
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_IMMUTABLE);
 	if (fx_Date_prototype_get_aux(the, &dt, 1, slot)) {
 		mxResult->value.integer = (txInteger)dt.date;
 		mxResult->kind = XS_INTEGER_KIND;
@@ -734,7 +734,7 @@ void fx_Date_prototype_getUTCDate(txMachine* the)
 void fx_Date_prototype_getUTCMonth(txMachine* the)
 {
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_IMMUTABLE);
 	if (fx_Date_prototype_get_aux(the, &dt, 1, slot)) {
 		mxResult->value.integer = (txInteger)dt.month;
 		mxResult->kind = XS_INTEGER_KIND;
@@ -744,7 +744,7 @@ void fx_Date_prototype_getUTCMonth(txMachine* the)
 void fx_Date_prototype_getUTCFullYear(txMachine* the)
 {
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_IMMUTABLE);
 	if (fx_Date_prototype_get_aux(the, &dt, 1, slot)) {
 		mxResult->value.integer = (txInteger)dt.year;
 		mxResult->kind = XS_INTEGER_KIND;
@@ -754,7 +754,7 @@ void fx_Date_prototype_getUTCFullYear(txMachine* the)
 void fx_Date_prototype_getTimezoneOffset(txMachine* the)
 {
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_IMMUTABLE);
 	if (fx_Date_prototype_get_aux(the, &dt, 0, slot)) {
 		mxResult->value.integer = dt.offset;
 		mxResult->kind = XS_INTEGER_KIND;
@@ -765,7 +765,7 @@ void fx_Date_prototype_setMilliseconds(txMachine* the)
 {
 	txInteger c = mxArgc;
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_MUTABLE);
 	fx_Date_prototype_get_aux(the, &dt, 0, slot);
 	dt.milliseconds = (c > 0) ? fxToNumber(the, mxArgv(0)) : C_NAN;
 	fx_Date_prototype_set_aux(the, &dt, 0, slot);
@@ -775,7 +775,7 @@ void fx_Date_prototype_setSeconds(txMachine* the)
 {
 	txInteger c = mxArgc;
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_MUTABLE);
 	fx_Date_prototype_get_aux(the, &dt, 0, slot);
 	dt.seconds = (c > 0) ? fxToNumber(the, mxArgv(0)) : C_NAN;
 	if (c > 1) dt.milliseconds = fxToNumber(the, mxArgv(1));
@@ -786,7 +786,7 @@ void fx_Date_prototype_setMinutes(txMachine* the)
 {
 	txInteger c = mxArgc;
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_MUTABLE);
 	fx_Date_prototype_get_aux(the, &dt, 0, slot);
 	dt.minutes = (c > 0) ? fxToNumber(the, mxArgv(0)) : C_NAN;
 	if (c > 1) dt.seconds = fxToNumber(the, mxArgv(1));
@@ -798,7 +798,7 @@ void fx_Date_prototype_setHours(txMachine* the)
 {
 	txInteger c = mxArgc;
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_MUTABLE);
 	fx_Date_prototype_get_aux(the, &dt, 0, slot);
 	dt.hours = (c > 0) ? fxToNumber(the, mxArgv(0)) : C_NAN;
 	if (c > 1) dt.minutes = fxToNumber(the, mxArgv(1));
@@ -811,7 +811,7 @@ void fx_Date_prototype_setDate(txMachine* the)
 {
 	txInteger c = mxArgc;
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_MUTABLE);
 	fx_Date_prototype_get_aux(the, &dt, 0, slot);
 	dt.date = (c > 0) ? fxToNumber(the, mxArgv(0)) : C_NAN;
 	fx_Date_prototype_set_aux(the, &dt, 0, slot);
@@ -821,7 +821,7 @@ void fx_Date_prototype_setMonth(txMachine* the)
 {
 	txInteger c = mxArgc;
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_MUTABLE);
 	fx_Date_prototype_get_aux(the, &dt, 0, slot);
 	dt.month = (c > 0) ? fxToNumber(the, mxArgv(0)) : C_NAN;
 	if (c > 1) dt.date = fxToNumber(the, mxArgv(1));
@@ -832,7 +832,7 @@ void fx_Date_prototype_setYear(txMachine* the)
 {
 	txInteger c = mxArgc;
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_MUTABLE);
 	if (c_isnan(slot->value.number)) {
 		slot->value.number = 0;
 		fx_Date_prototype_get_aux(the, &dt, 1, slot);
@@ -849,7 +849,7 @@ void fx_Date_prototype_setFullYear(txMachine* the)
 {
 	txInteger c = mxArgc;
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_MUTABLE);
 	if (c_isnan(slot->value.number)) {
 		slot->value.number = 0;
 		fx_Date_prototype_get_aux(the, &dt, 1, slot);
@@ -864,7 +864,7 @@ void fx_Date_prototype_setFullYear(txMachine* the)
 
 void fx_Date_prototype_setTime(txMachine* the)
 {
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_MUTABLE);
 	if (!slot) mxTypeError("this is no date");
 	if (mxArgc < 1)
 		slot->value.number = C_NAN;
@@ -887,7 +887,7 @@ void fx_Date_prototype_setUTCMilliseconds(txMachine* the)
 {
 	txInteger c = mxArgc;
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_MUTABLE);
 	fx_Date_prototype_get_aux(the, &dt, 1, slot);
 	dt.milliseconds = (c > 0) ? fxToNumber(the, mxArgv(0)) : C_NAN;
 	fx_Date_prototype_set_aux(the, &dt, 1, slot);
@@ -897,7 +897,7 @@ void fx_Date_prototype_setUTCSeconds(txMachine* the)
 {
 	txInteger c = mxArgc;
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_MUTABLE);
 	fx_Date_prototype_get_aux(the, &dt, 1, slot);
 	dt.seconds = (c > 0) ? fxToNumber(the, mxArgv(0)) : C_NAN;
 	if (c > 1) dt.milliseconds = fxToNumber(the, mxArgv(1));
@@ -908,7 +908,7 @@ void fx_Date_prototype_setUTCMinutes(txMachine* the)
 {
 	txInteger c = mxArgc;
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_MUTABLE);
 	fx_Date_prototype_get_aux(the, &dt, 1, slot);
 	dt.minutes = (c > 0) ? fxToNumber(the, mxArgv(0)) : C_NAN;
 	if (c > 1) dt.seconds = fxToNumber(the, mxArgv(1));
@@ -920,7 +920,7 @@ void fx_Date_prototype_setUTCHours(txMachine* the)
 {
 	txInteger c = mxArgc;
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_MUTABLE);
 	fx_Date_prototype_get_aux(the, &dt, 1, slot);
 	dt.hours = (c > 0) ? fxToNumber(the, mxArgv(0)) : C_NAN;
 	if (c > 1) dt.minutes = fxToNumber(the, mxArgv(1));
@@ -933,7 +933,7 @@ void fx_Date_prototype_setUTCDate(txMachine* the)
 {
 	txInteger c = mxArgc;
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_MUTABLE);
 	fx_Date_prototype_get_aux(the, &dt, 1, slot);
 	dt.date = (c > 0) ? fxToNumber(the, mxArgv(0)) : C_NAN;
 	fx_Date_prototype_set_aux(the, &dt, 1, slot);
@@ -943,7 +943,7 @@ void fx_Date_prototype_setUTCMonth(txMachine* the)
 {
 	txInteger c = mxArgc;
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_MUTABLE);
 	fx_Date_prototype_get_aux(the, &dt, 1, slot);
 	dt.month = (c > 0) ? fxToNumber(the, mxArgv(0)) : C_NAN;
 	if (c > 1) dt.date = fxToNumber(the, mxArgv(1));
@@ -954,7 +954,7 @@ void fx_Date_prototype_setUTCFullYear(txMachine* the)
 {
 	txInteger c = mxArgc;
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_MUTABLE);
 	if (c_isnan(slot->value.number)) slot->value.number = 0;
 	fx_Date_prototype_get_aux(the, &dt, 1, slot);
 	dt.year = (c > 0) ? fxToNumber(the, mxArgv(0)) : C_NAN;
@@ -967,7 +967,7 @@ void fx_Date_prototype_toDateString(txMachine* the)
 {
 	char buffer[256];
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_IMMUTABLE);
 	if (fx_Date_prototype_get_aux(the, &dt, 0, slot)) {
 		txString p = buffer;
 		p = fxDatePrintDay(p, dt.day);
@@ -984,7 +984,7 @@ void fx_Date_prototype_toISOString(txMachine* the)
 {
 	char buffer[256];
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_IMMUTABLE);
 	if (fx_Date_prototype_get_aux(the, &dt, 1, slot)) {
 		txString p = buffer;
 		p = fxDatePrint4Digits(p, (txInteger)dt.year);
@@ -1079,7 +1079,7 @@ void fx_Date_prototype_toString(txMachine* the)
 {
 	char buffer[256];
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_IMMUTABLE);
 	if (fx_Date_prototype_get_aux(the, &dt, 0, slot)) {
 		txString p = buffer;
 		p = fxDatePrintDay(p, dt.day);
@@ -1100,7 +1100,7 @@ void fx_Date_prototype_toTimeString(txMachine* the)
 {
 	char buffer[256];
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_IMMUTABLE);
 	if (fx_Date_prototype_get_aux(the, &dt, 0, slot)) {
 		txString p = buffer;
 		p = fxDatePrintTime(p, (txInteger)dt.hours, (txInteger)dt.minutes, (txInteger)dt.seconds);
@@ -1117,7 +1117,7 @@ void fx_Date_prototype_toUTCString(txMachine* the)
 {
 	char buffer[256];
 	txDateTime dt;
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_IMMUTABLE);
 	if (fx_Date_prototype_get_aux(the, &dt, 1, slot)) {
 		txString p = buffer;
 		p = fxDatePrintDay(p, dt.day);
@@ -1139,7 +1139,7 @@ void fx_Date_prototype_toUTCString(txMachine* the)
 
 void fx_Date_prototype_valueOf(txMachine* the)
 {
-	txSlot* slot = fxDateCheck(the);
+	txSlot* slot = fxDateCheck(the, XS_IMMUTABLE);
 	mxResult->kind = XS_NUMBER_KIND;
 	mxResult->value = slot->value;
 }
@@ -1177,14 +1177,17 @@ static const txInteger gxSimilarLeapYears[7] ICACHE_XS6RO2_ATTR = {
 	(((YEAR) % 4) ? 0 : ((YEAR) % 100) ? 1 : ((YEAR) % 400) ? 0 : 1)
 #define mxYearsOffset 400000
 
-txSlot* fxDateCheck(txMachine* the)
+txSlot* fxDateCheck(txMachine* the, txBoolean mutable)
 {
 	txSlot* it = mxThis;
 	if (it->kind == XS_REFERENCE_KIND) {
 		txSlot* instance = it->value.reference;
 		it = instance->next;
-		if ((it) && (it->flag & XS_INTERNAL_FLAG) && (it->kind == XS_DATE_KIND))
+		if ((it) && (it->flag & XS_INTERNAL_FLAG) && (it->kind == XS_DATE_KIND)) {
+			if (instance->ID >= 0)
+				it = ((mutable) ? fxAliasInstance(the, instance) : mxAliasInstance(instance))->next;
 			return it;
+		}
 	}
 	mxTypeError("this is no date");
 	return C_NULL;
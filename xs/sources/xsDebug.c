@@ -118,6 +118,7 @@ enum {
 	XS_CLEAR_BREAKPOINTS_TAG,
 	XS_GO_TAG,
 	XS_LOGOUT_TAG,
+	XS_REPORT_ALLOCATIONS_TAG,
 	XS_SET_BREAKPOINT_TAG,
 	XS_SET_ALL_BREAKPOINTS_TAG,
 	XS_SELECT_TAG,
@@ -487,6 +488,8 @@ void fxDebugParseTag(txMachine* the, txString name)
 		the->debugTag = XS_GO_TAG;
 	else if (!c_strcmp(name, "logout"))
 		the->debugTag = XS_LOGOUT_TAG;
+	else if (!c_strcmp(name, "report-allocations"))
+		the->debugTag = XS_REPORT_ALLOCATIONS_TAG;
 	else if (!c_strcmp(name, "select"))
 		the->debugTag = XS_SELECT_TAG;
 	else if (!c_strcmp(name, "set-all-breakpoints"))
@@ -525,6 +528,9 @@ void fxDebugPopTag(txMachine* the)
 	case XS_LOGOUT_TAG:
 		the->debugExit |= 2;
 		break;
+	case XS_REPORT_ALLOCATIONS_TAG:
+		the->debugExit |= 1;
+		break;
 	case XS_SELECT_TAG:
 		break;
 	case XS_SET_ALL_BREAKPOINTS_TAG:
@@ -571,6 +577,16 @@ void fxDebugPushTag(txMachine* the)
 		fxLogout(the);
 		fxGo(the);
 		break;
+	case XS_REPORT_ALLOCATIONS_TAG:
+	#ifdef mxInstrument
+		if (the->allocationSites)
+			fxReportAllocations(the, 20);
+		else {
+			fxStartAllocationSampling(the, 0);
+			fxReport(the, "# Allocations: sampling every %ld bytes\n", (long)the->allocationInterval);
+		}
+	#endif
+		break;
 	case XS_SELECT_TAG:
 		fxSelect(the, (txSlot*)the->idValue);
 		fxEchoStart(the);
@@ -768,9 +784,9 @@ void fxEchoInstance(txMachine* the, txSlot* theInstance, txInspectorNameList* th
 	txSlot* aProperty;
 	txSlot* aSlot;
 	txInteger anIndex;
-	txSlot* aliasInstance;
-	txSlot* aliasProperty;
 
+	if (theInstance->ID >= 0)
+		theInstance = mxAliasInstance(theInstance);
 	aParent = theInstance->value.instance.prototype;
 	if (aParent)
 		fxEchoPropertyInstance(the, theList, "(..)", -1, C_NULL, XS_NO_ID, theInstance->flag & XS_MARK_FLAG, aParent);
@@ -881,41 +897,32 @@ void fxEchoInstance(txMachine* the, txSlot* theInstance, txInspectorNameList* th
 			break;
 		}
 	}
-	aliasInstance = (theInstance->ID >= 0) ? the->aliasArray[theInstance->ID] : C_NULL;
 	while (aProperty) {
 		if (aProperty->ID < -1) {
-			aliasProperty = NULL;
-			if (aliasInstance) {
-				aliasProperty = aliasInstance->next;
-				while (aliasProperty) {
-					if (aliasProperty->ID == aProperty->ID)
-						break;
-					aliasProperty = aliasProperty->next;
-				}
-			}
-			if (!aliasProperty)
-				fxEchoProperty(the, aProperty, theList, C_NULL, -1, C_NULL);
+			fxEchoProperty(the, aProperty, theList, C_NULL, -1, C_NULL);
 		}
 		else {
 			if (aProperty->kind == XS_ARRAY_KIND) {
 				txSlot* item = aProperty->value.array.address;
 				txIndex c = fxGetIndexSize(the, aProperty), i;
 				for (i = 0; i < c; i++) {
-					txIndex index = *((txIndex*)item);
+					txIndex index = (c == aProperty->value.array.length) ? i : *((txIndex*)item);
 					fxEchoProperty(the, item, theList, "[", index, "]");
 					item++;
 				}
 			}
+			else if (mxIsPackedArray(aProperty)) {
+				txSlot item;
+				txIndex c = aProperty->value.array.length, i;
+				c_memset(&item, 0, sizeof(txSlot));
+				for (i = 0; i < c; i++) {
+					fxGetPackedItem(the, aProperty, i, &item);
+					fxEchoProperty(the, &item, theList, "[", i, "]");
+				}
+			}
 		}
 		aProperty = aProperty->next;
 	}
-	if (aliasInstance) {
-		aliasProperty = aliasInstance->next;
-		while (aliasProperty) {
-			fxEchoProperty(the, aliasProperty, theList, C_NULL, -1, C_NULL);
-			aliasProperty = aliasProperty->next;
-		}
-	}
 }
 
 void fxEchoModule(txMachine* the, txSlot* module, txInspectorNameList* list)
@@ -970,7 +977,7 @@ void fxEchoProperty(txMachine* the, txSlot* theProperty, txInspectorNameList* th
 	char buffer[256];
 	txString name;
 	if ((theProperty->kind == XS_CLOSURE_KIND) || (theProperty->kind == XS_EXPORT_KIND))
-		theProperty = theProperty->value.closure;
+		theProperty = mxAliasClosure(theProperty->value.closure);
 	if (theProperty->kind == XS_REFERENCE_KIND) {
  		instance = fxGetInstance(the, theProperty);
 		if (instance)
@@ -1023,6 +1030,8 @@ void fxEchoProperty(txMachine* the, txSlot* theProperty, txInspectorNameList* th
 			break;
 	#endif
 		case XS_ARRAY_KIND:
+		case XS_PACKED_INTEGER_KIND:
+		case XS_PACKED_NUMBER_KIND:
 			fxEcho(the, " value=\"");
 			fxEchoInteger(the, theProperty->value.array.length);
 			fxEcho(the, " items\"/>");
@@ -1800,7 +1809,7 @@ void fxVReportWarning(void* console, txString thePath, txInteger theLine, txStri
 }
 
 #ifdef mxInstrument	
-#define xsInstrumentCount 9
+#define xsInstrumentCount 10
 static char* xsInstrumentNames[xsInstrumentCount] ICACHE_XS6STRING_ATTR = {
 	"Chunk used",
 	"Chunk available",
@@ -1811,6 +1820,7 @@ static char* xsInstrumentNames[xsInstrumentCount] ICACHE_XS6STRING_ATTR = {
 	"Garbage collections",
 	"Keys used",
 	"Modules loaded",
+	"Stack peak",
 };
 static char* xsInstrumentUnits[xsInstrumentCount] ICACHE_XS6STRING_ATTR = {
 	" / ",
@@ -1822,6 +1832,7 @@ static char* xsInstrumentUnits[xsInstrumentCount] ICACHE_XS6STRING_ATTR = {
 	" times",
 	" keys",
 	" modules",
+	" bytes",
 };
 
 void fxDescribeInstrumentation(txMachine* the, txInteger count, txString* names, txString* units)
@@ -1875,6 +1886,9 @@ void fxSampleInstrumentation(txMachine* the, txInteger count, txInteger* values)
 	xsInstrumentValues[6] = the->garbageCollectionCount;
 	xsInstrumentValues[7] = the->keyIndex - the->keyOffset;
 	xsInstrumentValues[8] = the->loadedModulesCount;
+	if (the->peakStackCount < (the->stackTop - the->stackPeak))
+		the->peakStackCount = (txSize)(the->stackTop - the->stackPeak);
+	xsInstrumentValues[9] = the->peakStackCount * sizeof(txSlot);
 
 	txInteger i;
 #ifdef mxDebug
@@ -623,17 +623,7 @@ void fxRunAwait(txMachine* the, txSlot* instance)
 	txSlot* value = the->stack;
 	
 	fxBeginHost(the);
-	mxPushSlot(value);
-	mxPushInteger(1);
-	mxPush(mxPromiseConstructor);
-	fxCallID(the, mxID(_resolve));
-	mxPullSlot(value);
-	mxPushSlot(resolveAwaitFunction);
-	mxPushSlot(rejectAwaitFunction);
-	mxPushInteger(2);
-	mxPushSlot(value);
-	fxCallID(the, mxID(_then));
-	mxPop();
+	fxAwaitPromise(the, value, resolveAwaitFunction->value.reference, rejectAwaitFunction->value.reference);
 	fxEndHost(the);
 }
 
@@ -140,12 +140,25 @@ void fx_Generator(txMachine* the)
 void fx_Generator_prototype_aux(txMachine* the, txFlag status)
 {
 	txSlot* generator = fxCheckGeneratorInstance(the, mxThis);
-	txSlot* slot = generator->next->next;
-	txSlot* result = slot->value.reference;
-	txSlot* value = result->next;
-	txSlot* done = value->next;
-	txSlot* state = slot->next;
-	
+	txSlot* slot;
+	txSlot* result;
+	txSlot* value;
+	txSlot* done;
+	txSlot* state;
+
+	if (generator->ID >= 0) {
+		/* resuming writes the stack, the state and the result of the generator */
+		generator = fxAliasInstance(the, generator);
+		slot = generator->next->next;
+		if (slot->value.reference->ID >= 0)
+			slot->value.reference = fxAliasInstance(the, slot->value.reference);
+	}
+	slot = generator->next->next;
+	result = slot->value.reference;
+	value = result->next;
+	done = value->next;
+	state = slot->next;
+
 	if (state->value.integer > 0)
 		mxTypeError("generator is running");
 	
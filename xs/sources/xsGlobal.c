@@ -365,17 +365,19 @@ void fx_Enumerator(txMachine* the)
 	result = the->stack;
 	for (;;) {
 		txSlot* at = fxNewInstance(the);
+		txSlot* last = item;
 		mxBehaviorOwnKeys(the, instance, XS_EACH_NAME_FLAG, at);
 		address = &at->next;
 		while ((at = *address)) {
 			if (mxBehaviorGetOwnProperty(the, instance, at->value.at.id, at->value.at.index, result)) {
+				txSlot* limit = last->next;
 				slot = list->next;
-				while ((slot)) {
+				while (slot != limit) {
 					if ((at->value.at.id == slot->value.at.id) && (at->value.at.index == slot->value.at.index))
 						break;
 					slot = slot->next;
 				}
-				if (slot)
+				if (slot != limit)
 					address = &(at->next);
 				else {
 					*address = at->next;
@@ -440,7 +442,7 @@ txSlot* fxEnvironmentGetProperty(txMachine* the, txSlot* instance, txID id, txIn
 		txSlot* result = instance->next->next;
 		while (result) {
 			if (result->ID == id)
-				return result->value.closure;
+				return mxAliasClosure(result->value.closure);
 			result = result->next;
 		}
 	}
@@ -453,7 +455,7 @@ txSlot* fxEnvironmentSetProperty(txMachine* the, txSlot* instance, txID id, txIn
 		txSlot* result = instance->next->next;
 		while (result) {
 			if (result->ID == id)
-				return result->value.closure;
+				return fxAliasClosure(the, result->value.closure);
 			result = result->next;
 		}
 	}
@@ -65,6 +65,27 @@ typedef struct {
 	txInteger line;
 } txJSONParser;
 
+#ifndef mxJSONBufferPoolSize
+	#define mxJSONBufferPoolSize 4096
+#endif
+#define mxJSONNameCacheLength 32
+
+#define mxJSONSafeByte(BYTE) (((BYTE) >= 32) && ((BYTE) < 127) && ((BYTE) != 34) && ((BYTE) != 92))
+#define mxJSONHasZeroByte(WORD) (((WORD) - 0x01010101) & ~(WORD) & 0x80808080)
+#define mxJSONUnsafeWord(WORD) ((((WORD) - 0x20202020) & ~(WORD) & 0x80808080) | ((WORD) & 0x80808080) | mxJSONHasZeroByte((WORD) ^ 0x22222222) | mxJSONHasZeroByte((WORD) ^ 0x5C5C5C5C) | mxJSONHasZeroByte((WORD) ^ 0x7F7F7F7F))
+
+typedef struct {
+	txID id;
+	txSize offset;
+	txSize size;
+} txJSONName;
+
+typedef struct sxJSONLevel txJSONLevel;
+struct sxJSONLevel {
+	txJSONLevel* previous;
+	txSlot* instance;
+};
+
 typedef struct {
 	txString buffer;
 	char indent[16];
@@ -74,6 +95,8 @@ typedef struct {
 	txSlot* replacer;
 	txSlot* keys;
 	txSlot* stack;
+	txJSONLevel* levels;
+	txJSONName names[mxJSONNameCacheLength];
 } txJSONStringifier;
 
 static void fxParseJSON(txMachine* the, txJSONParser* theParser);
@@ -88,9 +111,11 @@ static void fxStringifyJSONChar(txMachine* the, txJSONStringifier* theStringifie
 static void fxStringifyJSONChars(txMachine* the, txJSONStringifier* theStringifier, char* s);
 static void fxStringifyJSONIndent(txMachine* the, txJSONStringifier* theStringifier);
 static void fxStringifyJSONInteger(txMachine* the, txJSONStringifier* theStringifier, txInteger theInteger);
-static void fxStringifyJSONName(txMachine* the, txJSONStringifier* theStringifier, txInteger* theFlag);
+static void fxStringifyJSONName(txMachine* the, txJSONStringifier* theStringifier, txID theID, txInteger* theFlag);
 static void fxStringifyJSONNumber(txMachine* the, txJSONStringifier* theStringifier, txNumber theNumber);
-static void fxStringifyJSONProperty(txMachine* the, txJSONStringifier* theStringifier, txInteger* theFlag);
+static void fxStringifyJSONProperty(txMachine* the, txJSONStringifier* theStringifier, txID theID, txInteger* theFlag);
+static void fxStringifyJSONRelease(txMachine* the, txJSONStringifier* theStringifier);
+static txString fxStringifyJSONReserve(txMachine* the, txJSONStringifier* theStringifier, txSize theSize);
 static void fxStringifyJSONString(txMachine* the, txJSONStringifier* theStringifier, txString theString);
 static void fxStringifyJSONUnicodeEscape(txMachine* the, txJSONStringifier* theStringifier, txInteger character);
 
@@ -103,6 +128,7 @@ void fxBuildJSON(txMachine* the)
 	slot = fxLastProperty(the, fxNewObjectInstance(the));
 	slot = fxNextHostFunctionProperty(the, slot, mxCallback(fx_JSON_parse), 2, mxID(_parse), XS_DONT_ENUM_FLAG);
 	slot = fxNextHostFunctionProperty(the, slot, mxCallback(fx_JSON_stringify), 3, mxID(_stringify), XS_DONT_ENUM_FLAG);
+	slot = fxNextHostFunctionProperty(the, slot, mxCallback(fx_JSON_stringifyToArrayBuffer), 3, mxID(_stringifyToArrayBuffer), XS_DONT_ENUM_FLAG);
 	slot = fxNextStringXProperty(the, slot, "JSON", mxID(_Symbol_toStringTag), XS_DONT_ENUM_FLAG | XS_DONT_SET_FLAG);
 	slot = fxGlobalSetProperty(the, mxGlobal.value.reference, mxID(_JSON), XS_NO_ID, XS_OWN);
 	slot->flag = XS_DONT_ENUM_FLAG;
@@ -637,11 +663,27 @@ void fx_JSON_stringify(txMachine* the)
 			c_memcpy(mxResult->value.string, aStringifier.buffer, aStringifier.offset);
 			mxResult->kind = XS_STRING_KIND;
 		}
-		c_free(aStringifier.buffer);
+		fxStringifyJSONRelease(the, (txJSONStringifier*)&aStringifier);
+	}
+	mxCatch(the) {
+		fxStringifyJSONRelease(the, (txJSONStringifier*)&aStringifier);
+		fxJump(the);
+	}
+}
+
+void fx_JSON_stringifyToArrayBuffer(txMachine* the)
+{
+	volatile txJSONStringifier aStringifier;
+	mxTry(the) {
+		/* the bytes are built in the C buffer, so pointers into strings stay valid while the output grows */
+		c_memset((txJSONStringifier*)&aStringifier, 0, sizeof(aStringifier));
+		fxStringifyJSON(the, (txJSONStringifier*)&aStringifier);
+		if (aStringifier.offset)
+			fxArrayBuffer(the, mxResult, aStringifier.buffer, aStringifier.offset);
+		fxStringifyJSONRelease(the, (txJSONStringifier*)&aStringifier);
 	}
 	mxCatch(the) {
-		if (aStringifier.buffer)
-			c_free(aStringifier.buffer);
+		fxStringifyJSONRelease(the, (txJSONStringifier*)&aStringifier);
 		fxJump(the);
 	}
 }
@@ -653,10 +695,17 @@ void fxStringifyJSON(txMachine* the, txJSONStringifier* theStringifier)
 	
 	aSlot = fxGetInstance(the, mxThis);
 	theStringifier->offset = 0;
-	theStringifier->size = 1024;
-	theStringifier->buffer = c_malloc(1024);
-	if (!theStringifier->buffer)
-		mxUnknownError("out of memory");
+	if (the->stringifyBuffer) {
+		theStringifier->buffer = the->stringifyBuffer;
+		theStringifier->size = the->stringifySize;
+		the->stringifyBuffer = C_NULL;
+	}
+	else {
+		theStringifier->size = 1024;
+		theStringifier->buffer = c_malloc(1024);
+		if (!theStringifier->buffer)
+			mxUnknownError("out of memory");
+	}
 
 	if (mxArgc > 1) {
 		aSlot = mxArgv(1);
@@ -697,38 +746,22 @@ void fxStringifyJSON(txMachine* the, txJSONStringifier* theStringifier)
 	else
 		mxPushUndefined();
 	mxPush(mxEmptyString);
-	fxStringifyJSONProperty(the, theStringifier, &aFlag);
+	fxStringifyJSONProperty(the, theStringifier, XS_NO_ID, &aFlag);
 	the->stack++;
 }
 
 void fxStringifyJSONChar(txMachine* the, txJSONStringifier* theStringifier, char c)
 {
-    //fprintf(stderr, "%c", c);
-	if (theStringifier->offset == theStringifier->size) {
-		char* aBuffer;
-		theStringifier->size += 1024;
-		aBuffer = c_realloc(theStringifier->buffer, theStringifier->size);
-		if (!aBuffer)
-			mxUnknownError("out of memory");
-		theStringifier->buffer = aBuffer;
-	}
-	theStringifier->buffer[theStringifier->offset] = c;
+	txString p = fxStringifyJSONReserve(the, theStringifier, 1);
+	*p = c;
 	theStringifier->offset++;
 }
 
 void fxStringifyJSONChars(txMachine* the, txJSONStringifier* theStringifier, char* s)
 {
-    //fprintf(stderr, "%s", s);
 	txSize aSize = c_strlen(s);
-	if ((theStringifier->offset + aSize) >= theStringifier->size) {
-		char* aBuffer;
-		theStringifier->size += ((aSize / 1024) + 1) * 1024;
-		aBuffer = c_realloc(theStringifier->buffer, theStringifier->size);
-		if (!aBuffer)
-			mxUnknownError("out of memory");
-		theStringifier->buffer = aBuffer;
-	}
-	c_memcpy(theStringifier->buffer + theStringifier->offset, s, aSize);
+	txString p = fxStringifyJSONReserve(the, theStringifier, aSize);
+	c_memcpy(p, s, aSize);
 	theStringifier->offset += aSize;
 }
 
@@ -744,12 +777,24 @@ void fxStringifyJSONIndent(txMachine* the, txJSONStringifier* theStringifier)
 
 void fxStringifyJSONInteger(txMachine* the, txJSONStringifier* theStringifier, txInteger theInteger)
 {
-	char aBuffer[256];
-	fxIntegerToString(the->dtoa, theInteger, aBuffer, sizeof(aBuffer));
-	fxStringifyJSONChars(the, theStringifier, aBuffer);
+	char aBuffer[12];
+	txString q = aBuffer + sizeof(aBuffer);
+	txUnsigned value = (theInteger < 0) ? 0 - (txUnsigned)theInteger : (txUnsigned)theInteger;
+	txString p;
+	txSize aSize;
+	do {
+		*--q = (char)('0' + (value % 10));
+		value /= 10;
+	} while (value);
+	if (theInteger < 0)
+		*--q = '-';
+	aSize = (txSize)(aBuffer + sizeof(aBuffer) - q);
+	p = fxStringifyJSONReserve(the, theStringifier, aSize);
+	c_memcpy(p, q, aSize);
+	theStringifier->offset += aSize;
 }
 
-void fxStringifyJSONName(txMachine* the, txJSONStringifier* theStringifier, txInteger* theFlag)
+void fxStringifyJSONName(txMachine* the, txJSONStringifier* theStringifier, txID theID, txInteger* theFlag)
 {
 	txSlot* aSlot = the->stack;
 	if (*theFlag & 1) {
@@ -763,10 +808,28 @@ void fxStringifyJSONName(txMachine* the, txJSONStringifier* theStringifier, txIn
 			fxStringifyJSONChar(the, theStringifier, '"');
 			fxStringifyJSONInteger(the, theStringifier, aSlot->value.integer);
 			fxStringifyJSONChar(the, theStringifier, '"');
+			fxStringifyJSONChars(the, theStringifier, ":");
 		}
-		else
+		else if ((theID != XS_NO_ID) && theID) {
+			txJSONName* name = &theStringifier->names[theID & (mxJSONNameCacheLength - 1)];
+			if (name->id == theID) {
+				txString p = fxStringifyJSONReserve(the, theStringifier, name->size);
+				c_memcpy(p, p - theStringifier->offset + name->offset, name->size);
+				theStringifier->offset += name->size;
+			}
+			else {
+				txSize offset = theStringifier->offset;
+				fxStringifyJSONString(the, theStringifier, aSlot->value.string);
+				fxStringifyJSONChars(the, theStringifier, ":");
+				name->id = theID;
+				name->offset = offset;
+				name->size = theStringifier->offset - offset;
+			}
+		}
+		else {
 			fxStringifyJSONString(the, theStringifier, aSlot->value.string);
-		fxStringifyJSONChars(the, theStringifier, ":");
+			fxStringifyJSONChars(the, theStringifier, ":");
+		}
 	}
 	the->stack++; // POP KEY
 }
@@ -783,7 +846,8 @@ void fxStringifyJSONNumber(txMachine* the, txJSONStringifier* theStringifier, tx
 		fxStringifyJSONChars(the, theStringifier, "null");
 }
 
-void fxStringifyJSONProperty(txMachine* the, txJSONStringifier* theStringifier, txInteger* theFlag)
+void fxStringifyJSONProperty(txMachine* the, txJSONStringifier* theStringifier, txID theID, txInteger* theFlag)
+
 {
 	txSlot* aWrapper = the->stack + 2;
 	txSlot* aValue = the->stack + 1;
@@ -791,10 +855,19 @@ void fxStringifyJSONProperty(txMachine* the, txJSONStringifier* theStringifier,
 	txSlot* anInstance;
 	txInteger aFlag;
 	txIndex aLength, anIndex;
+	txJSONLevel aLevel;
 	
 	if (mxIsReference(aValue)) {
 		anInstance = fxGetInstance(the, aValue);
-		if (anInstance->flag & XS_LEVEL_FLAG)
+		if (anInstance->flag & XS_MARK_FLAG) {
+			txJSONLevel* level = theStringifier->levels;
+			while (level) {
+				if (level->instance == anInstance)
+					mxTypeError("cyclic value");
+				level = level->previous;
+			}
+		}
+		else if (anInstance->flag & XS_LEVEL_FLAG)
 			mxTypeError("cyclic value");
 		mxPushSlot(aKey);
 		/* COUNT */
@@ -829,24 +902,24 @@ void fxStringifyJSONProperty(txMachine* the, txJSONStringifier* theStringifier,
 again:
 	switch (aValue->kind) {
 	case XS_NULL_KIND:
-		fxStringifyJSONName(the, theStringifier, theFlag);
+		fxStringifyJSONName(the, theStringifier, theID, theFlag);
 		fxStringifyJSONChars(the, theStringifier, "null");
 		break;
 	case XS_BOOLEAN_KIND:
-		fxStringifyJSONName(the, theStringifier, theFlag);
+		fxStringifyJSONName(the, theStringifier, theID, theFlag);
 		fxStringifyJSONChars(the, theStringifier, aValue->value.boolean ? "true" : "false");
 		break;
 	case XS_INTEGER_KIND:
-		fxStringifyJSONName(the, theStringifier, theFlag);
+		fxStringifyJSONName(the, theStringifier, theID, theFlag);
 		fxStringifyJSONInteger(the, theStringifier, aValue->value.integer);
 		break;
 	case XS_NUMBER_KIND:
-		fxStringifyJSONName(the, theStringifier, theFlag);
+		fxStringifyJSONName(the, theStringifier, theID, theFlag);
 		fxStringifyJSONNumber(the, theStringifier, aValue->value.number);
 		break;
 	case XS_STRING_KIND:
 	case XS_STRING_X_KIND:
-		fxStringifyJSONName(the, theStringifier, theFlag);
+		fxStringifyJSONName(the, theStringifier, theID, theFlag);
 		fxStringifyJSONString(the, theStringifier, aValue->value.string);
 		break;
 	case XS_REFERENCE_KIND:
@@ -855,8 +928,15 @@ again:
 		if (aValue && (aValue->flag & XS_INTERNAL_FLAG) && (aValue->kind != XS_PROXY_KIND)) {
 			goto again;
 		}
-		fxStringifyJSONName(the, theStringifier, theFlag);
-		anInstance->flag |= XS_LEVEL_FLAG;
+		fxStringifyJSONName(the, theStringifier, theID, theFlag);
+		/* instances of shared machines and of ROM are marked and read only, so they are listed instead of flagged */
+		if (anInstance->flag & XS_MARK_FLAG) {
+			aLevel.previous = theStringifier->levels;
+			aLevel.instance = anInstance;
+			theStringifier->levels = &aLevel;
+		}
+		else
+			anInstance->flag |= XS_LEVEL_FLAG;
 		if (fxIsArray(the, anInstance)) {
 			fxStringifyJSONChar(the, theStringifier, '[');
 			theStringifier->level++;
@@ -870,7 +950,7 @@ again:
 				mxPushReference(anInstance);
 				fxGetID(the, anIndex);
 				mxPushInteger(anIndex);
-				fxStringifyJSONProperty(the, theStringifier, &aFlag);
+				fxStringifyJSONProperty(the, theStringifier, XS_NO_ID, &aFlag);
 			}
 			theStringifier->level--;
 			fxStringifyJSONIndent(the, theStringifier);
@@ -898,7 +978,7 @@ again:
 						}
 						else
 							mxPushInteger((txInteger)at->value.at.index);
-						fxStringifyJSONProperty(the, theStringifier, &aFlag);
+						fxStringifyJSONProperty(the, theStringifier, at->value.at.id, &aFlag);
 					}
 				}
 				mxPop();
@@ -908,7 +988,10 @@ again:
 			fxStringifyJSONIndent(the, theStringifier);
 			fxStringifyJSONChar(the, theStringifier, '}');
 		}
-		anInstance->flag &= ~XS_LEVEL_FLAG;
+		if (anInstance->flag & XS_MARK_FLAG)
+			theStringifier->levels = aLevel.previous;
+		else
+			anInstance->flag &= ~XS_LEVEL_FLAG;
 		break;
 	default:
 		if (*theFlag & 4) {
@@ -925,12 +1008,66 @@ again:
 	the->stack++; // POP VALUE
 }
 
+void fxStringifyJSONRelease(txMachine* the, txJSONStringifier* theStringifier)
+{
+	if (theStringifier->buffer) {
+		if (!the->stringifyBuffer && (theStringifier->size <= mxJSONBufferPoolSize)) {
+			the->stringifyBuffer = theStringifier->buffer;
+			the->stringifySize = theStringifier->size;
+		}
+		else
+			c_free(theStringifier->buffer);
+		theStringifier->buffer = C_NULL;
+	}
+}
+
+txString fxStringifyJSONReserve(txMachine* the, txJSONStringifier* theStringifier, txSize theSize)
+{
+	txSize offset;
+	if (theStringifier->offset > 0x7FFFFFFF - theSize)
+		mxUnknownError("out of memory");
+	offset = theStringifier->offset + theSize;
+	if (offset > theStringifier->size) {
+		txSize size = theStringifier->size;
+		txString buffer;
+		while (size < offset)
+			size = (size > 0x3FFFFFFF) ? 0x7FFFFFFF : size * 2;
+		buffer = c_realloc(theStringifier->buffer, size);
+		if (!buffer)
+			mxUnknownError("out of memory");
+		theStringifier->buffer = buffer;
+		theStringifier->size = size;
+	}
+	return theStringifier->buffer + theStringifier->offset;
+}
+
 void fxStringifyJSONString(txMachine* the, txJSONStringifier* theStringifier, txString theString)
 {
 	txString string = theString;
+	txString limit = theString + c_strlen(theString);
 	txInteger character;	
 	fxStringifyJSONChar(the, theStringifier, '"');
-	while (((string = fxUTF8Decode(string, &character))) && (character != C_EOF)) {
+	for (;;) {
+		txString safe = string;
+		txSize size;
+		while ((((uintptr_t)string) & 3) && mxJSONSafeByte(c_read8(string)))
+			string++;
+		if (!(((uintptr_t)string) & 3)) {
+			/* words are only read before the terminating zero, the tail is scanned byte by byte */
+			while ((limit - string >= 4) && !mxJSONUnsafeWord(c_read32(string)))
+				string += 4;
+			while (mxJSONSafeByte(c_read8(string)))
+				string++;
+		}
+		size = (txSize)(string - safe);
+		if (size) {
+			txString p = fxStringifyJSONReserve(the, theStringifier, size);
+			c_memcpy(p, safe, size);
+			theStringifier->offset += size;
+		}
+		string = fxUTF8Decode(string, &character);
+		if (!string || (character == C_EOF))
+			break;
 		if (character < 8)
 			fxStringifyJSONUnicodeEscape(the, theStringifier, character);
 		else if (character == 8)
@@ -947,16 +1084,10 @@ void fxStringifyJSONString(txMachine* the, txJSONStringifier* theStringifier, tx
 			fxStringifyJSONChars(the, theStringifier, "\\r");
 		else if (character < 32)
 			fxStringifyJSONUnicodeEscape(the, theStringifier, character);
-		else if (character < 34)
-			fxStringifyJSONChar(the, theStringifier, (char)character);
 		else if (character == 34)
 			fxStringifyJSONChars(the, theStringifier, "\\\"");
-		else if (character < 92)
-			fxStringifyJSONChar(the, theStringifier, (char)character);
 		else if (character == 92)
 			fxStringifyJSONChars(the, theStringifier, "\\\\");
-		else if (character < 127)
-			fxStringifyJSONChar(the, theStringifier, (char)character);
 		else
 			fxStringifyJSONUnicodeEscape(the, theStringifier, character);
 	}
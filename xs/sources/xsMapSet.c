@@ -41,16 +41,16 @@
 	#define mxMapSetLength (127)
 #endif
 
-static txSlot* fxCheckMapInstance(txMachine* the, txSlot* slot);
+static txSlot* fxCheckMapInstance(txMachine* the, txSlot* slot, txBoolean mutable);
 static txSlot* fxCheckMapKey(txMachine* the);
 
-static txSlot* fxCheckSetInstance(txMachine* the, txSlot* slot);
+static txSlot* fxCheckSetInstance(txMachine* the, txSlot* slot, txBoolean mutable);
 static txSlot* fxCheckSetValue(txMachine* the);
 
-static txSlot* fxCheckWeakMapInstance(txMachine* the, txSlot* slot);
+static txSlot* fxCheckWeakMapInstance(txMachine* the, txSlot* slot, txBoolean mutable);
 static txSlot* fxCheckWeakMapKey(txMachine* the);
 
-static txSlot* fxCheckWeakSetInstance(txMachine* the, txSlot* slot);
+static txSlot* fxCheckWeakSetInstance(txMachine* the, txSlot* slot, txBoolean mutable);
 static txSlot* fxCheckWeakSetValue(txMachine* the);
 
 static void fxClearEntries(txMachine* the, txSlot* table, txSlot* list, txBoolean paired);
@@ -163,12 +163,12 @@ void fxBuildMapSet(txMachine* the)
 	the->stack++;
 }
 
-txSlot* fxCheckMapInstance(txMachine* the, txSlot* slot)
+txSlot* fxCheckMapInstance(txMachine* the, txSlot* slot, txBoolean mutable)
 {
 	if (slot->kind == XS_REFERENCE_KIND) {
 		txSlot* instance = slot->value.reference;
 		if (((slot = instance->next)) && (slot->flag & XS_INTERNAL_FLAG) && (slot->kind == XS_MAP_KIND) && (instance != mxMapPrototype.value.reference))
-			return instance;
+			return (instance->ID >= 0) ? ((mutable) ? fxAliasInstance(the, instance) : mxAliasInstance(instance)) : instance;
 	}
 	mxTypeError("this is no Map instance");
 	return C_NULL;
@@ -269,7 +269,7 @@ void fx_Map(txMachine* the)
 
 void fx_Map_prototype_clear(txMachine* the)
 {
-	txSlot* instance = fxCheckMapInstance(the, mxThis);
+	txSlot* instance = fxCheckMapInstance(the, mxThis, XS_MUTABLE);
 	txSlot* table = instance->next;
 	txSlot* list = table->next;
 	fxClearEntries(the, table, list, 1);
@@ -277,7 +277,7 @@ void fx_Map_prototype_clear(txMachine* the)
 
 void fx_Map_prototype_delete(txMachine* the)
 {
-	txSlot* instance = fxCheckMapInstance(the, mxThis);
+	txSlot* instance = fxCheckMapInstance(the, mxThis, XS_MUTABLE);
 	txSlot* table = instance->next;
 	txSlot* list = table->next;
 	txSlot* key = fxCheckMapKey(the);
@@ -287,7 +287,7 @@ void fx_Map_prototype_delete(txMachine* the)
 
 void fx_Map_prototype_entries(txMachine* the)
 {
-	fxCheckMapInstance(the, mxThis);
+	fxCheckMapInstance(the, mxThis, XS_MUTABLE);
 	mxPush(mxMapEntriesIteratorPrototype);
 	fxNewEntryIteratorInstance(the, mxThis);
 	mxPullSlot(mxResult);
@@ -323,7 +323,7 @@ void fx_Map_prototype_entries_next(txMachine* the)
 
 void fx_Map_prototype_forEach(txMachine* the)
 {
-	txSlot* instance = fxCheckMapInstance(the, mxThis);
+	txSlot* instance = fxCheckMapInstance(the, mxThis, XS_MUTABLE);
 	txSlot* table = instance->next;
 	txSlot* list = table->next;
 	txSlot* function = fxArgToCallback(the, 0);
@@ -355,7 +355,7 @@ void fx_Map_prototype_forEach(txMachine* the)
 
 void fx_Map_prototype_get(txMachine* the)
 {
-	txSlot* instance = fxCheckMapInstance(the, mxThis);
+	txSlot* instance = fxCheckMapInstance(the, mxThis, XS_IMMUTABLE);
 	txSlot* table = instance->next;
 	txSlot* key = fxCheckMapKey(the);
 	txSlot* result = fxGetEntry(the, table, key);
@@ -368,7 +368,7 @@ void fx_Map_prototype_get(txMachine* the)
 
 void fx_Map_prototype_has(txMachine* the)
 {
-	txSlot* instance = fxCheckMapInstance(the, mxThis);
+	txSlot* instance = fxCheckMapInstance(the, mxThis, XS_IMMUTABLE);
 	txSlot* table = instance->next;
 	txSlot* key = fxCheckMapKey(the);
 	txSlot* result = fxGetEntry(the, table, key);
@@ -378,7 +378,7 @@ void fx_Map_prototype_has(txMachine* the)
 
 void fx_Map_prototype_keys(txMachine* the)
 {
-	fxCheckMapInstance(the, mxThis);
+	fxCheckMapInstance(the, mxThis, XS_MUTABLE);
 	mxPush(mxMapKeysIteratorPrototype);
 	fxNewEntryIteratorInstance(the, mxThis);
 	mxPullSlot(mxResult);
@@ -413,7 +413,7 @@ void fx_Map_prototype_keys_next(txMachine* the)
 
 void fx_Map_prototype_set(txMachine* the)
 {
-	txSlot* instance = fxCheckMapInstance(the, mxThis);
+	txSlot* instance = fxCheckMapInstance(the, mxThis, XS_MUTABLE);
 	txSlot* table = instance->next;
 	txSlot* list = table->next;
 	txSlot* key = fxCheckMapKey(the);
@@ -423,7 +423,7 @@ void fx_Map_prototype_set(txMachine* the)
 
 void fx_Map_prototype_size(txMachine* the)
 {
-	txSlot* instance = fxCheckMapInstance(the, mxThis);
+	txSlot* instance = fxCheckMapInstance(the, mxThis, XS_IMMUTABLE);
 	txSlot* table = instance->next;
 	txSlot* list = table->next;
 	mxResult->kind = XS_INTEGER_KIND;
@@ -432,7 +432,7 @@ void fx_Map_prototype_size(txMachine* the)
 
 void fx_Map_prototype_values(txMachine* the)
 {
-	fxCheckMapInstance(the, mxThis);
+	fxCheckMapInstance(the, mxThis, XS_MUTABLE);
 	mxPush(mxMapValuesIteratorPrototype);
 	fxNewEntryIteratorInstance(the, mxThis);
 	mxPullSlot(mxResult);
@@ -465,12 +465,12 @@ void fx_Map_prototype_values_next(txMachine* the)
 	}
 }
 
-txSlot* fxCheckSetInstance(txMachine* the, txSlot* slot)
+txSlot* fxCheckSetInstance(txMachine* the, txSlot* slot, txBoolean mutable)
 {
 	if (slot->kind == XS_REFERENCE_KIND) {
 		txSlot* instance = slot->value.reference;
 		if (((slot = instance->next)) && (slot->flag & XS_INTERNAL_FLAG) && (slot->kind == XS_SET_KIND) && (instance != mxSetPrototype.value.reference))
-			return instance;
+			return (instance->ID >= 0) ? ((mutable) ? fxAliasInstance(the, instance) : mxAliasInstance(instance)) : instance;
 	}
 	mxTypeError("this is no Set instance");
 	return C_NULL;
@@ -564,7 +564,7 @@ void fx_Set(txMachine* the)
 
 void fx_Set_prototype_add(txMachine* the)
 {
-	txSlot* instance = fxCheckSetInstance(the, mxThis);
+	txSlot* instance = fxCheckSetInstance(the, mxThis, XS_MUTABLE);
 	txSlot* table = instance->next;
 	txSlot* list = table->next;
 	txSlot* value = fxCheckSetValue(the);
@@ -574,7 +574,7 @@ void fx_Set_prototype_add(txMachine* the)
 
 void fx_Set_prototype_clear(txMachine* the)
 {
-	txSlot* instance = fxCheckSetInstance(the, mxThis);
+	txSlot* instance = fxCheckSetInstance(the, mxThis, XS_MUTABLE);
 	txSlot* table = instance->next;
 	txSlot* list = table->next;
 	fxClearEntries(the, table, list, 0);
@@ -582,7 +582,7 @@ void fx_Set_prototype_clear(txMachine* the)
 
 void fx_Set_prototype_delete(txMachine* the)
 {
-	txSlot* instance = fxCheckSetInstance(the, mxThis);
+	txSlot* instance = fxCheckSetInstance(the, mxThis, XS_MUTABLE);
 	txSlot* table = instance->next;
 	txSlot* list = table->next;
 	txSlot* value = fxCheckSetValue(the);
@@ -592,7 +592,7 @@ void fx_Set_prototype_delete(txMachine* the)
 
 void fx_Set_prototype_entries(txMachine* the)
 {
-	fxCheckSetInstance(the, mxThis);
+	fxCheckSetInstance(the, mxThis, XS_MUTABLE);
 	mxPush(mxSetEntriesIteratorPrototype);
 	fxNewEntryIteratorInstance(the, mxThis);
 	mxPullSlot(mxResult);
@@ -625,7 +625,7 @@ void fx_Set_prototype_entries_next(txMachine* the)
 
 void fx_Set_prototype_forEach(txMachine* the)
 {
-	txSlot* instance = fxCheckSetInstance(the, mxThis);
+	txSlot* instance = fxCheckSetInstance(the, mxThis, XS_MUTABLE);
 	txSlot* table = instance->next;
 	txSlot* list = table->next;
 	txSlot* function = fxArgToCallback(the, 0);
@@ -656,7 +656,7 @@ void fx_Set_prototype_forEach(txMachine* the)
 
 void fx_Set_prototype_has(txMachine* the)
 {
-	txSlot* instance = fxCheckSetInstance(the, mxThis);
+	txSlot* instance = fxCheckSetInstance(the, mxThis, XS_IMMUTABLE);
 	txSlot* table = instance->next;
 	txSlot* value = fxCheckSetValue(the);
 	txSlot* result = fxGetEntry(the, table, value);
@@ -666,7 +666,7 @@ void fx_Set_prototype_has(txMachine* the)
 
 void fx_Set_prototype_size(txMachine* the)
 {
-	txSlot* instance = fxCheckSetInstance(the, mxThis);
+	txSlot* instance = fxCheckSetInstance(the, mxThis, XS_IMMUTABLE);
 	txSlot* table = instance->next;
 	txSlot* list = table->next;
 	mxResult->kind = XS_INTEGER_KIND;
@@ -675,7 +675,7 @@ void fx_Set_prototype_size(txMachine* the)
 
 void fx_Set_prototype_values(txMachine* the)
 {
-	fxCheckSetInstance(the, mxThis);
+	fxCheckSetInstance(the, mxThis, XS_MUTABLE);
 	mxPush(mxSetValuesIteratorPrototype);
 	fxNewEntryIteratorInstance(the, mxThis);
 	mxPullSlot(mxResult);
@@ -705,12 +705,12 @@ void fx_Set_prototype_values_next(txMachine* the)
 	}
 }
 
-txSlot* fxCheckWeakMapInstance(txMachine* the, txSlot* slot)
+txSlot* fxCheckWeakMapInstance(txMachine* the, txSlot* slot, txBoolean mutable)
 {
 	if (slot->kind == XS_REFERENCE_KIND) {
 		txSlot* instance = slot->value.reference;
 		if (((slot = instance->next)) && (slot->flag & XS_INTERNAL_FLAG) && (slot->kind == XS_WEAK_MAP_KIND) && (instance != mxWeakMapPrototype.value.reference))
-			return instance;
+			return (instance->ID >= 0) ? ((mutable) ? fxAliasInstance(the, instance) : mxAliasInstance(instance)) : instance;
 	}
 	mxTypeError("this is no WeakMap instance");
 	return C_NULL;
@@ -801,7 +801,7 @@ void fx_WeakMap(txMachine* the)
 
 void fx_WeakMap_prototype_delete(txMachine* the)
 {
-	txSlot* instance = fxCheckWeakMapInstance(the, mxThis);
+	txSlot* instance = fxCheckWeakMapInstance(the, mxThis, XS_MUTABLE);
 	txSlot* table = instance->next;
 	txSlot* key = fxCheckWeakMapKey(the);
 	mxResult->value.boolean = (key) ? fxDeleteEntry(the, table, C_NULL, key, 1) : 0;
@@ -810,7 +810,7 @@ void fx_WeakMap_prototype_delete(txMachine* the)
 
 void fx_WeakMap_prototype_get(txMachine* the)
 {
-	txSlot* instance = fxCheckWeakMapInstance(the, mxThis);
+	txSlot* instance = fxCheckWeakMapInstance(the, mxThis, XS_IMMUTABLE);
 	txSlot* table = instance->next;
 	txSlot* key = fxCheckWeakMapKey(the);
 	txSlot* result = (key) ? fxGetEntry(the, table, key) : C_NULL;
@@ -823,7 +823,7 @@ void fx_WeakMap_prototype_get(txMachine* the)
 
 void fx_WeakMap_prototype_has(txMachine* the)
 {
-	txSlot* instance = fxCheckWeakMapInstance(the, mxThis);
+	txSlot* instance = fxCheckWeakMapInstance(the, mxThis, XS_IMMUTABLE);
 	txSlot* table = instance->next;
 	txSlot* key = fxCheckWeakMapKey(the);
 	txSlot* result = (key) ? fxGetEntry(the, table, key) : C_NULL;
@@ -833,7 +833,7 @@ void fx_WeakMap_prototype_has(txMachine* the)
 
 void fx_WeakMap_prototype_set(txMachine* the)
 {
-	txSlot* instance = fxCheckWeakMapInstance(the, mxThis);
+	txSlot* instance = fxCheckWeakMapInstance(the, mxThis, XS_MUTABLE);
 	txSlot* table = instance->next;
 	txSlot* key = fxCheckWeakMapKey(the);
 	if (!key)
@@ -842,12 +842,12 @@ void fx_WeakMap_prototype_set(txMachine* the)
 	*mxResult = *mxThis;
 }
 
-txSlot* fxCheckWeakSetInstance(txMachine* the, txSlot* slot)
+txSlot* fxCheckWeakSetInstance(txMachine* the, txSlot* slot, txBoolean mutable)
 {
 	if (slot->kind == XS_REFERENCE_KIND) {
 		txSlot* instance = slot->value.reference;
 		if (((slot = instance->next)) && (slot->flag & XS_INTERNAL_FLAG) && (slot->kind == XS_WEAK_SET_KIND) && (instance != mxWeakSetPrototype.value.reference))
-			return instance;
+			return (instance->ID >= 0) ? ((mutable) ? fxAliasInstance(the, instance) : mxAliasInstance(instance)) : instance;
 	}
 	mxTypeError("this is no WeakSet instance");
 	return C_NULL;
@@ -934,7 +934,7 @@ void fx_WeakSet(txMachine* the)
 
 void fx_WeakSet_prototype_add(txMachine* the)
 {
-	txSlot* instance = fxCheckWeakSetInstance(the, mxThis);
+	txSlot* instance = fxCheckWeakSetInstance(the, mxThis, XS_MUTABLE);
 	txSlot* table = instance->next;
 	txSlot* value = fxCheckWeakSetValue(the);
 	if (!value)
@@ -945,7 +945,7 @@ void fx_WeakSet_prototype_add(txMachine* the)
 
 void fx_WeakSet_prototype_has(txMachine* the)
 {
-	txSlot* instance = fxCheckWeakSetInstance(the, mxThis);
+	txSlot* instance = fxCheckWeakSetInstance(the, mxThis, XS_IMMUTABLE);
 	txSlot* table = instance->next;
 	txSlot* value = fxCheckWeakSetValue(the);
 	txSlot* result = (value) ? fxGetEntry(the, table, value) : C_NULL;
@@ -955,7 +955,7 @@ void fx_WeakSet_prototype_has(txMachine* the)
 
 void fx_WeakSet_prototype_delete(txMachine* the)
 {
-	txSlot* instance = fxCheckWeakSetInstance(the, mxThis);
+	txSlot* instance = fxCheckWeakSetInstance(the, mxThis, XS_MUTABLE);
 	txSlot* table = instance->next;
 	txSlot* value = fxCheckWeakSetValue(the);
 	mxResult->value.boolean = (value) ? fxDeleteEntry(the, table, C_NULL, value, 0) : 0;
@@ -1017,6 +1017,37 @@ txBoolean fxDeleteEntry(txMachine* the, txSlot* table, txSlot* list, txSlot* slo
 	return 0;
 }
 
+void fxAliasEntries(txMachine* the, txSlot* from, txSlot* table, txSlot* list, txBoolean paired)
+{
+	txSlot* slot;
+	if (list) {
+		slot = from->value.list.first;
+		while (slot) {
+			if (!(slot->flag & XS_DONT_ENUM_FLAG)) {
+				mxPushSlot(slot);
+				fxSetEntry(the, table, list, the->stack, (paired) ? slot->next : C_NULL);
+				mxPop();
+			}
+			slot = (paired) ? slot->next->next : slot->next;
+		}
+	}
+	else {
+		txSlot** address = from->value.table.address;
+		txInteger modulo = from->value.table.length;
+		while (modulo) {
+			slot = *address;
+			while (slot) {
+				mxPushSlot(slot->value.entry.slot);
+				fxSetEntry(the, table, C_NULL, the->stack, (paired) ? slot->value.entry.slot->next : C_NULL);
+				mxPop();
+				slot = slot->next;
+			}
+			address++;
+			modulo--;
+		}
+	}
+}
+
 txSlot* fxGetEntry(txMachine* the, txSlot* table, txSlot* slot) 
 {
 	txU4 sum = fxSumEntry(the, slot);
@@ -1048,7 +1079,7 @@ txSlot* fxNewEntryIteratorInstance(txMachine* the, txSlot* iterable)
 	property = fxNextSlotProperty(the, property, iterable, mxID(_iterable), XS_GET_ONLY);
 	property = fxNextNullProperty(the, property, mxID(_index), XS_GET_ONLY);
 	property->kind = XS_CLOSURE_KIND;
-	property->value.closure = iterable->value.reference->next->next->value.list.first;
+	property->value.closure = mxAliasInstance(iterable->value.reference)->next->next->value.list.first;
     the->stack++;
 	return instance;
 }
@@ -1072,6 +1103,29 @@ void fxPurgeEntries(txMachine* the, txSlot* list)
 }
 #endif
 
+void fxRehashEntries(txMachine* the, txSlot* table)
+{
+	txSize length = table->value.table.length;
+	txSlot** address = table->value.table.address;
+	txSlot* first = C_NULL;
+	txSlot* entry;
+	txSize index;
+	for (index = 0; index < length; index++) {
+		while ((entry = address[index])) {
+			address[index] = entry->next;
+			entry->next = first;
+			first = entry;
+		}
+	}
+	while ((entry = first)) {
+		first = entry->next;
+		entry->value.entry.sum = fxSumEntry(the, entry->value.entry.slot);
+		index = entry->value.entry.sum % length;
+		entry->next = address[index];
+		address[index] = entry;
+	}
+}
+
 void fxSetEntry(txMachine* the, txSlot* table, txSlot* list, txSlot* slot, txSlot* pair) 
 {
 	txU4 sum = fxSumEntry(the, slot);
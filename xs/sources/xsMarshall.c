@@ -103,6 +103,8 @@ void fxDemarshall(txMachine* the, void* theData, txBoolean alien)
 			switch (aSlot->kind) {
 			case XS_STRING_KIND:
 			case XS_ARRAY_BUFFER_KIND:
+			case XS_PACKED_INTEGER_KIND:
+			case XS_PACKED_NUMBER_KIND:
 				aChunk = (txChunk*)p;
 				p += aChunk->size;
 				mxMarshallAlign(p, aChunk->size);
@@ -178,6 +180,17 @@ void fxDemarshallSlot(txMachine* the, txSlot* theSlot, txSlot* theResult, txID*
             theResult->kind = theSlot->kind;
 		}
 		break;
+	case XS_PACKED_INTEGER_KIND:
+	case XS_PACKED_NUMBER_KIND:
+		theResult->value.array.length = 0;
+		theResult->value.array.address = C_NULL;
+		if (theSlot->value.array.address) {
+			txSlot **s = &theResult->value.array.address;
+			fxDemarshallChunk(the, theSlot->value.array.address, (void **)s);
+			theResult->value.array.length = theSlot->value.array.length;
+		}
+		theResult->kind = theSlot->kind;
+		break;
 	case XS_HOST_KIND:
 		aLength = theSlot->next->value.integer;
 		if (aLength) {
@@ -414,6 +427,13 @@ void fxMarshallSlot(txMachine* the, txSlot* theSlot, txSlot** theSlotAddress, tx
 			fxMarshallChunk(the, theSlot->value.arrayBuffer.address, (void **)s, theBuffer);
 		}
 		break;
+	case XS_PACKED_INTEGER_KIND:
+	case XS_PACKED_NUMBER_KIND:
+		if (theSlot->value.array.address) {
+			txSlot **s = &aResult->value.array.address;
+			fxMarshallChunk(the, theSlot->value.array.address, (void **)s, theBuffer);
+		}
+		break;
 	case XS_HOST_KIND:
 		aLength = theSlot->next->value.integer;
 		if (aLength) {
@@ -442,7 +462,7 @@ void fxMarshallSlot(txMachine* the, txSlot* theSlot, txSlot** theSlotAddress, tx
 		txIndex former = 0, current;	
 		aSlotAddress = &(aResult->value.array.address);
 		while (slot < limit) {
-			current = *((txIndex*)slot);
+			current = (length == size) ? former : *((txIndex*)slot);
 			while (former < current) {
 				fxMarshallSlot(the, &mxUndefined, aSlotAddress, theBuffer, alien);
 				aSlotAddress = &((*aSlotAddress)->next);
@@ -533,6 +553,11 @@ void fxMeasureSlot(txMachine* the, txSlot* theSlot, txMarshallBuffer* theBuffer,
 		if (theSlot->value.arrayBuffer.address)
 			fxMeasureChunk(the, theSlot->value.arrayBuffer.address, theBuffer);
 		break;
+	case XS_PACKED_INTEGER_KIND:
+	case XS_PACKED_NUMBER_KIND:
+		if (theSlot->value.array.address)
+			fxMeasureChunk(the, theSlot->value.array.address, theBuffer);
+		break;
 	case XS_HOST_KIND:
 		aSlot = theSlot->next;
 		if (aSlot && (aSlot->kind == XS_INTEGER_KIND)) {
@@ -557,7 +582,7 @@ void fxMeasureSlot(txMachine* the, txSlot* theSlot, txMarshallBuffer* theBuffer,
 		txSlot* limit = slot + size;
 		txIndex former = 0, current;	
 		while (slot < limit) {
-			current = *((txIndex*)slot);
+			current = (length == size) ? former : *((txIndex*)slot);
 			while (former < current) {
 				theBuffer->size += sizeof(txSlot);
 				former++;
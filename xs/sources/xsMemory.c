@@ -52,19 +52,47 @@ int gxStress = 0;
 #endif
 
 #define mxChunkFlag 0x80000000
+#define mxSpareChunk ((txByte*)-1)
+#define mxYoungChunk ((txByte*)-2)
+
+#define mxCollectSlots 0
+#define mxCollectAndCompact 1
+#define mxCollectAndRecycle 2
 
 //#define mxRoundSize(_SIZE) ((_SIZE + (sizeof(txChunk) - 1)) & ~(sizeof(txChunk) - 1))
 #define mxRoundSize(_SIZE) ((_SIZE + (sizeof(txSize) - 1)) & ~(sizeof(txSize) - 1))
 
+#ifdef mxInstrument
+#define mxAllocationInterval 4096
+#define mxAllocationSiteCount 256
+static int fxCompareAllocationSites(const void* p, const void* q);
+static void fxSampleAllocation(txMachine* the, txBoolean isChunk);
+static txSize fxGetHeapChunkSize(void* data);
+static txBoolean fxVisitHeapAddress(txHeapWriter* writer, void* address);
+static void fxWriteHeapByte(txHeapWriter* writer, txU1 value);
+static void fxWriteHeapEdge(txHeapWriter* writer, void* from, void* to, txU1 kind, txUnsigned name);
+static void fxWriteHeapInstance(txMachine* the, txHeapWriter* writer, txSlot* instance);
+static void fxWriteHeapMarker(txMachine* the, txSlot* slot);
+static txUnsigned fxWriteHeapName(txMachine* the, txHeapWriter* writer, txID id);
+static void fxWriteHeapNode(txHeapWriter* writer, void* address, txU1 kind, txSize size, txUnsigned name);
+static void fxWriteHeapNumber(txHeapWriter* writer, uintptr_t value);
+static txSize fxWriteHeapValue(txMachine* the, txHeapWriter* writer, txSlot* owner, txSlot* slot, txU1 kind, txUnsigned name);
+#endif
+
+static void fxDisposeChunk(txMachine* the, txByte* theData, txSize theSize);
+static txInteger fxGetFreeChunkClass(txSize theSize);
 static void fxGrowChunks(txMachine* the, txSize theSize); 
 static void fxGrowSlots(txMachine* the, txSize theCount); 
 static void fxMark(txMachine* the, void (*theMarker)(txMachine*, txSlot*));
 static void fxMarkInstance(txMachine* the, txSlot* theCurrent, void (*theMarker)(txMachine*, txSlot*));
-static void fxMarkReference(txMachine* the, txSlot* theSlot);
 static void fxMarkValue(txMachine* the, txSlot* theSlot);
 static void fxMarkWeakMapTable(txMachine* the, txSlot* table, void (*theMarker)(txMachine*, txSlot*));
 static void fxMarkWeakSetTable(txMachine* the, txSlot* table);
 static void fxMarkWeakTables(txMachine* the, void (*theMarker)(txMachine*, txSlot*));
+static txByte* fxRecycleChunk(txMachine* the, txSize theSize);
+static void fxRecycleChunks(txMachine* the, txBoolean keepYoung);
+static txBoolean fxIsFrozenInstance(txMachine* the, txSlot* instance);
+static void fxShareValue(txMachine* the, txSlot* theSlot, txInteger* theCount);
 static void fxSweep(txMachine* the);
 static void fxSweepValue(txMachine* the, txSlot* theSlot);
 
@@ -161,8 +189,10 @@ void fxAllocate(txMachine* the, txCreation* theCreation)
 	the->stackTop = the->stackBottom + theCreation->stackCount;
 	the->stackPrototypes = the->stackTop;
 	the->stack = the->stackTop;
+	the->maximumStackCount = theCreation->maximumStackCount;
 #ifdef mxInstrument
 	the->stackPeak = the->stackTop;
+	the->peakStackCount = 0;
 #endif
 
 	fxGrowSlots(the, theCreation->initialHeapCount);
@@ -203,16 +233,13 @@ void fxCollect(txMachine* the, txBoolean theFlag)
 	fxBeginGC(the);
 #endif
 
-	fxMarkHost(the, theFlag ? fxMarkValue : fxMarkReference);
-
-	if (theFlag) {
-		fxMark(the, fxMarkValue);
-		fxMarkWeakTables(the, fxMarkValue);
+	fxMarkHost(the, fxMarkValue);
+	fxMark(the, fxMarkValue);
+	fxMarkWeakTables(the, fxMarkValue);
+	if (theFlag == mxCollectAndCompact)
 		fxSweep(the);
-	}
 	else {
-		fxMark(the, fxMarkReference);
-		fxMarkWeakTables(the, fxMarkReference);
+		fxRecycleChunks(the, theFlag == mxCollectSlots);
 	#ifdef mxNever
 		startTime(&gxSweepSlotTime);
 	#endif
@@ -270,7 +297,7 @@ void fxCollect(txMachine* the, txBoolean theFlag)
 	
 	fxSweepHost(the);
 	
-	if (!theFlag) {
+	if (theFlag == mxCollectSlots) {
 		if ((the->maximumHeapCount - the->currentHeapCount) < the->minimumHeapCount)
 				the->collectFlag |= XS_TRASHING_FLAG;
 			else
@@ -278,8 +305,7 @@ void fxCollect(txMachine* the, txBoolean theFlag)
 	}
 	
 #if mxReport
-	if (theFlag)
-		fxReport(the, "# Chunk collection: reserved %ld used %ld peak %ld bytes\n", 
+	fxReport(the, "# Chunk collection: reserved %ld used %ld peak %ld bytes\n", 
 			(long)the->maximumChunksSize, (long)the->currentChunksSize, (long)the->peakChunksSize);
 	fxReport(the, "# Slot collection: reserved %ld used %ld peak %ld bytes %ld\n",
 		(long)(the->maximumHeapCount * sizeof(txSlot)),
@@ -287,9 +313,7 @@ void fxCollect(txMachine* the, txBoolean theFlag)
 		(long)(the->peakHeapCount * sizeof(txSlot)),
 		the->collectFlag & XS_TRASHING_FLAG);
 #endif
-#ifdef mxInstrument
 	the->garbageCollectionCount++;
-#endif
 #ifdef mxProfile
 	fxEndGC(the);
 #endif
@@ -315,6 +339,9 @@ void fxFree(txMachine* the)
 	if (the->aliasArray)
 		c_free_uint32(the->aliasArray);
 	the->aliasArray = C_NULL;
+#ifdef mxInstrument
+	fxStopAllocationSampling(the);
+#endif
 
 	if (the->symbolTable)
 		c_free_uint32(the->symbolTable);
@@ -364,6 +391,33 @@ void fxFree(txMachine* the)
 #endif
 }
 
+void fxDisposeChunk(txMachine* the, txByte* theData, txSize theSize)
+{
+	txChunk* aChunk = (txChunk*)theData;
+	txInteger aClass;
+#if mxFill
+	c_memset(theData, 0xFF, theSize);
+#endif
+	aClass = fxGetFreeChunkClass(theSize);
+	aChunk->size = theSize;
+	aChunk->temporary = the->freeChunks[aClass];
+	the->freeChunks[aClass] = theData;
+}
+
+txInteger fxGetFreeChunkClass(txSize theSize)
+{
+	txInteger aClass;
+	if (theSize < 256)
+		return theSize >> 4;
+	aClass = 16;
+	theSize >>= 9;
+	while (theSize && (aClass < mxFreeChunkClassCount - 1)) {
+		theSize >>= 1;
+		aClass++;
+	}
+	return aClass;
+}
+
 #ifndef roundup
 #define roundup(x, y)	((((x) + (y) - 1) / (y)) * (y))
 #endif
@@ -445,6 +499,82 @@ void fxGrowSlots(txMachine* the, txSize theCount)
 #endif
 }
 
+void fxGrowStack(txMachine* the, txSize theCount)
+{
+	txSlot* oldBottom = the->stackBottom;
+	txSlot* oldTop = the->stackTop;
+	txSlot* newBottom;
+	txSlot* newTop;
+	txSize oldCount = (txSize)(oldTop - oldBottom);
+	txSize usedCount = (txSize)(oldTop - the->stack);
+	txSize newCount = oldCount;
+	txSlot* aFrame;
+	txJump* aJump;
+
+	if (the->maximumStackCount <= 0)
+		return;
+	// host code may keep raw pointers to stack slots, the stack can only move when no such host frame is running over JavaScript frames
+	// conversions by the interpreter do not keep pointers, their frames are movable
+	aFrame = the->frame;
+	while (aFrame) {
+		if (((aFrame->flag & (XS_C_FLAG | XS_MOVABLE_FLAG)) == XS_C_FLAG) && aFrame->next)
+			break;
+		aFrame = aFrame->next;
+	}
+	// the margin of mxGrowStack leaves enough room to throw
+	if (aFrame || (newCount >= the->maximumStackCount))
+		mxRangeError("stack overflow");
+	while ((newCount - usedCount) < theCount) {
+		if (newCount >= (the->maximumStackCount >> 1)) {
+			newCount = the->maximumStackCount;
+			break;
+		}
+		newCount <<= 1;
+	}
+	newBottom = fxAllocateSlots(the, newCount);
+	if (!newBottom)
+		mxRangeError("stack overflow");
+	newTop = newBottom + newCount;
+	c_memcpy(newTop - usedCount, the->stack, usedCount * sizeof(txSlot));
+
+#define mxRelocateStack(POINTER) \
+	if ((oldBottom <= (POINTER)) && ((POINTER) <= oldTop)) \
+		POINTER = newTop - (oldTop - (POINTER))
+
+	mxRelocateStack(the->frame);
+	aFrame = the->frame;
+	while (aFrame) {
+		mxRelocateStack(aFrame->next);
+		mxRelocateStack(aFrame->value.frame.scope);
+		aFrame = aFrame->next;
+	}
+	aJump = the->firstJump;
+	while (aJump) {
+		mxRelocateStack(aJump->stack);
+		mxRelocateStack(aJump->scope);
+		mxRelocateStack(aJump->frame);
+		aJump = aJump->nextJump;
+	}
+	mxRelocateStack(the->stack);
+	mxRelocateStack(the->scope);
+#ifdef mxInstrument
+	mxRelocateStack(the->stackPeak);
+#endif
+	if (the->stackPrototypes == oldTop)
+		the->stackPrototypes = newTop;
+
+#undef mxRelocateStack
+
+	fxFreeSlots(the, oldBottom);
+	the->stackBottom = newBottom;
+	the->stackTop = newTop;
+#if mxReport
+	fxReport(the, "# Stack allocation: reserved %ld used %ld bytes\n",
+		(long)(newCount * sizeof(txSlot)),
+		(long)(usedCount * sizeof(txSlot)));
+#endif
+}
+
 void fxMark(txMachine* the, void (*theMarker)(txMachine*, txSlot*))
 {
 	txInteger anIndex;
@@ -473,9 +603,16 @@ void fxMark(txMachine* the, void (*theMarker)(txMachine*, txSlot*))
 	anArray = the->aliasArray;
 	anIndex = the->aliasCount;
 	while (anIndex) {
-		if ((aSlot = *anArray))
-			if (!(aSlot->flag & XS_MARK_FLAG))
-				fxMarkInstance(the, aSlot, theMarker);
+		if ((aSlot = *anArray)) {
+			if (!(aSlot->flag & XS_MARK_FLAG)) {
+				if (aSlot->kind == XS_INSTANCE_KIND)
+					fxMarkInstance(the, aSlot, theMarker);
+				else {
+					aSlot->flag |= XS_MARK_FLAG;
+					(*theMarker)(the, aSlot);
+				}
+			}
+		}
 		anArray++;
 		anIndex--;
 	}
@@ -549,134 +686,6 @@ void fxMarkInstance(txMachine* the, txSlot* theCurrent, void (*theMarker)(txMach
 	}
 }
 
-void fxMarkReference(txMachine* the, txSlot* theSlot)
-{
-	txSlot* aSlot;
-	switch (theSlot->kind) {
-	case XS_REFERENCE_KIND:
-		aSlot = theSlot->value.reference;
-		if (!(aSlot->flag & XS_MARK_FLAG))
-			fxMarkInstance(the, aSlot, fxMarkReference);
-		break;
-	case XS_CLOSURE_KIND:
-		aSlot = theSlot->value.closure;
-		if (aSlot && (!(aSlot->flag & XS_MARK_FLAG))) {
-			aSlot->flag |= XS_MARK_FLAG; 
-			fxMarkReference(the, aSlot);
-		}
-		break;
-	case XS_INSTANCE_KIND:
-		if (!(theSlot->flag & XS_MARK_FLAG))
-			fxMarkInstance(the, theSlot, fxMarkReference);
-		break;
-	case XS_ACCESSOR_KIND:
-		aSlot = theSlot->value.accessor.getter;
-		if (aSlot && !(aSlot->flag & XS_MARK_FLAG))
-			fxMarkInstance(the, aSlot, fxMarkReference);
-		aSlot = theSlot->value.accessor.setter;
-		if (aSlot && !(aSlot->flag & XS_MARK_FLAG))
-			fxMarkInstance(the, aSlot, fxMarkReference);
-		break;
-	case XS_ARGUMENTS_SLOPPY_KIND:
-	case XS_ARGUMENTS_STRICT_KIND:
-	case XS_ARRAY_KIND:
-	case XS_STACK_KIND:
-		if ((aSlot = theSlot->value.array.address)) {
-			txIndex aLength = (((txChunk*)(((txByte*)aSlot) - sizeof(txChunk)))->size) / sizeof(txSlot);
-			while (aLength) {
-				fxMarkReference(the, aSlot);
-				aSlot++;
-				aLength--;
-			}
-		}
-		break;
-	case XS_CODE_KIND:
-	case XS_CODE_X_KIND:
-		aSlot = theSlot->value.code.closures;
-		if (aSlot && !(aSlot->flag & XS_MARK_FLAG))
-			fxMarkInstance(the, aSlot, fxMarkReference);
-		break;
-	case XS_HOME_KIND:
-		aSlot = theSlot->value.home.object;
-		if (aSlot && !(aSlot->flag & XS_MARK_FLAG))
-			fxMarkInstance(the, aSlot, fxMarkReference);
-		aSlot = theSlot->value.home.module;
-		if (aSlot && !(aSlot->flag & XS_MARK_FLAG))
-			fxMarkInstance(the, aSlot, fxMarkReference);
-		break;
-	case XS_EXPORT_KIND:
-		aSlot = theSlot->value.export.closure;
-		if (aSlot && !(aSlot->flag & XS_MARK_FLAG)) {
-			aSlot->flag |= XS_MARK_FLAG; 
-			fxMarkReference(the, aSlot);
-		}
-		aSlot = theSlot->value.export.module;
-		if (aSlot && !(aSlot->flag & XS_MARK_FLAG))
-			fxMarkInstance(the, aSlot, fxMarkReference);
-		break;
-	case XS_HOST_KIND:
-		if (theSlot->value.host.data) {
-			if ((theSlot->flag & XS_HOST_HOOKS_FLAG) && (theSlot->value.host.variant.hooks->marker))
-				(*theSlot->value.host.variant.hooks->marker)(the, theSlot->value.host.data, fxMarkReference);
-		}
-		break;
-	case XS_PROXY_KIND:
-		aSlot = theSlot->value.proxy.handler;
-		if (aSlot && !(aSlot->flag & XS_MARK_FLAG))
-			fxMarkInstance(the, aSlot, fxMarkReference);
-		aSlot = theSlot->value.proxy.target;
-		if (aSlot && !(aSlot->flag & XS_MARK_FLAG))
-			fxMarkInstance(the, aSlot, fxMarkReference);
-		break;
-	case XS_WITH_KIND:
-		aSlot = theSlot->value.reference;
-		if (aSlot && !(aSlot->flag & XS_MARK_FLAG))
-			fxMarkInstance(the, aSlot, fxMarkReference);
-		break;
-		
-	case XS_LIST_KIND:
-		aSlot = theSlot->value.list.first;
-		while (aSlot) {
-			if (!(aSlot->flag & XS_MARK_FLAG)) {
-				aSlot->flag |= XS_MARK_FLAG;
-				fxMarkReference(the, aSlot);
-			}
-			aSlot = aSlot->next;
-		}
-		break;
-	case XS_MAP_KIND:
-	case XS_SET_KIND:
-		{
-			txSlot** anAddress = theSlot->value.table.address;
-			txInteger aLength = theSlot->value.table.length;
-			while (aLength) {
-				aSlot = *anAddress;
-				while (aSlot) {
-					aSlot->flag |= XS_MARK_FLAG; 
-					aSlot = aSlot->next;
-				}
-				anAddress++;
-				aLength--;
-			}
-		}
-		break;
-	case XS_WEAK_MAP_KIND:
-		theSlot->value.table.address[theSlot->value.table.length] = the->firstWeakMapTable;
-		the->firstWeakMapTable = theSlot;
-		break;
-	case XS_WEAK_SET_KIND:
-		theSlot->value.table.address[theSlot->value.table.length] = the->firstWeakSetTable;
-		the->firstWeakSetTable = theSlot;
-		break;
-		
-	case XS_HOST_INSPECTOR_KIND:
-		aSlot = theSlot->value.hostInspector.cache;
-		if (!(aSlot->flag & XS_MARK_FLAG))
-			fxMarkInstance(the, aSlot, fxMarkReference);
-		break;	
-	}
-}
-
 void fxMarkValue(txMachine* the, txSlot* theSlot)
 {
 #define mxMarkChunk(_THE_DATA) \
@@ -718,6 +727,11 @@ void fxMarkValue(txMachine* the, txSlot* theSlot)
 			mxMarkChunk(theSlot->value.array.address);
 		}
 		break;
+	case XS_PACKED_INTEGER_KIND:
+	case XS_PACKED_NUMBER_KIND:
+		if (theSlot->value.array.address)
+			mxMarkChunk(theSlot->value.array.address);
+		break;
 	case XS_ARRAY_BUFFER_KIND:
 		if (theSlot->value.arrayBuffer.address)
 			mxMarkChunk(theSlot->value.arrayBuffer.address);
@@ -911,11 +925,12 @@ void* fxNewChunk(txMachine* the, txSize theSize)
 {
 	txBlock* aBlock;
 	txByte* aData;
-	txBoolean once = 1;
+	txSize aFree;
+	txInteger once = 1;
 	
 #if mxStress
 	if (gxStress) {
-		fxCollect(the, 1);
+		fxCollect(the, (the->garbageCollectionCount & 1) ? mxCollectAndCompact : mxCollectAndRecycle);
 		once = 0;
 	}
 #endif
@@ -923,22 +938,41 @@ void* fxNewChunk(txMachine* the, txSize theSize)
     //	fprintf(stderr, "# fxNewChunk %ld\n", theSize);
 	theSize = mxRoundSize(theSize) + sizeof(txChunk);
 again:
-	aBlock = the->firstBlock;
-	while (aBlock) {
-		if ((aBlock->current + theSize) <= aBlock->limit) {
-			aData = aBlock->current;
-			((txChunk*)aData)->size = theSize;
-			((txChunk*)aData)->temporary = C_NULL;
-			aBlock->current += theSize;
-			the->currentChunksSize += theSize;
-			if (the->peakChunksSize < the->currentChunksSize)
-				the->peakChunksSize = the->currentChunksSize;
-			return aData + sizeof(txChunk);
+	aData = C_NULL;
+	aFree = the->freeChunksSize;
+	if (aFree >= theSize)
+		aData = fxRecycleChunk(the, theSize);
+	if (!aData) {
+		aBlock = the->firstBlock;
+		while (aBlock) {
+			if ((aBlock->current + theSize) <= aBlock->limit) {
+				aData = aBlock->current;
+				aBlock->current += theSize;
+				break;
+			}
+			aFree += (txSize)(aBlock->limit - aBlock->current);
+			aBlock = aBlock->nextBlock;
 		}
-		aBlock = aBlock->nextBlock;
 	}
-	if (once) {
-		fxCollect(the, 1);
+	if (aData) {
+		((txChunk*)aData)->size = theSize;
+		((txChunk*)aData)->temporary = mxYoungChunk;
+		the->currentChunksSize += theSize;
+		if (the->peakChunksSize < the->currentChunksSize)
+			the->peakChunksSize = the->currentChunksSize;
+	#ifdef mxInstrument
+		if (the->allocationSites && ((the->allocationCountdown -= theSize) <= 0))
+			fxSampleAllocation(the, 1);
+	#endif
+		return aData + sizeof(txChunk);
+	}
+	// recycle dead chunks in place, compact only for large requests, fragmented heaps or when recycling is not enough
+	if ((once == 1) && (theSize < (the->maximumChunksSize >> 4)) && (the->freeChunksSize < (the->maximumChunksSize >> 2))) {
+		fxCollect(the, mxCollectAndRecycle);
+		once = 2;
+	}
+	else if ((once == 1) || ((once == 2) && (aFree >= theSize))) {
+		fxCollect(the, mxCollectAndCompact);
 		once = 0;
 	}
 	else {
@@ -956,7 +990,7 @@ txSlot* fxNewSlot(txMachine* the)
 	
 #if mxStress
 	if (gxStress) {
-		fxCollect(the, 1);
+		fxCollect(the, (the->garbageCollectionCount & 1) ? mxCollectAndCompact : mxCollectSlots);
 		once = 0;
 	}
 #endif
@@ -970,12 +1004,16 @@ again:
 		the->currentHeapCount++;
 		if (the->peakHeapCount < the->currentHeapCount)
 			the->peakHeapCount = the->currentHeapCount;
+	#ifdef mxInstrument
+		if (the->allocationSites && ((the->allocationCountdown -= sizeof(txSlot)) <= 0))
+			fxSampleAllocation(the, 0);
+	#endif
 		return aSlot;
 	}
 	if (once) {
 		txBoolean wasThrashing = ((the->collectFlag & XS_TRASHING_FLAG) != 0), isThrashing;
 
-		fxCollect(the, 0);
+		fxCollect(the, mxCollectSlots);
 
 		isThrashing = ((the->collectFlag & XS_TRASHING_FLAG) != 0);
 		if (wasThrashing && isThrashing)
@@ -989,6 +1027,92 @@ again:
 	return C_NULL;
 }
 
+txByte* fxRecycleChunk(txMachine* the, txSize theSize)
+{
+	txByte* aData = the->recycledChunk;
+	txSize aSpareSize;
+	if (aData) {
+		aSpareSize = ((txChunk*)aData)->size - theSize;
+		if ((aSpareSize == 0) || (aSpareSize >= (txSize)sizeof(txChunk)))
+			goto carve;
+		the->recycledChunk = C_NULL;
+		fxDisposeChunk(the, aData, ((txChunk*)aData)->size);
+	}
+	{
+		txInteger aClass = fxGetFreeChunkClass(theSize);
+		while (aClass < mxFreeChunkClassCount) {
+			txByte** address = &(the->freeChunks[aClass]);
+			txInteger aCount = 4;
+			while ((aData = *address) && aCount) {
+				aSpareSize = ((txChunk*)aData)->size - theSize;
+				if ((aSpareSize == 0) || (aSpareSize >= (txSize)sizeof(txChunk))) {
+					*address = ((txChunk*)aData)->temporary;
+					goto carve;
+				}
+				address = &(((txChunk*)aData)->temporary);
+				aCount--;
+			}
+			aClass++;
+		}
+	}
+	return C_NULL;
+carve:
+	if (aSpareSize) {
+		txChunk* aChunk = (txChunk*)(aData + theSize);
+		aChunk->size = aSpareSize;
+		aChunk->temporary = C_NULL;
+		the->recycledChunk = (txByte*)aChunk;
+	}
+	else
+		the->recycledChunk = C_NULL;
+	the->freeChunksSize -= theSize;
+	return aData;
+}
+
+void fxRecycleChunks(txMachine* the, txBoolean keepYoung)
+{
+	txSize aTotal = 0;
+	txBlock* aBlock = the->firstBlock;
+	c_memset(the->freeChunks, 0, sizeof(the->freeChunks));
+	the->freeChunksSize = 0;
+	the->recycledChunk = C_NULL;
+	while (aBlock) {
+		txByte* mByte = ((txByte*)aBlock) + sizeof(txBlock);
+		txByte* nByte = aBlock->current;
+		txByte* pByte = C_NULL;
+		while (mByte < nByte) {
+			txChunk* aChunk = (txChunk*)mByte;
+			txSize aSize = aChunk->size;
+			if (aSize & mxChunkFlag) {
+				aSize &= ~mxChunkFlag;
+				aChunk->size = aSize;
+				aChunk->temporary = C_NULL;
+			}
+			else if (!keepYoung || (aChunk->temporary != mxYoungChunk)) {
+				if (!pByte)
+					pByte = mByte;
+				mByte += aSize;
+				continue;
+			}
+			if (pByte) {
+				fxDisposeChunk(the, pByte, (txSize)(mByte - pByte));
+				the->freeChunksSize += (txSize)(mByte - pByte);
+				pByte = C_NULL;
+			}
+			aTotal += aSize;
+			mByte += aSize;
+		}
+		if (pByte) {
+		#if mxFill
+			c_memset(pByte, 0xFF, nByte - pByte);
+		#endif
+			aBlock->current = pByte;
+		}
+		aBlock = aBlock->nextBlock;
+	}
+	the->currentChunksSize = aTotal;
+}
+
 void* fxRenewChunk(txMachine* the, void* theData, txSize theSize)
 {
 	txByte* aData = ((txByte*)theData) - sizeof(txChunk);
@@ -1012,6 +1136,10 @@ void* fxRenewChunk(txMachine* the, void* theData, txSize theSize)
 				the->currentChunksSize += theSize;
 				if (the->peakChunksSize < the->currentChunksSize)
 					the->peakChunksSize = the->currentChunksSize;
+			#ifdef mxInstrument
+				if (the->allocationSites && ((the->allocationCountdown -= theSize) <= 0))
+					fxSampleAllocation(the, 1);
+			#endif
 			#ifdef mxNever
 				gxRenewChunkCases[1]++;
 			#endif
@@ -1024,6 +1152,29 @@ void* fxRenewChunk(txMachine* the, void* theData, txSize theSize)
 				return C_NULL;
 			}
 		}
+		if ((((txByte*)aBlock) < aData) && (aData < aBlock->current)) {
+			txChunk* aSpare = (txChunk*)aData;
+			if ((theSize > 0) && (aSpare->temporary == mxSpareChunk)) {
+				txSize aSpareSize = aSpare->size - theSize;
+				if ((aSpareSize == 0) || (aSpareSize >= (txSize)sizeof(txChunk))) {
+					if (aSpareSize) {
+						aSpare = (txChunk*)(aData + theSize);
+						aSpare->size = aSpareSize;
+						aSpare->temporary = mxSpareChunk;
+					}
+					aChunk->size += theSize;
+					the->currentChunksSize += theSize;
+					if (the->peakChunksSize < the->currentChunksSize)
+						the->peakChunksSize = the->currentChunksSize;
+				#ifdef mxInstrument
+					if (the->allocationSites && ((the->allocationCountdown -= theSize) <= 0))
+						fxSampleAllocation(the, 1);
+				#endif
+					return theData;
+				}
+			}
+			break;
+		}
 		aBlock = aBlock->nextBlock;
 	}
 	if (theSize < 0) {
@@ -1033,7 +1184,7 @@ void* fxRenewChunk(txMachine* the, void* theData, txSize theSize)
 		aChunk->size += theSize;
 		aData += theSize;
 		((txChunk*)aData)->size = -theSize;
-		((txChunk*)aData)->temporary = C_NULL;
+		((txChunk*)aData)->temporary = mxSpareChunk;
 	#ifdef mxNever
 		gxRenewChunkCases[2]++;
 	#endif
@@ -1045,38 +1196,344 @@ void* fxRenewChunk(txMachine* the, void* theData, txSize theSize)
 	return C_NULL;
 }
 
+void* fxReserveChunk(txMachine* the, txSize theSize, txSize theCapacity)
+{
+	txByte* aData = (txByte*)fxNewChunk(the, theCapacity);
+	txChunk* aChunk = (txChunk*)(aData - sizeof(txChunk));
+	txSize aSize = mxRoundSize(theSize) + sizeof(txChunk);
+	txSize aSpareSize = aChunk->size - aSize;
+	if (aSpareSize >= (txSize)sizeof(txChunk)) {
+		aChunk->size = aSize;
+		aChunk = (txChunk*)(((txByte*)aChunk) + aSize);
+		aChunk->size = aSpareSize;
+		aChunk->temporary = mxSpareChunk;
+		the->currentChunksSize -= aSpareSize;
+	}
+	return aData;
+}
+
+void* fxSliceChunk(txMachine* the, void* theData, txSize theOffset)
+{
+	txByte* aData = ((txByte*)theData) - sizeof(txChunk);
+	txChunk* aChunk = (txChunk*)aData;
+	txBlock* aBlock = the->firstBlock;
+	if ((theOffset < (txSize)sizeof(txChunk)) || (theOffset != (txSize)mxRoundSize(theOffset)) || (aChunk->size - theOffset < (txSize)sizeof(txChunk)))
+		return C_NULL;
+	while (aBlock) {
+		if ((((txByte*)aBlock) < aData) && (aData < aBlock->current)) {
+			txSize aSize = aChunk->size - theOffset;
+			aChunk->size = theOffset;
+			aChunk->temporary = mxSpareChunk;
+			aChunk = (txChunk*)(aData + theOffset);
+			aChunk->size = aSize;
+			aChunk->temporary = C_NULL;
+			the->currentChunksSize -= theOffset;
+			return ((txByte*)theData) + theOffset;
+		}
+		aBlock = aBlock->nextBlock;
+	}
+	return C_NULL;
+}
+
+void fxProtect(txMachine* the, txBoolean theFlag)
+{
+#ifdef mxUseDefaultHeapProtection
+	txSlot* aHeap;
+
+	/* chunks stay writable, clones still write in place into the stacks of generators and the data of host objects */
+	aHeap = the->firstHeap;
+	while (aHeap) {
+		fxProtectHeap(the, aHeap, (txSize)((aHeap->value.reference - aHeap) * sizeof(txSlot)), theFlag);
+		aHeap = aHeap->next;
+	}
+	fxProtectHeap(the, the->stackBottom, (txSize)((the->stackTop - the->stackBottom) * sizeof(txSlot)), theFlag);
+#endif
+}
+
+#ifdef mxInstrument
+int fxCompareAllocationSites(const void* p, const void* q)
+{
+	txAllocationSite* a = *((txAllocationSite**)p);
+	txAllocationSite* b = *((txAllocationSite**)q);
+	txSize aSize = a->slotsSize + a->chunksSize;
+	txSize bSize = b->slotsSize + b->chunksSize;
+	return (aSize > bSize) ? -1 : (aSize < bSize) ? 1 : 0;
+}
+
+void fxReportAllocations(txMachine* the, txInteger count)
+{
+	txAllocationSite* site = the->allocationSites;
+	txAllocationSite* limit = site + mxAllocationSiteCount + 1;
+	txAllocationSite** sites;
+	txInteger length = 0, index;
+	txSize total = 0;
+	if (!site) {
+		fxReport(the, "# Allocations: not sampling\n");
+		return;
+	}
+	sites = c_malloc((mxAllocationSiteCount + 1) * sizeof(txAllocationSite*));
+	if (!sites)
+		return;
+	while (site < limit) {
+		if (site->sampleCount) {
+			sites[length++] = site;
+			total += site->slotsSize + site->chunksSize;
+		}
+		site++;
+	}
+	c_qsort(sites, length, sizeof(txAllocationSite*), fxCompareAllocationSites);
+	fxReport(the, "# Allocations: sampled every %ld bytes, %ld bytes in %ld sites\n", (long)the->allocationInterval, (long)total, (long)length);
+	if (count > length)
+		count = length;
+	for (index = 0; index < count; index++) {
+		txString name, path;
+		site = sites[index];
+		name = (site->name != XS_NO_ID) ? fxGetKeyName(the, site->name) : C_NULL;
+		path = (site->path != XS_NO_ID) ? fxGetKeyName(the, site->path) : C_NULL;
+		if (site == the->allocationSites + mxAllocationSiteCount)
+			name = "(other)";
+		else if (!name)
+			name = "(anonymous)";
+		if (path)
+			fxReport(the, "#   %ld bytes, %ld in slots, %ld in chunks: %s (%s:%ld)\n", (long)(site->slotsSize + site->chunksSize), (long)site->slotsSize, (long)site->chunksSize, name, path, (long)site->line);
+		else
+			fxReport(the, "#   %ld bytes, %ld in slots, %ld in chunks: %s\n", (long)(site->slotsSize + site->chunksSize), (long)site->slotsSize, (long)site->chunksSize, name);
+	}
+	c_free(sites);
+}
+
+void fxSampleAllocation(txMachine* the, txBoolean isChunk)
+{
+	txSize interval = the->allocationInterval;
+	txSize weight = ((0 - the->allocationCountdown) / interval + 1) * interval;
+	txSlot* frame = the->frame;
+	txID path = XS_NO_ID;
+	txID name = XS_NO_ID;
+	txInteger line = 0;
+	txAllocationSite* site;
+	txU4 index, probe;
+	the->allocationCountdown += weight;
+	while (frame) {
+		txSlot* environment = frame - 1;
+		txSlot* function = frame + 3;
+		if ((function->kind == XS_REFERENCE_KIND) && mxIsFunction(function->value.reference)) {
+			if ((name == XS_NO_ID) || (environment->ID != XS_NO_ID))
+				name = mxFunctionInstanceCode(function->value.reference)->ID;
+		}
+		if (environment->ID != XS_NO_ID) {
+			path = environment->ID;
+			line = environment->value.environment.line;
+			break;
+		}
+		frame = frame->next;
+	}
+	index = ((((txU4)(txU2)path * 31) + (txU4)line) * 31 + (txU4)(txU2)name) & (mxAllocationSiteCount - 1);
+	for (probe = 0; probe < mxAllocationSiteCount; probe++) {
+		site = the->allocationSites + index;
+		if (!site->sampleCount) {
+			site->path = path;
+			site->name = name;
+			site->line = line;
+			break;
+		}
+		if ((site->path == path) && (site->name == name) && (site->line == line))
+			break;
+		index = (index + 1) & (mxAllocationSiteCount - 1);
+	}
+	if (probe == mxAllocationSiteCount)
+		site = the->allocationSites + mxAllocationSiteCount;
+	site->sampleCount++;
+	if (isChunk)
+		site->chunksSize += weight;
+	else
+		site->slotsSize += weight;
+}
+#endif
+
+txBoolean fxIsFrozenInstance(txMachine* the, txSlot* instance)
+{
+	txSlot* property;
+	txSlot* item;
+	txIndex length;
+	if (!(instance->flag & XS_DONT_PATCH_FLAG))
+		return 0;
+	property = instance->next;
+	while (property) {
+		switch (property->kind) {
+		case XS_ARGUMENTS_SLOPPY_KIND:
+		case XS_ARGUMENTS_STRICT_KIND:
+		case XS_ARRAY_KIND:
+			if ((item = property->value.array.address)) {
+				length = fxGetIndexSize(the, property);
+				while (length) {
+					if ((item->kind != XS_ACCESSOR_KIND) && !(item->flag & XS_DONT_SET_FLAG))
+						return 0;
+					if (!(item->flag & XS_DONT_DELETE_FLAG))
+						return 0;
+					item++;
+					length--;
+				}
+			}
+			break;
+		case XS_ARRAY_BUFFER_KIND:
+		case XS_DATE_KIND:
+		case XS_GLOBAL_KIND:
+		case XS_HOST_KIND:
+		case XS_MAP_KIND:
+		case XS_PACKED_INTEGER_KIND:
+		case XS_PACKED_NUMBER_KIND:
+		case XS_PROMISE_KIND:
+		case XS_PROXY_KIND:
+		case XS_REGEXP_KIND:
+		case XS_SET_KIND:
+		case XS_STACK_KIND:
+		case XS_WEAK_MAP_KIND:
+		case XS_WEAK_SET_KIND:
+			/* internal state that freezing does not cover */
+			return 0;
+		}
+		if ((property->kind != XS_ACCESSOR_KIND) && !(property->flag & XS_DONT_SET_FLAG))
+			return 0;
+		if (!(property->flag & XS_DONT_DELETE_FLAG))
+			return 0;
+		property = property->next;
+	}
+	return 1;
+}
+
 void fxShare(txMachine* the)
 {
-	txID aliasCount = 0;
+	txInteger aliasCount = 0;
 	txSlot* aSlot;
 	txSlot* bSlot;
 	txSlot* cSlot;
+	txSlot* aProperty;
 
 	fxCollect(the, 1);
+	aSlot = the->freeHeap;
+	while (aSlot) {
+		aSlot->flag |= XS_MARK_FLAG;
+		aSlot = aSlot->next;
+	}
 	aSlot = the->firstHeap;
 	while (aSlot) {
 		bSlot = aSlot + 1;
 		cSlot = aSlot->value.reference;
 		while (bSlot < cSlot) {
-			if (bSlot->kind == XS_INSTANCE_KIND) {
-				bSlot->ID = aliasCount++;
-				bSlot->flag |= XS_MARK_FLAG; 
+			if (!(bSlot->flag & XS_MARK_FLAG)) {
+				fxShareValue(the, bSlot, &aliasCount);
+				if (bSlot->kind == XS_INSTANCE_KIND) {
+					aProperty = bSlot->next;
+					if (aProperty && ((aProperty->kind == XS_MODULE_KIND) || (aProperty->kind == XS_WITH_KIND)))
+						bSlot->ID = XS_NO_ID;
+					else if (fxIsFrozenInstance(the, bSlot))
+						bSlot->ID = XS_NO_ID;
+					else
+						bSlot->ID = (txID)aliasCount++;
+				}
 			}
-			
 			bSlot++;
 		}
 		aSlot = aSlot->next;
 	}
-	the->aliasCount = aliasCount;
+	aSlot = the->stack;
+	while (aSlot < the->stackTop) {
+		fxShareValue(the, aSlot, &aliasCount);
+		aSlot++;
+	}
+	if (aliasCount > 0x7FFF) {
+		fxReport(the, "# Share: too many instances and closures (%ld)\n", aliasCount);
+		fxJump(the);
+	}
+	aSlot = the->firstHeap;
+	while (aSlot) {
+		bSlot = aSlot + 1;
+		cSlot = aSlot->value.reference;
+		while (bSlot < cSlot) {
+			bSlot->flag |= XS_MARK_FLAG; 
+			bSlot++;
+		}
+		aSlot = aSlot->next;
+	}
+	the->aliasCount = (txID)aliasCount;
 	/*
 	fxReport(the, "# Share\n");
 	fxReport(the, "# \tSlots: %ld\n", the->currentHeapCount);
 	fxReport(the, "# \t\tSymbols: %ld\n", the->keyIndex);
-	fxReport(the, "# \t\tInstances: %ld\n", aliasCount);
+	fxReport(the, "# \t\tAliases: %ld\n", aliasCount);
 	fxReport(the, "# \tChunks: %ld bytes\n", the->currentChunksSize);
 	*/
 }
 
+void fxShareValue(txMachine* the, txSlot* theSlot, txInteger* theCount)
+{
+	txSlot* aSlot;
+	txIndex aLength;
+	switch (theSlot->kind) {
+	case XS_STRING_KIND:
+		theSlot->kind = XS_STRING_X_KIND;
+		break;
+	case XS_KEY_KIND:
+		theSlot->kind = XS_KEY_X_KIND;
+		break;
+	case XS_CODE_KIND:
+		theSlot->kind = XS_CODE_X_KIND;
+		break;
+	case XS_CALLBACK_KIND:
+		theSlot->kind = XS_CALLBACK_X_KIND;
+		break;
+	case XS_CLOSURE_KIND:
+		aSlot = theSlot->value.closure;
+		goto closure;
+	case XS_EXPORT_KIND:
+		aSlot = theSlot->value.export.closure;
+	closure:
+		if (aSlot && !(aSlot->flag & (XS_ALIAS_FLAG | XS_DONT_SET_FLAG))) {
+			aSlot->flag |= XS_ALIAS_FLAG;
+			aSlot->ID = (txID)(*theCount)++;
+		}
+		break;
+	case XS_ARGUMENTS_SLOPPY_KIND:
+	case XS_ARGUMENTS_STRICT_KIND:
+	case XS_ARRAY_KIND:
+	case XS_STACK_KIND:
+		if ((aSlot = theSlot->value.array.address)) {
+			aLength = (((txChunk*)(((txByte*)aSlot) - sizeof(txChunk)))->size) / sizeof(txSlot);
+			while (aLength) {
+				fxShareValue(the, aSlot, theCount);
+				aSlot++;
+				aLength--;
+			}
+		}
+		break;
+	}
+}
+#ifdef mxInstrument
+void fxStartAllocationSampling(txMachine* the, txSize interval)
+{
+	if (interval <= 0)
+		interval = mxAllocationInterval;
+	if (!the->allocationSites) {
+		the->allocationSites = c_calloc(mxAllocationSiteCount + 1, sizeof(txAllocationSite));
+		if (!the->allocationSites)
+			return;
+	}
+	else
+		c_memset(the->allocationSites, 0, (mxAllocationSiteCount + 1) * sizeof(txAllocationSite));
+	the->allocationInterval = interval;
+	the->allocationCountdown = interval;
+}
+
+void fxStopAllocationSampling(txMachine* the)
+{
+	if (the->allocationSites)
+		c_free(the->allocationSites);
+	the->allocationSites = C_NULL;
+	the->allocationInterval = 0;
+	the->allocationCountdown = 0;
+}
+#endif
+
 void fxSweep(txMachine* the)
 {
 	txSize aTotal;
@@ -1111,12 +1568,17 @@ void fxSweep(txMachine* the)
 				pByte += aSize;
 				aTotal += aSize;
 			}
+			else
+				((txChunk*)mByte)->temporary = C_NULL;
 			mByte += aSize;
 		}	
 		aBlock->temporary = pByte;
 		aBlock = aBlock->nextBlock;
 	}
 	the->currentChunksSize = aTotal;
+	c_memset(the->freeChunks, 0, sizeof(the->freeChunks));
+	the->freeChunksSize = 0;
+	the->recycledChunk = C_NULL;
 
 	aCodeAddress = &(the->code);
 	aSlot = the->frame;
@@ -1284,6 +1746,11 @@ void fxSweepValue(txMachine* the, txSlot* theSlot)
 			mxSweepChunk(theSlot->value.array.address, txSlot*);
 		}
 		break;
+	case XS_PACKED_INTEGER_KIND:
+	case XS_PACKED_NUMBER_KIND:
+		if (theSlot->value.array.address)
+			mxSweepChunk(theSlot->value.array.address, txSlot*);
+		break;
 	case XS_ARRAY_BUFFER_KIND:
 		if (theSlot->value.arrayBuffer.address)
 			mxSweepChunk(theSlot->value.arrayBuffer.address, txByte*);
@@ -1324,3 +1791,383 @@ void fxSweepValue(txMachine* the, txSlot* theSlot)
 		break;
 	}
 }
+
+#ifdef mxInstrument
+struct sxHeapWriter {
+	void* stream;
+	txBoolean (*write)(void* stream, void* address, size_t size);
+	txBoolean error;
+	txU1* names;
+	void** addresses;
+	txSize addressCount;
+	txSize addressLength;
+	txSlot* owner;
+	txSize size;
+	txInteger offset;
+	txU1 buffer[1024];
+};
+
+txSize fxGetHeapChunkSize(void* data)
+{
+	return ((txChunk*)(((txByte*)data) - sizeof(txChunk)))->size;
+}
+
+void fxWriteHeapByte(txHeapWriter* writer, txU1 value)
+{
+	if (writer->offset == sizeof(writer->buffer)) {
+		if (!writer->error && !(*writer->write)(writer->stream, writer->buffer, writer->offset))
+			writer->error = 1;
+		writer->offset = 0;
+	}
+	writer->buffer[writer->offset++] = value;
+}
+
+void fxWriteHeapEdge(txHeapWriter* writer, void* from, void* to, txU1 kind, txUnsigned name)
+{
+	fxWriteHeapByte(writer, XS_HEAP_EDGE_RECORD);
+	fxWriteHeapNumber(writer, (uintptr_t)from);
+	fxWriteHeapNumber(writer, (uintptr_t)to);
+	fxWriteHeapByte(writer, kind);
+	fxWriteHeapNumber(writer, name);
+}
+
+void fxWriteHeapMarker(txMachine* the, txSlot* slot)
+{
+	txHeapWriter* writer = the->heapWriter;
+	writer->size += fxWriteHeapValue(the, writer, writer->owner, slot, XS_HEAP_INTERNAL_EDGE, 0);
+}
+
+txUnsigned fxWriteHeapName(txMachine* the, txHeapWriter* writer, txID id)
+{
+	txInteger index;
+	txString string;
+	txSize length;
+	if (id == XS_NO_ID)
+		return 0;
+	index = id & 0x7FFF;
+	if (index >= the->keyCount)
+		return 0;
+	if (!(writer->names[index >> 3] & (1 << (index & 7)))) {
+		writer->names[index >> 3] |= 1 << (index & 7);
+		string = fxGetKeyName(the, id);
+		length = string ? c_strlen(string) : 0;
+		fxWriteHeapByte(writer, XS_HEAP_NAME_RECORD);
+		fxWriteHeapNumber(writer, index + 1);
+		fxWriteHeapNumber(writer, length);
+		while (length) {
+			fxWriteHeapByte(writer, (txU1)*string++);
+			length--;
+		}
+	}
+	return index + 1;
+}
+
+void fxWriteHeapNode(txHeapWriter* writer, void* address, txU1 kind, txSize size, txUnsigned name)
+{
+	fxWriteHeapByte(writer, XS_HEAP_NODE_RECORD);
+	fxWriteHeapNumber(writer, (uintptr_t)address);
+	fxWriteHeapByte(writer, kind);
+	fxWriteHeapNumber(writer, size);
+	fxWriteHeapNumber(writer, name);
+}
+
+void fxWriteHeapNumber(txHeapWriter* writer, uintptr_t value)
+{
+	while (value >= 0x80) {
+		fxWriteHeapByte(writer, (txU1)(value | 0x80));
+		value >>= 7;
+	}
+	fxWriteHeapByte(writer, (txU1)value);
+}
+
+txBoolean fxWriteHeapSnapshot(txMachine* the, void* stream, txBoolean (*write)(void* stream, void* address, size_t size))
+{
+	txHeapWriter _writer;
+	txHeapWriter* writer = &_writer;
+	txSize size = 0;
+	txSlot** keys;
+	txInteger index;
+	txSlot* slot;
+	txSlot* heap;
+
+	fxCollect(the, 1);
+	c_memset(writer, 0, sizeof(txHeapWriter));
+	writer->stream = stream;
+	writer->write = write;
+	writer->names = c_calloc((the->keyCount + 7) >> 3, 1);
+	writer->addressLength = 1024;
+	writer->addresses = c_calloc(writer->addressLength, sizeof(void*));
+	if (!writer->names || !writer->addresses)
+		writer->error = 1;
+	else {
+		the->heapWriter = writer;
+		
+		fxWriteHeapByte(writer, 'X');
+		fxWriteHeapByte(writer, 'S');
+		fxWriteHeapByte(writer, 'H');
+		fxWriteHeapByte(writer, 'P');
+		fxWriteHeapByte(writer, XS_HEAP_SNAPSHOT_VERSION);
+	
+		keys = the->keyArray;
+		for (index = the->keyOffset; index < the->keyIndex; index++) {
+			if ((slot = *keys)) {
+				size += sizeof(txSlot);
+				if ((slot->kind == XS_KEY_KIND) && slot->value.key.string)
+					size += fxGetHeapChunkSize(slot->value.key.string);
+			}
+			keys++;
+		}
+		slot = the->stack;
+		while (slot < the->stackTop) {
+			size += fxWriteHeapValue(the, writer, C_NULL, slot, XS_HEAP_INTERNAL_EDGE, 0);
+			slot++;
+		}
+		slot = the->cRoot;
+		while (slot) {
+			size += fxWriteHeapValue(the, writer, C_NULL, slot, XS_HEAP_INTERNAL_EDGE, 0);
+			slot = slot->next;
+		}
+		fxWriteHeapNode(writer, C_NULL, XS_HEAP_ROOT_NODE, size, 0);
+	
+		heap = the->firstHeap;
+		while (heap) {
+			slot = heap + 1;
+			while (slot < heap->value.reference) {
+				if (slot->kind == XS_INSTANCE_KIND)
+					fxWriteHeapInstance(the, writer, slot);
+				slot++;
+			}
+			heap = heap->next;
+		}
+		if (writer->offset && !writer->error && !(*writer->write)(writer->stream, writer->buffer, writer->offset))
+			writer->error = 1;
+		the->heapWriter = C_NULL;
+	}
+	if (writer->addresses)
+		c_free(writer->addresses);
+	if (writer->names)
+		c_free(writer->names);
+	return writer->error ? 0 : 1;
+}
+
+void fxWriteHeapInstance(txMachine* the, txHeapWriter* writer, txSlot* instance)
+{
+	txSlot* prototype = instance->value.instance.prototype;
+	txSlot* property = instance->next;
+	txU1 kind = XS_HEAP_OBJECT_NODE;
+	txID name = XS_NO_ID;
+	txSize size = sizeof(txSlot);
+	if (prototype)
+		fxWriteHeapEdge(writer, instance, prototype, XS_HEAP_PROTOTYPE_EDGE, 0);
+	if (mxIsFunction(instance)) {
+		kind = XS_HEAP_FUNCTION_NODE;
+		name = mxFunctionInstanceCode(instance)->ID;
+	}
+	else if (property && (property->ID == XS_ARRAY_BEHAVIOR) && (instance->flag & XS_EXOTIC_FLAG))
+		kind = XS_HEAP_ARRAY_NODE;
+	else if (property && (property->flag & XS_INTERNAL_FLAG) && (property->kind == XS_HOST_KIND))
+		kind = XS_HEAP_HOST_NODE;
+	if ((kind != XS_HEAP_FUNCTION_NODE) && prototype) {
+		txSlot* constructor = prototype->next;
+		while (constructor) {
+			if (constructor->ID == mxID(_constructor)) {
+				if ((constructor->kind == XS_REFERENCE_KIND) && mxIsFunction(constructor->value.reference))
+					name = mxFunctionInstanceCode(constructor->value.reference)->ID;
+				break;
+			}
+			constructor = constructor->next;
+		}
+	}
+	while (property) {
+		size += sizeof(txSlot);
+		size += fxWriteHeapValue(the, writer, instance, property, (property->flag & XS_INTERNAL_FLAG) ? XS_HEAP_INTERNAL_EDGE : XS_HEAP_PROPERTY_EDGE, fxWriteHeapName(the, writer, property->ID));
+		property = property->next;
+	}
+	fxWriteHeapNode(writer, instance, kind, size, fxWriteHeapName(the, writer, name));
+}
+
+txSize fxWriteHeapValue(txMachine* the, txHeapWriter* writer, txSlot* owner, txSlot* slot, txU1 kind, txUnsigned name)
+{
+	txSize size = 0;
+	txSlot* target;
+	switch (slot->kind) {
+	case XS_STRING_KIND:
+		fxWriteHeapEdge(writer, owner, slot->value.string, kind, name);
+		if (fxVisitHeapAddress(writer, slot->value.string))
+			fxWriteHeapNode(writer, slot->value.string, XS_HEAP_STRING_NODE, fxGetHeapChunkSize(slot->value.string), 0);
+		break;
+	case XS_REFERENCE_KIND:
+	case XS_WITH_KIND:
+		if ((target = slot->value.reference))
+			fxWriteHeapEdge(writer, owner, target, kind, name);
+		break;
+	case XS_CLOSURE_KIND:
+		if ((target = slot->value.closure)) {
+			fxWriteHeapEdge(writer, owner, target, kind, name);
+			if (fxVisitHeapAddress(writer, target))
+				fxWriteHeapNode(writer, target, XS_HEAP_CLOSURE_NODE, sizeof(txSlot) + fxWriteHeapValue(the, writer, target, target, XS_HEAP_INTERNAL_EDGE, 0), name);
+		}
+		break;
+	case XS_ACCESSOR_KIND:
+		if ((target = slot->value.accessor.getter))
+			fxWriteHeapEdge(writer, owner, target, kind, name);
+		if ((target = slot->value.accessor.setter))
+			fxWriteHeapEdge(writer, owner, target, kind, name);
+		break;
+	case XS_ARGUMENTS_SLOPPY_KIND:
+	case XS_ARGUMENTS_STRICT_KIND:
+	case XS_ARRAY_KIND:
+	case XS_STACK_KIND:
+		if ((target = slot->value.array.address)) {
+			txIndex length = fxGetHeapChunkSize(target) / sizeof(txSlot), index;
+			size += fxGetHeapChunkSize(target);
+			for (index = 0; index < length; index++) {
+				size += fxWriteHeapValue(the, writer, owner, target, XS_HEAP_ELEMENT_EDGE, index);
+				target++;
+			}
+		}
+		break;
+	case XS_PACKED_INTEGER_KIND:
+	case XS_PACKED_NUMBER_KIND:
+		if (slot->value.array.address)
+			size += fxGetHeapChunkSize(slot->value.array.address);
+		break;
+	case XS_ARRAY_BUFFER_KIND:
+		if (slot->value.arrayBuffer.address)
+			size += fxGetHeapChunkSize(slot->value.arrayBuffer.address);
+		break;
+	case XS_CALLBACK_KIND:
+		if (slot->value.callback.IDs)
+			size += fxGetHeapChunkSize(slot->value.callback.IDs);
+		break;
+	case XS_CODE_KIND:
+		size += fxGetHeapChunkSize(slot->value.code.address);
+		/* continue */
+	case XS_CODE_X_KIND:
+		if ((target = slot->value.code.closures))
+			fxWriteHeapEdge(writer, owner, target, XS_HEAP_INTERNAL_EDGE, 0);
+		break;
+	case XS_GLOBAL_KIND:
+		size += fxGetHeapChunkSize(slot->value.table.address);
+		break;
+	case XS_HOST_KIND:
+		if (slot->value.host.data) {
+			if ((slot->flag & XS_HOST_HOOKS_FLAG) && (slot->value.host.variant.hooks->marker)) {
+				txSlot* formerOwner = writer->owner;
+				txSize formerSize = writer->size;
+				writer->owner = owner;
+				writer->size = 0;
+				(*slot->value.host.variant.hooks->marker)(the, slot->value.host.data, fxWriteHeapMarker);
+				size += writer->size;
+				writer->owner = formerOwner;
+				writer->size = formerSize;
+			}
+			if (slot->flag & XS_HOST_CHUNK_FLAG)
+				size += fxGetHeapChunkSize(slot->value.host.data);
+		}
+		break;
+	case XS_PROXY_KIND:
+		if ((target = slot->value.proxy.handler))
+			fxWriteHeapEdge(writer, owner, target, XS_HEAP_INTERNAL_EDGE, 0);
+		if ((target = slot->value.proxy.target))
+			fxWriteHeapEdge(writer, owner, target, XS_HEAP_INTERNAL_EDGE, 0);
+		break;
+	case XS_REGEXP_KIND:
+		if (slot->value.regexp.code)
+			size += fxGetHeapChunkSize(slot->value.regexp.code);
+		if (slot->value.regexp.data)
+			size += fxGetHeapChunkSize(slot->value.regexp.data);
+		break;
+	case XS_HOME_KIND:
+		if ((target = slot->value.home.object))
+			fxWriteHeapEdge(writer, owner, target, XS_HEAP_INTERNAL_EDGE, 0);
+		if ((target = slot->value.home.module))
+			fxWriteHeapEdge(writer, owner, target, XS_HEAP_INTERNAL_EDGE, 0);
+		break;
+	case XS_EXPORT_KIND:
+		if ((target = slot->value.export.closure)) {
+			fxWriteHeapEdge(writer, owner, target, kind, name);
+			if (fxVisitHeapAddress(writer, target))
+				fxWriteHeapNode(writer, target, XS_HEAP_CLOSURE_NODE, sizeof(txSlot) + fxWriteHeapValue(the, writer, target, target, XS_HEAP_INTERNAL_EDGE, 0), name);
+		}
+		if ((target = slot->value.export.module))
+			fxWriteHeapEdge(writer, owner, target, XS_HEAP_INTERNAL_EDGE, 0);
+		break;
+	case XS_KEY_KIND:
+		if (slot->value.key.string)
+			size += fxGetHeapChunkSize(slot->value.key.string);
+		break;
+	case XS_LIST_KIND:
+		target = slot->value.list.first;
+		while (target) {
+			size += sizeof(txSlot) + fxWriteHeapValue(the, writer, owner, target, XS_HEAP_INTERNAL_EDGE, fxWriteHeapName(the, writer, target->ID));
+			target = target->next;
+		}
+		break;
+	case XS_MAP_KIND:
+	case XS_SET_KIND:
+	case XS_WEAK_MAP_KIND:
+	case XS_WEAK_SET_KIND:
+		{
+			txSlot** address = slot->value.table.address;
+			txInteger length = slot->value.table.length;
+			size += fxGetHeapChunkSize(address);
+			while (length) {
+				target = *address;
+				while (target) {
+					size += sizeof(txSlot);
+					if (slot->kind == XS_WEAK_MAP_KIND) {
+						txSlot* value = target->value.entry.slot->next;
+						size += 2 * sizeof(txSlot) + fxWriteHeapValue(the, writer, owner, value, XS_HEAP_INTERNAL_EDGE, 0);
+					}
+					else if (slot->kind == XS_WEAK_SET_KIND)
+						size += sizeof(txSlot);
+					target = target->next;
+				}
+				address++;
+				length--;
+			}
+		}
+		break;
+	}
+	return size;
+}
+
+txBoolean fxVisitHeapAddress(txHeapWriter* writer, void* address)
+{
+	txSize mask, index;
+	if (writer->error)
+		return 0;
+	if ((writer->addressCount + 1) * 2 > writer->addressLength) {
+		txSize length = writer->addressLength * 2, i;
+		void** addresses = c_calloc(length, sizeof(void*));
+		if (!addresses) {
+			writer->error = 1;
+			return 0;
+		}
+		mask = length - 1;
+		for (i = 0; i < writer->addressLength; i++) {
+			void* former = writer->addresses[i];
+			if (former) {
+				index = (txSize)(((uintptr_t)former >> 3) & mask);
+				while (addresses[index])
+					index = (index + 1) & mask;
+				addresses[index] = former;
+			}
+		}
+		c_free(writer->addresses);
+		writer->addresses = addresses;
+		writer->addressLength = length;
+	}
+	mask = writer->addressLength - 1;
+	index = (txSize)(((uintptr_t)address >> 3) & mask);
+	while (writer->addresses[index]) {
+		if (writer->addresses[index] == address)
+			return 0;
+		index = (index + 1) & mask;
+	}
+	writer->addresses[index] = address;
+	writer->addressCount++;
+	return 1;
+}
+#endif
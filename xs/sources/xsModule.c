@@ -345,8 +345,8 @@ void fx_require(txMachine* the)
 		while (export) {
 			mxCheck(the, export->kind == XS_EXPORT_KIND);
 			if (export->ID == defaultID) {
-				mxResult->kind = export->value.export.closure->kind;
-				mxResult->value = export->value.export.closure->value;
+				mxResult->kind = mxAliasClosure(export->value.export.closure)->kind;
+				mxResult->value = mxAliasClosure(export->value.export.closure)->value;
 				break;
 			}
 			export = export->next;
@@ -1065,6 +1065,8 @@ txSlot* fxModuleGetProperty(txMachine* the, txSlot* instance, txID id, txIndex i
 		while (property) {
 			if (property->ID == id) {
 				property = property->value.export.closure;
+				if (property)
+					property = mxAliasClosure(property);
 				if (property && (property->kind == XS_UNINITIALIZED_KIND)) {
 					fxIDToString(the, id, the->nameBuffer, sizeof(the->nameBuffer));
 					mxReferenceError("get %s: not initialized yet", the->nameBuffer);
@@ -236,6 +236,8 @@ void fx_Object_prototype_toLocaleString(txMachine* the)
 
 void fx_Object_prototype_toPrimitive(txMachine* the)
 {
+	/* no pointer to the stack is kept over calls to valueOf and toString */
+	the->frame->flag |= XS_MOVABLE_FLAG;
 	if (mxThis->kind == XS_REFERENCE_KIND) {
 		txInteger hint = XS_NO_HINT;
 		txInteger ids[2], i;
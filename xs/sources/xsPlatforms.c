@@ -154,6 +154,23 @@ void fxFreeSlots(txMachine* the, void* theSlots)
 #endif /* mxUseDefaultSlotAllocation */ 
 
 
+#ifdef mxUseDefaultHeapProtection
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+void fxProtectHeap(txMachine* the, void* theAddress, txSize theSize, txBoolean theFlag)
+{
+	uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+	uintptr_t from = ((uintptr_t)theAddress + page - 1) & ~(page - 1);
+	uintptr_t to = ((uintptr_t)theAddress + theSize) & ~(page - 1);
+	if (from < to)
+		mprotect((void*)from, to - from, theFlag ? PROT_READ : PROT_READ | PROT_WRITE);
+}
+
+#endif /* mxUseDefaultHeapProtection */ 
+
+
 #if mxUseDefaultHostCollection
 
 void fxMarkHost(txMachine* the, txMarkRoot markRoot)
@@ -46,6 +46,7 @@ static void fxBuildPromiseCapability(txMachine* the);
 static void fxCallPromise(txMachine* the);
 static void fxCallPromiseAll(txMachine* the);
 static void fxCheckPromiseCapability(txMachine* the, txSlot* capability, txSlot** resolveFunction, txSlot** rejectFunction);
+static void fxPerformPromiseThen(txMachine* the, txSlot* promise, txSlot* onFullfilled, txSlot* onRejected, txSlot* resolveFunction, txSlot* rejectFunction);
 static void fxQueueJob(txMachine* the, txID id);
 
 void fxBuildPromise(txMachine* the)
@@ -80,6 +81,51 @@ void fxBuildPromise(txMachine* the)
 	the->stack++;
 }
 
+void fxAwaitPromise(txMachine* the, txSlot* value, txSlot* onFullfilled, txSlot* onRejected)
+{
+	txSlot* promise;
+	if (mxIsReference(value)) {
+		promise = value->value.reference;
+		if (mxIsPromise(promise)) {
+			mxPushReference(promise);
+			fxGetID(the, mxID(_constructor));
+			if (fxIsSameValue(the, &mxPromiseConstructor, the->stack, 0)) {
+				mxPop();
+				fxPerformPromiseThen(the, promise, onFullfilled, onRejected, C_NULL, C_NULL);
+				return;
+			}
+			mxPop();
+		}
+		mxPush(mxPromisePrototype);
+		promise = fxNewPromiseInstance(the);
+		mxPromiseStatus(promise)->value.integer = mxPendingStatus;
+		mxPushSlot(value);
+		/* COUNT */
+		mxPushInteger(1);
+		/* THIS */
+		mxPushReference(promise);
+		/* FUNCTION */
+		mxPush(mxResolvePromiseFunction);
+		fxCall(the);
+		mxPop();
+		fxPerformPromiseThen(the, promise, onFullfilled, onRejected, C_NULL, C_NULL);
+		mxPop(); // promise
+	}
+	else {
+		// the promise would be already fulfilled, queue the reaction job directly
+		mxPushSlot(value);
+		/* COUNT */
+		mxPushInteger(1);
+		/* THIS */
+		mxPushUndefined();
+		/* FUNCTION */
+		mxPushReference(onFullfilled);
+		/* TARGET */
+		mxPushUndefined();
+		fxQueueJob(the, XS_NO_ID);
+	}
+}
+
 void fxPushSpeciesConstructor(txMachine* the, txSlot* constructor)
 {
 	mxPushSlot(mxThis);
@@ -336,6 +382,8 @@ void fxOnRejectedPromise(txMachine* the)
 			*argument = mxException;
 		}
 	}
+	if (function->kind == XS_UNDEFINED_KIND)
+		return;
 	mxPushSlot(argument);
 	/* COUNT */
 	mxPushInteger(1);
@@ -372,6 +420,8 @@ void fxOnResolvedPromise(txMachine* the)
 			function = rejectFunction;
 		}
 	}
+	if (function->kind == XS_UNDEFINED_KIND)
+		return;
 	mxPushSlot(argument);
 	/* COUNT */
 	mxPushInteger(1);
@@ -850,9 +900,6 @@ void fx_Promise_prototype_then(txMachine* the)
 	txSlot* capability;
 	txSlot* resolveFunction;
 	txSlot* rejectFunction;
-	txSlot* reaction;
-	txSlot* slot;
-	txSlot* status;
 
 	if (!mxIsReference(mxThis))
 		mxTypeError("this is no object");
@@ -867,23 +914,36 @@ void fx_Promise_prototype_then(txMachine* the)
 	fxNew(the);
 	mxPullSlot(mxResult);
 	fxCheckPromiseCapability(the, capability, &resolveFunction, &rejectFunction);
-		
+	fxPerformPromiseThen(the, promise, ((mxArgc > 0) && mxIsReference(mxArgv(0))) ? mxArgv(0)->value.reference : C_NULL, ((mxArgc > 1) && mxIsReference(mxArgv(1))) ? mxArgv(1)->value.reference : C_NULL, resolveFunction, rejectFunction);
+	mxPop(); // capability
+}
+
+void fxPerformPromiseThen(txMachine* the, txSlot* promise, txSlot* onFullfilled, txSlot* onRejected, txSlot* resolveFunction, txSlot* rejectFunction)
+{
+	txSlot* reaction;
+	txSlot* slot;
+	txSlot* status;
+	
 	reaction = fxNewInstance(the);
 	slot = reaction->next = fxNewSlot(the);
-	slot->kind = XS_REFERENCE_KIND;
-	slot->value.reference = resolveFunction;
+	if (resolveFunction) {
+		slot->kind = XS_REFERENCE_KIND;
+		slot->value.reference = resolveFunction;
+	}
 	slot = slot->next = fxNewSlot(the);
-	slot->kind = XS_REFERENCE_KIND;
-	slot->value.reference = rejectFunction;
+	if (rejectFunction) {
+		slot->kind = XS_REFERENCE_KIND;
+		slot->value.reference = rejectFunction;
+	}
 	slot = slot->next = fxNewSlot(the);
-	if ((mxArgc > 0) && mxIsReference(mxArgv(0))) {
+	if (onFullfilled) {
 		slot->kind = XS_REFERENCE_KIND;
-		slot->value.reference = mxArgv(0)->value.reference;
+		slot->value.reference = onFullfilled;
 	}
 	slot = slot->next = fxNewSlot(the);
-	if ((mxArgc > 1) && mxIsReference(mxArgv(1))) {
+	if (onRejected) {
 		slot->kind = XS_REFERENCE_KIND;
-		slot->value.reference = mxArgv(1)->value.reference;
+		slot->value.reference = onRejected;
 	}
 		
 	status = mxPromiseStatus(promise);
@@ -912,7 +972,6 @@ void fx_Promise_prototype_then(txMachine* the)
 		fxQueueJob(the, XS_NO_ID);
 	}
 	mxPop(); // reaction
-	mxPop(); // capability
 }
 
 void fxQueueJob(txMachine* the, txID id)
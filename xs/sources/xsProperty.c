@@ -246,9 +246,15 @@ txBoolean fxDeleteIndexProperty(txMachine* the, txSlot* array, txIndex index)
 		if (result < limit) {
 			if (result->flag & XS_DONT_DELETE_FLAG)
 				return 0;
+			if (length == size)
+				fxIndexArray(the, array);
 			size--;
 			if (size > 0) {
+				txSize offset = result - address;
 				chunk = (txSlot*)fxNewChunk(the, size * sizeof(txSlot));
+				address = array->value.array.address;
+				result = address + offset;
+				limit = address + size + 1;
 				if (result > address)
 					c_memcpy(chunk, address, (result - address) * sizeof(txSlot));
 				result++;
@@ -299,12 +305,20 @@ txIndex fxGetIndexSize(txMachine* the, txSlot* array)
 txSlot* fxQueueIndexKeys(txMachine* the, txSlot* array, txFlag flag, txSlot* keys)
 {
 	if (flag & XS_EACH_NAME_FLAG) {
-		if (array->value.array.address) {
+		if (mxIsPackedArray(array)) {
+			txIndex index = 0, length = array->value.array.length;
+			while (index < length) {
+				keys = fxQueueKey(the, 0, index, keys);
+				index++;
+			}
+		}
+		else if (array->value.array.address) {
 			txSize offset = 0;
 			txSize size = (((txChunk*)(((txByte*)array->value.array.address) - sizeof(txChunk)))->size) / sizeof(txSlot);
+			txBoolean dense = (array->value.array.length == (txIndex)size) ? 1 : 0;
 			while (offset < size) {
 				txSlot* slot = array->value.array.address + offset;
-				txIndex index = *((txIndex*)slot);
+				txIndex index = (dense) ? (txIndex)offset : *((txIndex*)slot);
 				keys = fxQueueKey(the, 0, index, keys);
 				offset++;
 			}
@@ -331,10 +345,12 @@ txSlot* fxSetIndexProperty(txMachine* the, txSlot* instance, txSlot* array, txIn
 				return C_NULL;
 			if (array->flag & XS_DONT_SET_FLAG)
 				return C_NULL;
+			if (index > length)
+				fxIndexArray(the, array);
 			size++;
 			chunk = (txSlot*)fxRenewChunk(the, address, size * sizeof(txSlot));
 			if (!chunk) {
-				chunk = (txSlot*)fxNewChunk(the, size * sizeof(txSlot));
+				chunk = (txSlot*)fxReserveChunk(the, size * sizeof(txSlot), mxIndexCapacity(size) * sizeof(txSlot));
 				address = array->value.array.address;
 				c_memcpy(chunk, address, length * sizeof(txSlot));
 			}
@@ -391,9 +407,13 @@ txSlot* fxSetIndexProperty(txMachine* the, txSlot* instance, txSlot* array, txIn
 
 void fxSetIndexSize(txMachine* the, txSlot* array, txIndex target)
 {
-	txSlot* address = array->value.array.address;
+	txSlot* address;
 	txSlot* chunk = C_NULL;
-	txIndex size = (address) ? (((txChunk*)(((txByte*)address) - sizeof(txChunk)))->size) / sizeof(txSlot) : 0;
+	txIndex size;
+	if (mxIsPackedArray(array))
+		fxUnpackArray(the, array);
+	address = array->value.array.address;
+	size = (address) ? (((txChunk*)(((txByte*)address) - sizeof(txChunk)))->size) / sizeof(txSlot) : 0;
 	if (size != target) {
 		if (array->flag & XS_DONT_SET_FLAG)
 			mxTypeError("set length: not writable");
@@ -401,7 +421,7 @@ void fxSetIndexSize(txMachine* the, txSlot* array, txIndex target)
 			if (target) {
 				chunk = (txSlot*)fxRenewChunk(the, address, target * sizeof(txSlot));
 				if (!chunk) {
-					chunk = (txSlot*)fxNewChunk(the, target * sizeof(txSlot));
+					chunk = (txSlot*)fxReserveChunk(the, target * sizeof(txSlot), ((size < target) ? mxIndexCapacity(target) : target) * sizeof(txSlot));
 					address = array->value.array.address;
 					if (size < target)
 						c_memcpy(chunk, address, size * sizeof(txSlot));
@@ -410,7 +410,7 @@ void fx_RegExp_prototype_exec(txMachine* the)
 {
 #if mxRegExp
 	txSlot* instance = fxCheckRegExpInstance(the, mxThis);
-	txSlot* regexp = instance->next;
+	txSlot* regexp;
 	txSlot* argument;
 	txInteger lastIndex;
 	txInteger flags;
@@ -433,6 +433,10 @@ void fx_RegExp_prototype_exec(txMachine* the)
 	if (lastIndex < 0)
 		lastIndex = 0;
 
+	/* matching writes the captures into the data of the regexp */
+	if (instance->ID >= 0)
+		instance = fxAliasInstance(the, instance);
+	regexp = instance->next;
 	flags = regexp->value.regexp.code[0];
 	globalFlag = (flags & XS_REGEXP_G) ? 1 : 0;
 	namedFlag = (flags & XS_REGEXP_N) ? 1 : 0;
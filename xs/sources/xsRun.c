@@ -54,6 +54,7 @@ static void fxRunForOf(txMachine* the);
 static void fxRunIn(txMachine* the);
 static void fxRunProxy(txMachine* the, txSlot* instance);
 static void fxRunInstanceOf(txMachine* the);
+static void fxRunPrimitive(txMachine* the, txSlot* slot, txInteger hint);
 static txBoolean fxIsScopableSlot(txMachine* the, txSlot* instance, txID id);
 
 #if defined(__GNUC__) && defined(__OPTIMIZE__)
@@ -137,6 +138,14 @@ static txBoolean fxIsScopableSlot(txMachine* the, txSlot* instance, txID id);
 	mxStack -= _COUNT
 #endif
 
+#define mxStackMargin 64
+#define mxGrowStack(_COUNT) \
+	if ((mxStack - (_COUNT)) < the->stackBottom) { \
+		mxSaveState; \
+		fxGrowStack(the, _COUNT); \
+		mxRestoreState; \
+	}
+
 #define mxPushKind(_KIND) { \
 	mxOverflow(1); \
 	mxStack->next = C_NULL;  \
@@ -155,6 +164,17 @@ static txBoolean fxIsScopableSlot(txMachine* the, txSlot* instance, txID id);
 	fxThrowMessage(the, NULL, 0, _ERROR, _MESSAGE, the->nameBuffer); \
 }
 
+#define mxToPrimitive(SLOT, HINT) \
+	if (XS_REFERENCE_KIND == (SLOT)->kind) { \
+		txSlot* former = the->stackTop; \
+		txSlot* bottom = the->stackBottom; \
+		mxSaveState; \
+		fxRunPrimitive(the, SLOT, HINT); \
+		mxRestoreState; \
+		if ((bottom <= slot) && (slot < former)) \
+			slot = the->stackTop - (former - slot); \
+	}
+
 #define mxToBoolean(SLOT) \
 	if (XS_BOOLEAN_KIND != (SLOT)->kind) { \
 		if (XS_SYMBOL_KIND <= (SLOT)->kind) { \
@@ -169,6 +189,7 @@ static txBoolean fxIsScopableSlot(txMachine* the, txSlot* instance, txID id);
 #define mxToInteger(SLOT) \
 	if (XS_INTEGER_KIND != (SLOT)->kind) { \
 		if (XS_SYMBOL_KIND <= (SLOT)->kind) { \
+			mxToPrimitive(SLOT, XS_NUMBER_HINT); \
 			mxSaveState; \
 			fxToInteger(the, SLOT); \
 			mxRestoreState; \
@@ -180,6 +201,7 @@ static txBoolean fxIsScopableSlot(txMachine* the, txSlot* instance, txID id);
 #define mxToNumber(SLOT) \
 	if (XS_NUMBER_KIND != (SLOT)->kind) { \
 		if (XS_SYMBOL_KIND <= (SLOT)->kind) { \
+			mxToPrimitive(SLOT, XS_NUMBER_HINT); \
 			mxSaveState; \
 			fxToNumber(the, SLOT); \
 			mxRestoreState; \
@@ -190,6 +212,7 @@ static txBoolean fxIsScopableSlot(txMachine* the, txSlot* instance, txID id);
 	
 #define mxToString(SLOT) \
 	if ((XS_STRING_KIND != (SLOT)->kind) && (XS_STRING_X_KIND != (SLOT)->kind)) { \
+		mxToPrimitive(SLOT, XS_STRING_HINT); \
 		mxSaveState; \
 		fxToString(the, SLOT); \
 		mxRestoreState; \
@@ -692,6 +715,36 @@ XS_CODE_JUMP:
 			slot = fxGetInstance(the, mxStack);
 			if (!mxIsCallable(slot)) 
 				mxRunDebugID(XS_TYPE_ERROR, "call %s: no function", offset);
+		#endif
+		#if !defined(mxLink) && !defined(mxProfile) && !defined(mxTraceCall)
+		#ifdef mxHostFunctionPrimitive
+			if (slot->kind == XS_HOST_FUNCTION_KIND) {
+				if (slot->value.hostFunction.builder->signature) {
+					index = (mxStack + 2)->value.integer;
+					mxSaveState;
+					fxCallFastHost(the, slot->value.hostFunction.builder->fastCallback, slot->value.hostFunction.builder->signature, mxStack, &scratch);
+					mxRestoreState;
+					goto XS_CODE_CALL_FAST;
+				}
+			}
+			else
+		#endif
+			if ((slot->next->flag & XS_FAST_FLAG) && ((slot->next->kind == XS_CALLBACK_KIND) || (slot->next->kind == XS_CALLBACK_X_KIND)) && !(slot->flag & (XS_BASE_FLAG | XS_DERIVED_FLAG))) {
+				index = (mxStack + 2)->value.integer;
+				mxSaveState;
+				fxCallFastHost(the, slot->next->value.fastCallback.address, slot->next->ID, mxStack, &scratch);
+				mxRestoreState;
+		#ifdef mxHostFunctionPrimitive
+			XS_CODE_CALL_FAST:
+		#endif
+				mxStack += 2 + index;
+				mxStack->next = C_NULL;
+				mxStack->flag = XS_NO_FLAG;
+				mxStack->kind = scratch.kind;
+				mxStack->value = scratch.value;
+				mxNextCode(0);
+				mxBreak;
+			}
 		#endif
 			/* TARGET */
 			mxPushKind(XS_UNDEFINED_KIND);
@@ -734,7 +787,10 @@ XS_CODE_JUMP:
 				if ((txU1*)slot->value.hostFunction.builder->callback - (txU1*)gxFakeCallback < 0)
 					mxRunDebugID(XS_TYPE_ERROR, "call %s: no function", offset);
 #endif
-				(*(slot->value.hostFunction.builder->callback))(the);
+				if (slot->value.hostFunction.builder->signature)
+					fxCallFastHost(the, slot->value.hostFunction.builder->fastCallback, slot->value.hostFunction.builder->signature, mxFrame + 3, mxFrameResult);
+				else
+					(*(slot->value.hostFunction.builder->callback))(the);
 				mxRestoreState;
 				slot = mxFrameResult;
 				goto XS_CODE_END_ALL;
@@ -760,7 +816,10 @@ XS_CODE_JUMP:
 					fxRunBase(the);
 				else if (slot->flag & XS_DERIVED_FLAG)
 					fxRunDerived(the);
-				(*(slot->next->value.callback.address))(the);
+				if ((slot->next->flag & XS_FAST_FLAG) && !(slot->flag & (XS_BASE_FLAG | XS_DERIVED_FLAG)))
+					fxCallFastHost(the, slot->next->value.fastCallback.address, slot->next->ID, mxFrame + 3, mxFrameResult);
+				else
+					(*(slot->next->value.callback.address))(the);
 				mxRestoreState;
 				if (slot->flag & XS_BASE_FLAG)
 					goto XS_CODE_END_BASE_ALL;
@@ -786,6 +845,7 @@ XS_CODE_JUMP:
 				slot = mxFrameResult;
 				goto XS_CODE_END_ALL;
 			}
+			mxGrowStack(mxStackMargin);
 			variable = slot->next->value.code.closures;
 			if (variable) {
 				mxPushKind(XS_REFERENCE_KIND);
@@ -861,7 +921,7 @@ XS_CODE_JUMP:
 			if (slot->kind != XS_REFERENCE_KIND) {
 				if ((slot->kind != XS_UNDEFINED_KIND) && (slot->kind != XS_CLOSURE_KIND))
 					mxRunDebug(XS_TYPE_ERROR, "invalid result");
-				slot = mxFrameThis->value.closure;
+				slot = mxAliasClosure(mxFrameThis->value.closure);
 				if (slot->kind < 0)
 					mxRunDebug(XS_REFERENCE_ERROR, "this is not initialized");
 			}
@@ -1126,7 +1186,7 @@ XS_CODE_JUMP:
 			mxBreak;
 		mxCase(XS_CODE_GET_THIS)
 			slot = mxFrameThis;
-			variable = slot->value.closure;
+			variable = mxAliasClosure(slot->value.closure);
 			if (variable->kind < 0)
 				mxRunDebug(XS_REFERENCE_ERROR, "this is not initialized yet");
 			mxPushKind(variable->kind);
@@ -1136,6 +1196,11 @@ XS_CODE_JUMP:
 		mxCase(XS_CODE_SET_THIS)
 			slot = mxFrameThis;
 			variable = slot->value.closure;
+			if (variable->flag & XS_ALIAS_FLAG) {
+				mxSaveState;
+				variable = fxAliasClosure(the, variable);
+				mxRestoreState;
+			}
 			if (variable->kind >= 0)
 				mxRunDebug(XS_REFERENCE_ERROR, "this is already initialized");
 			variable->kind = mxStack->kind;
@@ -1334,6 +1399,11 @@ XS_CODE_JUMP:
 #endif
 			slot = mxFrame - index;
 			variable = slot->value.closure;
+			if (variable->flag & XS_ALIAS_FLAG) {
+				mxSaveState;
+				variable = fxAliasClosure(the, variable);
+				mxRestoreState;
+			}
 			if (variable->kind >= 0)
 				mxRunDebugID(XS_REFERENCE_ERROR, "set %s: already initialized", slot->ID);
 			variable->flag |= XS_DONT_DELETE_FLAG | XS_DONT_SET_FLAG;
@@ -1374,7 +1444,7 @@ XS_CODE_JUMP:
 			#ifdef mxDebug
 				offset = slot->ID;
 			#endif
-			variable = slot->value.closure;
+			variable = mxAliasClosure(slot->value.closure);
 			if (variable->kind < 0)
 				mxRunDebugID(XS_REFERENCE_ERROR, "get %s: not initialized yet", slot->ID);
 			mxPushKind(variable->kind);
@@ -1413,6 +1483,11 @@ XS_CODE_JUMP:
 			if (gxDoTrace) fxTraceIndex(the, index - 2);
 #endif
 			variable = (mxFrame - index)->value.closure;
+			if (variable->flag & XS_ALIAS_FLAG) {
+				mxSaveState;
+				variable = fxAliasClosure(the, variable);
+				mxRestoreState;
+			}
 			variable->flag |= XS_DONT_DELETE_FLAG;
 			variable->kind = mxStack->kind;
 			variable->value = mxStack->value;
@@ -1492,6 +1567,11 @@ XS_CODE_JUMP:
 			if (slot->flag & XS_DONT_SET_FLAG)
 				mxRunDebugID(XS_TYPE_ERROR, "set %s: const", slot->ID);
 			variable = slot->value.closure;
+			if (variable->flag & XS_ALIAS_FLAG) {
+				mxSaveState;
+				variable = fxAliasClosure(the, variable);
+				mxRestoreState;
+			}
 			if (variable->kind < 0)
 				mxRunDebugID(XS_REFERENCE_ERROR, "set %s: not initialized yet", slot->ID);
 			if (variable->flag & XS_DONT_SET_FLAG)
@@ -1536,10 +1616,10 @@ XS_CODE_JUMP:
 			mxSaveState;
 			slot = fxNewSlot(the);
 			mxRestoreState;
-			slot->flag = variable->value.closure->flag;
+			slot->flag = mxAliasClosure(variable->value.closure)->flag & ~(XS_ALIAS_FLAG | XS_MARK_FLAG);
 			slot->ID = variable->value.closure->ID;
-			slot->kind = variable->value.closure->kind;
-			slot->value = variable->value.closure->value;
+			slot->kind = mxAliasClosure(variable->value.closure)->kind;
+			slot->value = mxAliasClosure(variable->value.closure)->value;
 			variable->value.closure = slot;
 			mxBreak;
 		mxCase(XS_CODE_REFRESH_LOCAL_1)
@@ -1567,6 +1647,7 @@ XS_CODE_JUMP:
 #ifdef mxTrace
 			if (gxDoTrace) fxTraceIndex(the, index);
 #endif
+			mxGrowStack(index + mxStackMargin);
 			mxOverflow(index);		
 			c_memset(mxStack, 0, index * sizeof(txSlot));
 			mxBreak;
@@ -1627,6 +1708,11 @@ XS_CODE_JUMP:
 			if (slot->flag & XS_DONT_SET_FLAG)
 				mxRunDebugID(XS_TYPE_ERROR, "set %s: const", slot->ID);
 			variable = slot->value.closure;
+			if (variable->flag & XS_ALIAS_FLAG) {
+				mxSaveState;
+				variable = fxAliasClosure(the, variable);
+				mxRestoreState;
+			}
 			if (variable->kind < 0)
 				mxRunDebugID(XS_REFERENCE_ERROR, "set %s: not initialized yet", slot->ID);
 			if (variable->flag & XS_DONT_SET_FLAG)
@@ -1666,6 +1752,11 @@ XS_CODE_JUMP:
 			if (gxDoTrace) fxTraceIndex(the, index - 2);
 #endif
 			variable = (mxFrame - index)->value.closure;
+			if (variable->flag & XS_ALIAS_FLAG) {
+				mxSaveState;
+				variable = fxAliasClosure(the, variable);
+				mxRestoreState;
+			}
 			variable->kind = mxStack->kind;
 			variable->value = mxStack->value;
 			mxBreak;
@@ -1947,6 +2038,13 @@ XS_CODE_JUMP:
 			index = mxStack->value.at.index;
 			mxStack++;
 			mxNextCode(1);
+			if (!offset && (variable->flag & XS_EXOTIC_FLAG) && (variable->ID < 0)) {
+				slot = variable->next;
+				if (mxIsPackedArray(slot) && (index < slot->value.array.length)) {
+					fxGetPackedItem(the, slot, index, mxStack);
+					mxBreak;
+				}
+			}
 			goto XS_CODE_GET_PROPERTY_ALL;
 		mxCase(XS_CODE_GET_PROPERTY)
 			mxToInstance(mxStack);
@@ -2063,6 +2161,24 @@ XS_CODE_JUMP:
 			*(mxStack + 1) = *mxStack;
 			mxStack++;
 			mxNextCode(1);
+			if (!offset && (variable->flag & XS_EXOTIC_FLAG) && (variable->ID < 0)) {
+				slot = variable->next;
+				if ((slot->kind == XS_PACKED_INTEGER_KIND) && (index < slot->value.array.length) && (mxStack->kind == XS_INTEGER_KIND)) {
+					((txInteger*)slot->value.array.address)[index] = mxStack->value.integer;
+					goto XS_CODE_SET_SKIP;
+				}
+				if ((slot->kind == XS_PACKED_NUMBER_KIND) && (index < slot->value.array.length) && (mxStack->kind == XS_NUMBER_KIND)) {
+					c_memcpy(((txNumber*)slot->value.array.address) + index, &(mxStack->value.number), sizeof(txNumber));
+					goto XS_CODE_SET_SKIP;
+				}
+				if ((slot->ID == XS_ARRAY_BEHAVIOR) && ((mxIsPackedArray(slot)) ? (index <= slot->value.array.length) : (!index && !slot->value.array.length && !slot->value.array.address))) {
+					mxSaveState;
+					offset = fxSetPackedItem(the, variable, index, mxStack);
+					mxRestoreState;
+					if (offset)
+						goto XS_CODE_SET_SKIP;
+				}
+			}
 			goto XS_CODE_SET_PROPERTY_ALL;
 		mxCase(XS_CODE_SET_PROPERTY)
 			mxToInstance(mxStack + 1);
@@ -2494,6 +2610,8 @@ XS_CODE_JUMP:
 			mxBreak;
 		mxCase(XS_CODE_UNSIGNED_RIGHT_SHIFT)
 			slot = mxStack + 1;
+			mxToNumber(slot);
+			mxToNumber(mxStack);
 			mxSaveState;
 			fxUnsigned(the, slot, fxToUnsigned(the, slot) >> (fxToUnsigned(the, mxStack) & 0x1F));
 			mxRestoreState;
@@ -2576,9 +2694,9 @@ XS_CODE_JUMP:
 			} 			
 			else {
 		XS_CODE_ADD_GENERAL:
+				mxToPrimitive(slot, XS_NO_HINT);
+				mxToPrimitive(mxStack, XS_NO_HINT);
 				mxSaveState;
-				fxToPrimitive(the, slot, XS_NO_HINT);
-				fxToPrimitive(the, mxStack, XS_NO_HINT);
 				if ((slot->kind == XS_STRING_KIND) || (slot->kind == XS_STRING_X_KIND) || (mxStack->kind == XS_STRING_KIND) || (mxStack->kind == XS_STRING_X_KIND)) {
 					fxToString(the, slot);
 					fxToString(the, mxStack);
@@ -2703,10 +2821,8 @@ XS_CODE_JUMP:
 			else if ((slot->kind == XS_NUMBER_KIND) || (mxStack->kind == XS_NUMBER_KIND))
 				goto XS_CODE_LESS_ALL;
 			else {
-				mxSaveState; 
-				fxToPrimitive(the, slot, XS_NUMBER_HINT); 
-				fxToPrimitive(the, mxStack, XS_NUMBER_HINT); 
-				mxRestoreState;
+				mxToPrimitive(slot, XS_NUMBER_HINT);
+				mxToPrimitive(mxStack, XS_NUMBER_HINT);
 				if (((slot->kind == XS_STRING_KIND) || (slot->kind == XS_STRING_X_KIND)) && ((mxStack->kind == XS_STRING_KIND) || (mxStack->kind == XS_STRING_X_KIND)))
 					offset = c_strcmp(slot->value.string, mxStack->value.string) < 0;
 				else {
@@ -2728,10 +2844,8 @@ XS_CODE_JUMP:
 			else if ((slot->kind == XS_NUMBER_KIND) || (mxStack->kind == XS_NUMBER_KIND))
 				goto XS_CODE_LESS_EQUAL_ALL;
 			else {
-				mxSaveState; 
-				fxToPrimitive(the, slot, XS_NUMBER_HINT); 
-				fxToPrimitive(the, mxStack, XS_NUMBER_HINT); 
-				mxRestoreState;
+				mxToPrimitive(slot, XS_NUMBER_HINT);
+				mxToPrimitive(mxStack, XS_NUMBER_HINT);
 				if (((slot->kind == XS_STRING_KIND) || (slot->kind == XS_STRING_X_KIND)) && ((mxStack->kind == XS_STRING_KIND) || (mxStack->kind == XS_STRING_X_KIND)))
 					offset = c_strcmp(slot->value.string, mxStack->value.string) <= 0;
 				else {
@@ -2753,10 +2867,8 @@ XS_CODE_JUMP:
 			else if ((slot->kind == XS_NUMBER_KIND) || (mxStack->kind == XS_NUMBER_KIND))
 				goto XS_CODE_MORE_ALL;
 			else {
-				mxSaveState; 
-				fxToPrimitive(the, slot, XS_NUMBER_HINT); 
-				fxToPrimitive(the, mxStack, XS_NUMBER_HINT); 
-				mxRestoreState;
+				mxToPrimitive(slot, XS_NUMBER_HINT);
+				mxToPrimitive(mxStack, XS_NUMBER_HINT);
 				if (((slot->kind == XS_STRING_KIND) || (slot->kind == XS_STRING_X_KIND)) && ((mxStack->kind == XS_STRING_KIND) || (mxStack->kind == XS_STRING_X_KIND)))
 					offset = c_strcmp(slot->value.string, mxStack->value.string) > 0;
 				else {
@@ -2778,10 +2890,8 @@ XS_CODE_JUMP:
 			else if ((slot->kind == XS_NUMBER_KIND) || (mxStack->kind == XS_NUMBER_KIND))
 				goto XS_CODE_MORE_EQUAL_ALL;
 			else {
-				mxSaveState; 
-				fxToPrimitive(the, slot, XS_NUMBER_HINT); 
-				fxToPrimitive(the, mxStack, XS_NUMBER_HINT); 
-				mxRestoreState;
+				mxToPrimitive(slot, XS_NUMBER_HINT);
+				mxToPrimitive(mxStack, XS_NUMBER_HINT);
 				if (((slot->kind == XS_STRING_KIND) || (slot->kind == XS_STRING_X_KIND)) && ((mxStack->kind == XS_STRING_KIND) || (mxStack->kind == XS_STRING_X_KIND)))
 					offset = c_strcmp(slot->value.string, mxStack->value.string) >= 0;
 				else {
@@ -2853,15 +2963,11 @@ XS_CODE_JUMP:
 					goto XS_CODE_EQUAL_AGAIN;
 				}
 				else if (((slot->kind == XS_INTEGER_KIND) || (slot->kind == XS_NUMBER_KIND) || (slot->kind == XS_STRING_KIND) || (slot->kind == XS_STRING_X_KIND) || (slot->kind == XS_SYMBOL_KIND)) && mxIsReference(mxStack)) {
-					mxSaveState;
-					fxToPrimitive(the, mxStack, XS_NO_HINT);
-					mxRestoreState;
+					mxToPrimitive(mxStack, XS_NO_HINT);
 					goto XS_CODE_EQUAL_AGAIN;
 				}
 				else if (((mxStack->kind == XS_INTEGER_KIND) || (mxStack->kind == XS_NUMBER_KIND) || (mxStack->kind == XS_STRING_KIND) || (mxStack->kind == XS_STRING_X_KIND) || (mxStack->kind == XS_SYMBOL_KIND)) && mxIsReference(slot)) {
-					mxSaveState;
-					fxToPrimitive(the, slot, XS_NO_HINT);
-					mxRestoreState;
+					mxToPrimitive(slot, XS_NO_HINT);
 					goto XS_CODE_EQUAL_AGAIN;
 				}
                 else
@@ -2930,15 +3036,11 @@ XS_CODE_JUMP:
 					goto XS_CODE_NOT_EQUAL_AGAIN;
 				}
 				else if (((slot->kind == XS_INTEGER_KIND) || (slot->kind == XS_NUMBER_KIND) || (slot->kind == XS_STRING_KIND) || (slot->kind == XS_STRING_X_KIND) || (slot->kind == XS_SYMBOL_KIND)) && mxIsReference(mxStack)) {
-					mxSaveState;
-					fxToPrimitive(the, mxStack, XS_NO_HINT);
-					mxRestoreState;
+					mxToPrimitive(mxStack, XS_NO_HINT);
 					goto XS_CODE_NOT_EQUAL_AGAIN;
 				}
 				else if (((mxStack->kind == XS_INTEGER_KIND) || (mxStack->kind == XS_NUMBER_KIND) || (mxStack->kind == XS_STRING_KIND) || (mxStack->kind == XS_STRING_X_KIND) || (mxStack->kind == XS_SYMBOL_KIND)) && mxIsReference(slot)) {
-					mxSaveState;
-					fxToPrimitive(the, slot, XS_NO_HINT);
-					mxRestoreState;
+					mxToPrimitive(slot, XS_NO_HINT);
 					goto XS_CODE_NOT_EQUAL_AGAIN;
 				}
                 else
@@ -3340,6 +3442,7 @@ void fxRunEval(txMachine* the)
 	txSlot* function;
 	txSlot* home;
 	txSlot* closures;
+	txSize depth;
 	if (the->stack->value.integer == 0)
 		the->stack->kind = XS_UNDEFINED_KIND;
 	else {
@@ -3362,7 +3465,10 @@ void fxRunEval(txMachine* the)
 				closures = closures->value.reference;
 			else
 				closures = C_NULL;
+			// the stack can move while the script runs
+			depth = (txSize)(the->stackTop - aStream.slot);
 			fxRunScript(the, fxParseScript(the, &aStream, fxStringGetter, flags), mxThis, mxTarget, closures, home->value.home.object, C_NULL);
+			aStream.slot = the->stackTop - depth;
 			aStream.slot->kind = the->stack->kind;
 			aStream.slot->value = the->stack->value;
 			the->stack++;
@@ -3412,6 +3518,20 @@ void fxRunInstanceOf(txMachine* the)
 	the->stack++;
 }
 
+void fxRunPrimitive(txMachine* the, txSlot* slot, txInteger hint)
+{
+	txInteger offset = (txInteger)(the->stackTop - slot);
+	fxBeginHost(the);
+	/* the interpreter does not keep pointers to the stack over conversions, so JavaScript code can grow it */
+	the->frame->flag |= XS_MOVABLE_FLAG;
+	fxPushPrimitive(the, slot, hint);
+	slot = the->stackTop - offset;
+	slot->kind = the->stack->kind;
+	slot->value = the->stack->value;
+	the->stack++;
+	fxEndHost(the);
+}
+
 void fxRunProxy(txMachine* the, txSlot* instance)
 {
 	txSlot* array;
@@ -37,6 +37,9 @@
 
 #include "xsScript.h"
 
+#define mxCaptureByReference 1
+#define mxCaptureByValue 2
+
 #define mxBindHoistPart\
 	txParser* parser;\
 	txScope* scope
@@ -68,12 +71,13 @@ static txScope* fxScopeNew(txHoister* hoister, txNode* node, txToken token);
 static void fxScopeAddDeclareNode(txScope* self, txDeclareNode* node);
 static void fxScopeAddDefineNode(txScope* self, txDefineNode* node);
 static void fxScopeBindDefineNodes(txScope* self, void* param);
+static void fxScopeCapture(txScope* self, txDeclareNode* declaration, txFlag closureFlag);
 static void fxScopeBinding(txScope* self, txBinder* binder);
 static void fxScopeBound(txScope* self, txBinder* binder);
 static void fxScopeEval(txScope* self);
 static txDeclareNode* fxScopeGetDeclareNode(txScope* self, txSymbol* symbol);
 static void fxScopeHoisted(txScope* self, txHoister* hoister);
-static void fxScopeLookup(txScope* self, txAccessNode* access, txBoolean closureFlag);
+static void fxScopeLookup(txScope* self, txAccessNode* access, txFlag closureFlag);
 
 static void fxNodeDispatchBind(void* it, void* param);
 static void fxNodeDispatchHoist(void* it, void* param);
@@ -289,7 +293,24 @@ void fxScopeHoisted(txScope* self, txHoister* hoister)
 	hoister->scope = self->scope;
 }
 
-void fxScopeLookup(txScope* self, txAccessNode* access, txBoolean closureFlag) 
+void fxScopeCapture(txScope* self, txDeclareNode* declaration, txFlag closureFlag)
+{
+	if (declaration->description->token == XS_NO_TOKEN) {
+		// the closure of an intermediate function: capturing by reference requires the original declaration to be a closure
+		if (closureFlag == mxCaptureByReference) {
+			while (declaration->declaration && (declaration->description->token == XS_NO_TOKEN))
+				declaration = declaration->declaration;
+			declaration->flags |= mxDeclareNodeClosureFlag;
+		}
+	}
+	else if ((closureFlag == mxCaptureByValue) && (declaration->description->token == XS_TOKEN_CONST) && (declaration->flags & mxDeclareNodeInitializedFlag)) {
+		// an initialized const can be copied into the environment of the function that captures it
+	}
+	else
+		declaration->flags |= mxDeclareNodeClosureFlag;
+}
+
+void fxScopeLookup(txScope* self, txAccessNode* access, txFlag closureFlag) 
 {
 	txDeclareNode* declaration;
 	if (self->token == XS_TOKEN_EVAL) {
@@ -320,7 +341,7 @@ void fxScopeLookup(txScope* self, txAccessNode* access, txBoolean closureFlag)
 		}
 	}
 	else if (self->token == XS_TOKEN_WITH) {
-		fxScopeLookup(self->scope, access, 1);
+		fxScopeLookup(self->scope, access, mxCaptureByReference);
 		if (access->declaration && (!(access->declaration->flags & mxDeclareNodeUseClosureFlag))) {
 			// cache variables declared by the blocks and the function containing the with
 			txDeclareNode* closureNode = fxScopeGetDeclareNode(self, access->symbol);
@@ -340,7 +361,7 @@ void fxScopeLookup(txScope* self, txAccessNode* access, txBoolean closureFlag)
 		declaration = fxScopeGetDeclareNode(self, access->symbol);
 		if (declaration) {
 			if (closureFlag)
-				declaration->flags |= mxDeclareNodeClosureFlag;
+				fxScopeCapture(self, declaration, closureFlag);
 			access->declaration = declaration;
 		}
 		else if (self->scope) {
@@ -350,7 +371,7 @@ void fxScopeLookup(txScope* self, txAccessNode* access, txBoolean closureFlag)
 					access->declaration = C_NULL;
 				}
 				else {
-					fxScopeLookup(self->scope, access, 1);
+					fxScopeLookup(self->scope, access, closureFlag ? closureFlag : mxCaptureByValue);
 					if (access->declaration) {
 						txDeclareNode* closureNode = fxDeclareNodeNew(self->parser, XS_NO_TOKEN, access->symbol);
 						closureNode->flags |= mxDeclareNodeClosureFlag | mxDeclareNodeUseClosureFlag;
@@ -900,12 +921,13 @@ void fxDeclareNodeBind(void* it, void* param)
 {
 	txBindingNode* self = it;
 	txBinder* binder = param;
-	self->flags |= mxDeclareNodeBoundFlag | mxDeclareNodeInitializedFlag;
+	self->flags |= mxDeclareNodeBoundFlag;
 	fxScopeLookup(binder->scope, (txAccessNode*)self, 0);
 	if (self->initializer) {
 		fxFunctionNodeRename(self->initializer, self->symbol);
 		fxNodeDispatchBind(self->initializer, param);
 	}
+	self->flags |= mxDeclareNodeInitializedFlag;
 }
 
 void fxDefineNodeBind(void* it, void* param) 
@@ -301,6 +301,8 @@ struct sxHostNode {
 	txStringNode* at;
 	txHostNode* nextHostNode;
 	txInteger paramsCount;
+	txID signature;
+	txSize nameLength;
 };
 
 typedef struct {
@@ -0,0 +1,714 @@
+/*
+ * Copyright (c) 2016-2017  Moddable Tech, Inc.
+ *
+ *   This file is part of the Moddable SDK Runtime.
+ *
+ *   The Moddable SDK Runtime is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU Lesser General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   The Moddable SDK Runtime is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU Lesser General Public License for more details.
+ *
+ *   You should have received a copy of the GNU Lesser General Public License
+ *   along with the Moddable SDK Runtime.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "xsAll.h"
+
+/*
+	A snapshot is the raw image of the slot heaps, the chunk blocks, the stack, the keys and the name and symbol tables of an idle machine, together with the address ranges they occupied.
+	Reading a snapshot copies the image into one slot heap and one chunk block, then relocates every pointer by looking up the range it belongs to.
+	Pointers outside of all ranges (host callbacks, ROM strings and code, type dispatches...) are relocated by the displacement of the executable, so a snapshot can only be read by the executable that wrote it.
+	The offsets of a function and of a constant from gxNoCode are written with the anchor and checked when reading, to reject a snapshot written by another executable instead of relocating its pointers into garbage.
+*/
+
+#define XS_ATOM_SNAPSHOT 0x58535F53 /* 'XS_S' */
+#define XS_ATOM_BLOCK 0x424C4F43 /* 'BLOC' */
+#define XS_ATOM_HEAP 0x48454150 /* 'HEAP' */
+#define XS_ATOM_KEYS 0x4B455953 /* 'KEYS' */
+#define XS_ATOM_MACHINE 0x4D414348 /* 'MACH' */
+#define XS_ATOM_NAMES 0x4E414D45 /* 'NAME' */
+#define XS_ATOM_STACK 0x53544143 /* 'STAC' */
+
+typedef struct sxSnapshotMachine txSnapshotMachine;
+typedef struct sxSnapshotRange txSnapshotRange;
+typedef struct sxSnapshotStream txSnapshotStream;
+
+struct sxSnapshotMachine {
+	txSize slotSize;
+	txSize heapCount;
+	txSize heapRangeCount;
+	txSize chunksSize;
+	txSize blockRangeCount;
+	txSize stackCount;
+	txSize stackSize;
+	txSize maximumStackCount;
+	txSize incrementalChunkSize;
+	txSize incrementalHeapCount;
+	txSize keyCount;
+	txSize keyIndex;
+	txSize nameModulo;
+	txSize symbolModulo;
+	txSize currentChunksSize;
+	txSize peakChunksSize;
+	txSize currentHeapCount;
+	txSize peakHeapCount;
+	txFlag requireFlag;
+	txSlot* freeHeap;
+	const txByte* anchor;
+	const txByte* codeAnchor;
+	const txByte* dataAnchor;
+	void* preparation;
+};
+
+struct sxSnapshotRange {
+	txByte* from;
+	txByte* to;
+	txByte* address;
+};
+
+struct sxSnapshotStream {
+	c_jmp_buf jmp_buf;
+	txSnapshot* snapshot;
+	txMachine* the;
+	txSnapshotRange* ranges;
+	txSize rangeCount;
+	txSnapshotRange* range;
+	const txByte* anchor;
+	txSlot* tail;
+};
+
+static void fxCheckSnapshotSlot(txMachine* the, txSnapshotStream* self, txSlot* slot);
+static void* fxProjectSnapshotChunk(txSnapshotStream* self, void* address);
+static void* fxProjectSnapshotStatic(txSnapshotStream* self, void* address);
+static txSlot* fxProjectSnapshotSlot(txSnapshotStream* self, txSlot* address);
+static void fxReadSnapshotAtom(txSnapshotStream* self, Atom* atom, txU4 type);
+static void fxReadSnapshotBuffer(txSnapshotStream* self, void* buffer, size_t size);
+static void fxRelocateSnapshotSlot(txMachine* the, txSnapshotStream* self, txSlot* slot);
+static void fxRelocateSnapshotTable(txSnapshotStream* self, txSlot** address, txSize length);
+static void fxUnmarkSnapshotTail(txSnapshotStream* self);
+static void fxWriteSnapshotAtom(txSnapshotStream* self, txS4 size, txU4 type);
+static void fxWriteSnapshotBuffer(txSnapshotStream* self, void* buffer, size_t size);
+
+#define mxSnapshotElseThrow(_ASSERTION,_ERROR) if (!(_ASSERTION)) { self->snapshot->error = _ERROR; c_longjmp(self->jmp_buf, 1); }
+
+#define mxSnapshotChunkLength(_ADDRESS) \
+	((((txChunk*)(((txByte*)(_ADDRESS)) - sizeof(txChunk)))->size) / sizeof(txSlot))
+
+void fxCheckSnapshotSlot(txMachine* the, txSnapshotStream* self, txSlot* slot)
+{
+	switch (slot->kind) {
+	case XS_FRAME_KIND:
+		mxSnapshotElseThrow(0, XS_SNAPSHOT_STATE_ERROR);
+		break;
+	case XS_HOST_KIND:
+		if (slot->value.host.data)
+			mxSnapshotElseThrow(slot->flag & XS_HOST_CHUNK_FLAG, XS_SNAPSHOT_HOST_ERROR);
+		break;
+	case XS_INSTANCE_INSPECTOR_KIND:
+		mxSnapshotElseThrow(0, XS_SNAPSHOT_STATE_ERROR);
+		break;
+	}
+}
+
+void* fxProjectSnapshotChunk(txSnapshotStream* self, void* address)
+{
+	if (address) {
+		txByte* data = (txByte*)address;
+		txSnapshotRange* range = self->range;
+		if ((range->from <= data) && (data < range->to))
+			return range->address + (data - range->from);
+		range = self->ranges;
+		while (range < self->ranges + self->rangeCount) {
+			if ((range->from <= data) && (data < range->to)) {
+				self->range = range;
+				return range->address + (data - range->from);
+			}
+			range++;
+		}
+		return ((txByte*)gxNoCode) + (data - self->anchor);
+	}
+	return C_NULL;
+}
+
+void* fxProjectSnapshotStatic(txSnapshotStream* self, void* address)
+{
+	if (address)
+		return ((txByte*)gxNoCode) + (((txByte*)address) - self->anchor);
+	return C_NULL;
+}
+
+txSlot* fxProjectSnapshotSlot(txSnapshotStream* self, txSlot* address)
+{
+	return (txSlot*)fxProjectSnapshotChunk(self, address);
+}
+
+txMachine* fxReadSnapshot(txSnapshot* snapshot, txString theName, void* theContext)
+{
+	txSnapshotStream _self;
+	txSnapshotStream* self = &_self;
+	txMachine* the = C_NULL;
+	c_memset(self, 0, sizeof(txSnapshotStream));
+	self->snapshot = snapshot;
+	snapshot->error = XS_SNAPSHOT_NO_ERROR;
+	if (c_setjmp(self->jmp_buf) == 0) {
+		txSnapshotMachine machine;
+		txCreation creation;
+		txJump aJump;
+		Atom atom;
+		txS1 version[XS_VERSION_SIZE];
+		txSlot* heap;
+		txSlot* slot;
+		txSlot* limit;
+		txSize count, index;
+
+		fxReadSnapshotAtom(self, &atom, XS_ATOM_SNAPSHOT);
+		fxReadSnapshotAtom(self, &atom, XS_ATOM_VERSION);
+		mxSnapshotElseThrow(atom.atomSize == sizeof(Atom) + XS_VERSION_SIZE, XS_SNAPSHOT_FORMAT_ERROR);
+		fxReadSnapshotBuffer(self, version, XS_VERSION_SIZE);
+		mxSnapshotElseThrow((version[0] == XS_MAJOR_VERSION) && (version[1] == XS_MINOR_VERSION) && (version[2] == XS_PATCH_VERSION), XS_SNAPSHOT_VERSION_ERROR);
+		fxReadSnapshotAtom(self, &atom, XS_ATOM_SIGNATURE);
+		mxSnapshotElseThrow(atom.atomSize == (txS4)sizeof(Atom) + snapshot->signatureLength, XS_SNAPSHOT_SIGNATURE_ERROR);
+		if (snapshot->signatureLength) {
+			txString signature = c_malloc(snapshot->signatureLength);
+			mxSnapshotElseThrow(signature, XS_SNAPSHOT_MEMORY_ERROR);
+			if (!snapshot->read(snapshot->stream, signature, snapshot->signatureLength)) {
+				c_free(signature);
+				mxSnapshotElseThrow(0, XS_SNAPSHOT_STREAM_ERROR);
+			}
+			index = c_memcmp(signature, snapshot->signature, snapshot->signatureLength);
+			c_free(signature);
+			mxSnapshotElseThrow(index == 0, XS_SNAPSHOT_SIGNATURE_ERROR);
+		}
+		fxReadSnapshotAtom(self, &atom, XS_ATOM_MACHINE);
+		mxSnapshotElseThrow(atom.atomSize == sizeof(Atom) + sizeof(txSnapshotMachine), XS_SNAPSHOT_FORMAT_ERROR);
+		fxReadSnapshotBuffer(self, &machine, sizeof(txSnapshotMachine));
+		mxSnapshotElseThrow(machine.slotSize == sizeof(txSlot), XS_SNAPSHOT_FORMAT_ERROR);
+		mxSnapshotElseThrow(machine.codeAnchor - machine.anchor == ((const txByte*)(void*)fx_Array) - ((const txByte*)gxNoCode), XS_SNAPSHOT_SIGNATURE_ERROR);
+		mxSnapshotElseThrow(machine.dataAnchor - machine.anchor == ((const txByte*)gxTypeDispatches) - ((const txByte*)gxNoCode), XS_SNAPSHOT_SIGNATURE_ERROR);
+		self->anchor = machine.anchor;
+		self->rangeCount = machine.heapRangeCount + machine.blockRangeCount + 1;
+		self->ranges = c_malloc(self->rangeCount * sizeof(txSnapshotRange));
+		mxSnapshotElseThrow(self->ranges, XS_SNAPSHOT_MEMORY_ERROR);
+		self->range = self->ranges;
+
+		creation.initialChunkSize = machine.chunksSize + machine.incrementalChunkSize;
+		creation.incrementalChunkSize = machine.incrementalChunkSize;
+		creation.initialHeapCount = machine.heapCount + machine.incrementalHeapCount;
+		creation.incrementalHeapCount = machine.incrementalHeapCount;
+		creation.stackCount = machine.stackCount;
+		creation.keyCount = machine.keyCount;
+		creation.nameModulo = machine.nameModulo;
+		creation.symbolModulo = machine.symbolModulo;
+		creation.staticSize = 0;
+		creation.maximumStackCount = machine.maximumStackCount;
+
+		the = self->the = (txMachine* )c_calloc(sizeof(txMachine), 1);
+		mxSnapshotElseThrow(the, XS_SNAPSHOT_MEMORY_ERROR);
+		aJump.nextJump = C_NULL;
+		aJump.stack = C_NULL;
+		aJump.scope = C_NULL;
+		aJump.frame = C_NULL;
+		aJump.code = C_NULL;
+		aJump.flag = 0;
+		the->firstJump = &aJump;
+		if (c_setjmp(aJump.buffer) == 0) {
+			the->dtoa = fxNew_dtoa(the);
+			the->context = theContext;
+			fxCreateMachinePlatform(the);
+		#ifdef mxDebug
+			the->name = theName;
+		#endif
+		#ifdef mxProfile
+			the->profileID = 1;
+			the->profileBottom = c_malloc(XS_PROFILE_COUNT * sizeof(txProfileRecord));
+			if (!the->profileBottom)
+				fxJump(the);
+			the->profileCurrent = the->profileBottom;
+			the->profileTop = the->profileBottom + XS_PROFILE_COUNT;
+		#endif
+			fxAllocate(the, &creation);
+		}
+		else {
+			fxFree(the);
+			c_free(the);
+			the = self->the = C_NULL;
+			mxSnapshotElseThrow(0, XS_SNAPSHOT_MEMORY_ERROR);
+		}
+		the->firstJump = C_NULL;
+
+		heap = the->firstHeap;
+		slot = heap + 1;
+		for (index = 0; index < machine.heapRangeCount; index++) {
+			txSnapshotRange* range = self->ranges + index;
+			fxReadSnapshotAtom(self, &atom, XS_ATOM_HEAP);
+			fxReadSnapshotBuffer(self, range, 2 * sizeof(txByte*));
+			count = (txSize)((range->to - range->from) / sizeof(txSlot));
+			mxSnapshotElseThrow(atom.atomSize == (txS4)(sizeof(Atom) + (2 * sizeof(txByte*)) + (count * sizeof(txSlot))), XS_SNAPSHOT_FORMAT_ERROR);
+			mxSnapshotElseThrow(slot + count <= heap->value.reference, XS_SNAPSHOT_FORMAT_ERROR);
+			fxReadSnapshotBuffer(self, slot, count * sizeof(txSlot));
+			range->address = (txByte*)slot;
+			slot += count;
+		}
+		limit = slot;
+		for (; index < machine.heapRangeCount + machine.blockRangeCount; index++) {
+			txSnapshotRange* range = self->ranges + index;
+			txBlock* block = the->firstBlock;
+			fxReadSnapshotAtom(self, &atom, XS_ATOM_BLOCK);
+			fxReadSnapshotBuffer(self, range, 2 * sizeof(txByte*));
+			count = (txSize)(range->to - range->from);
+			mxSnapshotElseThrow(atom.atomSize == (txS4)(sizeof(Atom) + (2 * sizeof(txByte*)) + count), XS_SNAPSHOT_FORMAT_ERROR);
+			mxSnapshotElseThrow(block->current + count <= block->limit, XS_SNAPSHOT_FORMAT_ERROR);
+			fxReadSnapshotBuffer(self, block->current, count);
+			range->address = block->current;
+			block->current += count;
+		}
+		{
+			txSnapshotRange* range = self->ranges + index;
+			fxReadSnapshotAtom(self, &atom, XS_ATOM_STACK);
+			fxReadSnapshotBuffer(self, range, 2 * sizeof(txByte*));
+			count = (txSize)((range->to - range->from) / sizeof(txSlot));
+			mxSnapshotElseThrow(atom.atomSize == (txS4)(sizeof(Atom) + (2 * sizeof(txByte*)) + (count * sizeof(txSlot))), XS_SNAPSHOT_FORMAT_ERROR);
+			mxSnapshotElseThrow(count == machine.stackSize, XS_SNAPSHOT_FORMAT_ERROR);
+			the->stack = the->stackTop - count;
+			fxReadSnapshotBuffer(self, the->stack, count * sizeof(txSlot));
+			range->address = (txByte*)the->stack;
+		}
+
+		fxReadSnapshotAtom(self, &atom, XS_ATOM_KEYS);
+		mxSnapshotElseThrow(atom.atomSize == (txS4)(sizeof(Atom) + (machine.keyIndex * sizeof(txSlot*))), XS_SNAPSHOT_FORMAT_ERROR);
+		c_memset(the->keyArray, 0, machine.keyCount * sizeof(txSlot*));
+		fxReadSnapshotBuffer(self, the->keyArray, machine.keyIndex * sizeof(txSlot*));
+		the->keyIndex = (txID)machine.keyIndex;
+		fxReadSnapshotAtom(self, &atom, XS_ATOM_NAMES);
+		mxSnapshotElseThrow(atom.atomSize == (txS4)(sizeof(Atom) + (machine.nameModulo * sizeof(txSlot*))), XS_SNAPSHOT_FORMAT_ERROR);
+		fxReadSnapshotBuffer(self, the->nameTable, machine.nameModulo * sizeof(txSlot*));
+		fxReadSnapshotAtom(self, &atom, XS_ATOM_SYMBOLS);
+		mxSnapshotElseThrow(atom.atomSize == (txS4)(sizeof(Atom) + (machine.symbolModulo * sizeof(txSlot*))), XS_SNAPSHOT_FORMAT_ERROR);
+		fxReadSnapshotBuffer(self, the->symbolTable, machine.symbolModulo * sizeof(txSlot*));
+
+		slot = heap + 1;
+		while (slot < limit) {
+			slot->next = fxProjectSnapshotSlot(self, slot->next);
+			fxRelocateSnapshotSlot(the, self, slot);
+			slot++;
+		}
+		slot = the->stack;
+		while (slot < the->stackTop) {
+			fxRelocateSnapshotSlot(the, self, slot);
+			slot++;
+		}
+		slot = heap + 1;
+		while (slot < limit) {
+			if ((slot->kind == XS_MAP_KIND) || (slot->kind == XS_SET_KIND) || (slot->kind == XS_WEAK_MAP_KIND) || (slot->kind == XS_WEAK_SET_KIND))
+				fxRehashEntries(the, slot);
+			slot++;
+		}
+		fxRelocateSnapshotTable(self, the->keyArray, machine.keyIndex);
+		fxRelocateSnapshotTable(self, the->nameTable, machine.nameModulo);
+		fxRelocateSnapshotTable(self, the->symbolTable, machine.symbolModulo);
+
+		the->freeHeap = fxProjectSnapshotSlot(self, machine.freeHeap);
+		slot = heap->value.reference;
+		while (limit < slot) {
+			slot--;
+			slot->next = the->freeHeap;
+			slot->ID = XS_NO_ID;
+			slot->flag = XS_NO_FLAG;
+			slot->kind = XS_UNDEFINED_KIND;
+			the->freeHeap = slot;
+		}
+
+		the->currentChunksSize = machine.currentChunksSize;
+		the->peakChunksSize = machine.peakChunksSize;
+		the->currentHeapCount = machine.currentHeapCount;
+		the->peakHeapCount = machine.peakHeapCount;
+		the->requireFlag = machine.requireFlag;
+		the->preparation = fxProjectSnapshotStatic(self, machine.preparation);
+	#ifdef mxInstrument
+		the->stackPeak = the->stack;
+	#endif
+		the->collectFlag = XS_COLLECTING_FLAG;
+
+		c_free(self->ranges);
+		self->ranges = C_NULL;
+
+	#ifdef mxDebug
+		fxLogin(the);
+	#endif
+	}
+	else {
+		if (self->ranges)
+			c_free(self->ranges);
+		the = self->the;
+		if (the) {
+			fxDelete_dtoa(the->dtoa);
+			fxDeleteMachinePlatform(the);
+			fxFree(the);
+			c_free(the);
+			the = C_NULL;
+		}
+	}
+	return the;
+}
+
+void fxReadSnapshotAtom(txSnapshotStream* self, Atom* atom, txU4 type)
+{
+	txU1 buffer[sizeof(Atom)];
+	fxReadSnapshotBuffer(self, buffer, sizeof(Atom));
+	atom->atomSize = (buffer[0] << 24) | (buffer[1] << 16) | (buffer[2] << 8) | buffer[3];
+	atom->atomType = (buffer[4] << 24) | (buffer[5] << 16) | (buffer[6] << 8) | buffer[7];
+	mxSnapshotElseThrow(atom->atomType == type, XS_SNAPSHOT_FORMAT_ERROR);
+}
+
+void fxReadSnapshotBuffer(txSnapshotStream* self, void* buffer, size_t size)
+{
+	mxSnapshotElseThrow(self->snapshot->read(self->snapshot->stream, buffer, size), XS_SNAPSHOT_STREAM_ERROR);
+}
+
+void fxRelocateSnapshotSlot(txMachine* the, txSnapshotStream* self, txSlot* slot)
+{
+	txSlot* item;
+	txSize length;
+	switch (slot->kind) {
+	case XS_STRING_KIND:
+		slot->value.string = (txString)fxProjectSnapshotChunk(self, slot->value.string);
+		break;
+	case XS_STRING_X_KIND:
+		slot->value.string = (txString)fxProjectSnapshotStatic(self, slot->value.string);
+		break;
+	case XS_REFERENCE_KIND:
+		slot->value.reference = fxProjectSnapshotSlot(self, slot->value.reference);
+		break;
+	case XS_CLOSURE_KIND:
+		slot->value.closure = fxProjectSnapshotSlot(self, slot->value.closure);
+		break;
+	case XS_INSTANCE_KIND:
+		slot->value.instance.garbage = C_NULL;
+		slot->value.instance.prototype = fxProjectSnapshotSlot(self, slot->value.instance.prototype);
+		break;
+	case XS_ARGUMENTS_SLOPPY_KIND:
+	case XS_ARGUMENTS_STRICT_KIND:
+	case XS_ARRAY_KIND:
+	case XS_STACK_KIND:
+		if (slot->value.array.address) {
+			slot->value.array.address = (txSlot*)fxProjectSnapshotChunk(self, slot->value.array.address);
+			item = slot->value.array.address;
+			length = (txSize)mxSnapshotChunkLength(item);
+			while (length) {
+				fxRelocateSnapshotSlot(the, self, item);
+				item++;
+				length--;
+			}
+		}
+		break;
+	case XS_PACKED_INTEGER_KIND:
+	case XS_PACKED_NUMBER_KIND:
+		slot->value.array.address = (txSlot*)fxProjectSnapshotChunk(self, slot->value.array.address);
+		break;
+	case XS_ARRAY_BUFFER_KIND:
+		slot->value.arrayBuffer.address = (txByte*)fxProjectSnapshotChunk(self, slot->value.arrayBuffer.address);
+		break;
+	case XS_CALLBACK_KIND:
+	case XS_CALLBACK_X_KIND:
+		slot->value.callback.address = (txCallback)fxProjectSnapshotStatic(self, (void*)slot->value.callback.address);
+		slot->value.callback.IDs = (txID*)fxProjectSnapshotChunk(self, slot->value.callback.IDs);
+		break;
+	case XS_CODE_KIND:
+		slot->value.code.address = (txByte*)fxProjectSnapshotChunk(self, slot->value.code.address);
+		slot->value.code.closures = fxProjectSnapshotSlot(self, slot->value.code.closures);
+		break;
+	case XS_CODE_X_KIND:
+		slot->value.code.address = (txByte*)fxProjectSnapshotStatic(self, slot->value.code.address);
+		slot->value.code.closures = fxProjectSnapshotSlot(self, slot->value.code.closures);
+		break;
+	case XS_GLOBAL_KIND:
+		slot->value.table.address = (txSlot**)fxProjectSnapshotChunk(self, slot->value.table.address);
+		fxRelocateSnapshotTable(self, slot->value.table.address, slot->value.table.length);
+		break;
+	case XS_HOST_KIND:
+		if (slot->flag & XS_HOST_CHUNK_FLAG)
+			slot->value.host.data = fxProjectSnapshotChunk(self, slot->value.host.data);
+		if (slot->flag & XS_HOST_HOOKS_FLAG)
+			slot->value.host.variant.hooks = (txHostHooks*)fxProjectSnapshotStatic(self, slot->value.host.variant.hooks);
+		else
+			slot->value.host.variant.destructor = (txDestructor)fxProjectSnapshotStatic(self, (void*)slot->value.host.variant.destructor);
+		break;
+	case XS_MAP_KIND:
+	case XS_SET_KIND:
+		slot->value.table.address = (txSlot**)fxProjectSnapshotChunk(self, slot->value.table.address);
+		fxRelocateSnapshotTable(self, slot->value.table.address, slot->value.table.length);
+		break;
+	case XS_WEAK_MAP_KIND:
+	case XS_WEAK_SET_KIND:
+		slot->value.table.address = (txSlot**)fxProjectSnapshotChunk(self, slot->value.table.address);
+		fxRelocateSnapshotTable(self, slot->value.table.address, slot->value.table.length);
+		slot->value.table.address[slot->value.table.length] = C_NULL;
+		break;
+	case XS_PROXY_KIND:
+		slot->value.proxy.handler = fxProjectSnapshotSlot(self, slot->value.proxy.handler);
+		slot->value.proxy.target = fxProjectSnapshotSlot(self, slot->value.proxy.target);
+		break;
+	case XS_REGEXP_KIND:
+		slot->value.regexp.code = (txInteger*)fxProjectSnapshotChunk(self, slot->value.regexp.code);
+		slot->value.regexp.data = (txInteger*)fxProjectSnapshotChunk(self, slot->value.regexp.data);
+		break;
+	case XS_TYPED_ARRAY_KIND:
+		slot->value.typedArray.dispatch = (txTypeDispatch*)fxProjectSnapshotStatic(self, slot->value.typedArray.dispatch);
+		slot->value.typedArray.atomics = (txTypeAtomics*)fxProjectSnapshotStatic(self, slot->value.typedArray.atomics);
+		break;
+	case XS_WITH_KIND:
+		slot->value.reference = fxProjectSnapshotSlot(self, slot->value.reference);
+		break;
+	case XS_ACCESSOR_KIND:
+		slot->value.accessor.getter = fxProjectSnapshotSlot(self, slot->value.accessor.getter);
+		slot->value.accessor.setter = fxProjectSnapshotSlot(self, slot->value.accessor.setter);
+		break;
+	case XS_ENTRY_KIND:
+		slot->value.entry.slot = fxProjectSnapshotSlot(self, slot->value.entry.slot);
+		break;
+	case XS_HOME_KIND:
+		slot->value.home.object = fxProjectSnapshotSlot(self, slot->value.home.object);
+		slot->value.home.module = fxProjectSnapshotSlot(self, slot->value.home.module);
+		break;
+	case XS_KEY_KIND:
+		slot->value.key.string = (txString)fxProjectSnapshotChunk(self, slot->value.key.string);
+		break;
+	case XS_KEY_X_KIND:
+		slot->value.key.string = (txString)fxProjectSnapshotStatic(self, slot->value.key.string);
+		break;
+	case XS_LIST_KIND:
+		slot->value.list.first = fxProjectSnapshotSlot(self, slot->value.list.first);
+		slot->value.list.last = fxProjectSnapshotSlot(self, slot->value.list.last);
+		break;
+#ifdef mxHostFunctionPrimitive
+	case XS_HOST_FUNCTION_KIND:
+		slot->value.hostFunction.builder = (txHostFunctionBuilder*)fxProjectSnapshotStatic(self, (void*)slot->value.hostFunction.builder);
+		slot->value.hostFunction.IDs = (txID*)fxProjectSnapshotChunk(self, slot->value.hostFunction.IDs);
+		break;
+#endif
+	case XS_HOST_INSPECTOR_KIND:
+		slot->value.hostInspector.cache = fxProjectSnapshotSlot(self, slot->value.hostInspector.cache);
+		slot->value.hostInspector.instance = fxProjectSnapshotSlot(self, slot->value.hostInspector.instance);
+		break;
+	case XS_EXPORT_KIND:
+		slot->value.export.closure = fxProjectSnapshotSlot(self, slot->value.export.closure);
+		slot->value.export.module = fxProjectSnapshotSlot(self, slot->value.export.module);
+		break;
+	}
+}
+
+void fxRelocateSnapshotTable(txSnapshotStream* self, txSlot** address, txSize length)
+{
+	while (length) {
+		*address = fxProjectSnapshotSlot(self, *address);
+		address++;
+		length--;
+	}
+}
+
+void fxUnmarkSnapshotTail(txSnapshotStream* self)
+{
+	txSlot* slot = self->tail;
+	while (slot && (slot->flag & XS_MARK_FLAG)) {
+		slot->flag &= ~XS_MARK_FLAG;
+		slot = slot->next;
+	}
+	self->tail = C_NULL;
+}
+
+txBoolean fxWriteSnapshot(txMachine* the, txSnapshot* snapshot)
+{
+	txSnapshotStream _self;
+	txSnapshotStream* self = &_self;
+	c_memset(self, 0, sizeof(txSnapshotStream));
+	self->snapshot = snapshot;
+	snapshot->error = XS_SNAPSHOT_NO_ERROR;
+	if (c_setjmp(self->jmp_buf) == 0) {
+		txSnapshotMachine machine;
+		txS1 version[XS_VERSION_SIZE];
+		txSlot* heap;
+		txSlot* slot;
+		txSlot* limit;
+		txBlock* block;
+		txSize size;
+		txS4 total;
+
+		mxSnapshotElseThrow((the->frame == C_NULL) && (the->cRoot == C_NULL) && (the->archive == C_NULL) && !the->shared && !the->sharedMachine && (the->aliasCount == 0), XS_SNAPSHOT_STATE_ERROR);
+		fxCollect(the, 1);
+
+		c_memset(&machine, 0, sizeof(txSnapshotMachine));
+		machine.slotSize = sizeof(txSlot);
+		slot = the->freeHeap;
+		while (slot) {
+			slot->flag |= XS_MARK_FLAG;
+			slot = slot->next;
+		}
+		heap = the->firstHeap;
+		while (heap) {
+			limit = heap->value.reference;
+			while ((limit > heap + 1) && ((limit - 1)->flag & XS_MARK_FLAG)) {
+				limit--;
+				limit->next = self->tail;
+				self->tail = limit;
+			}
+			slot = heap + 1;
+			while (slot < limit) {
+				if (slot->flag & XS_MARK_FLAG) {
+					slot->flag &= ~XS_MARK_FLAG;
+					slot->next = machine.freeHeap;
+					machine.freeHeap = slot;
+				}
+				slot++;
+			}
+			machine.heapCount += (txSize)(limit - (heap + 1));
+			machine.heapRangeCount++;
+			heap = heap->next;
+		}
+		the->freeHeap = machine.freeHeap;
+		slot = self->tail;
+		while (slot) {
+			if (!slot->next) {
+				slot->next = machine.freeHeap;
+				the->freeHeap = self->tail;
+				break;
+			}
+			slot = slot->next;
+		}
+		heap = the->firstHeap;
+		while (heap) {
+			slot = heap + 1;
+			limit = heap->value.reference;
+			while (slot < limit) {
+				if (!(slot->flag & XS_MARK_FLAG))
+					fxCheckSnapshotSlot(the, self, slot);
+				slot++;
+			}
+			heap = heap->next;
+		}
+		block = the->firstBlock;
+		while (block) {
+			machine.chunksSize += (txSize)(block->current - (((txByte*)block) + sizeof(txBlock)));
+			machine.blockRangeCount++;
+			block = block->nextBlock;
+		}
+		slot = the->stack;
+		while (slot < the->stackTop) {
+			fxCheckSnapshotSlot(the, self, slot);
+			slot++;
+		}
+		machine.stackCount = (txSize)(the->stackTop - the->stackBottom);
+		machine.stackSize = (txSize)(the->stackTop - the->stack);
+		machine.maximumStackCount = the->maximumStackCount;
+		machine.incrementalChunkSize = the->minimumChunksSize + sizeof(txBlock);
+		machine.incrementalHeapCount = the->minimumHeapCount;
+		machine.keyCount = the->keyCount;
+		machine.keyIndex = the->keyIndex;
+		machine.nameModulo = the->nameModulo;
+		machine.symbolModulo = the->symbolModulo;
+		machine.currentChunksSize = the->currentChunksSize;
+		machine.peakChunksSize = the->peakChunksSize;
+		machine.currentHeapCount = the->currentHeapCount;
+		machine.peakHeapCount = the->peakHeapCount;
+		machine.requireFlag = the->requireFlag;
+		machine.anchor = gxNoCode;
+		machine.codeAnchor = (const txByte*)(void*)fx_Array;
+		machine.dataAnchor = (const txByte*)gxTypeDispatches;
+		machine.preparation = the->preparation;
+
+		total = sizeof(Atom)
+			+ sizeof(Atom) + XS_VERSION_SIZE
+			+ sizeof(Atom) + snapshot->signatureLength
+			+ sizeof(Atom) + sizeof(txSnapshotMachine)
+			+ ((machine.heapRangeCount + machine.blockRangeCount + 1) * (sizeof(Atom) + (2 * sizeof(txByte*))))
+			+ (machine.heapCount * sizeof(txSlot))
+			+ machine.chunksSize
+			+ (machine.stackSize * sizeof(txSlot))
+			+ sizeof(Atom) + (machine.keyIndex * sizeof(txSlot*))
+			+ sizeof(Atom) + (machine.nameModulo * sizeof(txSlot*))
+			+ sizeof(Atom) + (machine.symbolModulo * sizeof(txSlot*));
+		fxWriteSnapshotAtom(self, total, XS_ATOM_SNAPSHOT);
+
+		version[0] = XS_MAJOR_VERSION;
+		version[1] = XS_MINOR_VERSION;
+		version[2] = XS_PATCH_VERSION;
+		version[3] = 0;
+		fxWriteSnapshotAtom(self, sizeof(Atom) + XS_VERSION_SIZE, XS_ATOM_VERSION);
+		fxWriteSnapshotBuffer(self, version, XS_VERSION_SIZE);
+		fxWriteSnapshotAtom(self, sizeof(Atom) + snapshot->signatureLength, XS_ATOM_SIGNATURE);
+		if (snapshot->signatureLength)
+			fxWriteSnapshotBuffer(self, snapshot->signature, snapshot->signatureLength);
+		fxWriteSnapshotAtom(self, sizeof(Atom) + sizeof(txSnapshotMachine), XS_ATOM_MACHINE);
+		fxWriteSnapshotBuffer(self, &machine, sizeof(txSnapshotMachine));
+
+		heap = the->firstHeap;
+		while (heap) {
+			txByte* range[2];
+			limit = heap->value.reference;
+			while ((limit > heap + 1) && ((limit - 1)->flag & XS_MARK_FLAG))
+				limit--;
+			range[0] = (txByte*)(heap + 1);
+			range[1] = (txByte*)limit;
+			size = (txSize)(range[1] - range[0]);
+			fxWriteSnapshotAtom(self, sizeof(Atom) + sizeof(range) + size, XS_ATOM_HEAP);
+			fxWriteSnapshotBuffer(self, range, sizeof(range));
+			fxWriteSnapshotBuffer(self, range[0], size);
+			heap = heap->next;
+		}
+		block = the->firstBlock;
+		while (block) {
+			txByte* range[2];
+			range[0] = ((txByte*)block) + sizeof(txBlock);
+			range[1] = block->current;
+			size = (txSize)(range[1] - range[0]);
+			fxWriteSnapshotAtom(self, sizeof(Atom) + sizeof(range) + size, XS_ATOM_BLOCK);
+			fxWriteSnapshotBuffer(self, range, sizeof(range));
+			fxWriteSnapshotBuffer(self, range[0], size);
+			block = block->nextBlock;
+		}
+		{
+			txByte* range[2];
+			range[0] = (txByte*)(the->stack);
+			range[1] = (txByte*)(the->stackTop);
+			size = (txSize)(range[1] - range[0]);
+			fxWriteSnapshotAtom(self, sizeof(Atom) + sizeof(range) + size, XS_ATOM_STACK);
+			fxWriteSnapshotBuffer(self, range, sizeof(range));
+			fxWriteSnapshotBuffer(self, range[0], size);
+		}
+
+		fxWriteSnapshotAtom(self, sizeof(Atom) + (machine.keyIndex * sizeof(txSlot*)), XS_ATOM_KEYS);
+		fxWriteSnapshotBuffer(self, the->keyArray, machine.keyIndex * sizeof(txSlot*));
+		fxWriteSnapshotAtom(self, sizeof(Atom) + (machine.nameModulo * sizeof(txSlot*)), XS_ATOM_NAMES);
+		fxWriteSnapshotBuffer(self, the->nameTable, machine.nameModulo * sizeof(txSlot*));
+		fxWriteSnapshotAtom(self, sizeof(Atom) + (machine.symbolModulo * sizeof(txSlot*)), XS_ATOM_SYMBOLS);
+		fxWriteSnapshotBuffer(self, the->symbolTable, machine.symbolModulo * sizeof(txSlot*));
+		fxUnmarkSnapshotTail(self);
+		return 1;
+	}
+	fxUnmarkSnapshotTail(self);
+	return 0;
+}
+
+void fxWriteSnapshotAtom(txSnapshotStream* self, txS4 size, txU4 type)
+{
+	txU1 buffer[sizeof(Atom)];
+	buffer[0] = (txU1)(size >> 24);
+	buffer[1] = (txU1)(size >> 16);
+	buffer[2] = (txU1)(size >> 8);
+	buffer[3] = (txU1)size;
+	buffer[4] = (txU1)(type >> 24);
+	buffer[5] = (txU1)(type >> 16);
+	buffer[6] = (txU1)(type >> 8);
+	buffer[7] = (txU1)type;
+	fxWriteSnapshotBuffer(self, buffer, sizeof(Atom));
+}
+
+void fxWriteSnapshotBuffer(txSnapshotStream* self, void* buffer, size_t size)
+{
+	mxSnapshotElseThrow(self->snapshot->write(self->snapshot->stream, buffer, size), XS_SNAPSHOT_STREAM_ERROR);
+}
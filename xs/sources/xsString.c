@@ -309,7 +309,7 @@ void fx_String_fromArrayBuffer(txMachine* the)
 		mxTypeError("no argument");
 	slot = mxArgv(0);
 	if (slot->kind == XS_REFERENCE_KIND) {
-		slot = slot->value.reference->next;
+		slot = mxAliasInstance(slot->value.reference)->next;
 		if (slot && (slot->kind == XS_ARRAY_BUFFER_KIND))
 			arrayBuffer = slot;
 	}
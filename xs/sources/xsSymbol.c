@@ -448,9 +448,16 @@ void fxKeyAt(txMachine* the, txID id, txIndex index, txSlot* slot)
 			slot->value.symbol = id;
 		}
 	}
+	else if (index < mxSmallIntegerStringCount) {
+		slot->kind = XS_STRING_X_KIND;
+		slot->value.string = mxSmallIntegerString(index);
+	}
 	else {
 		char buffer[16];
-		fxCopyStringC(the, slot, fxNumberToString(the->dtoa, index, buffer, sizeof(buffer), 0, 0));
+		if (index <= 0x7FFFFFFF)
+			fxCopyStringC(the, slot, fxIntegerToString(the->dtoa, (txInteger)index, buffer, sizeof(buffer)));
+		else
+			fxCopyStringC(the, slot, fxNumberToString(the->dtoa, index, buffer, sizeof(buffer), 0, 0));
 	}
 }
 
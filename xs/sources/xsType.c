@@ -55,6 +55,155 @@ const txBehavior ICACHE_FLASH_ATTR gxOrdinaryBehavior = {
 	fxOrdinarySetPrototype,
 };
 
+static void* fxAliasChunk(txMachine* the, void* data, txSize size);
+
+#define mxChunkSize(DATA) ((((txChunk*)(((txByte*)(DATA)) - sizeof(txChunk)))->size) - (txSize)sizeof(txChunk))
+
+void* fxAliasChunk(txMachine* the, void* data, txSize size)
+{
+	void* result = fxNewChunk(the, size);
+	c_memcpy(result, data, size);
+	return result;
+}
+
+txSlot* fxAliasClosure(txMachine* the, txSlot* closure)
+{
+	txSlot* alias;
+	if (!(closure->flag & XS_ALIAS_FLAG))
+		return closure;
+	alias = the->aliasArray[closure->ID];
+	if (!alias) {
+		alias = fxNewSlot(the);
+		alias->flag = closure->flag & ~(XS_ALIAS_FLAG | XS_MARK_FLAG);
+		alias->kind = closure->kind;
+		alias->value = closure->value;
+		the->aliasArray[closure->ID] = alias;
+	}
+	return alias;
+}
+
+txSlot* fxAliasInstance(txMachine* the, txSlot* instance)
+{
+	txSlot* alias;
+	txSlot* from;
+	txSlot** address;
+	txSlot* property;
+	txSlot* table = C_NULL;
+	if (instance->ID < 0)
+		return instance;
+	alias = the->aliasArray[instance->ID];
+	if (alias)
+		return alias;
+	alias = fxNewSlot(the);
+	alias->flag = instance->flag & ~XS_MARK_FLAG;
+	alias->kind = XS_INSTANCE_KIND;
+	alias->value.instance.garbage = C_NULL;
+	alias->value.instance.prototype = instance->value.instance.prototype;
+	the->aliasArray[instance->ID] = alias;
+	from = instance->next;
+	address = &(alias->next);
+	while (from) {
+		property = *address = fxNewSlot(the);
+		property->ID = from->ID;
+		property->flag = from->flag & ~XS_MARK_FLAG;
+		property->kind = XS_UNDEFINED_KIND;
+		switch (from->kind) {
+		case XS_ARGUMENTS_SLOPPY_KIND:
+		case XS_ARGUMENTS_STRICT_KIND:
+		case XS_ARRAY_KIND:
+		case XS_STACK_KIND:
+			/* the chunk header of arrays in ROM only tells the count of items */
+			property->value.array.length = from->value.array.length;
+			property->value.array.address = C_NULL;
+			property->kind = from->kind;
+			if (from->value.array.address)
+				property->value.array.address = (txSlot*)fxAliasChunk(the, from->value.array.address, (txSize)(fxGetIndexSize(the, from) * sizeof(txSlot)));
+			break;
+		case XS_PACKED_INTEGER_KIND:
+		case XS_PACKED_NUMBER_KIND:
+			property->value.array.length = from->value.array.length;
+			property->value.array.address = C_NULL;
+			property->kind = from->kind;
+			if (from->value.array.address)
+				property->value.array.address = (txSlot*)fxAliasChunk(the, from->value.array.address, mxChunkSize(from->value.array.address));
+			break;
+		case XS_ARRAY_BUFFER_KIND:
+			property->value.arrayBuffer.length = from->value.arrayBuffer.length;
+			property->value.arrayBuffer.address = C_NULL;
+			property->kind = from->kind;
+			if (from->value.arrayBuffer.address)
+				property->value.arrayBuffer.address = (txByte*)fxAliasChunk(the, from->value.arrayBuffer.address, mxChunkSize(from->value.arrayBuffer.address));
+			break;
+		case XS_CALLBACK_KIND:
+			property->value.callback.address = from->value.callback.address;
+			property->value.callback.IDs = C_NULL;
+			property->kind = from->kind;
+			if (from->value.callback.IDs)
+				property->value.callback.IDs = (txID*)fxAliasChunk(the, from->value.callback.IDs, mxChunkSize(from->value.callback.IDs));
+			break;
+		case XS_HOST_KIND:
+			/* the host data still belongs to the shared instance */
+			property->flag &= ~(XS_HOST_CHUNK_FLAG | XS_HOST_HOOKS_FLAG);
+			property->value.host.data = from->value.host.data;
+			property->value.host.variant.destructor = C_NULL;
+			property->kind = from->kind;
+			break;
+		case XS_REGEXP_KIND:
+			property->value.regexp.code = C_NULL;
+			property->value.regexp.data = C_NULL;
+			property->kind = from->kind;
+			if (from->value.regexp.code)
+				property->value.regexp.code = (txInteger*)fxAliasChunk(the, from->value.regexp.code, mxChunkSize(from->value.regexp.code));
+			if (from->value.regexp.data)
+				property->value.regexp.data = (txInteger*)fxAliasChunk(the, from->value.regexp.data, mxChunkSize(from->value.regexp.data));
+			break;
+		case XS_GLOBAL_KIND:
+		case XS_MAP_KIND:
+		case XS_SET_KIND:
+		case XS_WEAK_MAP_KIND:
+		case XS_WEAK_SET_KIND:
+			/* tables in ROM have no chunk header, and no address at all for maps and sets */
+			property->value.table.length = from->value.table.length;
+			if (!from->value.table.address) {
+				property->value.table.address = C_NULL;
+				property->kind = from->kind;
+				break;
+			}
+			if ((from->kind == XS_WEAK_MAP_KIND) || (from->kind == XS_WEAK_SET_KIND))
+				property->value.table.address = (txSlot**)fxAliasChunk(the, from->value.table.address, (from->value.table.length + 1) * sizeof(txSlot*));
+			else
+				property->value.table.address = (txSlot**)fxAliasChunk(the, from->value.table.address, from->value.table.length * sizeof(txSlot*));
+			property->kind = from->kind;
+			if (from->kind == XS_GLOBAL_KIND)
+				break;
+			c_memset(property->value.table.address, 0, property->value.table.length * sizeof(txSlot*));
+			if ((from->kind == XS_MAP_KIND) || (from->kind == XS_SET_KIND))
+				table = property;
+			else
+				fxAliasEntries(the, from, property, C_NULL, (from->kind == XS_WEAK_MAP_KIND) ? 1 : 0);
+			break;
+		case XS_LIST_KIND:
+			property->kind = from->kind;
+			if (table) {
+				property->value.list.first = C_NULL;
+				property->value.list.last = C_NULL;
+				fxAliasEntries(the, from, table, property, (table->kind == XS_MAP_KIND) ? 1 : 0);
+				table = C_NULL;
+			}
+			else
+				property->value = from->value;
+			break;
+		default:
+			property->kind = from->kind;
+			property->value = from->value;
+			break;
+		}
+		address = &(property->next);
+		from = from->next;
+	}
+	return alias;
+}
+
 txSlot* fxGetInstance(txMachine* the, txSlot* theSlot)
 {
 	if (theSlot->kind == XS_REFERENCE_KIND)
@@ -131,12 +280,20 @@ txSlot* fxToInstance(txMachine* the, txSlot* theSlot)
 		break;
 #ifdef mxHostFunctionPrimitive
 	case XS_HOST_FUNCTION_KIND: {
+		const txHostFunctionBuilder* builder = theSlot->value.hostFunction.builder;
 		txByte* code = the->code;
 		the->code = (txByte*)(theSlot->value.hostFunction.IDs);
-		anInstance = fxNewHostFunction(the, theSlot->value.hostFunction.builder->callback, theSlot->value.hostFunction.builder->length, 
-			(theSlot->value.hostFunction.IDs && (theSlot->value.hostFunction.builder->id >= 0)) 
-				? theSlot->value.hostFunction.IDs[theSlot->value.hostFunction.builder->id]
-				: theSlot->value.hostFunction.builder->id);
+		anInstance = fxNewHostFunction(the, builder->callback, builder->length, 
+			(theSlot->value.hostFunction.IDs && (builder->id >= 0)) 
+				? theSlot->value.hostFunction.IDs[builder->id]
+				: builder->id);
+		if (builder->signature) {
+			anInstance->next->flag |= XS_FAST_FLAG;
+			anInstance->next->ID = builder->signature;
+		#ifndef mxLink
+			anInstance->next->value.fastCallback.address = builder->fastCallback;
+		#endif
+		}
 		the->code = code;
 		mxPullSlot(theSlot);
 		} break;
@@ -152,32 +309,37 @@ void fxToPrimitive(txMachine* the, txSlot* theSlot, txInteger theHint)
 {
 	if (theSlot->kind == XS_REFERENCE_KIND) {
 		fxBeginHost(the);
-		if (theHint == XS_NO_HINT)
-			mxPushSlot(&mxDefaultString);
-		else if (theHint == XS_NUMBER_HINT)
-			mxPushSlot(&mxNumberString);
-		else
-			mxPushSlot(&mxStringString);
-		mxPushInteger(1);
-		mxPushSlot(theSlot);
-		mxPushSlot(theSlot);
-		fxGetID(the, mxID(_Symbol_toPrimitive));
-		if ((the->stack->kind == XS_UNDEFINED_KIND) || (the->stack->kind == XS_NULL_KIND)) {
-            the->stack++;
-			mxPushSlot(&mxObjectPrototype);
-			fxGetID(the, mxID(_Symbol_toPrimitive));
-		}
-		fxCall(the);
+		fxPushPrimitive(the, theSlot, theHint);
 		theSlot->kind = the->stack->kind;
 		theSlot->value = the->stack->value;
-		if (theSlot->kind == XS_REFERENCE_KIND) {
-			mxTypeError("cannot coerce to primitive");
-		}
 		the->stack++;
 		fxEndHost(the);
 	}
 }
 
+void fxPushPrimitive(txMachine* the, txSlot* theSlot, txInteger theHint)
+{
+	if (theHint == XS_NO_HINT)
+		mxPushSlot(&mxDefaultString);
+	else if (theHint == XS_NUMBER_HINT)
+		mxPushSlot(&mxNumberString);
+	else
+		mxPushSlot(&mxStringString);
+	mxPushInteger(1);
+	mxPushSlot(theSlot);
+	mxPushSlot(theSlot);
+	fxGetID(the, mxID(_Symbol_toPrimitive));
+	if ((the->stack->kind == XS_UNDEFINED_KIND) || (the->stack->kind == XS_NULL_KIND)) {
+		the->stack++;
+		mxPushSlot(&mxObjectPrototype);
+		fxGetID(the, mxID(_Symbol_toPrimitive));
+	}
+	fxCall(the);
+	if (the->stack->kind == XS_REFERENCE_KIND) {
+		mxTypeError("cannot coerce to primitive");
+	}
+}
+
 
 void fxOrdinaryCall(txMachine* the, txSlot* instance, txSlot* _this, txSlot* arguments)
 {
@@ -229,6 +391,8 @@ txBoolean fxOrdinaryDefineOwnProperty(txMachine* the, txSlot* instance, txID id,
 {
 	txSlot* property = instance->next;
 	txBoolean result = 1;
+	if (instance->ID >= 0)
+		instance = fxAliasInstance(the, instance);
 	property = mxBehaviorGetProperty(the, instance, id, index, XS_OWN);
 	if (property) {
 		if (property->flag & XS_DONT_DELETE_FLAG) {
@@ -332,10 +496,10 @@ txBoolean fxOrdinaryDefineOwnProperty(txMachine* the, txSlot* instance, txID id,
 
 txBoolean fxOrdinaryDeleteProperty(txMachine* the, txSlot* instance, txID id, txIndex index)
 {
-	txSlot** address = &(instance->next);
+	txSlot** address;
 	txSlot* property;
 	if (instance->ID >= 0)
-		return 0;
+		instance = fxAliasInstance(the, instance);
 	address = &(instance->next);
 	while ((property = *address) && (property->flag & XS_INTERNAL_FLAG))
 		address = &(property->next);
@@ -378,14 +542,8 @@ txSlot* fxOrdinaryGetProperty(txMachine* the, txSlot* instance, txID id, txIndex
     txSlot* result;
 	mxCheck(the, instance->kind == XS_INSTANCE_KIND);
 again:
-	if (instance->ID >= 0) {
-		txSlot* alias = the->aliasArray[instance->ID];
-		if (alias) {
-			result = mxBehaviorGetProperty(the, alias, id, index, XS_OWN);
-			if (result)
-				return result;
-		}
-	}
+	if (instance->ID >= 0)
+		instance = mxAliasInstance(instance);
 	result = instance->next;
 	while (result && (result->flag & XS_INTERNAL_FLAG))
 		result = result->next;
@@ -454,7 +612,7 @@ bail:
 
 txBoolean fxOrdinaryGetPrototype(txMachine* the, txSlot* instance, txSlot* result)
 {
-	txSlot* prototype = instance->value.instance.prototype;
+	txSlot* prototype = mxAliasInstance(instance)->value.instance.prototype;
 	if (prototype) {
 		result->kind = XS_REFERENCE_KIND;
 		result->value.reference = prototype;
@@ -481,12 +639,12 @@ txBoolean fxOrdinaryHasProperty(txMachine* the, txSlot* instance, txID id, txInd
 
 txBoolean fxOrdinaryIsExtensible(txMachine* the, txSlot* instance)
 {
-	return (instance->flag & XS_DONT_PATCH_FLAG) ? 0 : 1;
+	return (mxAliasInstance(instance)->flag & XS_DONT_PATCH_FLAG) ? 0 : 1;
 }
 
 void fxOrdinaryOwnKeys(txMachine* the, txSlot* instance, txFlag flag, txSlot* keys)
 {
-	txSlot* property = instance->next;
+	txSlot* property = mxAliasInstance(instance)->next;
 	while (property && (property->flag & XS_INTERNAL_FLAG))
 		property = property->next;
 	if (property && (property->kind == XS_ARRAY_KIND)) {
@@ -498,6 +656,8 @@ void fxOrdinaryOwnKeys(txMachine* the, txSlot* instance, txFlag flag, txSlot* ke
 
 txBoolean fxOrdinaryPreventExtensions(txMachine* the, txSlot* instance)
 {
+	if (instance->ID >= 0)
+		instance = fxAliasInstance(the, instance);
 	instance->flag |= XS_DONT_PATCH_FLAG;
 	return 1;
 }
@@ -508,12 +668,6 @@ txSlot* fxOrdinarySetProperty(txMachine* the, txSlot* instance, txID id, txIndex
 	txSlot* property;
 	txSlot* result;
 	if (instance->ID >= 0) {
-		txSlot* alias = the->aliasArray[instance->ID];
-		if (alias) {
-			property = mxBehaviorGetProperty(the, alias, id, index, XS_OWN);
-			if (property)
-				return property;
-		}
 		property = mxBehaviorGetProperty(the, instance, id, index, flag);
 		if (property) {
 			if (property->kind == XS_ACCESSOR_KIND)
@@ -521,17 +675,7 @@ txSlot* fxOrdinarySetProperty(txMachine* the, txSlot* instance, txID id, txIndex
 			if (property->flag & XS_DONT_SET_FLAG)
 				return property;
 		}
-		if (instance->flag & XS_DONT_PATCH_FLAG)
-			return C_NULL;
-		if (!alias) {
-			alias = fxNewSlot(the);
-			alias->kind = XS_INSTANCE_KIND;
-			alias->value.instance.garbage = C_NULL;
-			alias->value.instance.prototype = C_NULL;
-			the->aliasArray[instance->ID] = alias;
-		}
-		instance = alias;
-		flag = XS_OWN;
+		instance = fxAliasInstance(the, instance);
 	}
 	address = &(instance->next);
 	while ((property = *address) && (property->flag & XS_INTERNAL_FLAG))
@@ -637,15 +781,17 @@ bail:
 txBoolean fxOrdinarySetPrototype(txMachine* the, txSlot* instance, txSlot* slot)
 {
 	txSlot* prototype = (slot->kind == XS_NULL_KIND) ? C_NULL : slot->value.reference;
-	if (instance->value.instance.prototype != prototype) {
-		if (instance->flag & XS_DONT_PATCH_FLAG)
+	if (mxAliasInstance(instance)->value.instance.prototype != prototype) {
+		if (mxAliasInstance(instance)->flag & XS_DONT_PATCH_FLAG)
 			return 0;
 		slot = prototype;
 		while (slot) {
 			if (instance == slot) 
 				return 0;
-			slot = slot->value.instance.prototype;
+			slot = mxAliasInstance(slot)->value.instance.prototype;
 		}
+		if (instance->ID >= 0)
+			instance = fxAliasInstance(the, instance);
 		instance->value.instance.prototype = prototype;
 	}
 	return 1;
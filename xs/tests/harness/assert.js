@@ -0,0 +1,32 @@
+/*
+ * Subset of the test262 harness, enough to run the XS regression cases with xst.
+ */
+
+function assert(actual, message) {
+	if (actual !== true)
+		throw new Test262Error(message || "expected true but got " + String(actual));
+}
+assert._isSameValue = function (a, b) {
+	if (a === b)
+		return (a !== 0) || (1 / a === 1 / b);
+	return (a !== a) && (b !== b);
+};
+assert.sameValue = function (actual, expected, message) {
+	if (!assert._isSameValue(actual, expected))
+		throw new Test262Error((message ? message + " " : "") + "expected " + String(expected) + " but got " + String(actual));
+};
+assert.notSameValue = function (actual, unexpected, message) {
+	if (assert._isSameValue(actual, unexpected))
+		throw new Test262Error((message ? message + " " : "") + "unexpected " + String(actual));
+};
+assert.throws = function (expectedErrorConstructor, func, message) {
+	try {
+		func();
+	}
+	catch (error) {
+		if ((typeof error !== "object") || (error === null) || (error.constructor !== expectedErrorConstructor))
+			throw new Test262Error((message ? message + " " : "") + "expected " + expectedErrorConstructor.name + " but got " + String(error));
+		return;
+	}
+	throw new Test262Error((message ? message + " " : "") + "expected " + expectedErrorConstructor.name + " but nothing was thrown");
+};
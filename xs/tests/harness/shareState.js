@@ -0,0 +1,30 @@
+// Builds the state that test/share/mutate.js changes in clones of the shared machine.
+
+var sharedArray = [1, 2, 3];
+var sharedHoles = [1, , 3];
+var sharedCounter = (function() {
+	var n = 0;
+	return function() {
+		return ++n;
+	};
+})();
+function sharedFunction() {
+	return sharedFunction.x;
+}
+sharedFunction.x = 0;
+var sharedObject = { a: 1 };
+var sharedKey = {};
+var sharedMap = new Map([[1, "one"], [sharedKey, "key"]]);
+var sharedSet = new Set(["a", sharedKey]);
+var sharedWeakMap = new WeakMap([[sharedKey, "weak"]]);
+var sharedBuffer = new ArrayBuffer(8);
+var sharedBytes = new Uint8Array(sharedBuffer);
+var sharedDate = new Date(0);
+var sharedFrozen = Object.freeze([1, 2]);
+var sharedCycle = { name: "cycle" };
+sharedCycle.self = sharedCycle;
+function* sharedGenerator() {
+	yield 1;
+	yield 2;
+}
+var sharedIterator = sharedGenerator();
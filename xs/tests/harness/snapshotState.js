@@ -0,0 +1,46 @@
+// Builds the state that test/snapshot/state.js checks after xst wrote, deleted and read back the machine.
+
+var snapshotSymbol = Symbol("snapshot");
+var snapshotKey = {};
+var snapshotMap = new Map([[1, "one"], ["two", 2], [snapshotKey, snapshotSymbol]]);
+var snapshotSet = new Set(["a", "b", snapshotKey]);
+var snapshotWeakMap = new WeakMap([[snapshotKey, "weak"]]);
+var snapshotRegExp = /(\d+)-(\d+)/g;
+var snapshotTypedArray = new Float64Array([0.5, 1.5, 2.5, 3.5]);
+var snapshotView = new DataView(snapshotTypedArray.buffer, 8, 16);
+var snapshotArray = [1, 2, 3];
+snapshotArray[10] = "sparse";
+var snapshotString = "snap" + "shot".repeat(3);
+var snapshotObject = {
+	[snapshotSymbol]: "symbol",
+	get getter() { return this.value * 2; },
+	value: 21,
+};
+var snapshotCounter = (function() {
+	var count = 0;
+	return function() {
+		return ++count;
+	};
+})();
+snapshotCounter();
+function* snapshotGenerator() {
+	yield 1;
+	yield 2;
+	yield 3;
+}
+var snapshotIterator = snapshotGenerator();
+snapshotIterator.next();
+var SnapshotBase = class {
+	constructor(name) {
+		this.name = name;
+	}
+	greet() {
+		return "hello " + this.name;
+	}
+};
+var SnapshotDerived = class extends SnapshotBase {
+	greet() {
+		return super.greet() + "!";
+	}
+};
+var snapshotInstance = new SnapshotDerived("snapshot");
@@ -0,0 +1,19 @@
+/*
+ * Subset of the test262 harness, enough to run the XS regression cases with xst.
+ */
+
+function Test262Error(message) {
+	this.message = message || "";
+}
+Test262Error.prototype.toString = function () {
+	return "Test262Error: " + this.message;
+};
+Test262Error.thrower = function (message) {
+	throw new Test262Error(message);
+};
+function $ERROR(message) {
+	throw new Test262Error(message);
+}
+function $DONOTEVALUATE() {
+	throw "Test262: This statement should not be evaluated.";
+}
@@ -0,0 +1,58 @@
+/*---
+description: slice, splice and map keep holes when the source is sparse, so sort and reverse see the same items as with the generic algorithms.
+---*/
+
+function keys(array) {
+	return Object.keys(array).join();
+}
+
+var a = [1,,3];
+var b = a.slice();
+assert.sameValue(b.length, 3, "slice length");
+assert.sameValue(b.hasOwnProperty(1), false, "slice hole");
+assert.sameValue(keys(b), "0,2", "slice keys");
+assert.sameValue(keys([0,1,,3,4].slice(1, 4)), "0,2", "slice range keys");
+
+var c = [5,,1].slice().sort();
+assert.sameValue(c[0], 1, "slice then sort");
+assert.sameValue(c[1], 5, "slice then sort");
+assert.sameValue(c.hasOwnProperty(2), false, "slice then sort hole");
+
+var d = [1,,3,4].slice().reverse();
+assert.sameValue(d.join(), "4,3,,1", "slice then reverse");
+assert.sameValue(keys(d), "0,1,3", "slice then reverse keys");
+
+var e = [1,,3,4];
+var f = e.splice(0, 3);
+assert.sameValue(f.length, 3, "splice deleted length");
+assert.sameValue(keys(f), "0,2", "splice deleted keys");
+assert.sameValue(e.join(), "4", "splice rest");
+assert.sameValue(keys([9,,8].splice(0).sort()), "0,1", "splice then sort keys");
+assert.sameValue([9,,8].splice(0).sort().join(), "8,9,", "splice then sort");
+
+var g = [1,,3].map(function(x) { return x * 2; });
+assert.sameValue(g.length, 3, "map length");
+assert.sameValue(keys(g), "0,2", "map keys");
+assert.sameValue(g.reverse().join(), "6,,2", "map then reverse");
+
+var h = [1,2,3].slice();
+assert.sameValue(keys(h), "0,1,2", "dense slice keys");
+assert.sameValue([3,1,2].slice(0).sort().join(), "1,2,3", "dense slice then sort");
+assert.sameValue([1,2,3,4].splice(1, 2).join(), "2,3", "dense splice");
+
+var leaked;
+class Leaky extends Array {
+	static get [Symbol.species]() {
+		return function(length) {
+			leaked = new Array(length);
+			return leaked;
+		};
+	}
+}
+var i = Leaky.from([1, 2, 3]);
+var j = i.map(function(x, index) {
+	assert.sameValue(leaked.hasOwnProperty(index), false, "species result before define");
+	return x;
+});
+assert.sameValue(j, leaked, "species result");
+assert.sameValue(keys(j), "0,1,2", "species map keys");
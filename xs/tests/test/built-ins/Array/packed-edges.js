@@ -0,0 +1,41 @@
+/*---
+description: numbers at the edges of the integer range keep their value once stored in a packed array.
+---*/
+
+var max = 2147483648 - 1; // a number, not an integer
+
+var a = [];
+a.push(-2147483648);
+a[0]--;
+assert.sameValue(a[0], -2147483649, "push INT32_MIN then decrement");
+
+var b = [];
+b.push(max);
+b[0]++;
+assert.sameValue(b[0], 2147483648, "push INT32_MAX then increment");
+
+var c = [0];
+c[0] = max;
+c[0]++;
+assert.sameValue(c[0], 2147483648, "set INT32_MAX then increment");
+
+var d = [1, 2];
+d[2] = -2147483648;
+d[2]--;
+assert.sameValue(d[2], -2147483649, "append INT32_MIN then decrement");
+
+var e = new Array(3).fill(max);
+e[1]++;
+assert.sameValue(e[1], 2147483648, "fill INT32_MAX then increment");
+
+var f = [1, 2].map(function(x) { return x * 2147483648 - 1; });
+f[0]++;
+assert.sameValue(f[0], 2147483648, "map INT32_MAX then increment");
+
+var g = [];
+g.push(3e9, -0, 0.5, 2147483646);
+g[3]++;
+assert.sameValue(g[0], 3e9, "push large number");
+assert.sameValue(1 / g[1], -Infinity, "push negative zero");
+assert.sameValue(g[2], 0.5, "push fraction");
+assert.sameValue(g[3], 2147483647, "push integer then increment");
@@ -0,0 +1,39 @@
+/*---
+description: JSON.stringify copies safe bytes by words, then finishes the tail of strings byte by byte, whatever the length and the position of the characters to escape.
+---*/
+
+function escape(string) {
+	var result = '"';
+	for (var i = 0; i < string.length; i++) {
+		var c = string[i];
+		if (c == '"')
+			result += '\\"';
+		else if (c == '\\')
+			result += '\\\\';
+		else if (c == '\n')
+			result += '\\n';
+		else if (c == '\u0001')
+			result += '\\u0001';
+		else
+			result += c;
+	}
+	return result + '"';
+}
+
+var specials = [ '"', '\\', '\n', '\u0001' ];
+var others = [ '\u007F', 'é', '\u{1F600}' ];
+for (var length = 0; length < 20; length++) {
+	var plain = "abcdefghijklmnopqrstuvwxyz".slice(0, length);
+	assert.sameValue(JSON.stringify(plain), '"' + plain + '"', "plain " + length);
+	for (var position = 0; position <= length; position++) {
+		for (var special of specials) {
+			var string = plain.slice(0, position) + special + plain.slice(position);
+			assert.sameValue(JSON.stringify(string), escape(string), "length " + length + " position " + position);
+			assert.sameValue(JSON.parse(JSON.stringify(string)), string, "round trip " + length + " position " + position);
+		}
+		for (var other of others) {
+			var string = plain.slice(0, position) + other + plain.slice(position);
+			assert.sameValue(JSON.parse(JSON.stringify(string)), string, "round trip " + length + " position " + position);
+		}
+	}
+}
@@ -0,0 +1,28 @@
+/*---
+description: JSON.stringifyToArrayBuffer writes the same bytes as JSON.stringify, while the output grows and while toJSON allocates enough to collect and compact.
+---*/
+
+function churn() {
+	var garbage;
+	for (var i = 0; i < 20000; i++)
+		garbage = { index: i, string: "item" + i, buffer: new ArrayBuffer(64) };
+	return this.name;
+}
+
+var names = [];
+for (var i = 0; i < 200; i++)
+	names.push("name " + i + " ".repeat(i % 7) + "\"quoted\" and \\ and \n and é " + "x".repeat(i));
+var value = {
+	names,
+	numbers: names.map((name, index) => index * 1.5),
+	nested: names.slice(0, 20).map(name => ({ name, toJSON: churn })),
+};
+
+var expected = JSON.stringify(value, null, "\t");
+var buffer = JSON.stringifyToArrayBuffer(value, null, "\t");
+assert.sameValue(buffer instanceof ArrayBuffer, true, "array buffer");
+assert.sameValue(buffer.byteLength, ArrayBuffer.fromString(expected).byteLength, "byte length");
+assert.sameValue(String.fromArrayBuffer(buffer), expected, "bytes");
+
+assert.sameValue(JSON.stringifyToArrayBuffer(undefined), undefined, "undefined");
+assert.sameValue(String.fromArrayBuffer(JSON.stringifyToArrayBuffer("a")), '"a"', "string");
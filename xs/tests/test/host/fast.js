@@ -0,0 +1,85 @@
+/*---
+description: fast host functions convert their arguments like ToInt32 and ToNumber, in order, whether called directly or through call, apply and bind. Buffer arguments are read after the other arguments are converted, so a collection or a detach in valueOf is seen. xst defines the hosts of $262.fast with the signatures sum(iiiiii)i, scale(ni)n, isNaN(n)b and peek(pi)i.
+---*/
+
+const { sum, scale, isNaN, peek } = $262.fast;
+
+assert.sameValue(sum(1, 2), 3, "missing integers are 0");
+assert.sameValue(sum(1, 2, 3, 4, 5, 6, 7), 21, "extra arguments are ignored");
+assert.sameValue(sum(2 ** 32 + 5), 5, "modulo 2^32");
+assert.sameValue(sum(-0.5), 0, "truncated");
+assert.sameValue(sum(-1.5), -1, "truncated toward zero");
+assert.sameValue(sum(NaN, Infinity, -Infinity), 0, "not finite");
+assert.sameValue(sum(2147483647, 1), -2147483648, "int32 result");
+assert.sameValue(sum("12", true, null, undefined, [3]), 16, "converted");
+assert.throws(TypeError, () => sum(Symbol()), "symbol");
+
+assert.sameValue(scale(1.5, 2), 3, "number and integer");
+assert.sameValue(scale(), NaN, "missing number is NaN");
+assert.sameValue(scale("2.5", "4"), 10, "strings");
+assert.sameValue(scale(2 ** 40, 2), 2 ** 41, "large number");
+assert.sameValue(isNaN(), true, "missing");
+assert.sameValue(isNaN("x"), true, "string");
+assert.sameValue(isNaN(1), false, "integer");
+assert.sameValue(typeof isNaN(0.5), "boolean", "boolean result");
+
+const order = [];
+function logged(name, value) {
+	return { valueOf() { order.push(name); return value; } };
+}
+assert.sameValue(sum(logged("a", 1), logged("b", 2), logged("c", 3)), 6, "valueOf results");
+assert.sameValue(order.join(), "a,b,c", "converted in order");
+order.length = 0;
+assert.throws(Test262Error, () => sum(logged("a", 1), { valueOf() { throw new Test262Error(); } }, logged("c", 3)), "valueOf throws");
+assert.sameValue(order.join(), "a", "conversion stops at the exception");
+assert.sameValue(sum({ valueOf() { return sum(1, sum(2, 3)); } }, 4), 10, "nested calls in valueOf");
+
+assert.sameValue(sum.call(null, 1, 2), 3, "call");
+assert.sameValue(sum.apply(null, [1, "2", 2 ** 32 + 3]), 6, "apply");
+assert.sameValue(sum.bind(null, 1)(2), 3, "bind");
+assert.sameValue(Reflect.apply(scale, null, [1.5, 2]), 3, "Reflect.apply");
+assert.sameValue([1, 2, 3].map(value => sum(value, value)).join(), "2,4,6", "in a callback");
+let total = 0;
+for (let i = 0; i < 10000; i++)
+	total = sum(total, i);
+assert.sameValue(total, 49995000, "in a loop");
+
+const bytes = new Uint8Array(256);
+for (let i = 0; i < 256; i++)
+	bytes[i] = i;
+assert.sameValue(peek(bytes.buffer, 200), 200, "ArrayBuffer");
+assert.sameValue(peek(bytes.buffer, -1), 256, "ArrayBuffer length");
+assert.sameValue(peek(bytes.buffer, 256), -1, "past the end");
+assert.sameValue(peek(bytes.subarray(16, 32), 1), 17, "typed array offset");
+assert.sameValue(peek(bytes.subarray(16, 32), -1), 16, "typed array length");
+assert.sameValue(peek(new DataView(bytes.buffer, 100, 10), 9), 109, "data view offset");
+assert.sameValue(peek(new DataView(bytes.buffer, 100, 10), -1), 10, "data view length");
+assert.sameValue(peek(new Uint16Array(bytes.buffer, 2, 3), -1), 6, "length in bytes");
+assert.throws(TypeError, () => peek({}, 0), "object");
+assert.throws(TypeError, () => peek(undefined, 0), "undefined");
+assert.throws(TypeError, () => peek(), "missing");
+assert.throws(TypeError, () => peek.call(null, 1, 0), "number through call");
+
+let garbage = [];
+for (let i = 0; i < 2000; i++)
+	garbage.push("garbage " + i);
+const moved = new Uint8Array(4096);
+for (let i = 0; i < 4096; i++)
+	moved[i] = i % 251;
+const collect = {
+	valueOf() {
+		garbage = null;
+		$262.gc();
+		for (let i = 0; i < 4000; i++)
+			garbage = [garbage, "live strings where the buffer was " + i];
+		$262.gc();
+		return 4000;
+	}
+};
+assert.sameValue(peek(moved.buffer, collect), 4000 % 251, "collection during conversion");
+garbage = null;
+assert.sameValue(peek.call(null, moved.subarray(10), collect), 4010 % 251, "collection during conversion through call");
+
+const detached = new ArrayBuffer(8);
+assert.throws(TypeError, () => peek(detached, { valueOf() { $262.detachArrayBuffer(detached); return 0; } }), "detached during conversion");
+assert.throws(TypeError, () => peek(detached, 0), "detached");
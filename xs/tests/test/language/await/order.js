@@ -0,0 +1,63 @@
+/*---
+description: await resumes after the same number of jobs as the spec, for primitives, native promises, subclass promises and thenables, interleaved with a chain of then.
+flags: [async]
+---*/
+
+const log = [];
+
+function ticks(count) {
+	let promise = Promise.resolve();
+	for (let i = 1; i <= count; i++)
+		promise = promise.then(() => log.push(i));
+	return promise;
+}
+
+class SubPromise extends Promise {
+}
+
+async function awaitValue(name, value) {
+	log.push(name);
+	await value;
+	log.push(name);
+}
+
+async function run(name, value) {
+	log.length = 0;
+	const chain = ticks(5);
+	await Promise.all([ awaitValue(name, value), chain ]);
+	return log.join();
+}
+
+async function test() {
+	assert.sameValue(await run("u", undefined), "u,1,u,2,3,4,5", "primitive");
+	assert.sameValue(await run("p", Promise.resolve(1)), "p,1,p,2,3,4,5", "native promise");
+	const pending = new Promise(resolve => resolve(1));
+	assert.sameValue(await run("r", pending), "r,1,r,2,3,4,5", "resolved native promise");
+	assert.sameValue(await run("s", SubPromise.resolve(1)), "s,1,2,3,s,4,5", "subclass promise");
+	assert.sameValue(await run("t", { then(resolve) { resolve(1); } }), "t,1,2,t,3,4,5", "thenable");
+	assert.sameValue(await run("c", Promise.resolve(Promise.resolve(1))), "c,1,c,2,3,4,5", "promise of a promise");
+
+	log.length = 0;
+	const chain = ticks(2);
+	const rejected = (async function() {
+		try {
+			await Promise.reject(new Error("rejected"));
+		}
+		catch (e) {
+			log.push(e.message);
+		}
+	})();
+	await chain;
+	assert.sameValue(log.join(), "1,rejected,2", "rejected native promise");
+	await rejected;
+
+	const values = [];
+	async function loop() {
+		for (const value of [1, Promise.resolve(2), { then(resolve) { resolve(3); } }])
+			values.push(await value);
+	}
+	await loop();
+	assert.sameValue(values.join(), "1,2,3", "awaited values");
+}
+
+test().then($DONE, $DONE);
@@ -0,0 +1,98 @@
+/*---
+description: await reads the constructor of a native promise once and, when it is Promise, reacts to the promise without calling then, even a patched one. Other promises and thenables are resolved through their then.
+flags: [async]
+---*/
+
+async function test() {
+	const then = Promise.prototype.then;
+	let thenCalls = 0;
+	let constructorReads = 0;
+
+	const patched = Promise.resolve(1);
+	patched.then = function() {
+		thenCalls++;
+		return then.apply(this, arguments);
+	};
+	assert.sameValue(await patched, 1, "own then");
+	assert.sameValue(thenCalls, 0, "own then not called");
+
+	Promise.prototype.then = function() {
+		thenCalls++;
+		return then.apply(this, arguments);
+	};
+	try {
+		assert.sameValue(await Promise.resolve(2), 2, "patched Promise.prototype.then");
+		assert.sameValue(thenCalls, 0, "patched Promise.prototype.then not called");
+	}
+	finally {
+		Promise.prototype.then = then;
+	}
+
+	const counted = Promise.resolve(3);
+	Object.defineProperty(counted, "constructor", {
+		get() {
+			constructorReads++;
+			return Promise;
+		}
+	});
+	assert.sameValue(await counted, 3, "constructor getter");
+	assert.sameValue(constructorReads, 1, "constructor read once");
+
+	const foreign = Promise.resolve(4);
+	Object.defineProperty(foreign, "constructor", {
+		get() {
+			constructorReads++;
+			return Object;
+		}
+	});
+	foreign.then = function() {
+		thenCalls++;
+		return then.apply(this, arguments);
+	};
+	assert.sameValue(await foreign, 4, "other constructor");
+	assert.sameValue(constructorReads, 3, "other constructor read once by await, then by then for its species");
+	assert.sameValue(thenCalls, 1, "then called for another constructor");
+
+	const rejecting = Promise.reject(new RangeError("rejected"));
+	rejecting.then = function() {
+		thenCalls++;
+		return then.apply(this, arguments);
+	};
+	try {
+		await rejecting;
+		throw new Test262Error("no rejection");
+	}
+	catch (e) {
+		assert.sameValue(e.constructor, RangeError, "rejection");
+	}
+	assert.sameValue(thenCalls, 1, "then not called for a rejected promise");
+
+	let thenableReads = 0;
+	const thenable = {
+		get then() {
+			thenableReads++;
+			return function(resolve) {
+				resolve(5);
+			};
+		}
+	};
+	assert.sameValue(await thenable, 5, "thenable");
+	assert.sameValue(thenableReads, 1, "then of a thenable read once");
+
+	const primitive = Number.prototype;
+	Object.defineProperty(primitive, "then", {
+		configurable: true,
+		get() {
+			thenCalls++;
+		}
+	});
+	try {
+		assert.sameValue(await 6, 6, "number");
+		assert.sameValue(thenCalls, 1, "then of a primitive not read");
+	}
+	finally {
+		delete primitive.then;
+	}
+}
+
+test().then($DONE, $DONE);
@@ -0,0 +1,117 @@
+/*---
+description: closures see the value of each const they capture, whether the const is initialized before the closure is created, after it, or in another iteration, and reach it through eval.
+---*/
+
+function values(functions) {
+	return functions.map(f => f()).join();
+}
+
+const ofs = [];
+for (const x of [1, 2, 3])
+	ofs.push(() => x);
+assert.sameValue(values(ofs), "1,2,3", "for-of const");
+
+const ins = [];
+for (const key in { a: 1, b: 2 })
+	ins.push(() => key);
+assert.sameValue(values(ins), "a,b", "for-in const");
+
+const bodies = [];
+for (let i = 0; i < 3; i++) {
+	const doubled = i * 2;
+	bodies.push(() => doubled);
+}
+assert.sameValue(values(bodies), "0,2,4", "const in a loop body");
+
+const early = [];
+let count = 0;
+while (count < 3) {
+	early.push(() => later);
+	const later = count++;
+}
+assert.sameValue(values(early), "0,1,2", "closure created before the const of its iteration");
+
+const pending = [];
+for (let i = 0; i < 2; i++) {
+	pending.push(() => uninitialized);
+	if (i === 0)
+		assert.throws(ReferenceError, pending[0], "const read before its initialization");
+	const uninitialized = i;
+}
+assert.sameValue(values(pending), "0,1", "const read after its initialization");
+
+function hoisted() {
+	return declaredLater;
+}
+assert.throws(ReferenceError, hoisted, "hoisted function before the const");
+const declaredLater = "later";
+assert.sameValue(hoisted(), "later", "hoisted function after the const");
+
+function fallThrough(value) {
+	let f;
+	switch (value) {
+	case 0:
+		f = () => constant;
+	case 1:
+		const constant = value + 10;
+		if (!f)
+			f = () => constant;
+	}
+	return f();
+}
+assert.sameValue(fallThrough(0), 10, "closure created in an earlier case");
+assert.sameValue(fallThrough(1), 11, "closure created after the const");
+
+function outer() {
+	const a = 1;
+	const b = { value: 2 };
+	function middle() {
+		const c = 3;
+		return () => a + b.value + c;
+	}
+	const inner = middle();
+	b.value = 20;
+	return inner;
+}
+assert.sameValue(outer()(), 24, "nested capture sees the same object");
+
+function viaEval() {
+	const e = 5;
+	return [() => eval("e"), (name) => eval(name)];
+}
+const [direct, named] = viaEval();
+assert.sameValue(direct(), 5, "eval in a closure");
+assert.sameValue(named("e"), 5, "eval of a name in a closure");
+
+function* generator() {
+	const g = 6;
+	yield () => g;
+	const h = 7;
+	yield () => g + h;
+}
+assert.sameValue(values([...generator()]), "6,13", "generator closures");
+
+const member = 8;
+class Members {
+	get value() {
+		return member;
+	}
+	method() {
+		return member;
+	}
+	static read() {
+		return () => member;
+	}
+}
+assert.sameValue(new Members().value, 8, "getter");
+assert.sameValue(new Members().method(), 8, "method");
+assert.sameValue(Members.read()(), 8, "closure in a static method");
+
+function many() {
+	const c0 = 0, c1 = 1, c2 = 2, c3 = 3, c4 = 4, c5 = 5, c6 = 6, c7 = 7;
+	let changed = 0;
+	const f = () => c0 + c1 + c2 + c3 + c4 + c5 + c6 + c7 + changed;
+	changed = 100;
+	return f;
+}
+assert.sameValue(many()(), 128, "consts by value and a let by reference");
@@ -0,0 +1,84 @@
+/*---
+description: integers convert to the same strings whether or not they are small, and only canonical decimal strings below 2^32-1 are array indexes, including strings built at runtime.
+---*/
+
+function min32() {
+	return (-2147483647 - 1) | 0;
+}
+
+assert.sameValue(String(0), "0", "0");
+assert.sameValue(String(-0), "0", "-0");
+assert.sameValue(String(1023), "1023", "last shared string");
+assert.sameValue(String(1024), "1024", "first other string");
+assert.sameValue(String(-1), "-1", "negative");
+assert.sameValue(String(2147483647), "2147483647", "largest integer");
+assert.sameValue(String(min32()), "-2147483648", "smallest integer");
+assert.sameValue("" + min32(), "-2147483648", "smallest integer concatenated");
+assert.sameValue(String(1023.5), "1023.5", "fraction");
+assert.sameValue(String(1e21), "1e+21", "exponent");
+assert.sameValue(String(4294967295), "4294967295", "2^32-1");
+assert.sameValue((7).toString(), "7", "toString");
+assert.sameValue(String(5) === "5", true, "shared string equal to a literal");
+assert.sameValue(String(5) + String(12), "512", "shared strings concatenated");
+
+const object = {};
+object[1023] = "a";
+assert.sameValue(object["10" + "23"], "a", "built key reads a shared key");
+object["10" + "24"] = "b";
+assert.sameValue(object[1024], "b", "number reads a built key");
+object["-0"] = "minus zero";
+object["01"] = "leading zero";
+object["00"] = "zeros";
+object[0] = "zero";
+assert.sameValue(object[-0], "zero", "-0 converts to 0");
+assert.sameValue(object["-0"], "minus zero", "-0 is a string key");
+assert.sameValue(object[1], undefined, "01 is not 1");
+assert.sameValue(Object.keys(object).join(), "0,1023,1024,-0,01,00", "integer keys first, then strings in order");
+
+const array = [];
+array["-0"] = 1;
+array["01"] = 2;
+array["1.0"] = 3;
+array["+1"] = 4;
+array[" 1"] = 5;
+assert.sameValue(array.length, 0, "strings that are not canonical are not indexes");
+array["999999999"] = 6;
+assert.sameValue(array.length, 1000000000, "nine digits");
+array["1000000000"] = 7;
+assert.sameValue(array.length, 1000000001, "ten digits");
+array["4294967294"] = 8;
+assert.sameValue(array.length, 4294967295, "2^32-2 is the last index");
+array["4294967295"] = 9;
+assert.sameValue(array.length, 4294967295, "2^32-1 is not an index");
+array["4294967296"] = 10;
+assert.sameValue(array.length, 4294967295, "2^32 is not an index");
+assert.sameValue(array[4294967295], 9, "2^32-1 read as a number");
+assert.sameValue(array[4294967296], 10, "2^32 read as a number");
+assert.sameValue(array.hasOwnProperty("4294967294"), true, "2^32-2 key");
+assert.sameValue(array.hasOwnProperty(999999999), true, "nine digits key");
+
+const parsed = JSON.parse('{"b":1,"2":2,"01":3,"1":4,"-0":5,"1024":6}');
+assert.sameValue(Object.keys(parsed).join(), "1,2,1024,b,01,-0", "parsed keys");
+assert.sameValue(JSON.stringify(parsed), '{"1":4,"2":2,"1024":6,"b":1,"01":3,"-0":5}', "stringified keys");
+
+const keys = [];
+const base = { 1: "base", 2: "base", x: "base" };
+const derived = Object.create(base);
+derived[2] = "derived";
+derived[3] = "derived";
+Object.defineProperty(derived, "1", { value: "hidden", enumerable: false });
+for (const key in derived)
+	keys.push(key);
+assert.sameValue(keys.join(), "2,3,x", "for-in skips shadowed and repeated keys");
+
+const large = [];
+for (let i = 0; i < 2000; i++)
+	large[i] = i;
+let sum = 0, last = "";
+for (const key in large) {
+	sum += large[key];
+	last = key;
+}
+assert.sameValue(sum, 1999000, "for-in over an array");
+assert.sameValue(last, "1999", "last key");
+assert.sameValue(typeof last, "string", "keys are strings");
@@ -0,0 +1,43 @@
+/*---
+description: the stack grows when operators call valueOf or toString, but does not move while a host function, like String, is converting. xst starts with 4096 slots and grows up to 16384 slots.
+---*/
+
+function viaString(n) {
+	return n ? String({ toString() { return viaString(n - 1); } }) : "";
+}
+function unary(n) {
+	return n ? +{ valueOf() { return unary(n - 1) + 1; } } : 0;
+}
+function binary(n) {
+	return n ? { valueOf() { return binary(n - 1); } } * 1 + 1 : 0;
+}
+function concat(n) {
+	return n ? "." + { toString() { return concat(n - 1); } } : "";
+}
+function relational(n) {
+	return n ? { valueOf() { return relational(n - 1); } } < n : true;
+}
+function equality(n) {
+	return n ? { valueOf() { return equality(n - 1) ? 1 : 0; } } == 1 : true;
+}
+function key(n) {
+	const o = { k: 1 };
+	return n ? o[{ toString() { return key(n - 1) ? "k" : "_"; } }] : 1;
+}
+
+assert.sameValue(viaString(20), "", "recursion through String within the initial stack");
+assert.throws(RangeError, function() {
+	viaString(400);
+}, "recursion through String cannot grow the stack");
+
+assert.sameValue(unary(400), 400, "recursion through unary plus grows the stack");
+assert.sameValue(binary(400), 400, "recursion through multiplication");
+assert.sameValue(concat(400), ".".repeat(400), "recursion through concatenation");
+assert.sameValue(relational(400), true, "recursion through comparison");
+assert.sameValue(equality(400), true, "recursion through equality");
+assert.sameValue(key(400), 1, "recursion through property keys");
+
+assert.throws(RangeError, function() {
+	unary(100000);
+}, "recursion through valueOf beyond the maximum");
+assert.sameValue(unary(400), 400, "machine usable after the overflow");
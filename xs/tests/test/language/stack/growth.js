@@ -0,0 +1,28 @@
+/*---
+description: the stack grows for JavaScript calls but does not move while a host function, like Array.prototype.map, is running. xst starts with 4096 slots and grows up to 16384 slots.
+---*/
+
+function plain(n) {
+	return n ? plain(n - 1) + 1 : 0;
+}
+function viaMap(n) {
+	return n ? [n - 1].map(viaMap)[0] + 1 : 0;
+}
+
+assert.sameValue(viaMap(100), 100, "recursion through map within the initial stack");
+assert.throws(RangeError, function() {
+	viaMap(500);
+}, "recursion through map cannot grow the stack");
+assert.sameValue(viaMap(100), 100, "machine usable after the overflow");
+
+assert.sameValue(plain(1000), 1000, "recursion grows the stack");
+assert.sameValue(viaMap(500), 500, "recursion through map uses the grown stack");
+
+assert.throws(RangeError, function() {
+	plain(100000);
+}, "recursion beyond the maximum");
+assert.throws(RangeError, function() {
+	var o = { toJSON() { return [o]; } };
+	JSON.stringify(o);
+}, "recursion through toJSON");
+assert.sameValue(plain(1000), 1000, "machine usable after the overflow");
@@ -0,0 +1,82 @@
+/*---
+description: xst shares the machine after the harness ran, then runs the test in two clones. The second clone must see the state of the harness, not the writes of the first clone.
+includes: [shareState.js]
+flags: [share]
+---*/
+
+assert.sameValue(sharedArray.length, 3, "array length");
+sharedArray.push(4);
+sharedArray[0] = 9;
+assert.sameValue(sharedArray.join(), "9,2,3,4", "array write");
+sharedArray.length = 2;
+assert.sameValue(sharedArray.join(), "9,2", "array length write");
+assert.sameValue(sharedHoles.indexOf(3), 2, "array read");
+sharedHoles.sort();
+assert.sameValue(sharedHoles.join(), "1,3,", "array sort");
+
+assert.sameValue(sharedCounter(), 1, "closure");
+assert.sameValue(sharedCounter(), 2, "closure again");
+
+assert.sameValue(sharedFunction(), 0, "function property");
+sharedFunction.x = 1;
+assert.sameValue(sharedFunction(), 1, "function property write");
+sharedFunction.y = 2;
+assert.sameValue(sharedFunction.y, 2, "function property add");
+delete sharedFunction.x;
+assert.sameValue("x" in sharedFunction, false, "function property delete");
+
+assert.sameValue(sharedObject.a, 1, "object");
+sharedObject.a = 2;
+sharedObject.b = 3;
+assert.sameValue(sharedObject.a + sharedObject.b, 5, "object write");
+
+assert.sameValue(sharedMap.size, 2, "map size");
+assert.sameValue(sharedMap.get(sharedKey), "key", "map get");
+sharedMap.set(2, "two");
+sharedMap.delete(1);
+assert.sameValue(sharedMap.get(2), "two", "map set");
+assert.sameValue(sharedMap.has(1), false, "map delete");
+assert.sameValue([...sharedMap.keys()].length, 2, "map keys");
+for (let i = 0; i < 100; i++)
+	sharedMap.set("key" + i, i);
+assert.sameValue(sharedMap.get("key99"), 99, "map grow");
+
+assert.sameValue(sharedSet.has("a"), true, "set has");
+sharedSet.add("b");
+sharedSet.delete("a");
+assert.sameValue(sharedSet.has("a") || !sharedSet.has("b"), false, "set write");
+
+assert.sameValue(sharedWeakMap.get(sharedKey), "weak", "weak map get");
+sharedWeakMap.set(sharedKey, "changed");
+assert.sameValue(sharedWeakMap.get(sharedKey), "changed", "weak map set");
+
+assert.sameValue(sharedBytes[0], 0, "buffer");
+sharedBytes[0] = 255;
+assert.sameValue(new DataView(sharedBuffer).getUint8(0), 255, "buffer write");
+
+assert.sameValue(sharedDate.getTime(), 0, "date");
+sharedDate.setTime(1000);
+assert.sameValue(sharedDate.getTime(), 1000, "date write");
+
+assert.throws(TypeError, function() {
+	"use strict";
+	sharedFrozen[0] = 3;
+}, "frozen array");
+
+assert.sameValue(JSON.stringify(sharedObject), '{"a":2,"b":3}', "stringify");
+assert.throws(TypeError, function() {
+	JSON.stringify(sharedCycle);
+}, "stringify cycle");
+assert.sameValue(JSON.stringify([sharedKey, sharedKey]), "[{},{}]", "stringify twice");
+
+assert.sameValue(sharedIterator.next().value, 1, "generator");
+assert.sameValue(sharedIterator.next().value, 2, "generator again");
+assert.sameValue(sharedIterator.next().done, true, "generator done");
+
+var garbage;
+for (var i = 0; i < 500000; i++)
+	garbage = { index: i, string: "item" + i };
+assert.sameValue(sharedArray.join(), "9,2", "array after collection");
+assert.sameValue(sharedCounter(), 3, "closure after collection");
+assert.sameValue(sharedMap.get("key99"), 99, "map after collection");
+assert.sameValue(sharedWeakMap.get(sharedKey), "changed", "weak map after collection");
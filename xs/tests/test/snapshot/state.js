@@ -0,0 +1,64 @@
+/*---
+description: xst writes a snapshot of the machine after the harness ran, deletes the machine, reads the snapshot back and runs the test in the new machine.
+includes: [snapshotState.js]
+flags: [snapshot]
+---*/
+
+assert.sameValue(snapshotSymbol.toString(), "Symbol(snapshot)", "symbol");
+assert.sameValue(Symbol.for("snapshot") === snapshotSymbol, false, "registered symbol");
+assert.sameValue(Symbol.for("registry"), Symbol.for("registry"), "symbol registry");
+
+assert.sameValue(snapshotMap.size, 3, "map size");
+assert.sameValue(snapshotMap.get(1), "one", "map number key");
+assert.sameValue(snapshotMap.get("two"), 2, "map string key");
+assert.sameValue(snapshotMap.get(snapshotKey), snapshotSymbol, "map object key");
+snapshotMap.set(3, "three");
+assert.sameValue(snapshotMap.get(3), "three", "map set");
+
+assert.sameValue(snapshotSet.has("a") && snapshotSet.has("b") && snapshotSet.has(snapshotKey), true, "set");
+assert.sameValue(snapshotSet.has("c"), false, "set miss");
+assert.sameValue(snapshotWeakMap.get(snapshotKey), "weak", "weak map");
+
+assert.sameValue("12-34 56-78".replace(snapshotRegExp, "$2-$1"), "34-12 78-56", "regexp");
+assert.sameValue(/b+/.exec("abbbc")[0], "bbb", "new regexp");
+
+assert.sameValue(snapshotTypedArray[2], 2.5, "typed array");
+assert.sameValue(snapshotView.getFloat64(8, true), 2.5, "data view");
+snapshotTypedArray[1] = 4;
+assert.sameValue(snapshotView.getFloat64(0, true), 4, "shared buffer");
+assert.sameValue(snapshotTypedArray.map(x => x * 2).join(), "1,8,5,7", "typed array map");
+
+assert.sameValue(snapshotArray.length, 11, "array length");
+assert.sameValue(snapshotArray[10], "sparse", "array element");
+assert.sameValue(5 in snapshotArray, false, "array hole");
+
+assert.sameValue(snapshotString, "snapshotshotshot", "string");
+assert.sameValue(snapshotString.toUpperCase(), "SNAPSHOTSHOTSHOT", "string method");
+
+assert.sameValue(snapshotObject[snapshotSymbol], "symbol", "symbol property");
+assert.sameValue(snapshotObject.getter, 42, "getter");
+assert.sameValue(JSON.stringify({ a: [1, "b"] }), '{"a":[1,"b"]}', "JSON");
+
+assert.sameValue(snapshotCounter(), 2, "closure");
+assert.sameValue(snapshotCounter(), 3, "closure again");
+
+var result = snapshotIterator.next();
+assert.sameValue(result.value, 2, "generator resumes");
+assert.sameValue(snapshotIterator.next().value, 3, "generator");
+assert.sameValue(snapshotIterator.next().done, true, "generator done");
+
+assert.sameValue(snapshotInstance.greet(), "hello snapshot!", "class");
+assert.sameValue(snapshotInstance instanceof SnapshotBase, true, "instanceof");
+assert.sameValue(new SnapshotDerived("again").greet(), "hello again!", "new instance");
+
+assert.sameValue(Math.max(1, 3, 2), 3, "host function");
+assert.sameValue([3, 1, 2].sort().join(), "1,2,3", "array host function");
+$262.evalScript("var snapshotEval = snapshotCounter();");
+assert.sameValue(snapshotEval, 4, "xst host function");
+
+var garbage;
+for (var i = 0; i < 500000; i++)
+	garbage = { index: i, string: "item" + i };
+assert.sameValue(snapshotMap.get(snapshotKey), snapshotSymbol, "map after collection");
+assert.sameValue(snapshotWeakMap.get(snapshotKey), "weak", "weak map after collection");
+assert.sameValue(snapshotCounter(), 5, "closure after collection");
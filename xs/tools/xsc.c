@@ -201,9 +201,13 @@ void fxWriteExterns(txScript* script, FILE* file)
 	mxDecode2(p, c);
 	for (i = 0; i < c; i++) {
 		txS1 length = *p++;
+		txID signature;
 		p += 2;
+		mxDecode2(p, signature);
 		if (length < 0)
 			fprintf(file, "extern void %s(void* data);\n", p);
+		else if (signature)
+			fprintf(file, "extern void %s(xsMachine* the, xsSlot* self, xsFastValue* argv, xsFastValue* result);\n", p);
 		else
 			fprintf(file, "extern void %s(xsMachine* the);\n", p);
 		p += c_strlen((char*)p) + 1;
@@ -213,7 +217,7 @@ void fxWriteExterns(txScript* script, FILE* file)
 void fxWriteHosts(txScript* script, FILE* file)
 {
 	txByte* p = script->hostsBuffer;
-	txID c, i, id;
+	txID c, i, id, signature;
 	mxDecode2(p, c);
 	fprintf(file, "void xsHostModule(xsMachine* the)\n");
 	fprintf(file, "{\n");
@@ -221,8 +225,11 @@ void fxWriteHosts(txScript* script, FILE* file)
 	for (i = 0; i < c; i++) {
 		txS1 length = *p++;
 		mxDecode2(p, id);
+		mxDecode2(p, signature);
 		if (length < 0)
 			fprintf(file, "\t\t{ (xsCallback)%s, -1, -1 },\n", p);
+		else if (signature)
+			fprintf(file, "\t\t{ NULL, %d, %d, %d, %s },\n", length, id, signature, p);
 		else
 			fprintf(file, "\t\t{ %s, %d, %d },\n", p, length, id);
 		p += c_strlen((char*)p) + 1;
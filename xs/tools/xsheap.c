@@ -0,0 +1,488 @@
+/*
+ * Copyright (c) 2016-2018  Moddable Tech, Inc.
+ *
+ *   This file is part of the Moddable SDK Tools.
+ *
+ *   The Moddable SDK Tools is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   The Moddable SDK Tools is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with the Moddable SDK Tools.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "xsCommon.h"
+
+/*
+	Reads a heap snapshot written by fxWriteHeapSnapshot, computes the dominator tree
+	of the nodes reachable from the root, then reports retained sizes.
+*/
+
+typedef struct sxHeap txHeap;
+typedef struct sxHeapEdge txHeapEdge;
+typedef struct sxHeapNode txHeapNode;
+typedef struct sxHeapSummary txHeapSummary;
+
+struct sxHeapEdge {
+	txInteger from;
+	txInteger to;
+	txU4 name;
+	txU1 kind;
+};
+
+struct sxHeapNode {
+	uintptr_t address;
+	txInteger dominator;
+	txInteger parent;
+	txInteger parentEdge;
+	txInteger order;
+	txU4 name;
+	txU1 kind;
+	txU1 defined;
+	size_t size;
+	size_t retained;
+};
+
+struct sxHeapSummary {
+	txU4 name;
+	txU1 kind;
+	size_t count;
+	size_t size;
+};
+
+struct sxHeap {
+	txHeapNode* nodes;
+	txInteger nodeCount;
+	txInteger nodeLength;
+	txInteger* table;
+	txInteger tableLength;
+	txHeapEdge* edges;
+	txInteger edgeCount;
+	txInteger edgeLength;
+	txString* names;
+	txU4 nameLength;
+	txInteger* successors;
+	txInteger* successorIndexes;
+	txInteger* predecessors;
+	txInteger* predecessorIndexes;
+	txInteger* postorder;
+	txInteger reachableCount;
+};
+
+static int fxCompareRetained(const void* p, const void* q);
+static int fxCompareSummaries(const void* p, const void* q);
+static void fxComputeDominators(txHeap* heap);
+static txInteger fxFindNode(txHeap* heap, uintptr_t address);
+static void fxPrintPath(txHeap* heap, txInteger index);
+static void fxReadHeap(txHeap* heap, txU1* p, txU1* q);
+static uintptr_t fxReadHeapNumber(txU1** p, txU1* q);
+static void fxReportError(txString theFormat, ...);
+
+static const txString gxHeapKindNames[XS_HEAP_NODE_KIND_COUNT] = {
+	"(root)",
+	"object",
+	"array",
+	"function",
+	"host",
+	"closure",
+	"string",
+};
+
+static txHeap* gxHeap = NULL;
+
+int fxCompareRetained(const void* p, const void* q)
+{
+	txHeapNode* a = gxHeap->nodes + *((txInteger*)p);
+	txHeapNode* b = gxHeap->nodes + *((txInteger*)q);
+	return (a->retained > b->retained) ? -1 : (a->retained < b->retained) ? 1 : 0;
+}
+
+int fxCompareSummaries(const void* p, const void* q)
+{
+	txHeapSummary* a = (txHeapSummary*)p;
+	txHeapSummary* b = (txHeapSummary*)q;
+	return (a->size > b->size) ? -1 : (a->size < b->size) ? 1 : 0;
+}
+
+void fxComputeDominators(txHeap* heap)
+{
+	txHeapNode* nodes = heap->nodes;
+	txInteger nodeCount = heap->nodeCount;
+	txInteger* stack;
+	txInteger* cursors;
+	txInteger stackCount = 0, order = 0, index, changed;
+
+	/* successors and predecessors */
+	heap->successorIndexes = c_calloc(nodeCount + 1, sizeof(txInteger));
+	heap->predecessorIndexes = c_calloc(nodeCount + 1, sizeof(txInteger));
+	heap->successors = c_malloc((heap->edgeCount + 1) * sizeof(txInteger));
+	heap->predecessors = c_malloc((heap->edgeCount + 1) * sizeof(txInteger));
+	heap->postorder = c_malloc(nodeCount * sizeof(txInteger));
+	stack = c_malloc(nodeCount * sizeof(txInteger));
+	cursors = c_malloc(nodeCount * sizeof(txInteger));
+	if (!heap->successorIndexes || !heap->predecessorIndexes || !heap->successors || !heap->predecessors || !heap->postorder || !stack || !cursors)
+		fxReportError("not enough memory");
+	for (index = 0; index < heap->edgeCount; index++) {
+		heap->successorIndexes[heap->edges[index].from + 1]++;
+		heap->predecessorIndexes[heap->edges[index].to + 1]++;
+	}
+	for (index = 0; index < nodeCount; index++) {
+		heap->successorIndexes[index + 1] += heap->successorIndexes[index];
+		heap->predecessorIndexes[index + 1] += heap->predecessorIndexes[index];
+	}
+	for (index = 0; index < nodeCount; index++) {
+		cursors[index] = heap->successorIndexes[index];
+		stack[index] = heap->predecessorIndexes[index];
+	}
+	for (index = 0; index < heap->edgeCount; index++) {
+		txHeapEdge* edge = heap->edges + index;
+		heap->successors[cursors[edge->from]++] = index;
+		heap->predecessors[stack[edge->to]++] = edge->from;
+	}
+
+	/* depth first postorder from the root */
+	for (index = 0; index < nodeCount; index++) {
+		nodes[index].order = -1;
+		nodes[index].dominator = -1;
+		nodes[index].parent = -1;
+		cursors[index] = heap->successorIndexes[index];
+	}
+	nodes[0].parent = 0;
+	stack[stackCount++] = 0;
+	while (stackCount) {
+		txInteger node = stack[stackCount - 1];
+		if (cursors[node] < heap->successorIndexes[node + 1]) {
+			txInteger edge = heap->successors[cursors[node]++];
+			txInteger to = heap->edges[edge].to;
+			if (nodes[to].parent < 0) {
+				nodes[to].parent = node;
+				nodes[to].parentEdge = edge;
+				stack[stackCount++] = to;
+			}
+		}
+		else {
+			nodes[node].order = order;
+			heap->postorder[order++] = node;
+			stackCount--;
+		}
+	}
+	heap->reachableCount = order;
+
+	/* Cooper, Harvey and Kennedy, "A Simple, Fast Dominance Algorithm" */
+	nodes[0].dominator = 0;
+	do {
+		changed = 0;
+		for (index = order - 2; index >= 0; index--) {
+			txInteger node = heap->postorder[index];
+			txInteger dominator = -1;
+			txInteger i;
+			for (i = heap->predecessorIndexes[node]; i < heap->predecessorIndexes[node + 1]; i++) {
+				txInteger predecessor = heap->predecessors[i];
+				if (nodes[predecessor].dominator < 0)
+					continue;
+				if (dominator < 0)
+					dominator = predecessor;
+				else {
+					txInteger a = predecessor, b = dominator;
+					while (a != b) {
+						while (nodes[a].order < nodes[b].order)
+							a = nodes[a].dominator;
+						while (nodes[b].order < nodes[a].order)
+							b = nodes[b].dominator;
+					}
+					dominator = a;
+				}
+			}
+			if (nodes[node].dominator != dominator) {
+				nodes[node].dominator = dominator;
+				changed = 1;
+			}
+		}
+	} while (changed);
+
+	/* retained sizes, children before their dominator */
+	for (index = 0; index < nodeCount; index++)
+		nodes[index].retained = nodes[index].size;
+	for (index = 0; index < order - 1; index++) {
+		txInteger node = heap->postorder[index];
+		nodes[nodes[node].dominator].retained += nodes[node].retained;
+	}
+	c_free(cursors);
+	c_free(stack);
+}
+
+txInteger fxFindNode(txHeap* heap, uintptr_t address)
+{
+	txInteger mask, index, node;
+	if ((heap->nodeCount + 1) * 2 > heap->tableLength) {
+		txInteger length = heap->tableLength ? heap->tableLength * 2 : 4096;
+		txInteger* table = c_malloc(length * sizeof(txInteger));
+		if (!table)
+			fxReportError("not enough memory");
+		c_memset(table, 0xFF, length * sizeof(txInteger));
+		mask = length - 1;
+		for (node = 0; node < heap->nodeCount; node++) {
+			index = (txInteger)((heap->nodes[node].address >> 3) & mask);
+			while (table[index] >= 0)
+				index = (index + 1) & mask;
+			table[index] = node;
+		}
+		if (heap->table)
+			c_free(heap->table);
+		heap->table = table;
+		heap->tableLength = length;
+	}
+	mask = heap->tableLength - 1;
+	index = (txInteger)((address >> 3) & mask);
+	while ((node = heap->table[index]) >= 0) {
+		if (heap->nodes[node].address == address)
+			return node;
+		index = (index + 1) & mask;
+	}
+	if (heap->nodeCount == heap->nodeLength) {
+		heap->nodeLength = heap->nodeLength ? heap->nodeLength * 2 : 4096;
+		heap->nodes = c_realloc(heap->nodes, heap->nodeLength * sizeof(txHeapNode));
+		if (!heap->nodes)
+			fxReportError("not enough memory");
+	}
+	node = heap->nodeCount++;
+	c_memset(heap->nodes + node, 0, sizeof(txHeapNode));
+	heap->nodes[node].address = address;
+	heap->table[index] = node;
+	return node;
+}
+
+void fxPrintPath(txHeap* heap, txInteger index)
+{
+	txInteger path[16];
+	txInteger count = 0;
+	while ((index > 0) && (count < 16)) {
+		path[count++] = heap->nodes[index].parentEdge;
+		index = heap->nodes[index].parent;
+	}
+	if (index > 0)
+		fprintf(stdout, "...");
+	else
+		fprintf(stdout, "(root)");
+	while (count) {
+		txHeapEdge* edge = heap->edges + path[--count];
+		txString name = (edge->name < heap->nameLength) ? heap->names[edge->name] : NULL;
+		switch (edge->kind) {
+		case XS_HEAP_ELEMENT_EDGE:
+			fprintf(stdout, "[%u]", (unsigned)edge->name);
+			break;
+		case XS_HEAP_PROTOTYPE_EDGE:
+			fprintf(stdout, ".__proto__");
+			break;
+		default:
+			if (name)
+				fprintf(stdout, ".%s", name);
+			else
+				fprintf(stdout, ".(internal)");
+			break;
+		}
+	}
+}
+
+void fxReadHeap(txHeap* heap, txU1* p, txU1* q)
+{
+	if ((q - p < 5) || c_strncmp((char*)p, "XSHP", 4))
+		fxReportError("invalid heap snapshot");
+	if (p[4] != XS_HEAP_SNAPSHOT_VERSION)
+		fxReportError("invalid heap snapshot version");
+	p += 5;
+	fxFindNode(heap, 0);
+	while (p < q) {
+		txU1 record = *p++;
+		if (record == XS_HEAP_NAME_RECORD) {
+			txU4 name = (txU4)fxReadHeapNumber(&p, q);
+			size_t length = (size_t)fxReadHeapNumber(&p, q);
+			txString string;
+			if ((size_t)(q - p) < length)
+				fxReportError("invalid name record");
+			if (name >= heap->nameLength) {
+				txU4 nameLength = name + 256;
+				heap->names = c_realloc(heap->names, nameLength * sizeof(txString));
+				if (!heap->names)
+					fxReportError("not enough memory");
+				c_memset(heap->names + heap->nameLength, 0, (nameLength - heap->nameLength) * sizeof(txString));
+				heap->nameLength = nameLength;
+			}
+			string = c_malloc(length + 1);
+			if (!string)
+				fxReportError("not enough memory");
+			c_memcpy(string, p, length);
+			string[length] = 0;
+			heap->names[name] = string;
+			p += length;
+		}
+		else if (record == XS_HEAP_NODE_RECORD) {
+			txInteger node = fxFindNode(heap, fxReadHeapNumber(&p, q));
+			if (p >= q)
+				fxReportError("invalid node record");
+			heap->nodes[node].kind = *p++;
+			heap->nodes[node].size = (size_t)fxReadHeapNumber(&p, q);
+			heap->nodes[node].name = (txU4)fxReadHeapNumber(&p, q);
+			heap->nodes[node].defined = 1;
+			if (heap->nodes[node].kind >= XS_HEAP_NODE_KIND_COUNT)
+				fxReportError("invalid node kind");
+		}
+		else if (record == XS_HEAP_EDGE_RECORD) {
+			txHeapEdge* edge;
+			if (heap->edgeCount == heap->edgeLength) {
+				heap->edgeLength = heap->edgeLength ? heap->edgeLength * 2 : 4096;
+				heap->edges = c_realloc(heap->edges, heap->edgeLength * sizeof(txHeapEdge));
+				if (!heap->edges)
+					fxReportError("not enough memory");
+			}
+			edge = heap->edges + heap->edgeCount++;
+			edge->from = fxFindNode(heap, fxReadHeapNumber(&p, q));
+			edge->to = fxFindNode(heap, fxReadHeapNumber(&p, q));
+			if (p >= q)
+				fxReportError("invalid edge record");
+			edge->kind = *p++;
+			edge->name = (txU4)fxReadHeapNumber(&p, q);
+		}
+		else
+			fxReportError("invalid record");
+	}
+}
+
+uintptr_t fxReadHeapNumber(txU1** p, txU1* q)
+{
+	uintptr_t value = 0;
+	int shift = 0;
+	txU1 byte;
+	do {
+		if (*p >= q)
+			fxReportError("truncated heap snapshot");
+		byte = *(*p)++;
+		value |= (uintptr_t)(byte & 0x7F) << shift;
+		shift += 7;
+	} while (byte & 0x80);
+	return value;
+}
+
+void fxReportError(txString theFormat, ...)
+{
+	c_va_list arguments;
+	fprintf(stderr, "# ");
+	c_va_start(arguments, theFormat);
+	vfprintf(stderr, theFormat, arguments);
+	c_va_end(arguments);
+	fprintf(stderr, "\n");
+	exit(1);
+}
+
+int main(int argc, char* argv[])
+{
+	int argi;
+	char* input = NULL;
+	int count = 20;
+	FILE* file = NULL;
+	size_t size;
+	txU1* buffer = NULL;
+	txHeap _heap;
+	txHeap* heap = &_heap;
+	txInteger* sorted;
+	txHeapSummary* summaries;
+	txInteger summaryCount = 0;
+	txInteger index, i;
+	size_t total = 0;
+
+	for (argi = 1; argi < argc; argi++) {
+		if (!strcmp(argv[argi], "-n")) {
+			argi++;
+			if (argi >= argc)
+				fxReportError("no count");
+			count = atoi(argv[argi]);
+			if (count <= 0)
+				fxReportError("invalid count");
+		}
+		else {
+			if (input)
+				fxReportError("too many files");
+			else
+				input = argv[argi];
+		}
+	}
+	if (!input)
+		fxReportError("no file");
+
+	file = fopen(input, "rb");
+	if (!file)
+		fxReportError("cannot open input file");
+	fseek(file, 0, SEEK_END);
+	size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+	buffer = c_malloc(size);
+	if (!buffer)
+		fxReportError("not enough memory");
+	if (fread(buffer, 1, size, file) != size)
+		fxReportError("file not read");
+	fclose(file);
+	file = NULL;
+
+	c_memset(heap, 0, sizeof(txHeap));
+	gxHeap = heap;
+	fxReadHeap(heap, buffer, buffer + size);
+	c_free(buffer);
+	fxComputeDominators(heap);
+
+	sorted = c_malloc(heap->reachableCount * sizeof(txInteger));
+	summaries = c_calloc(heap->reachableCount, sizeof(txHeapSummary));
+	if (!sorted || !summaries)
+		fxReportError("not enough memory");
+	for (index = 0; index < heap->reachableCount; index++) {
+		txHeapNode* node = heap->nodes + heap->postorder[index];
+		sorted[index] = heap->postorder[index];
+		total += node->size;
+		for (i = 0; i < summaryCount; i++) {
+			if ((summaries[i].kind == node->kind) && (summaries[i].name == node->name))
+				break;
+		}
+		if (i == summaryCount) {
+			summaries[i].kind = node->kind;
+			summaries[i].name = node->name;
+			summaryCount++;
+		}
+		summaries[i].count++;
+		summaries[i].size += node->size;
+	}
+
+	fprintf(stdout, "# %d nodes, %d edges, %d reachable nodes, %lu bytes\n", (int)heap->nodeCount, (int)heap->edgeCount, (int)heap->reachableCount, (unsigned long)total);
+
+	c_qsort(summaries, summaryCount, sizeof(txHeapSummary), fxCompareSummaries);
+	fprintf(stdout, "\n#   count         bytes  kind\n");
+	for (i = 0; (i < summaryCount) && (i < count); i++) {
+		txString name = (summaries[i].name < heap->nameLength) ? heap->names[summaries[i].name] : NULL;
+		fprintf(stdout, "%9lu %13lu  %s", (unsigned long)summaries[i].count, (unsigned long)summaries[i].size, gxHeapKindNames[summaries[i].kind]);
+		if (name)
+			fprintf(stdout, " %s", name);
+		fprintf(stdout, "\n");
+	}
+
+	c_qsort(sorted, heap->reachableCount, sizeof(txInteger), fxCompareRetained);
+	fprintf(stdout, "\n#     retained         self  kind\n");
+	for (i = 0, index = 0; (i < count) && (index < heap->reachableCount); index++) {
+		txHeapNode* node = heap->nodes + sorted[index];
+		txString name = (node->name < heap->nameLength) ? heap->names[node->name] : NULL;
+		if (node->kind == XS_HEAP_ROOT_NODE)
+			continue;
+		fprintf(stdout, "%13lu %12lu  %s", (unsigned long)node->retained, (unsigned long)node->size, gxHeapKindNames[node->kind]);
+		if (name)
+			fprintf(stdout, " %s", name);
+		fprintf(stdout, " ");
+		fxPrintPath(heap, sorted[index]);
+		fprintf(stdout, "\n");
+		i++;
+	}
+	return 0;
+}
@@ -127,7 +127,7 @@ int main(int argc, char* argv[])
 				argi++;
 				if (argi >= argc)
 					fxReportLinkerError(linker, "-c: no creation");
-				sscanf(argv[argi], "%d,%d,%d,%d,%d,%d,%d,%d,%d,%s", 
+				if (sscanf(argv[argi], "%d,%d,%d,%d,%d,%d,%d,%d,%d,%d,%s", 
 					&linker->creation.initialChunkSize,
 					&linker->creation.incrementalChunkSize,
 					&linker->creation.initialHeapCount,
@@ -137,7 +137,21 @@ int main(int argc, char* argv[])
 					&linker->creation.nameModulo,
 					&linker->creation.symbolModulo,
 					&linker->creation.staticSize,
-					linker->main);
+					&linker->creation.maximumStackCount,
+					linker->main) < 11) {
+					linker->creation.maximumStackCount = 0;
+					sscanf(argv[argi], "%d,%d,%d,%d,%d,%d,%d,%d,%d,%s", 
+						&linker->creation.initialChunkSize,
+						&linker->creation.incrementalChunkSize,
+						&linker->creation.initialHeapCount,
+						&linker->creation.incrementalHeapCount,
+						&linker->creation.stackCount,
+						&linker->creation.keyCount,
+						&linker->creation.nameModulo,
+						&linker->creation.symbolModulo,
+						&linker->creation.staticSize,
+						linker->main);
+				}
 				linker->symbolModulo = linker->creation.nameModulo;
 			}		
 			else if (!c_strcmp(argv[argi], "-o")) {
@@ -451,7 +465,7 @@ int main(int argc, char* argv[])
 			fprintf(file, ",\n");
 			fprintf(file, "\tmxScriptsCount,\n");
 			fprintf(file, "\t(txScript*)gxScripts,\n");
-			fprintf(file, "\t{ %d, %d, %d, %d, %d, %d, %d, %d, %d },\n",
+			fprintf(file, "\t{ %d, %d, %d, %d, %d, %d, %d, %d, %d, %d },\n",
 				linker->creation.initialChunkSize,
 				linker->creation.incrementalChunkSize,
 				linker->creation.initialHeapCount,
@@ -460,7 +474,8 @@ int main(int argc, char* argv[])
 				linker->creation.keyCount,
 				linker->creation.nameModulo,
 				linker->creation.symbolModulo,
-				linker->creation.staticSize
+				linker->creation.staticSize,
+				linker->creation.maximumStackCount
 			);
 			fprintf(file, "\t\"%s\",\n", linker->main);
 			fprintf(file, "\t{ 0x%.2X", linker->symbolsChecksum[0]);
@@ -258,6 +258,7 @@ void fxMapHosts(txLinker* linker, txLinkerScript* script, txID* theIDs)
 				p -= 2;
 				mxEncode2(p, id);
 			}
+			p += 2;
 			p += c_strlen((char*)p) + 1;
 		}
 		linker->hostsCount += c;
@@ -808,9 +809,13 @@ void fxWriteScriptExterns(txLinkerScript* script, FILE* file)
 		mxDecode2(p, c);
 		for (i = 0; i < c; i++) {
 			txS1 length = *p++;
+			txID signature;
 			p += 2;
+			mxDecode2(p, signature);
 			if (length < 0)
 				fprintf(file, "extern void %s(void* data);\n", p);
+			else if (signature)
+				fprintf(file, "extern void %s(xsMachine* the, xsSlot* self, xsFastValue* argv, xsFastValue* result);\n", p);
 			else
 				fprintf(file, "extern void %s(xsMachine* the);\n", p);
 			p += c_strlen((char*)p) + 1;
@@ -822,14 +827,17 @@ void fxWriteScriptHosts(txLinkerScript* script, FILE* file)
 {
 	txByte* p = script->hostsBuffer;
 	if (p) {
-		txID c, i, id;
+		txID c, i, id, signature;
 		mxDecode2(p, c);
 		fprintf(file, "static const xsHostBuilder gxBuilders%d[%d] = {\n", script->scriptIndex, c);
 		for (i = 0; i < c; i++) {
 			txS1 length = *p++;
 			mxDecode2(p, id);
+			mxDecode2(p, signature);
 			if (length < 0)
 				fprintf(file, "\t{ (xsCallback)%s, -1, -1 },\n", p);
+			else if (signature)
+				fprintf(file, "\t{ NULL, %d, %d, %d, %s },\n", length, id, signature, p);
 			else
 				fprintf(file, "\t{ %s, %d, %d },\n", p, length, id);
 			p += c_strlen((char*)p) + 1;
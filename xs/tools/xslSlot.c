@@ -190,6 +190,7 @@ void fxLinkerScriptCallback(txMachine* the)
 					builder->callback = callback;
 					builder->length = length;
 					builder->id = id;
+					mxDecode2(p, builder->signature);
 					callbackName->callback = callback;
 					callbackName->name = (char*)p;
 					if (length < 0) {
@@ -299,6 +300,8 @@ txInteger fxPrepareHeap(txMachine* the)
 		limit = heap->value.reference;
 		while (slot < limit) {
 			txSlot* next = slot->next;
+			if (mxIsPackedArray(slot))
+				fxUnpackArray(the, slot);
 			if (next && (next->next == NULL) && (next->ID == XS_NO_ID) && (next->kind == XS_HOME_KIND)) {
 				if (home && (home->flag == next->flag) && (home->value.home.object == next->value.home.object) && (home->value.home.module == next->value.home.module))
 					slot->next = home;
@@ -602,7 +605,10 @@ void fxPrintSlot(txMachine* the, FILE* file, txSlot* slot, txFlag flag, txBoolea
 	case XS_CALLBACK_KIND: {
 		fprintf(file, "XS_CALLBACK_X_KIND, ");
 		if (dummy) fprintf(file, "0, ");
-		fprintf(file, "{ .callback = { %s, NULL } }", fxGetCallbackName(the, slot->value.callback.address));
+		if (slot->flag & XS_FAST_FLAG)
+			fprintf(file, "{ .fastCallback = { %s, NULL } }", fxGetCallbackName(the, slot->value.callback.address));
+		else
+			fprintf(file, "{ .callback = { %s, NULL } }", fxGetCallbackName(the, slot->value.callback.address));
 	} break;
 	case XS_CODE_KIND:  {
 		fprintf(file, "XS_CODE_X_KIND, ");
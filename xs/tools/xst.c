@@ -59,6 +59,7 @@ typedef struct sxAgent txAgent;
 typedef struct sxAgentCluster txAgentCluster;
 typedef struct sxAgentReport txAgentReport;
 typedef struct sxContext txContext;
+typedef struct sxFile txFile;
 typedef struct sxJob txJob;
 typedef void (*txJobCallback)(txJob*);
 typedef struct sxResult txResult;
@@ -101,9 +102,15 @@ struct sxContext {
 	char harnessPath[C_PATH_MAX];
 	int testPathLength;
 	txResult* current;
-	yaml_document_t* document;
-	yaml_node_t* includes;
-	yaml_node_t* negative;
+	txFile* firstFile;
+	txFile* lastFile;
+	txFile* nextFile;
+	int benchCount;
+	int workerCount;
+	int share;
+	int snapshot;
+	txCondition condition;
+	txMutex mutex;
 #ifdef mxInstrument
 	txSize peakChunksSize;
 	txSize peakHeapCount;
@@ -112,6 +119,28 @@ struct sxContext {
 #endif
 };
 
+struct sxFile {
+	txFile* next;
+	txResult* result;
+	yaml_document_t* document;
+	yaml_node_t* includes;
+	yaml_node_t* negative;
+	int done;
+	int serial;
+	int worker;
+	int testCount;
+	int successCount;
+	int pendingCount;
+	int share;
+	int snapshot;
+	int async;
+	txSize collectionCount;
+	char* output;
+	size_t outputLength;
+	size_t outputSize;
+	char path[1];
+};
+
 struct sxJob {
 	txJob* next;
 	txMachine* the;
@@ -133,16 +162,38 @@ struct sxResult {
 	char path[1];
 };
 
-static void fxCountResult(txContext* context, int success, int pending);
+static txNumber fxBenchNow();
+static int fxCompareDurations(const void* p, const void* q);
+static void fxCountResult(txContext* context, txFile* file);
 static yaml_node_t *fxGetMappingValue(yaml_document_t* document, yaml_node_t* mapping, char* name);
 static void fxPopResult(txContext* context);
+static void fxPrintFile(txFile* file, char* format, ...);
 static void fxPrintResult(txContext* context, txResult* result, int c);
 static void fxPushResult(txContext* context, char* path);
+static void fxQueueFile(txContext* context, char* path);
 static void fxRunDirectory(txContext* context, char* path);
-static void fxRunFile(txContext* context, char* path);
-static int fxRunTestCase(txContext* context, char* path, txUnsigned flags, char* message);
+static void fxRunFile(txContext* context, txFile* file);
+static void fxRunFiles(txContext* context);
+static int fxRunTestCase(txContext* context, txFile* file, txUnsigned flags, char* message);
+static int fxRunTestShare(xsCreation* creation, xsMachine* shared, txString path, txUnsigned flags, char* message);
+static xsMachine* fxRunTestSnapshot(xsMachine* machine, char* message);
+#if mxWindows
+static unsigned int __stdcall fxRunWorker(void* it);
+#else
+static void* fxRunWorker(void* it);
+#endif
 static int fxStringEndsWith(const char *string, const char *suffix);
 
+typedef struct sxSnapshotMemory txSnapshotMemory;
+struct sxSnapshotMemory {
+	char* buffer;
+	size_t offset;
+	size_t size;
+	size_t capacity;
+};
+static txBoolean fxReadSnapshotMemory(void* stream, void* address, size_t size);
+static txBoolean fxWriteSnapshotMemory(void* stream, void* address, size_t size);
+
 static void fxRunModule(txMachine* the, txString path);
 static void fxRunProgram(txMachine* the, txString path, txUnsigned flags);
 static void fxRunLoop(txMachine* the);
@@ -163,8 +214,14 @@ static void* fx_agent_start_aux(void* it);
 static void fx_agent_stop(xsMachine* the);
 static void fx_createRealm(xsMachine* the);
 static void fx_detachArrayBuffer(xsMachine* the);
+static txSlot* fxNextFastHostFunctionProperty(txMachine* the, txSlot* property, txFastCallback call, txString signature, txInteger length, txID id);
 static void fx_done(xsMachine* the);
 static void fx_evalScript(xsMachine* the);
+static void fx_fast_isNaN(txMachine* the, txSlot* self, txFastValue* argv, txFastValue* result);
+static void fx_fast_peek(txMachine* the, txSlot* self, txFastValue* argv, txFastValue* result);
+static void fx_fast_scale(txMachine* the, txSlot* self, txFastValue* argv, txFastValue* result);
+static void fx_fast_sum(txMachine* the, txSlot* self, txFastValue* argv, txFastValue* result);
+static void fx_gc(xsMachine* the);
 static void fx_print(xsMachine* the);
 static void fx_clearTimer(txMachine* the);
 static void fx_destroyTimer(void* data);
@@ -192,6 +249,8 @@ int main(int argc, char* argv[])
 	int argi = 1;
 	
 	c_memset(&context, 0, sizeof(txContext));
+	fxCreateCondition(&(context.condition));
+	fxCreateMutex(&(context.mutex));
 	
 	c_memset(&gxAgentCluster, 0, sizeof(txAgentCluster));
 	fxCreateCondition(&(gxAgentCluster.countCondition));
@@ -220,7 +279,23 @@ int main(int argc, char* argv[])
 	fxPushResult(&context, "");
 	
 	while (argi < argc) {
-		if (c_realpath(argv[argi], path)) {
+		if (!c_strcmp(argv[argi], "-j") || !c_strcmp(argv[argi], "--bench")) {
+			int count = (argi + 1 < argc) ? atoi(argv[argi + 1]) : 0;
+			if (count <= 0) {
+				fprintf(stderr, "### invalid count: %s\n", argv[argi]);
+				return 1;
+			}
+			if (argv[argi][1] == 'j')
+				context.workerCount = count;
+			else
+				context.benchCount = count;
+			argi++;
+		}
+		else if (!c_strcmp(argv[argi], "--share"))
+			context.share = 1;
+		else if (!c_strcmp(argv[argi], "--snapshot"))
+			context.snapshot = 1;
+		else if (c_realpath(argv[argi], path)) {
 #if mxWindows
 			DWORD attributes = GetFileAttributes(path);
 			if (attributes != 0xFFFFFFFF) {
@@ -235,7 +310,7 @@ int main(int argc, char* argv[])
 					fxPopResult(&context);
 				}
 				else if (fxStringEndsWith(path, ".js") && !fxStringEndsWith(path, "_FIXTURE.js"))
-					fxRunFile(&context, path);
+					fxQueueFile(&context, path);
 			}
 		}
 		else {
@@ -244,6 +319,7 @@ int main(int argc, char* argv[])
 		}
 		argi++;
 	}
+	fxRunFiles(&context);
 	fxPrintResult(&context, context.current, 0);
 #ifdef mxInstrument
 	fprintf(stderr, "# parser chunks: %d bytes\n", context.parserTotal);
@@ -251,16 +327,69 @@ int main(int argc, char* argv[])
 	fprintf(stderr, "# heap slots: %lu bytes\n", context.peakHeapCount * sizeof(txSlot));
 	fprintf(stderr, "# stack slots: %lu bytes\n", context.peakStackCount * sizeof(txSlot));
 #endif
+	fxDeleteMutex(&(context.mutex));
+	fxDeleteCondition(&(context.condition));
 	return error;
 }
 
-void fxCountResult(txContext* context, int success, int pending) 
+txBoolean fxReadSnapshotMemory(void* stream, void* address, size_t size)
 {
-	txResult* result = context->current;
+	txSnapshotMemory* memory = stream;
+	if (memory->offset + size > memory->size)
+		return 0;
+	c_memcpy(address, memory->buffer + memory->offset, size);
+	memory->offset += size;
+	return 1;
+}
+
+txBoolean fxWriteSnapshotMemory(void* stream, void* address, size_t size)
+{
+	txSnapshotMemory* memory = stream;
+	if (memory->offset + size > memory->capacity) {
+		size_t capacity = memory->capacity ? memory->capacity : 1024 * 1024;
+		char* buffer;
+		while (capacity < memory->offset + size)
+			capacity <<= 1;
+		buffer = c_realloc(memory->buffer, capacity);
+		if (!buffer)
+			return 0;
+		memory->buffer = buffer;
+		memory->capacity = capacity;
+	}
+	c_memcpy(memory->buffer + memory->offset, address, size);
+	memory->offset += size;
+	memory->size = memory->offset;
+	return 1;
+}
+
+txNumber fxBenchNow()
+{
+#if mxWindows
+	LARGE_INTEGER counter, frequency;
+	QueryPerformanceCounter(&counter);
+	QueryPerformanceFrequency(&frequency);
+	return (txNumber)counter.QuadPart * 1000.0 / (txNumber)frequency.QuadPart;
+#else
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((txNumber)now.tv_sec * 1000.0) + ((txNumber)now.tv_nsec / 1000000.0);
+#endif
+}
+
+int fxCompareDurations(const void* p, const void* q)
+{
+	txNumber a = *((txNumber*)p);
+	txNumber b = *((txNumber*)q);
+	return (a < b) ? -1 : (a > b) ? 1 : 0;
+}
+
+void fxCountResult(txContext* context, txFile* file) 
+{
+	txResult* result = file->result;
 	while (result) {
-		result->testCount++;
-		result->successCount += success;
-		result->pendingCount += pending;
+		result->testCount += file->testCount;
+		result->successCount += file->successCount;
+		result->pendingCount += file->pendingCount;
 		result = result->parent;
 	}
 }
@@ -283,6 +412,32 @@ void fxPopResult(txContext* context)
 	context->current = context->current->parent;
 }
 
+void fxPrintFile(txFile* file, char* format, ...)
+{
+	char buffer[C_PATH_MAX + 1024];
+	size_t length;
+	va_list arguments;
+	va_start(arguments, format);
+	vsnprintf(buffer, sizeof(buffer), format, arguments);
+	va_end(arguments);
+	if (!file->worker) {
+		fprintf(stderr, "%s", buffer);
+		return;
+	}
+	length = c_strlen(buffer);
+	if (file->outputLength + length + 1 > file->outputSize) {
+		size_t size = file->outputLength + length + 1024;
+		char* output = c_realloc(file->output, size);
+		if (!output) {
+			c_exit(1);
+		}
+		file->output = output;
+		file->outputSize = size;
+	}
+	c_memcpy(file->output + file->outputLength, buffer, length + 1);
+	file->outputLength += length;
+}
+
 void fxPrintResult(txContext* context, txResult* result, int c)
 {
 	int i = 0;
@@ -331,6 +486,22 @@ void fxPushResult(txContext* context, char* path)
 	context->current = result;
 }
 
+void fxQueueFile(txContext* context, char* path)
+{
+	txFile* file = c_malloc(sizeof(txFile) + c_strlen(path));
+	if (!file) {
+		c_exit(1);
+	}
+	c_memset(file, 0, sizeof(txFile));
+	file->result = context->current;
+	c_strcpy(file->path, path);
+	if (context->lastFile)
+		context->lastFile->next = file;
+	else
+		context->firstFile = file;
+	context->lastFile = file;
+}
+
 void fxRunDirectory(txContext* context, char* path)
 {
 	typedef struct sxEntry txEntry;
@@ -384,7 +555,7 @@ void fxRunDirectory(txContext* context, char* path)
 					fxPopResult(context);
 				}
 				else if (fxStringEndsWith(path, ".js") && !fxStringEndsWith(path, "_FIXTURE.js"))
-					fxRunFile(context, path);
+					fxQueueFile(context, path);
 			}
 			nextEntry = firstEntry->nextEntry;
 			free(firstEntry);
@@ -431,7 +602,7 @@ void fxRunDirectory(txContext* context, char* path)
 					fxPopResult(context);
 				}
 				else if (fxStringEndsWith(path, ".js") && !fxStringEndsWith(path, "_FIXTURE.js"))
-					fxRunFile(context, path);
+					fxQueueFile(context, path);
 			}
 			nextEntry = firstEntry->nextEntry;
 			free(firstEntry);
@@ -441,9 +612,10 @@ void fxRunDirectory(txContext* context, char* path)
 #endif
 }
 
-void fxRunFile(txContext* context, char* path)
+void fxRunFile(txContext* context, txFile* file)
 {
-	FILE* file = NULL;
+	char* path = file->path;
+	FILE* stream = NULL;
 	size_t size;
 	char* buffer = NULL;
 	char* begin;
@@ -457,22 +629,28 @@ void fxRunFile(txContext* context, char* path)
 	int sloppy = 1;
 	int strict = 1;
 	int module = 0;
-	int async = 0;
 	int pending = 0;
 	char message[1024];
 	
-	file = fopen(path, "rb");
-	if (!file) goto bail;
-	fseek(file, 0, SEEK_END);
-	size = ftell(file);
+	stream = fopen(path, "rb");
+	if (!stream) goto bail;
+	fseek(stream, 0, SEEK_END);
+	size = ftell(stream);
 	if (!size) goto bail;
-	fseek(file, 0, SEEK_SET);
+	fseek(stream, 0, SEEK_SET);
 	buffer = malloc(size + 1);
 	if (!buffer) goto bail;
-	if (fread(buffer, 1, size, file) != size) goto bail;	
+	if (fread(buffer, 1, size, stream) != size) goto bail;	
 	buffer[size] = 0;
-	fclose(file);
-	file = NULL;
+	fclose(stream);
+	stream = NULL;
+	
+	// agents and Atomics share process-wide state, so such tests run on the main thread once workers are done
+	if (file->worker && (strstr(buffer, "$262.agent") || strstr(buffer, "Atomics."))) {
+		file->serial = 1;
+		file->worker = 0;
+		goto bail;
+	}
 	
 	begin = strstr(buffer, "/*---");
 	if (!begin) goto bail;
@@ -488,13 +666,13 @@ void fxRunFile(txContext* context, char* path)
 	root = yaml_document_get_root_node(document);
 	if (!root) goto bail;
 		
-	context->document = document;
-	context->includes = fxGetMappingValue(document, root, "includes");
+	file->document = document;
+	file->includes = fxGetMappingValue(document, root, "includes");
 	value = fxGetMappingValue(document, root, "negative");
 	if (value)
-		context->negative = fxGetMappingValue(document, value, "type");
+		file->negative = fxGetMappingValue(document, value, "type");
 	else
-		context->negative = NULL;
+		file->negative = NULL;
 	
 	value = fxGetMappingValue(document, root, "flags");
 	if (value) {
@@ -516,7 +694,13 @@ void fxRunFile(txContext* context, char* path)
 				strict = 0;
 			}
 			else if (!strcmp((char*)node->data.scalar.value, "async")) {
-				async = 1;
+				file->async = 1;
+			}
+			else if (!strcmp((char*)node->data.scalar.value, "share")) {
+				file->share = 1;
+			}
+			else if (!strcmp((char*)node->data.scalar.value, "snapshot")) {
+				file->snapshot = 1;
 			}
 			item++;
 		}
@@ -549,46 +733,168 @@ void fxRunFile(txContext* context, char* path)
 	}
 
 	if (sloppy) {
-		fprintf(stderr, "### %s (sloppy): ", path + context->testPathLength);
-		if (fxRunTestCase(context, path, mxProgramFlag | mxDebugFlag, message))
-			fprintf(stderr, "%s\n", message);
-		else
-			fprintf(stderr, "%s\n", message);
+		fxPrintFile(file, "### %s (sloppy): ", path + context->testPathLength);
+		file->successCount += fxRunTestCase(context, file, mxProgramFlag | mxDebugFlag, message);
+		file->testCount++;
+		fxPrintFile(file, "%s\n", message);
 	}
 	if (strict) {
-		fprintf(stderr, "### %s (strict): ", path + context->testPathLength);
-		if (fxRunTestCase(context, path, mxProgramFlag | mxDebugFlag | mxStrictFlag, message))
-			fprintf(stderr, "%s\n", message);
-		else
-			fprintf(stderr, "%s\n", message);
+		fxPrintFile(file, "### %s (strict): ", path + context->testPathLength);
+		file->successCount += fxRunTestCase(context, file, mxProgramFlag | mxDebugFlag | mxStrictFlag, message);
+		file->testCount++;
+		fxPrintFile(file, "%s\n", message);
 	}
 	if (module) {
-		fprintf(stderr, "### %s (module): ", path + context->testPathLength);
-		if (fxRunTestCase(context, path, 0, message))
-			fprintf(stderr, "%s\n", message);
-		else
-			fprintf(stderr, "%s\n", message);
+		fxPrintFile(file, "### %s (module): ", path + context->testPathLength);
+		file->successCount += fxRunTestCase(context, file, 0, message);
+		file->testCount++;
+		fxPrintFile(file, "%s\n", message);
+	}
+	if (context->benchCount && (sloppy || strict || module)) {
+		int count = context->benchCount, i;
+		txNumber* durations = c_malloc(count * sizeof(txNumber));
+		if (!durations) goto bail;
+		file->collectionCount = 0;
+		for (i = 0; i < count; i++) {
+			txNumber when = fxBenchNow();
+			if (sloppy)
+				fxRunTestCase(context, file, mxProgramFlag | mxDebugFlag, message);
+			if (strict)
+				fxRunTestCase(context, file, mxProgramFlag | mxDebugFlag | mxStrictFlag, message);
+			if (module)
+				fxRunTestCase(context, file, 0, message);
+			durations[i] = fxBenchNow() - when;
+		}
+		c_qsort(durations, count, sizeof(txNumber), fxCompareDurations);
+		fxPrintFile(file, "### %s (bench): min %.3f ms, median %.3f ms, p99 %.3f ms, %.1f collections\n", path + context->testPathLength,
+			durations[0], durations[count / 2], durations[((99 * count) + 99) / 100 - 1], (double)file->collectionCount / count);
+		c_free(durations);
 	}
 	if (pending) {
-		fprintf(stderr, "### %s: SKIP\n", path + context->testPathLength);
-		fxCountResult(context, 0, 1);
+		fxPrintFile(file, "### %s: SKIP\n", path + context->testPathLength);
+		file->testCount++;
+		file->pendingCount++;
 	}
 bail:	
-	context->negative = NULL;
-	context->includes = NULL;
-	context->document = NULL;
+	file->negative = NULL;
+	file->includes = NULL;
+	file->document = NULL;
 	if (document)
 		yaml_document_delete(document);
 	if (parser)
 		yaml_parser_delete(parser);
 	if (buffer)
 		free(buffer);
-	if (file)
-		fclose(file);
+	if (stream)
+		fclose(stream);
 }
 
-int fxRunTestCase(txContext* context, char* path, txUnsigned flags, char* message)
+void fxRunFiles(txContext* context)
 {
+	int workerCount = context->workerCount;
+#if mxWindows
+	HANDLE* threads = NULL;
+#else
+	pthread_t* threads = NULL;
+	pthread_attr_t attributes;
+#endif
+	txFile* file;
+	int i;
+	if (workerCount) {
+		threads = c_malloc(workerCount * sizeof(*threads));
+		if (!threads) {
+			c_exit(1);
+		}
+		context->nextFile = context->firstFile;
+#if mxWindows
+		for (i = 0; i < workerCount; i++)
+			threads[i] = (HANDLE)_beginthreadex(NULL, 8 * 1024 * 1024, fxRunWorker, context, 0, NULL);
+#else
+		pthread_attr_init(&attributes);
+		pthread_attr_setstacksize(&attributes, 8 * 1024 * 1024);
+		for (i = 0; i < workerCount; i++)
+			pthread_create(&threads[i], &attributes, &fxRunWorker, context);
+		pthread_attr_destroy(&attributes);
+#endif
+	}
+	while ((file = context->firstFile)) {
+		if (threads) {
+			fxLockMutex(&(context->mutex));
+			while (!file->done)
+				fxSleepCondition(&(context->condition), &(context->mutex));
+			fxUnlockMutex(&(context->mutex));
+			if (file->serial) {
+				for (i = 0; i < workerCount; i++) {
+				#if mxWindows
+					WaitForSingleObject(threads[i], INFINITE);
+					CloseHandle(threads[i]);
+				#else
+					pthread_join(threads[i], NULL);
+				#endif
+				}
+				c_free(threads);
+				threads = NULL;
+			}
+		}
+		if (file->worker) {
+			if (file->output)
+				fprintf(stderr, "%s", file->output);
+		}
+		else
+			fxRunFile(context, file);
+		fxCountResult(context, file);
+		context->firstFile = file->next;
+		if (file->output)
+			c_free(file->output);
+		c_free(file);
+	}
+	context->lastFile = NULL;
+	if (threads) {
+		for (i = 0; i < workerCount; i++) {
+		#if mxWindows
+			WaitForSingleObject(threads[i], INFINITE);
+			CloseHandle(threads[i]);
+		#else
+			pthread_join(threads[i], NULL);
+		#endif
+		}
+		c_free(threads);
+	}
+}
+
+#if mxWindows
+unsigned int __stdcall fxRunWorker(void* it)
+#else
+void* fxRunWorker(void* it)
+#endif
+{
+	txContext* context = it;
+	txFile* file;
+	for (;;) {
+		fxLockMutex(&(context->mutex));
+		file = context->nextFile;
+		if (file)
+			context->nextFile = file->next;
+		fxUnlockMutex(&(context->mutex));
+		if (!file)
+			break;
+		file->worker = 1;
+		fxRunFile(context, file);
+		fxLockMutex(&(context->mutex));
+		file->done = 1;
+		fxWakeCondition(&(context->condition));
+		fxUnlockMutex(&(context->mutex));
+	}
+#if mxWindows
+	return 0;
+#else
+	return NULL;
+#endif
+}
+
+int fxRunTestCase(txContext* context, txFile* file, txUnsigned flags, char* message)
+{
+	char* path = file->path;
 	xsCreation _creation = {
 		128 * 1024 * 1024, 	/* initialChunkSize */
 		16 * 1024 * 1024, 	/* incrementalChunkSize */
@@ -597,13 +903,18 @@ int fxRunTestCase(txContext* context, char* path, txUnsigned flags, char* messag
 		4096, 		/* stackCount */
 		4096*3, 		/* keyCount */
 		1993, 		/* nameModulo */
-		127 		/* symbolModulo */
+		127, 		/* symbolModulo */
+		0, 		/* staticSize */
+		4096 * 4 		/* maximumStackCount */
 	};
 	xsCreation* creation = &_creation;
 	xsMachine* machine;
+	xsMachine* shared = NULL;
 	char buffer[C_PATH_MAX];
+	int ready = 1;
 	int success = 0;
-	fxInitializeSharedCluster();
+	if (!file->worker)
+		fxInitializeSharedCluster();
 	machine = xsCreateMachine(creation, "xst", NULL);
 	xsBeginHost(machine);
 	{
@@ -619,10 +930,19 @@ int fxRunTestCase(txContext* context, char* path, txUnsigned flags, char* messag
 			
 			mxPush(mxObjectPrototype);
 			slot = fxLastProperty(the, fxNewObjectInstance(the));
-			slot = fxNextSlotProperty(the, slot, the->stack + 1, xsID("agent"), XS_GET_ONLY);
+			slot = fxNextFastHostFunctionProperty(the, slot, fx_fast_isNaN, "isNaN(n)b", 1, xsID("isNaN"));
+			slot = fxNextFastHostFunctionProperty(the, slot, fx_fast_peek, "peek(pi)i", 2, xsID("peek"));
+			slot = fxNextFastHostFunctionProperty(the, slot, fx_fast_scale, "scale(ni)n", 2, xsID("scale"));
+			slot = fxNextFastHostFunctionProperty(the, slot, fx_fast_sum, "sum(iiiiii)i", 6, xsID("sum"));
+			
+			mxPush(mxObjectPrototype);
+			slot = fxLastProperty(the, fxNewObjectInstance(the));
+			slot = fxNextSlotProperty(the, slot, the->stack + 2, xsID("agent"), XS_GET_ONLY);
 			slot = fxNextHostFunctionProperty(the, slot, fx_createRealm, 0, xsID("createRealm"), XS_GET_ONLY); 
 			slot = fxNextHostFunctionProperty(the, slot, fx_detachArrayBuffer, 1, xsID("detachArrayBuffer"), XS_GET_ONLY); 
 			slot = fxNextHostFunctionProperty(the, slot, fx_evalScript, 1, xsID("evalScript"), XS_GET_ONLY); 
+			slot = fxNextSlotProperty(the, slot, the->stack + 1, xsID("fast"), XS_GET_ONLY);
+			slot = fxNextHostFunctionProperty(the, slot, fx_gc, 0, xsID("gc"), XS_GET_ONLY); 
 			slot = fxNextSlotProperty(the, slot, &mxGlobal, xsID("global"), XS_GET_ONLY);
 			slot = fxGlobalSetProperty(the, mxGlobal.value.reference, xsID("$262"), XS_NO_ID, XS_OWN);
 			slot->flag = XS_GET_ONLY;
@@ -630,6 +950,7 @@ int fxRunTestCase(txContext* context, char* path, txUnsigned flags, char* messag
 			slot->value = the->stack->value;
 			the->stack++;
 			
+			the->stack++;
 			the->stack++;
 		
 			fxNewHostFunctionGlobal(the, fx_print, 1, xsID("print"), XS_DONT_ENUM_FLAG);
@@ -651,49 +972,84 @@ int fxRunTestCase(txContext* context, char* path, txUnsigned flags, char* messag
 			c_strcpy(buffer, context->harnessPath);
 			c_strcat(buffer, "assert.js");
 			fxRunProgram(the, buffer, mxProgramFlag | mxDebugFlag);
-			if (context->includes) {
-				yaml_node_item_t* item = context->includes->data.sequence.items.start;
-				while (item < context->includes->data.sequence.items.top) {
-					yaml_node_t* node = yaml_document_get_node(context->document, *item);
+			if (file->includes) {
+				yaml_node_item_t* item = file->includes->data.sequence.items.start;
+				while (item < file->includes->data.sequence.items.top) {
+					yaml_node_t* node = yaml_document_get_node(file->document, *item);
 					c_strcpy(buffer, context->harnessPath);
 					c_strcat(buffer, (char*)node->data.scalar.value);
 					fxRunProgram(the, buffer, mxProgramFlag | mxDebugFlag);
 					item++;
 				}
 			}
-			if (flags)
-				fxRunProgram(the, path, flags);
-			else
-				fxRunModule(the, path);
-			fxRunLoop(the);
-			if (context->negative) {
-				snprintf(message, 1024, "# Expected a %s but got no errors", context->negative->data.scalar.value);
-			}
-			else {
-				snprintf(message, 1024, "OK");
-				success = 1;
-			}
 		}
 		xsCatch {
-			if (context->negative) {
-				txString name;
-				xsResult = xsGet(xsException, xsID("constructor"));
-				name = xsToString(xsGet(xsResult, xsID("name")));
-				if (strcmp(name, (char*)context->negative->data.scalar.value))
-					snprintf(message, 1024, "# Expected a %s but got a %s", context->negative->data.scalar.value, name);
+			xsToStringBuffer(xsException, message, 1024);
+			ready = 0;
+		}
+	}
+	xsEndHost(the);
+	if (ready && (context->snapshot || file->snapshot)) {
+		machine = fxRunTestSnapshot(machine, message);
+		if (!machine) {
+			if (!file->worker)
+				fxTerminateSharedCluster();
+			return 0;
+		}
+	}
+	if (ready && (context->share || file->share)) {
+		shared = machine;
+		xsShareMachine(shared);
+		if (!fxRunTestShare(creation, shared, path, flags, message) && !file->negative)
+			ready = 0;
+		machine = xsCloneMachine(creation, shared, "xst", NULL);
+	}
+	xsBeginHost(machine);
+	{
+		if (ready) {
+			xsTry {
+				if (flags)
+					fxRunProgram(the, path, flags);
+				else
+					fxRunModule(the, path);
+				fxRunLoop(the);
+				if (file->async) {
+					xsResult = xsGet(xsGet(xsGlobal, xsID("$DONE")), xsID("result"));
+					if (xsTypeOf(xsResult) == xsUndefinedType)
+						xsUnknownError("$DONE not called");
+					if (xsTypeOf(xsResult) != xsBooleanType)
+						xsThrow(xsResult);
+				}
+				if (file->negative) {
+					snprintf(message, 1024, "# Expected a %s but got no errors", file->negative->data.scalar.value);
+				}
 				else {
 					snprintf(message, 1024, "OK");
 					success = 1;
 				}
 			}
-			else {
-				xsToStringBuffer(xsException, message, 1024);
+			xsCatch {
+				if (file->negative) {
+					txString name;
+					xsResult = xsGet(xsException, xsID("constructor"));
+					name = xsToString(xsGet(xsResult, xsID("name")));
+					if (strcmp(name, (char*)file->negative->data.scalar.value))
+						snprintf(message, 1024, "# Expected a %s but got a %s", file->negative->data.scalar.value, name);
+					else {
+						snprintf(message, 1024, "OK");
+						success = 1;
+					}
+				}
+				else {
+					xsToStringBuffer(xsException, message, 1024);
+				}
 			}
 		}
 		xsResult = xsGet(xsGlobal, xsID("$262"));
 		xsResult = xsGet(xsResult, xsID("agent"));
 		xsCall0(xsResult, xsID("stop"));
 	}
+	file->collectionCount += the->garbageCollectionCount;
 #ifdef mxInstrument
 	fxCollectGarbage(the);
 	snprintf(buffer, sizeof(buffer), " # %d %lu %lu %d", 
@@ -702,6 +1058,7 @@ int fxRunTestCase(txContext* context, char* path, txUnsigned flags, char* messag
 		(the->stackTop - the->stackPeak) * sizeof(txSlot),
 		the->parserTotal);
 	c_strcat(message, buffer);
+	fxLockMutex(&(context->mutex));
 	if (context->peakChunksSize < the->peakChunksSize)
 		context->peakChunksSize = the->peakChunksSize;
 	if (context->peakHeapCount < the->peakHeapCount)
@@ -710,14 +1067,67 @@ int fxRunTestCase(txContext* context, char* path, txUnsigned flags, char* messag
 		context->peakStackCount = (the->stackTop - the->stackPeak);
 	if (context->parserTotal < the->parserTotal)
 		context->parserTotal = the->parserTotal;
+	fxUnlockMutex(&(context->mutex));
 #endif
 	xsEndHost(the);
 	xsDeleteMachine(machine);
-	fxTerminateSharedCluster();
-	fxCountResult(context, success, 0);
+	if (shared)
+		xsDeleteMachine(shared);
+	if (!file->worker)
+		fxTerminateSharedCluster();
 	return success;
 }
 
+int fxRunTestShare(xsCreation* creation, xsMachine* shared, txString path, txUnsigned flags, char* message)
+{
+	xsMachine* machine = xsCloneMachine(creation, shared, "xst", NULL);
+	int ready = 1;
+	xsBeginHost(machine);
+	{
+		xsTry {
+			if (flags)
+				fxRunProgram(the, path, flags);
+			else
+				fxRunModule(the, path);
+			fxRunLoop(the);
+		}
+		xsCatch {
+			xsToStringBuffer(xsException, message, 1024);
+			ready = 0;
+		}
+	}
+	xsEndHost(the);
+	xsDeleteMachine(machine);
+	return ready;
+}
+
+xsMachine* fxRunTestSnapshot(xsMachine* machine, char* message)
+{
+	txSnapshotMemory memory = { NULL, 0, 0, 0 };
+	xsSnapshot snapshot = {
+		"xst",
+		3,
+		fxReadSnapshotMemory,
+		fxWriteSnapshotMemory,
+		&memory,
+		0
+	};
+	if (xsWriteSnapshot(machine, &snapshot)) {
+		xsDeleteMachine(machine);
+		memory.offset = 0;
+		machine = xsReadSnapshot(&snapshot, "xst", NULL);
+		if (!machine)
+			snprintf(message, 1024, "# Snapshot read error %d", snapshot.error);
+	}
+	else {
+		xsDeleteMachine(machine);
+		machine = NULL;
+		snprintf(message, 1024, "# Snapshot write error %d", snapshot.error);
+	}
+	c_free(memory.buffer);
+	return machine;
+}
+
 int fxStringEndsWith(const char *string, const char *suffix)
 {
 	int stringLength = strlen(string);
@@ -858,7 +1268,9 @@ void* fx_agent_start_aux(void* it)
 		4096, 		/* stackCount */
 		4096*3, 		/* keyCount */
 		1993, 		/* nameModulo */
-		127 		/* symbolModulo */
+		127, 		/* symbolModulo */
+		0, 		/* staticSize */
+		4096 * 4 		/* maximumStackCount */
 	};
 	txAgent* agent = it;
 	xsMachine* machine = xsCreateMachine(&creation, "xst-agent", NULL);
@@ -950,6 +1362,10 @@ void fx_detachArrayBuffer(xsMachine* the)
 
 void fx_done(xsMachine* the)
 {
+	if ((xsToInteger(xsArgc) > 0) && xsTest(xsArg(0)))
+		xsSet(xsFunction, xsID("result"), xsArg(0));
+	else
+		xsSet(xsFunction, xsID("result"), xsTrue);
 }
 
 void fx_evalScript(xsMachine* the)
@@ -964,6 +1380,57 @@ void fx_evalScript(xsMachine* the)
 	xsCall1(xsGlobal, xsID("eval"), xsArg(0));
 }
 
+/*
+	$262.fast: host functions called with the fast ABI, as if declared with a signature in a hosts table
+*/
+
+txSlot* fxNextFastHostFunctionProperty(txMachine* the, txSlot* property, txFastCallback call, txString signature, txInteger length, txID id)
+{
+	txSlot* function;
+	txSize size;
+	property = fxNextHostFunctionProperty(the, property, C_NULL, length, id, XS_GET_ONLY);
+	function = property->value.reference;
+	function->next->flag |= XS_FAST_FLAG;
+	function->next->ID = fxParseFastSignature(signature, &size);
+	function->next->value.fastCallback.address = call;
+	return property;
+}
+
+void fx_fast_isNaN(txMachine* the, txSlot* self, txFastValue* argv, txFastValue* result)
+{
+	result->boolean = c_isnan(argv[0].number);
+}
+
+void fx_fast_peek(txMachine* the, txSlot* self, txFastValue* argv, txFastValue* result)
+{
+	txInteger index = argv[1].integer;
+	if (index < 0)
+		result->integer = argv[0].buffer.length;
+	else if (index < argv[0].buffer.length)
+		result->integer = ((txU1*)argv[0].buffer.data)[index];
+	else
+		result->integer = -1;
+}
+
+void fx_fast_scale(txMachine* the, txSlot* self, txFastValue* argv, txFastValue* result)
+{
+	result->number = argv[0].number * argv[1].integer;
+}
+
+void fx_fast_sum(txMachine* the, txSlot* self, txFastValue* argv, txFastValue* result)
+{
+	txUnsigned sum = 0;
+	txInteger index;
+	for (index = 0; index < 6; index++)
+		sum += (txUnsigned)argv[index].integer;
+	result->integer = (txInteger)sum;
+}
+
+void fx_gc(xsMachine* the)
+{
+	xsCollectGarbage();
+}
+
 void fx_print(xsMachine* the)
 {
 	fprintf(stdout, "%s\n", xsToString(xsArg(0)));
@@ -119,5 +119,8 @@
 #define mxUseDefaultLoadModule 1
 #define mxUseDefaultParseScript 1
 #define mxUseDefaultSharedChunks 1
+#if !mxWindows
+	#define mxUseDefaultHeapProtection 1
+#endif
 
 #endif /* __XST__ */